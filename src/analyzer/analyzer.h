@@ -1,5 +1,8 @@
 #pragma once
 
+#include <QByteArray>
+#include <QString>
+
 #include "analyzer/analyzertrack.h"
 #include "audio/signalinfo.h"
 #include "audio/types.h"
@@ -44,6 +47,35 @@ class Analyzer {
     // This function will be invoked after the results have been
     // stored or if processing aborted preliminary.
     virtual void cleanup() = 0;
+
+    // Results that only depend on the audio content and the settings
+    // of the analyzer could be reused for all tracks with the same
+    // audio content, e.g. after a file has been retagged or moved.
+    // Analyzers that support this return a non-empty id. The version
+    // must change whenever the results would change, i.e. if either
+    // the algorithm or the settings have been modified. Both are only
+    // queried after initialize() succeeded.
+    virtual QString cachedResultsId() const {
+        return QString();
+    }
+    virtual QString cachedResultsVersion() const {
+        return QString();
+    }
+
+    // Serialize the results that have been stored by storeResults()
+    // before cleanup() is invoked. Empty results are not cached.
+    virtual QByteArray exportResults() const {
+        return QByteArray();
+    }
+
+    // Update the track object with cached results instead of processing
+    // the audio samples. Return false if the results could not be applied.
+    // Only cleanup() will be invoked afterwards.
+    virtual bool importResults(TrackPointer pTrack, const QByteArray& results) {
+        Q_UNUSED(pTrack);
+        Q_UNUSED(results);
+        return false;
+    }
 };
 
 typedef std::unique_ptr<Analyzer> AnalyzerPtr;
@@ -86,9 +118,13 @@ class AnalyzerWithState final {
         }
     }
 
-    void finish(const AnalyzerTrack& track) {
+    // The exported results are only requested if a pointer is passed
+    void finish(const AnalyzerTrack& track, QByteArray* pExportedResults = nullptr) {
         if (m_active) {
             m_analyzer->storeResults(track.getTrack());
+            if (pExportedResults) {
+                *pExportedResults = m_analyzer->exportResults();
+            }
             m_analyzer->cleanup();
             m_active = false;
         }
@@ -101,6 +137,27 @@ class AnalyzerWithState final {
         }
     }
 
+    bool supportsCachedResults() const {
+        return m_active && !m_analyzer->cachedResultsId().isEmpty();
+    }
+
+    const Analyzer& analyzer() const {
+        return *m_analyzer;
+    }
+
+    // Finishes the analysis with cached results instead of processing
+    // the samples. Returns false and keeps the analyzer active if the
+    // results could not be applied.
+    bool finishWithCachedResults(const AnalyzerTrack& track, const QByteArray& results) {
+        DEBUG_ASSERT(m_active);
+        if (!m_analyzer->importResults(track.getTrack(), results)) {
+            return false;
+        }
+        m_analyzer->cleanup();
+        m_active = false;
+        return true;
+    }
+
   private:
     AnalyzerPtr m_analyzer;
     bool m_active;
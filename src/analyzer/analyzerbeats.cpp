@@ -1,5 +1,6 @@
 #include "analyzer/analyzerbeats.h"
 
+#include <QDataStream>
 #include <QHash>
 #include <QString>
 #include <QVector>
@@ -245,6 +246,7 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
 
 void AnalyzerBeats::cleanup() {
     m_pPlugin.reset();
+    m_pStoredBeats.reset();
 }
 
 void AnalyzerBeats::storeResults(TrackPointer pTrack) {
@@ -281,7 +283,50 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
         pBeats = mixxx::Beats::fromConstTempo(m_sampleRate, mixxx::audio::kStartFramePos, bpm);
     }
 
-    pTrack->trySetBeats(pBeats);
+    if (pTrack->trySetBeats(pBeats)) {
+        m_pStoredBeats = pBeats;
+    }
+}
+
+QString AnalyzerBeats::cachedResultsId() const {
+    return QStringLiteral("beats");
+}
+
+QString AnalyzerBeats::cachedResultsVersion() const {
+    return QStringLiteral("%1 fixed_tempo=%2 fast_analysis=%3 stem_strategy=%4")
+            .arg(m_pluginId,
+                    QString::number(m_bPreferencesFixedTempo),
+                    QString::number(m_bPreferencesFastAnalysis),
+                    QString::number(static_cast<int>(m_bpmSettings.getStemStrategy())));
+}
+
+QByteArray AnalyzerBeats::exportResults() const {
+    if (!m_pStoredBeats) {
+        return QByteArray();
+    }
+    QByteArray results;
+    QDataStream stream(&results, QIODevice::WriteOnly);
+    stream << m_pStoredBeats->getVersion()
+           << m_pStoredBeats->getSubVersion()
+           << m_pStoredBeats->toByteArray();
+    return results;
+}
+
+bool AnalyzerBeats::importResults(TrackPointer pTrack, const QByteArray& results) {
+    QString version;
+    QString subVersion;
+    QByteArray serializedBeats;
+    QDataStream stream(results);
+    stream >> version >> subVersion >> serializedBeats;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    const auto pBeats = mixxx::Beats::fromByteArray(
+            m_sampleRate, version, subVersion, serializedBeats);
+    if (!pBeats) {
+        return false;
+    }
+    return pTrack->trySetBeats(pBeats);
 }
 
 // static
@@ -8,6 +8,7 @@
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/beatdetectionsettings.h"
 #include "preferences/usersettings.h"
+#include "track/beats.h"
 
 class AnalyzerBeats : public Analyzer {
   public:
@@ -27,6 +28,11 @@ class AnalyzerBeats : public Analyzer {
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
+    QString cachedResultsId() const override;
+    QString cachedResultsVersion() const override;
+    QByteArray exportResults() const override;
+    bool importResults(TrackPointer pTrack, const QByteArray& results) override;
+
   private:
     bool shouldAnalyze(TrackPointer pTrack) const;
     static QHash<QString, QString> getExtraVersionInfo(
@@ -45,4 +51,6 @@ class AnalyzerBeats : public Analyzer {
     mixxx::audio::ChannelCount m_channelCount;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
+
+    mixxx::BeatsPointer m_pStoredBeats;
 };
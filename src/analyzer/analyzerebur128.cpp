@@ -1,5 +1,6 @@
 #include "analyzer/analyzerebur128.h"
 
+#include <QDataStream>
 #include <QtDebug>
 
 #include "analyzer/analyzertrack.h"
@@ -14,7 +15,8 @@ constexpr double kReplayGain2ReferenceLUFS = -18;
 
 AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig)
         : m_rgSettings(pConfig),
-          m_pState(nullptr) {
+          m_pState(nullptr),
+          m_storedRatio(mixxx::ReplayGain::kRatioUndefined) {
 }
 
 AnalyzerEbur128::~AnalyzerEbur128() {
@@ -44,6 +46,7 @@ void AnalyzerEbur128::cleanup() {
         // ebur128_destroy clears the pointer but let's not rely on that.
         m_pState = nullptr;
     }
+    m_storedRatio = mixxx::ReplayGain::kRatioUndefined;
 }
 
 bool AnalyzerEbur128::processSamples(const CSAMPLE* pIn, SINT count) {
@@ -84,6 +87,38 @@ void AnalyzerEbur128::storeResults(TrackPointer pTrack) {
     mixxx::ReplayGain replayGain(pTrack->getReplayGain());
     replayGain.setRatio(db2ratio(fReplayGain2));
     pTrack->setReplayGain(replayGain);
+    m_storedRatio = replayGain.getRatio();
     qDebug() << "ReplayGain 2.0 (libebur128) result is" << fReplayGain2
              << "dB for" << pTrack->getFileInfo();
 }
+
+QString AnalyzerEbur128::cachedResultsId() const {
+    return QStringLiteral("replaygain2");
+}
+
+QString AnalyzerEbur128::cachedResultsVersion() const {
+    return QString::number(kReplayGain2ReferenceLUFS);
+}
+
+QByteArray AnalyzerEbur128::exportResults() const {
+    if (!mixxx::ReplayGain::isValidRatio(m_storedRatio)) {
+        return QByteArray();
+    }
+    QByteArray results;
+    QDataStream stream(&results, QIODevice::WriteOnly);
+    stream << m_storedRatio;
+    return results;
+}
+
+bool AnalyzerEbur128::importResults(TrackPointer pTrack, const QByteArray& results) {
+    double ratio = mixxx::ReplayGain::kRatioUndefined;
+    QDataStream stream(results);
+    stream >> ratio;
+    if (stream.status() != QDataStream::Ok || !mixxx::ReplayGain::isValidRatio(ratio)) {
+        return false;
+    }
+    mixxx::ReplayGain replayGain(pTrack->getReplayGain());
+    replayGain.setRatio(ratio);
+    pTrack->setReplayGain(replayGain);
+    return true;
+}
@@ -22,7 +22,14 @@ class AnalyzerEbur128 : public Analyzer {
     void storeResults(TrackPointer pTrack) override;
     void cleanup() override;
 
+    QString cachedResultsId() const override;
+    QString cachedResultsVersion() const override;
+    QByteArray exportResults() const override;
+    bool importResults(TrackPointer pTrack, const QByteArray& results) override;
+
   private:
     ReplayGainSettings m_rgSettings;
     ebur128_state* m_pState;
+    // Undefined (= 0) until results have been stored
+    double m_storedRatio;
 };
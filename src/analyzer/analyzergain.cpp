@@ -2,6 +2,7 @@
 
 #include <replaygain.h>
 
+#include <QDataStream>
 #include <QtDebug>
 
 #include "analyzer/analyzertrack.h"
@@ -12,7 +13,8 @@
 
 AnalyzerGain::AnalyzerGain(UserSettingsPointer pConfig)
         : m_rgSettings(pConfig),
-          m_pReplayGain(std::make_unique<ReplayGain>()) {
+          m_pReplayGain(std::make_unique<ReplayGain>()),
+          m_storedRatio(mixxx::ReplayGain::kRatioUndefined) {
 }
 
 AnalyzerGain::~AnalyzerGain() = default;
@@ -33,6 +35,7 @@ bool AnalyzerGain::initialize(const AnalyzerTrack& track,
 }
 
 void AnalyzerGain::cleanup() {
+    m_storedRatio = mixxx::ReplayGain::kRatioUndefined;
 }
 
 bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
@@ -96,6 +99,38 @@ void AnalyzerGain::storeResults(TrackPointer pTrack) {
     mixxx::ReplayGain replayGain(pTrack->getReplayGain());
     replayGain.setRatio(db2ratio(fReplayGainOutput));
     pTrack->setReplayGain(replayGain);
+    m_storedRatio = replayGain.getRatio();
     qDebug() << "ReplayGain 1.0 result is" << fReplayGainOutput << "dB for"
              << pTrack->getLocation();
 }
+
+QString AnalyzerGain::cachedResultsId() const {
+    return QStringLiteral("replaygain1");
+}
+
+QString AnalyzerGain::cachedResultsVersion() const {
+    return QStringLiteral("1");
+}
+
+QByteArray AnalyzerGain::exportResults() const {
+    if (!mixxx::ReplayGain::isValidRatio(m_storedRatio)) {
+        return QByteArray();
+    }
+    QByteArray results;
+    QDataStream stream(&results, QIODevice::WriteOnly);
+    stream << m_storedRatio;
+    return results;
+}
+
+bool AnalyzerGain::importResults(TrackPointer pTrack, const QByteArray& results) {
+    double ratio = mixxx::ReplayGain::kRatioUndefined;
+    QDataStream stream(results);
+    stream >> ratio;
+    if (stream.status() != QDataStream::Ok || !mixxx::ReplayGain::isValidRatio(ratio)) {
+        return false;
+    }
+    mixxx::ReplayGain replayGain(pTrack->getReplayGain());
+    replayGain.setRatio(ratio);
+    pTrack->setReplayGain(replayGain);
+    return true;
+}
@@ -32,10 +32,17 @@ class AnalyzerGain : public Analyzer {
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
+    QString cachedResultsId() const override;
+    QString cachedResultsVersion() const override;
+    QByteArray exportResults() const override;
+    bool importResults(TrackPointer pTrack, const QByteArray& results) override;
+
   private:
     ReplayGainSettings m_rgSettings;
     std::vector<CSAMPLE> m_pLeftTempBuffer;
     std::vector<CSAMPLE> m_pRightTempBuffer;
     mixxx::audio::ChannelCount m_channelCount;
     std::unique_ptr<ReplayGain> m_pReplayGain;
+    // Undefined (= 0) until results have been stored
+    double m_storedRatio;
 };
@@ -1,5 +1,6 @@
 #include "analyzer/analyzerkey.h"
 
+#include <QDataStream>
 #include <QtDebug>
 
 #include "analyzer/analyzertrack.h"
@@ -210,6 +211,7 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
 
 void AnalyzerKey::cleanup() {
     m_pPlugin.reset();
+    m_storedKeys.reset();
 }
 
 void AnalyzerKey::storeResults(TrackPointer tio) {
@@ -228,6 +230,48 @@ void AnalyzerKey::storeResults(TrackPointer tio) {
     Keys track_keys = KeyFactory::makePreferredKeys(
             key_changes, extraVersionInfo, m_sampleRate, m_totalFrames);
     tio->setKeys(track_keys);
+    m_storedKeys = track_keys;
+}
+
+QString AnalyzerKey::cachedResultsId() const {
+    return QStringLiteral("key");
+}
+
+QString AnalyzerKey::cachedResultsVersion() const {
+    return QStringLiteral("%1 fast_analysis=%2 stem_strategy=%3")
+            .arg(m_pluginId,
+                    QString::number(m_bPreferencesFastAnalysisEnabled),
+                    QString::number(static_cast<int>(m_keySettings.getStemStrategy())));
+}
+
+QByteArray AnalyzerKey::exportResults() const {
+    if (!m_storedKeys) {
+        return QByteArray();
+    }
+    QByteArray results;
+    QDataStream stream(&results, QIODevice::WriteOnly);
+    stream << m_storedKeys->getVersion()
+           << m_storedKeys->getSubVersion()
+           << m_storedKeys->toByteArray();
+    return results;
+}
+
+bool AnalyzerKey::importResults(TrackPointer pTrack, const QByteArray& results) {
+    QString version;
+    QString subVersion;
+    QByteArray serializedKeys;
+    QDataStream stream(results);
+    stream >> version >> subVersion >> serializedKeys;
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    const Keys keys = KeyFactory::loadKeysFromByteArray(
+            version, subVersion, &serializedKeys);
+    if (keys.getGlobalKey() == mixxx::track::io::key::INVALID) {
+        return false;
+    }
+    pTrack->setKeys(keys);
+    return true;
 }
 
 // static
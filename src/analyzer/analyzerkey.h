@@ -4,10 +4,12 @@
 #include <QList>
 #include <QString>
 #include <memory>
+#include <optional>
 
 #include "analyzer/analyzer.h"
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/keydetectionsettings.h"
+#include "track/keys.h"
 #include "track/track_decl.h"
 
 class AnalyzerKey : public Analyzer {
@@ -26,6 +28,11 @@ class AnalyzerKey : public Analyzer {
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
+    QString cachedResultsId() const override;
+    QString cachedResultsVersion() const override;
+    QByteArray exportResults() const override;
+    bool importResults(TrackPointer pTrack, const QByteArray& results) override;
+
   private:
     static QHash<QString, QString> getExtraVersionInfo(
             const QString& pluginId, bool bPreferencesFastAnalysis);
@@ -44,4 +51,6 @@ class AnalyzerKey : public Analyzer {
     bool m_bPreferencesKeyDetectionEnabled;
     bool m_bPreferencesFastAnalysisEnabled;
     bool m_bPreferencesReanalyzeEnabled;
+
+    std::optional<Keys> m_storedKeys;
 };
@@ -0,0 +1,115 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("AnalyzerPipeline");
+
+} // anonymous namespace
+
+AnalyzerPipeline::AnalyzerPipeline(
+        const QString& name,
+        std::vector<AnalyzerWithState>* pAnalyzers,
+        SINT samplesPerChunk,
+        int numberOfChunks)
+        : m_pAnalyzers(pAnalyzers),
+          m_publishedChunkCount(0),
+          m_consumedChunkCounts(pAnalyzers->size(), 0),
+          m_stop(false) {
+    DEBUG_ASSERT(m_pAnalyzers);
+    DEBUG_ASSERT(numberOfChunks > 0);
+    m_chunks.reserve(numberOfChunks);
+    for (int i = 0; i < numberOfChunks; ++i) {
+        m_chunks.emplace_back(samplesPerChunk);
+    }
+    m_stageThreads.reserve(m_pAnalyzers->size());
+    for (std::size_t stageIndex = 0; stageIndex < m_pAnalyzers->size(); ++stageIndex) {
+        auto pThread = std::unique_ptr<QThread>(QThread::create(
+                [this, stageIndex] { runStage(stageIndex); }));
+        pThread->setObjectName(QStringLiteral("%1 Stage %2").arg(name).arg(stageIndex));
+        // Inherit the priority of the analyzer thread
+        pThread->start();
+        m_stageThreads.push_back(std::move(pThread));
+    }
+    kLogger.debug()
+            << name
+            << "started"
+            << m_stageThreads.size()
+            << "stages";
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_chunkPublished.notify_all();
+    for (const auto& pThread : m_stageThreads) {
+        pThread->wait();
+    }
+}
+
+quint64 AnalyzerPipeline::minConsumedChunkCount() const {
+    DEBUG_ASSERT(!m_consumedChunkCounts.empty());
+    return *std::min_element(
+            m_consumedChunkCounts.begin(),
+            m_consumedChunkCounts.end());
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerPipeline::nextChunk() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_consumedChunkCounts.empty()) {
+        m_chunkConsumed.wait(lock, [this] {
+            return m_publishedChunkCount - minConsumedChunkCount() < m_chunks.size();
+        });
+    }
+    return mixxx::SampleBuffer::WritableSlice(
+            m_chunks[m_publishedChunkCount % m_chunks.size()].buffer);
+}
+
+void AnalyzerPipeline::publishChunk(const CSAMPLE* pSamples, SINT sampleCount) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Chunk& chunk = m_chunks[m_publishedChunkCount % m_chunks.size()];
+        DEBUG_ASSERT(pSamples >= chunk.buffer.data());
+        DEBUG_ASSERT(pSamples + sampleCount <= chunk.buffer.data() + chunk.buffer.size());
+        chunk.pSamples = pSamples;
+        chunk.sampleCount = sampleCount;
+        ++m_publishedChunkCount;
+    }
+    m_chunkPublished.notify_all();
+}
+
+void AnalyzerPipeline::waitUntilProcessed() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_consumedChunkCounts.empty()) {
+        return;
+    }
+    m_chunkConsumed.wait(lock, [this] {
+        return minConsumedChunkCount() == m_publishedChunkCount;
+    });
+}
+
+void AnalyzerPipeline::runStage(std::size_t stageIndex) {
+    AnalyzerWithState& analyzer = (*m_pAnalyzers)[stageIndex];
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_chunkPublished.wait(lock, [this, stageIndex] {
+            return m_stop || m_consumedChunkCounts[stageIndex] < m_publishedChunkCount;
+        });
+        if (m_stop) {
+            break;
+        }
+        const Chunk& chunk = m_chunks[m_consumedChunkCounts[stageIndex] % m_chunks.size()];
+        // The chunk is not modified until it has been consumed
+        lock.unlock();
+        analyzer.processSamples(chunk.pSamples, chunk.sampleCount);
+        lock.lock();
+        ++m_consumedChunkCounts[stageIndex];
+        m_chunkConsumed.notify_all();
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QThread>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/samplebuffer.h"
+
+/// Runs each analyzer on a separate thread.
+///
+/// The decoded audio data is written into a ring of chunks that is shared
+/// by all analyzers. Each analyzer consumes the chunks on its own stage
+/// thread in order. A chunk is reused after all analyzers have processed
+/// it. The time for analyzing a track is then limited by the slowest
+/// analyzer instead of the sum of all analyzers.
+///
+/// The analyzers are only accessed from the stage threads while chunks are
+/// pending. initialize(), finish(), and cancel() must still be invoked by
+/// the owner after waitUntilProcessed() returned.
+///
+/// All functions must be invoked from the thread that owns the pipeline.
+class AnalyzerPipeline final {
+  public:
+    /// The analyzers must neither be added nor removed during the
+    /// lifetime of the pipeline.
+    AnalyzerPipeline(
+            const QString& name,
+            std::vector<AnalyzerWithState>* pAnalyzers,
+            SINT samplesPerChunk,
+            int numberOfChunks);
+    ~AnalyzerPipeline();
+
+    /// Returns the buffer for the next chunk. Blocks until all analyzers
+    /// have finished processing the previous contents of this chunk.
+    mixxx::SampleBuffer::WritableSlice nextChunk();
+
+    /// Hands over the samples that have been written into the buffer
+    /// returned by nextChunk() to the analyzers.
+    void publishChunk(const CSAMPLE* pSamples, SINT sampleCount);
+
+    /// Blocks until all analyzers have processed all published chunks.
+    void waitUntilProcessed();
+
+  private:
+    struct Chunk {
+        explicit Chunk(SINT samplesPerChunk)
+                : buffer(samplesPerChunk),
+                  pSamples(nullptr),
+                  sampleCount(0) {
+        }
+        mixxx::SampleBuffer buffer;
+        const CSAMPLE* pSamples;
+        SINT sampleCount;
+    };
+
+    void runStage(std::size_t stageIndex);
+
+    quint64 minConsumedChunkCount() const;
+
+    std::vector<AnalyzerWithState>* const m_pAnalyzers;
+    std::vector<Chunk> m_chunks;
+    std::vector<std::unique_ptr<QThread>> m_stageThreads;
+
+    // Shared state, protected by m_mutex
+    std::mutex m_mutex;
+    std::condition_variable m_chunkPublished;
+    std::condition_variable m_chunkConsumed;
+    quint64 m_publishedChunkCount;
+    std::vector<quint64> m_consumedChunkCounts;
+    bool m_stop;
+};
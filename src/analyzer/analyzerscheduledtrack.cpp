@@ -1,10 +1,14 @@
 #include "analyzer/analyzerscheduledtrack.h"
 
+#include <QDebug>
+
 #include "analyzer/analyzertrack.h"
 #include "track/trackid.h"
 
-AnalyzerScheduledTrack::AnalyzerScheduledTrack(TrackId trackId, AnalyzerTrack::Options options)
-        : m_trackId(trackId), m_options(options) {
+AnalyzerScheduledTrack::AnalyzerScheduledTrack(TrackId trackId,
+        AnalyzerTrack::Options options,
+        Priority priority)
+        : m_trackId(trackId), m_options(options), m_priority(priority) {
 }
 
 const TrackId& AnalyzerScheduledTrack::getTrackId() const {
@@ -14,3 +18,19 @@ const TrackId& AnalyzerScheduledTrack::getTrackId() const {
 const AnalyzerTrack::Options& AnalyzerScheduledTrack::getOptions() const {
     return m_options;
 }
+
+AnalyzerScheduledTrack::Priority AnalyzerScheduledTrack::getPriority() const {
+    return m_priority;
+}
+
+QDebug operator<<(QDebug dbg, AnalyzerScheduledTrack::Priority priority) {
+    switch (priority) {
+    case AnalyzerScheduledTrack::Priority::Batch:
+        return dbg << "Batch";
+    case AnalyzerScheduledTrack::Priority::AutoDJ:
+        return dbg << "AutoDJ";
+    case AnalyzerScheduledTrack::Priority::Deck:
+        return dbg << "Deck";
+    }
+    return dbg << static_cast<int>(priority);
+}
@@ -1,13 +1,29 @@
 #pragma once
 
+#include <QDebug>
+
 #include "analyzer/analyzertrack.h"
 #include "track/trackid.h"
 
 /// A track to be scheduled for analysis with additional options.
 class AnalyzerScheduledTrack {
   public:
+    /// Tracks with a higher priority are analyzed first and may
+    /// preempt the analysis of tracks with a lower priority.
+    enum class Priority {
+        /// Analysis of the library or selected tracks
+        Batch,
+        /// Tracks in the Auto DJ queue that will be played soon
+        AutoDJ,
+        /// Tracks that have been loaded into a deck and might be
+        /// played immediately
+        Deck,
+    };
+    static constexpr int kPriorityCount = static_cast<int>(Priority::Deck) + 1;
+
     AnalyzerScheduledTrack(TrackId trackId,
-            AnalyzerTrack::Options options = AnalyzerTrack::Options());
+            AnalyzerTrack::Options options = AnalyzerTrack::Options(),
+            Priority priority = Priority::Batch);
 
     /// Fetches the id of the track to be analyzed.
     const TrackId& getTrackId() const;
@@ -15,11 +31,18 @@ class AnalyzerScheduledTrack {
     /// Fetches the additional options.
     const AnalyzerTrack::Options& getOptions() const;
 
+    /// Fetches the priority.
+    Priority getPriority() const;
+
   private:
     /// The id of the track to be analyzed.
     TrackId m_trackId;
     /// The additional options.
     AnalyzerTrack::Options m_options;
+    /// The priority.
+    Priority m_priority;
 };
 
 Q_DECLARE_TYPEINFO(AnalyzerScheduledTrack, Q_MOVABLE_TYPE);
+
+QDebug operator<<(QDebug dbg, AnalyzerScheduledTrack::Priority priority);
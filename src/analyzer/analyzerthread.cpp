@@ -1,5 +1,6 @@
 #include "analyzer/analyzerthread.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "analyzer/analyzerbeats.h"
@@ -8,6 +9,7 @@
 #include "analyzer/analyzerkey.h"
 #include "analyzer/analyzersilence.h"
 #include "analyzer/analyzerwaveform.h"
+#include "analyzer/audiocontenthash.h"
 #include "analyzer/constants.h"
 #include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
@@ -34,6 +36,10 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// The number of chunks that may be buffered in pipelined mode while
+// waiting for the slowest analyzer.
+constexpr int kPipelinedChunks = 16;
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -93,8 +99,15 @@ void AnalyzerThread::doRun() {
     // before returning from this function.
     mixxx::DbConnectionPooler dbConnectionPooler;
 
+    // The database connection is needed for storing waveforms and
+    // for the results that are cached by the hash of the audio content.
+    dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
+    if (dbConnectionPooler.isPooling()) {
+        pAnalysisDao = std::make_unique<AnalysisDao>(m_pConfig);
+        pAnalysisDao->initialize(mixxx::DbConnectionPooled(m_dbConnectionPool));
+    }
+
     if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
-        dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
         if (!dbConnectionPooler.isPooling()) {
             kLogger.warning()
                     << "Failed to obtain database connection for analyzer thread";
@@ -118,6 +131,14 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if (m_modeFlags & AnalyzerModeFlags::Pipelined) {
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(
+                name(),
+                &m_analyzers,
+                mixxx::kAnalysisSamplesPerChunk,
+                kPipelinedChunks);
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -157,9 +178,31 @@ void AnalyzerThread::doRun() {
             }
         }
 
+        // Results that only depend on the audio content are reused
+        // for files that have been retagged or moved.
+        QString contentHash;
+        if (processTrack && pAnalysisDao &&
+                std::any_of(m_analyzers.begin(),
+                        m_analyzers.end(),
+                        [](const AnalyzerWithState& analyzer) {
+                            return analyzer.supportsCachedResults();
+                        })) {
+            contentHash = mixxx::calculateAudioContentHash(
+                    audioSource,
+                    mixxx::SampleBuffer::WritableSlice(m_sampleBuffer));
+            if (!contentHash.isEmpty()) {
+                processTrack = restoreCachedResults(*pAnalysisDao, contentHash);
+            }
+        }
+
         if (processTrack) {
             const auto analysisResult = analyzeAudioSource(audioSource);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
+            if (m_pPipeline) {
+                // The analyzers must not be accessed while still processing
+                // the remaining chunks on their stage threads.
+                m_pPipeline->waitUntilProcessed();
+            }
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
                 // any errors or partial if it has been aborted due to a corrupt
@@ -170,7 +213,18 @@ void AnalyzerThread::doRun() {
                 emitBusyProgress(kAnalyzerProgressFinalizing);
                 // This takes around 3 sec on a Atom Netbook
                 for (auto&& analyzer : m_analyzers) {
-                    analyzer.finish(*m_currentTrack);
+                    if (contentHash.isEmpty() || !analyzer.supportsCachedResults()) {
+                        analyzer.finish(*m_currentTrack);
+                        continue;
+                    }
+                    const QString analyzerId = analyzer.analyzer().cachedResultsId();
+                    const QString version = analyzer.analyzer().cachedResultsVersion();
+                    QByteArray results;
+                    analyzer.finish(*m_currentTrack, &results);
+                    if (!results.isEmpty()) {
+                        pAnalysisDao->saveCachedResults(
+                                contentHash, analyzerId, version, results);
+                    }
                 }
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
@@ -180,19 +234,51 @@ void AnalyzerThread::doRun() {
                 emitDoneProgress(kAnalyzerProgressUnknown);
             }
         } else {
-            kLogger.debug() << "Skipping track analysis because no analyzer initialized.";
+            kLogger.debug() << "Skipping track analysis because no analyzer needs to process it.";
             emitDoneProgress(kAnalyzerProgressDone);
         }
     }
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pPipeline.reset();
     m_analyzers.clear();
+    pAnalysisDao.reset();
 
     kLogger.debug() << "Exiting worker thread";
     emitProgress(AnalyzerThreadState::Exit);
 }
 
+bool AnalyzerThread::restoreCachedResults(
+        const AnalysisDao& analysisDao,
+        const QString& contentHash) {
+    DEBUG_ASSERT(m_currentTrack.has_value());
+    bool processTrack = false;
+    for (auto&& analyzer : m_analyzers) {
+        if (!analyzer.isActive()) {
+            continue;
+        }
+        if (analyzer.supportsCachedResults()) {
+            const QString analyzerId = analyzer.analyzer().cachedResultsId();
+            const QByteArray results = analysisDao.getCachedResults(
+                    contentHash,
+                    analyzerId,
+                    analyzer.analyzer().cachedResultsVersion());
+            if (!results.isEmpty() &&
+                    analyzer.finishWithCachedResults(*m_currentTrack, results)) {
+                kLogger.debug()
+                        << "Restored cached results of"
+                        << analyzerId
+                        << "for"
+                        << m_currentTrack->getTrack()->getLocation();
+                continue;
+            }
+        }
+        processTrack = true;
+    }
+    return processTrack;
+}
+
 bool AnalyzerThread::submitNextTrack(const AnalyzerTrack& nextTrack) {
     kLogger.debug()
             << "Enqueueing next track"
@@ -249,12 +335,16 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
-        // Request the next chunk of audio data
+        // Request the next chunk of audio data. In pipelined mode the data
+        // is decoded directly into the shared buffer of the analyzers.
+        const auto chunkBuffer = m_pPipeline
+                ? m_pPipeline->nextChunk()
+                : mixxx::SampleBuffer::WritableSlice(m_sampleBuffer);
         const auto readableSampleFrames =
                 audioSource->readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                chunkBuffer));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -299,10 +389,16 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            if (m_pPipeline) {
+                m_pPipeline->publishChunk(
                         readableSampleFrames.readableData(),
                         readableSampleFrames.readableLength());
+            } else {
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processSamples(
+                            readableSampleFrames.readableData(),
+                            readableSampleFrames.readableLength());
+                }
             }
         }
 
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
 #include "preferences/usersettings.h"
@@ -17,11 +18,16 @@
 #include "util/samplebuffer.h"
 #include "util/workerthread.h"
 
+class AnalysisDao;
+
 enum AnalyzerModeFlags {
     None = 0x00,
     WithBeats = 0x01,
     WithWaveform = 0x02,
     LowPriority = 0x04,
+    // Run each analyzer on a separate thread to reduce the latency
+    // for analyzing a single track (see AnalyzerPipeline)
+    Pipelined = 0x08,
     All = WithBeats | WithWaveform,
 };
 
@@ -118,6 +124,9 @@ class AnalyzerThread : public WorkerThread {
 
     std::vector<AnalyzerWithState> m_analyzers;
 
+    // Only used with AnalyzerModeFlags::Pipelined
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+
     mixxx::SampleBuffer m_sampleBuffer;
 
     std::optional<AnalyzerTrack> m_currentTrack;
@@ -131,6 +140,11 @@ class AnalyzerThread : public WorkerThread {
         Finished,
         Cancelled,
     };
+
+    // Finishes all active analyzers that support caching with the results
+    // that have been stored for the same audio content. Returns true if
+    // any analyzer is still active and the audio data needs to be processed.
+    bool restoreCachedResults(const AnalysisDao& analysisDao, const QString& contentHash);
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
 
@@ -123,9 +123,18 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
 
             if (analysis.type == AnalysisDao::TYPE_WAVEFORM) {
                 vc = WaveformFactory::waveformVersionToVersionClass(analysis.version);
-                if (missingWaveform && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveform = ConstWaveformPointer(
+                if (missingWaveform &&
+                        (vc == WaveformFactory::VC_USE ||
+                                vc == WaveformFactory::VC_CONVERT)) {
+                    WaveformPointer pWaveform(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
+                    if (vc == WaveformFactory::VC_CONVERT) {
+                        pWaveform->setVersion(WaveformFactory::currentWaveformVersion());
+                        pWaveform->setDescription(
+                                WaveformFactory::currentWaveformDescription());
+                        pWaveform->setSaveState(Waveform::SaveState::SavePending);
+                    }
+                    pLoadedTrackWaveform = pWaveform;
                     missingWaveform = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -134,9 +143,19 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
             }
             if (analysis.type == AnalysisDao::TYPE_WAVESUMMARY) {
                 vc = WaveformFactory::waveformSummaryVersionToVersionClass(analysis.version);
-                if (missingWavesummary && vc == WaveformFactory::VC_USE) {
-                    pLoadedTrackWaveformSummary = ConstWaveformPointer(
+                if (missingWavesummary &&
+                        (vc == WaveformFactory::VC_USE ||
+                                vc == WaveformFactory::VC_CONVERT)) {
+                    WaveformPointer pWaveformSummary(
                             WaveformFactory::loadWaveformFromAnalysis(analysis));
+                    if (vc == WaveformFactory::VC_CONVERT) {
+                        pWaveformSummary->setVersion(
+                                WaveformFactory::currentWaveformSummaryVersion());
+                        pWaveformSummary->setDescription(
+                                WaveformFactory::currentWaveformSummaryDescription());
+                        pWaveformSummary->setSaveState(Waveform::SaveState::SavePending);
+                    }
+                    pLoadedTrackWaveformSummary = pWaveformSummary;
                     missingWavesummary = false;
                 } else if (vc != WaveformFactory::VC_KEEP) {
                     // remove all other Analysis except that one we should keep
@@ -161,6 +180,12 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
     // If we don't need to calculate the waveform/wavesummary, skip.
     if (!missingWaveform && !missingWavesummary) {
         kLogger.debug() << "loadStored - Stored waveform loaded";
+        // Replaces the analyses that were stored in an older version, if
+        // they were loaded for conversion.
+        m_analysisDao.saveTrackAnalyses(
+                trackId,
+                pLoadedTrackWaveform,
+                pLoadedTrackWaveformSummary);
         if (pLoadedTrackWaveform) {
             pTrack->setWaveform(pLoadedTrackWaveform);
         }
@@ -278,6 +303,8 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
                 return false;
             }
             m_stride.store(m_waveformData + m_currentStride);
+            m_waveform->updateSummaryLevels(
+                    m_currentStride, m_currentStride + ChannelCount);
             m_currentStride += ChannelCount;
             m_waveform->setCompletion(m_currentStride);
         }
@@ -288,6 +315,8 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
                 return false;
             }
             m_stride.averageStore(m_waveformSummaryData + m_currentSummaryStride);
+            m_waveformSummary->updateSummaryLevels(
+                    m_currentSummaryStride, m_currentSummaryStride + ChannelCount);
             m_currentSummaryStride += ChannelCount;
             m_waveformSummary->setCompletion(m_currentSummaryStride);
 
@@ -0,0 +1,101 @@
+#include "analyzer/audiocontenthash.h"
+
+#include <QCryptographicHash>
+#include <algorithm>
+
+#include "analyzer/constants.h"
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("AudioContentHash");
+
+// Needs to be incremented whenever the calculation is modified
+constexpr int kVersion = 1;
+
+constexpr SINT kNumberOfWindows = 5;
+
+// ~1.5 sec at 44.1 kHz
+constexpr SINT kWindowFrames = 16 * kAnalysisFramesPerChunk;
+
+bool addWindowToHash(
+        QCryptographicHash* pHash,
+        const AudioSourcePointer& pAudioSource,
+        SampleBuffer::WritableSlice buffer,
+        IndexRange windowFrameRange) {
+    const auto signalInfo = pAudioSource->getSignalInfo();
+    const SINT bufferFrames = signalInfo.samples2frames(buffer.length());
+    while (!windowFrameRange.empty()) {
+        const auto chunkFrameRange = windowFrameRange.splitAndShrinkFront(
+                std::min(bufferFrames, windowFrameRange.length()));
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                WritableSampleFrames(
+                        chunkFrameRange,
+                        SampleBuffer::WritableSlice(
+                                buffer.data(),
+                                signalInfo.frames2samples(chunkFrameRange.length()))));
+        // The hash must not depend on the decoding errors of a
+        // single read operation
+        if (readableSampleFrames.frameIndexRange() != chunkFrameRange) {
+            kLogger.warning()
+                    << "Failed to read audio data"
+                    << chunkFrameRange;
+            return false;
+        }
+        pHash->addData(QByteArray::fromRawData(
+                reinterpret_cast<const char*>(readableSampleFrames.readableData()),
+                static_cast<int>(readableSampleFrames.readableLength() * sizeof(CSAMPLE))));
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+QString calculateAudioContentHash(
+        const AudioSourcePointer& pAudioSource,
+        SampleBuffer::WritableSlice buffer) {
+    VERIFY_OR_DEBUG_ASSERT(pAudioSource) {
+        return QString();
+    }
+    const auto signalInfo = pAudioSource->getSignalInfo();
+    VERIFY_OR_DEBUG_ASSERT(signalInfo.samples2frames(buffer.length()) > 0) {
+        return QString();
+    }
+    const IndexRange frameRange = pAudioSource->frameIndexRange();
+    if (frameRange.empty()) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArray::number(kVersion));
+    hash.addData(QByteArray::number(static_cast<int>(signalInfo.getChannelCount())));
+    hash.addData(QByteArray::number(static_cast<int>(signalInfo.getSampleRate())));
+    hash.addData(QByteArray::number(static_cast<qint64>(frameRange.length())));
+
+    if (frameRange.length() <= kNumberOfWindows * kWindowFrames) {
+        // Short tracks are hashed entirely
+        if (!addWindowToHash(&hash, pAudioSource, buffer, frameRange)) {
+            return QString();
+        }
+    } else {
+        // The windows are evenly distributed, including the
+        // very first and very last frames
+        const SINT windowDistance =
+                (frameRange.length() - kWindowFrames) / (kNumberOfWindows - 1);
+        for (SINT i = 0; i < kNumberOfWindows; ++i) {
+            const auto windowFrameRange = IndexRange::forward(
+                    frameRange.start() + i * windowDistance,
+                    kWindowFrames);
+            DEBUG_ASSERT(windowFrameRange.isSubrangeOf(frameRange));
+            if (!addWindowToHash(&hash, pAudioSource, buffer, windowFrameRange)) {
+                return QString();
+            }
+        }
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+} // namespace mixxx
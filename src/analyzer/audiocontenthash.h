@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QString>
+
+#include "sources/audiosource.h"
+#include "util/samplebuffer.h"
+
+namespace mixxx {
+
+/// Calculates a hash of the decoded audio data that identifies the
+/// audio content of a file independent of its location and tags.
+///
+/// Only the signal info, the length, and the samples of a few windows
+/// that are distributed over the whole track are considered. This is
+/// sufficient to detect if the audio content has been replaced, and is
+/// much faster than decoding the whole file.
+///
+/// The buffer is used for decoding and overwritten. Returns an empty
+/// string if the audio data could not be read.
+QString calculateAudioContentHash(
+        const AudioSourcePointer& pAudioSource,
+        SampleBuffer::WritableSlice buffer);
+
+} // namespace mixxx
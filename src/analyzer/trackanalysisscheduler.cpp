@@ -1,5 +1,7 @@
 #include "analyzer/trackanalysisscheduler.h"
 
+#include <algorithm>
+
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzertrack.h"
 #include "moc_trackanalysisscheduler.cpp"
@@ -53,6 +55,12 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         const UserSettingsPointer& pConfig,
         AnalyzerModeFlags modeFlags)
         : m_pEnvironment(std::move(pEnvironment)),
+          m_pDbConnectionPool(pDbConnectionPool),
+          m_pConfig(pConfig),
+          m_modeFlags(modeFlags),
+          m_maxRunningWorkers(numWorkerThreads),
+          // Worker threads are started in a suspended state
+          m_suspended(true),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
@@ -70,18 +78,13 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 << "worker threads. Priority: "
                 << (modeFlags & AnalyzerModeFlags::LowPriority ? "low" : "normal");
     }
+    // Each running worker might be preempted once by an additional worker
+    // that is created on demand. The capacity must be reserved upfront,
+    // because the workers must not be moved.
+    m_workers.reserve(2 * numWorkerThreads);
     // 1st pass: Create worker threads
-    m_workers.reserve(numWorkerThreads);
     for (int threadId = 0; threadId < numWorkerThreads; ++threadId) {
-        m_workers.emplace_back(AnalyzerThread::createInstance(
-                threadId,
-                pDbConnectionPool,
-                pConfig,
-                modeFlags));
-        connect(m_workers.back().thread(),
-                &AnalyzerThread::progress,
-                this,
-                &TrackAnalysisScheduler::onWorkerThreadProgress);
+        addWorker();
     }
     // 2nd pass: Start worker threads in a suspended state
     for (const auto& worker: m_workers) {
@@ -90,6 +93,21 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
     }
 }
 
+TrackAnalysisScheduler::Worker* TrackAnalysisScheduler::addWorker() {
+    DEBUG_ASSERT(m_workers.size() < m_workers.capacity());
+    const int threadId = static_cast<int>(m_workers.size());
+    m_workers.emplace_back(AnalyzerThread::createInstance(
+            threadId,
+            m_pDbConnectionPool,
+            m_pConfig,
+            m_modeFlags));
+    connect(m_workers.back().thread(),
+            &AnalyzerThread::progress,
+            this,
+            &TrackAnalysisScheduler::onWorkerThreadProgress);
+    return &m_workers.back();
+}
+
 TrackAnalysisScheduler::~TrackAnalysisScheduler() {
     kLogger.debug() << "Destroying";
 }
@@ -101,6 +119,7 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
         m_currentTrackProgress = kAnalyzerProgressUnknown;
         m_currentTrackNumber = 0;
         m_dequeuedTracksCount = 0;
+        logStatistics();
         emit finished();
         return;
     }
@@ -201,7 +220,7 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
         DEBUG_ASSERT(!trackId.isValid());
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
         worker.onAnalyzerProgress(analyzerProgress);
-        submitNextTrack(&worker);
+        dispatchTracks();
         break;
     case AnalyzerThreadState::Busy:
         DEBUG_ASSERT(trackId.isValid());
@@ -213,22 +232,37 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
             emit trackProgress(trackId, analyzerProgress);
         }
         break;
-    case AnalyzerThreadState::Done:
+    case AnalyzerThreadState::Done: {
         DEBUG_ASSERT(trackId.isValid());
+        DEBUG_ASSERT(worker.isBusy());
+        const Priority priority = worker.isBusy() ? worker.priority() : Priority::Batch;
+        const mixxx::Duration analysisDuration = worker.onTrackDone();
         // Ignore delayed signals for tracks that are no longer pending
         if (m_pendingTrackIds.find(trackId) != m_pendingTrackIds.end()) {
             DEBUG_ASSERT((analyzerProgress == kAnalyzerProgressDone) // success
                     || (analyzerProgress == kAnalyzerProgressUnknown)); // failure
             m_pendingTrackIds.erase(trackId);
+            Statistics& statistics = m_statistics[static_cast<int>(priority)];
+            ++statistics.finishedTracksCount;
+            statistics.analysisDuration += analysisDuration;
             worker.onAnalyzerProgress(analyzerProgress);
             emit trackProgress(trackId, analyzerProgress);
         }
         break;
+    }
     case AnalyzerThreadState::Exit:
         DEBUG_ASSERT(!trackId.isValid());
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
         worker.onThreadExit();
         DEBUG_ASSERT(!worker);
+        if (std::none_of(m_workers.begin(),
+                    m_workers.end(),
+                    [](const Worker& worker) {
+                        return static_cast<bool>(worker);
+                    })) {
+            kLogger.debug() << "All worker threads exited";
+            emit stopped();
+        }
         break;
     default:
         DEBUG_ASSERT(!"Unhandled signal from worker thread");
@@ -243,7 +277,14 @@ bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    // Insert the track behind all tracks with the same or a higher
+    // priority. Batch tracks are simply appended.
+    auto insertPos = m_queuedTracks.end();
+    while (insertPos != m_queuedTracks.begin() &&
+            std::prev(insertPos)->getPriority() < track.getPriority()) {
+        --insertPos;
+    }
+    m_queuedTracks.insert(insertPos, std::move(track));
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
@@ -263,6 +304,7 @@ int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>&
 
 void TrackAnalysisScheduler::suspend() {
     kLogger.debug() << "Suspending";
+    m_suspended = true;
     for (auto& worker: m_workers) {
         worker.suspendThread();
     }
@@ -270,9 +312,146 @@ void TrackAnalysisScheduler::suspend() {
 
 void TrackAnalysisScheduler::resume() {
     kLogger.debug() << "Resuming";
+    m_suspended = false;
     for (auto& worker: m_workers) {
         worker.resumeThread();
     }
+    dispatchTracks();
+}
+
+int TrackAnalysisScheduler::runningWorkersCount() const {
+    return static_cast<int>(std::count_if(
+            m_workers.begin(),
+            m_workers.end(),
+            [](const Worker& worker) {
+                return worker && worker.isBusy() && !worker.isPreempted();
+            }));
+}
+
+TrackAnalysisScheduler::Worker* TrackAnalysisScheduler::findIdleWorker() {
+    for (auto& worker : m_workers) {
+        if (worker && !worker.isBusy()) {
+            return &worker;
+        }
+    }
+    return nullptr;
+}
+
+TrackAnalysisScheduler::Worker* TrackAnalysisScheduler::findPreemptedWorker() {
+    Worker* pPreemptedWorker = nullptr;
+    for (auto& worker : m_workers) {
+        if (worker && worker.isPreempted() &&
+                (!pPreemptedWorker ||
+                        pPreemptedWorker->priority() < worker.priority())) {
+            pPreemptedWorker = &worker;
+        }
+    }
+    return pPreemptedWorker;
+}
+
+TrackAnalysisScheduler::Worker* TrackAnalysisScheduler::findPreemptableWorker(
+        Priority priority) {
+    Worker* pPreemptableWorker = nullptr;
+    for (auto& worker : m_workers) {
+        if (worker && worker.isBusy() && !worker.isPreempted() &&
+                worker.priority() < priority &&
+                (!pPreemptableWorker ||
+                        worker.priority() < pPreemptableWorker->priority())) {
+            pPreemptableWorker = &worker;
+        }
+    }
+    return pPreemptableWorker;
+}
+
+void TrackAnalysisScheduler::dispatchTracks() {
+    if (m_suspended) {
+        return;
+    }
+    while (true) {
+        Worker* pPreemptedWorker = findPreemptedWorker();
+        if (pPreemptedWorker &&
+                (m_queuedTracks.empty() ||
+                        pPreemptedWorker->priority() >=
+                                m_queuedTracks.front().getPriority())) {
+            // Continue the most important preempted track first
+            if (runningWorkersCount() >= m_maxRunningWorkers) {
+                Worker* pPreemptableWorker =
+                        findPreemptableWorker(pPreemptedWorker->priority());
+                if (!pPreemptableWorker) {
+                    return;
+                }
+                pPreemptableWorker->preemptThread();
+            }
+            kLogger.debug()
+                    << "Resuming preempted worker thread"
+                    << pPreemptedWorker->thread()->id();
+            pPreemptedWorker->resumePreemptedThread();
+            continue;
+        }
+        if (m_queuedTracks.empty()) {
+            return;
+        }
+        const Priority nextPriority = m_queuedTracks.front().getPriority();
+        Worker* pPreemptableWorker = nullptr;
+        if (runningWorkersCount() >= m_maxRunningWorkers) {
+            pPreemptableWorker = findPreemptableWorker(nextPriority);
+            if (!pPreemptableWorker) {
+                return;
+            }
+        }
+        Worker* pIdleWorker = findIdleWorker();
+        if (!pIdleWorker) {
+            if (m_workers.size() >= m_workers.capacity()) {
+                return;
+            }
+            // The new worker thread will ask for the next track
+            // when it becomes idle
+            pIdleWorker = addWorker();
+            pIdleWorker->thread()->start(kWorkerThreadPriority);
+            kLogger.debug()
+                    << "Started additional worker thread"
+                    << pIdleWorker->thread()->id();
+            if (pPreemptableWorker) {
+                pPreemptableWorker->preemptThread();
+            }
+            return;
+        }
+        if (pPreemptableWorker) {
+            kLogger.debug()
+                    << "Preempting worker thread"
+                    << pPreemptableWorker->thread()->id()
+                    << "for a track with priority"
+                    << nextPriority;
+            pPreemptableWorker->preemptThread();
+        }
+        if (!submitNextTrack(pIdleWorker)) {
+            if (pPreemptableWorker) {
+                // Nothing to do for the idle worker
+                pPreemptableWorker->resumePreemptedThread();
+            }
+            return;
+        }
+    }
+}
+
+void TrackAnalysisScheduler::logStatistics() const {
+    for (int i = 0; i < AnalyzerScheduledTrack::kPriorityCount; ++i) {
+        const Statistics& statistics = m_statistics[i];
+        if (statistics.finishedTracksCount <= 0) {
+            continue;
+        }
+        const double seconds = statistics.analysisDuration.toDoubleSeconds();
+        kLogger.info()
+                << "Analyzed"
+                << statistics.finishedTracksCount
+                << "tracks with priority"
+                << static_cast<Priority>(i)
+                << "in"
+                << statistics.analysisDuration.debugMillisWithUnit()
+                << "- average latency per track:"
+                << seconds / statistics.finishedTracksCount
+                << "s";
+    }
 }
 
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
@@ -288,6 +467,7 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                 AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
                     if (worker->submitNextTrack(std::move(nextTrack))) {
+                        worker->onTrackSubmitted(nextScheduledTrack.getPriority());
                         m_queuedTracks.pop_front();
                         ++m_dequeuedTracksCount;
                         return true;
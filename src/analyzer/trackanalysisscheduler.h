@@ -1,14 +1,18 @@
 #pragma once
 
 #include <QList>
+#include <array>
 #include <deque>
 #include <memory>
+#include <optional>
 #include <set>
 #include <vector>
 
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzerthread.h"
 #include "util/db/dbconnectionpool.h"
+#include "util/duration.h"
+#include "util/performancetimer.h"
 
 /// Callbacks for triggering side-effects in the outer context of
 /// TrackAnalysisScheduler.
@@ -22,10 +26,28 @@ class TrackAnalysisSchedulerEnvironment {
     virtual TrackPointer loadTrackById(TrackId trackId) const = 0;
 };
 
+/// Distributes scheduled tracks among a fixed number of analyzer threads.
+///
+/// Tracks are analyzed in order of their priority. If all threads are busy
+/// when a track with a higher priority arrives, the analysis of a track with
+/// a lower priority is suspended and continued from where it stopped after
+/// the more important track has been analyzed. Preempted threads are kept
+/// asleep, i.e. the number of threads that are running concurrently never
+/// exceeds the requested number.
 class TrackAnalysisScheduler : public QObject {
     Q_OBJECT
 
   public:
+    typedef AnalyzerScheduledTrack::Priority Priority;
+
+    // Throughput metrics for tracks of a single priority
+    struct Statistics {
+        int finishedTracksCount = 0;
+        // The accumulated wall-clock time from submitting each track
+        // to a worker until the analysis has finished
+        mixxx::Duration analysisDuration;
+    };
+
     typedef std::unique_ptr<TrackAnalysisScheduler, void(*)(TrackAnalysisScheduler*)> Pointer;
     // Subclass that provides a default constructor and nothing else
     class NullPointer: public Pointer {
@@ -53,6 +75,10 @@ class TrackAnalysisScheduler : public QObject {
     bool scheduleTrack(AnalyzerScheduledTrack track);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
+    const Statistics& statistics(Priority priority) const {
+        return m_statistics[static_cast<int>(priority)];
+    }
+
   public slots:
     void suspend();
 
@@ -69,6 +95,8 @@ class TrackAnalysisScheduler : public QObject {
     // Current average progress for all scheduled tracks and from all workers
     void progress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
     void finished();
+    // All worker threads have exited after the analysis has been stopped
+    void stopped();
 
   private slots:
     void onWorkerThreadProgress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress analyzerProgress);
@@ -82,7 +110,8 @@ class TrackAnalysisScheduler : public QObject {
       public:
         explicit Worker(AnalyzerThread::Pointer thread = AnalyzerThread::NullPointer())
             : m_thread(std::move(thread)),
-              m_analyzerProgress(kAnalyzerProgressUnknown) {
+              m_analyzerProgress(kAnalyzerProgressUnknown),
+              m_preempted(false) {
         }
         Worker(const Worker&) = delete;
         Worker(Worker&&) = default;
@@ -112,11 +141,58 @@ class TrackAnalysisScheduler : public QObject {
         }
 
         void resumeThread() {
-            if (m_thread) {
+            // Preempted threads are only resumed explicitly
+            if (m_thread && !m_preempted) {
                 m_thread->resume();
             }
         }
 
+        // A worker is busy from submitting a track until it
+        // reports that the analysis is done.
+        bool isBusy() const {
+            return m_priority.has_value();
+        }
+
+        Priority priority() const {
+            DEBUG_ASSERT(isBusy());
+            return *m_priority;
+        }
+
+        bool isPreempted() const {
+            return m_preempted;
+        }
+
+        // Suspends the analysis of the current track
+        void preemptThread() {
+            DEBUG_ASSERT(m_thread);
+            DEBUG_ASSERT(isBusy());
+            DEBUG_ASSERT(!m_preempted);
+            m_preempted = true;
+            m_thread->suspend();
+        }
+
+        // Continues the analysis of the current track
+        void resumePreemptedThread() {
+            DEBUG_ASSERT(m_thread);
+            DEBUG_ASSERT(m_preempted);
+            m_preempted = false;
+            m_thread->resume();
+        }
+
+        void onTrackSubmitted(Priority priority) {
+            DEBUG_ASSERT(!isBusy());
+            m_priority = priority;
+            m_busyTimer.start();
+        }
+
+        // Returns the elapsed time since the track has been submitted
+        mixxx::Duration onTrackDone() {
+            // Preempted threads only finish their track when stopped
+            m_preempted = false;
+            m_priority.reset();
+            return m_busyTimer.elapsed();
+        }
+
         void stopThread() {
             if (m_thread) {
                 m_thread->stop();
@@ -132,15 +208,34 @@ class TrackAnalysisScheduler : public QObject {
             DEBUG_ASSERT(m_thread);
             m_thread.reset();
             m_analyzerProgress = kAnalyzerProgressUnknown;
+            m_priority.reset();
+            m_preempted = false;
         }
 
       private:
         AnalyzerThread::Pointer m_thread;
         AnalyzerProgress m_analyzerProgress;
+        std::optional<Priority> m_priority;
+        bool m_preempted;
+        PerformanceTimer m_busyTimer;
     };
 
+    Worker* addWorker();
+
+    int runningWorkersCount() const;
+    Worker* findIdleWorker();
+    // The preempted worker with the highest priority
+    Worker* findPreemptedWorker();
+    // The running worker with the lowest priority below the given priority
+    Worker* findPreemptableWorker(Priority priority);
+
+    // Assigns queued tracks to idle workers and resumes or preempts
+    // workers depending on their priority.
+    void dispatchTracks();
+
     bool submitNextTrack(Worker* worker);
     void emitProgressOrFinished();
+    void logStatistics() const;
 
     bool allTracksFinished() const {
         return m_queuedTracks.empty() &&
@@ -148,9 +243,20 @@ class TrackAnalysisScheduler : public QObject {
     }
 
     const std::unique_ptr<const TrackAnalysisSchedulerEnvironment> m_pEnvironment;
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
+    const AnalyzerModeFlags m_modeFlags;
+
+    // The maximum number of workers that are running concurrently,
+    // i.e. that are neither idle nor preempted.
+    const int m_maxRunningWorkers;
 
     std::vector<Worker> m_workers;
 
+    bool m_suspended;
+
+    // Ordered by priority (descending) and by the time of
+    // scheduling (ascending)
     std::deque<AnalyzerScheduledTrack> m_queuedTracks;
 
     // Tracks that have already been submitted to workers
@@ -165,4 +271,6 @@ class TrackAnalysisScheduler : public QObject {
 
     typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
+
+    std::array<Statistics, AnalyzerScheduledTrack::kPriorityCount> m_statistics;
 };
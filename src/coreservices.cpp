@@ -47,6 +47,7 @@
 #include "qml/qmlplayermanagerproxy.h"
 #endif
 #include "soundio/soundmanager.h"
+#include "sources/decodedaudiocache.h"
 #include "sources/soundsourceproxy.h"
 #include "util/clipboard.h"
 #include "util/db/dbconnectionpooled.h"
@@ -480,6 +481,9 @@ void CoreServices::initialize(QApplication* pApp) {
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+    SoundSourceProxy::setDecodedAudioCache(
+            DecodedAudioCache::createFromConfig(pConfig));
+
     QString resourcePath = pConfig->getResourcePath();
 
     emit initializationProgressUpdate(0, tr("fonts"));
@@ -932,6 +936,8 @@ void CoreServices::finalize() {
     // PlayerInfo in EngineRecord.
     PlayerInfo::destroy();
 
+    SoundSourceProxy::setDecodedAudioCache(nullptr);
+
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting EffectsManager";
     CLEAR_AND_CHECK_DELETED(m_pEffectsManager);
 
@@ -0,0 +1,226 @@
+#include "effects/backends/builtin/convolutionreverbeffect.h"
+
+#include <QMutex>
+#include <cmath>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "effects/backends/effectmanifest.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "util/compatibility/qmutex.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace {
+
+struct RoomPreset {
+    // The time until the reverberation has decayed by 60 dB
+    double decaySeconds;
+    double preDelaySeconds;
+    // How much faster high frequencies decay, between 0 and 1
+    double damping;
+};
+
+constexpr RoomPreset kRoomPresets[ConvolutionReverbGroupState::kNumRooms] = {
+        {0.7, 0.004, 0.3}, // SmallRoom
+        {1.8, 0.012, 0.5}, // Hall
+        {3.0, 0.025, 0.7}, // Cathedral
+};
+
+constexpr int kNumEarlyReflections = 8;
+constexpr double kEarlyReflectionsSeconds = 0.04;
+// -60 dB
+constexpr double kDecayExponent = 6.907755;
+
+SINT impulseResponseFrames(const RoomPreset& preset, mixxx::audio::SampleRate sampleRate) {
+    return static_cast<SINT>(std::ceil(
+            (preset.preDelaySeconds + preset.decaySeconds) * sampleRate.toDouble()));
+}
+
+SINT maxImpulseResponseFrames(mixxx::audio::SampleRate sampleRate) {
+    SINT maxFrames = 0;
+    for (const auto& preset : kRoomPresets) {
+        maxFrames = math_max(maxFrames, impulseResponseFrames(preset, sampleRate));
+    }
+    return maxFrames;
+}
+
+/// Decaying noise that gets darker over time, preceded by a few
+/// discrete early reflections. The channels are decorrelated and the
+/// result is deterministic.
+std::vector<CSAMPLE> synthesizeImpulseResponse(
+        int room, int channel, mixxx::audio::SampleRate sampleRate) {
+    const RoomPreset& preset = kRoomPresets[room];
+    std::vector<CSAMPLE> impulseResponse(impulseResponseFrames(preset, sampleRate));
+    std::mt19937 generator(room * 2 + channel + 1);
+    std::normal_distribution<double> noise;
+
+    const auto preDelayFrames = static_cast<SINT>(
+            preset.preDelaySeconds * sampleRate.toDouble());
+    const auto decayFrames = preset.decaySeconds * sampleRate.toDouble();
+    double lowPass = 0;
+    for (SINT i = preDelayFrames; i < static_cast<SINT>(impulseResponse.size()); ++i) {
+        const double time = (i - preDelayFrames) / decayFrames;
+        const double coefficient = preset.damping * math_min(time * 2, 1.0);
+        lowPass = (1 - coefficient) * noise(generator) + coefficient * lowPass;
+        impulseResponse[i] = static_cast<CSAMPLE>(lowPass * std::exp(-kDecayExponent * time));
+    }
+
+    std::uniform_real_distribution<double> position(0, kEarlyReflectionsSeconds);
+    std::uniform_real_distribution<double> gain(-1, 1);
+    for (int i = 0; i < kNumEarlyReflections; ++i) {
+        const auto frame = preDelayFrames +
+                static_cast<SINT>(position(generator) * sampleRate.toDouble());
+        impulseResponse[frame] += static_cast<CSAMPLE>(gain(generator) * 4);
+    }
+    return impulseResponse;
+}
+
+std::shared_ptr<const PartitionedConvolver::ImpulseResponse> createImpulseResponse(
+        int room, mixxx::audio::SampleRate sampleRate) {
+    auto left = synthesizeImpulseResponse(room, 0, sampleRate);
+    auto right = synthesizeImpulseResponse(room, 1, sampleRate);
+
+    // Normalize to the energy of the input
+    double energy = 0;
+    for (SINT i = 0; i < static_cast<SINT>(left.size()); ++i) {
+        energy += left[i] * left[i] + right[i] * right[i];
+    }
+    const auto gain = static_cast<CSAMPLE_GAIN>(std::sqrt(2 / energy));
+    SampleUtil::applyGain(left.data(), gain, static_cast<SINT>(left.size()));
+    SampleUtil::applyGain(right.data(), gain, static_cast<SINT>(right.size()));
+
+    return std::make_shared<const PartitionedConvolver::ImpulseResponse>(
+            left.data(), right.data(), static_cast<SINT>(left.size()));
+}
+
+/// The impulse responses are shared by the states of all channels
+std::shared_ptr<const PartitionedConvolver::ImpulseResponse> sharedImpulseResponse(
+        int room, mixxx::audio::SampleRate sampleRate) {
+    static QMutex s_mutex;
+    static std::map<std::pair<int, double>,
+            std::weak_ptr<const PartitionedConvolver::ImpulseResponse>>
+            s_impulseResponses;
+    const auto locker = lockMutex(&s_mutex);
+    auto& pCached = s_impulseResponses[std::make_pair(room, sampleRate.toDouble())];
+    auto pImpulseResponse = pCached.lock();
+    if (!pImpulseResponse) {
+        pImpulseResponse = createImpulseResponse(room, sampleRate);
+        pCached = pImpulseResponse;
+    }
+    return pImpulseResponse;
+}
+
+} // anonymous namespace
+
+ConvolutionReverbGroupState::ConvolutionReverbGroupState(
+        const mixxx::EngineParameters& engineParameters)
+        : EffectState(engineParameters),
+          convolver(maxImpulseResponseFrames(engineParameters.sampleRate())),
+          sendBuffer(engineParameters.samplesPerBuffer()),
+          room(Hall),
+          sendPrevious(0) {
+    for (int i = 0; i < kNumRooms; ++i) {
+        impulseResponses[i] = sharedImpulseResponse(i, engineParameters.sampleRate());
+    }
+    convolver.setImpulseResponse(impulseResponses[room].get());
+}
+
+// static
+QString ConvolutionReverbEffect::getId() {
+    return "org.mixxx.effects.convolutionreverb";
+}
+
+// static
+EffectManifestPointer ConvolutionReverbEffect::getManifest() {
+    EffectManifestPointer pManifest(new EffectManifest());
+    pManifest->setAddDryToWet(true);
+    pManifest->setEffectRampsFromDry(true);
+
+    pManifest->setId(getId());
+    pManifest->setName(QObject::tr("Convolution Reverb"));
+    pManifest->setShortName(QObject::tr("Conv Reverb"));
+    pManifest->setAuthor("The Mixxx Team");
+    pManifest->setVersion("1.0");
+    pManifest->setDescription(QObject::tr(
+            "Places the signal in a room by convolving it with the room's "
+            "impulse response"));
+
+    EffectManifestParameterPointer room = pManifest->addParameter();
+    room->setId("room");
+    room->setName(QObject::tr("Room"));
+    room->setShortName(QObject::tr("Room"));
+    room->setDescription(QObject::tr(
+            "The size of the room. Larger rooms reverberate longer.\n"
+            "Switching the room cuts off the current reverberation."));
+    room->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    room->setRange(0, ConvolutionReverbGroupState::Hall, ConvolutionReverbGroupState::kNumRooms - 1);
+    room->appendStep(qMakePair(QObject::tr("Small Room"), ConvolutionReverbGroupState::SmallRoom));
+    room->appendStep(qMakePair(QObject::tr("Hall"), ConvolutionReverbGroupState::Hall));
+    room->appendStep(qMakePair(QObject::tr("Cathedral"), ConvolutionReverbGroupState::Cathedral));
+
+    EffectManifestParameterPointer send = pManifest->addParameter();
+    send->setId("send_amount");
+    send->setName(QObject::tr("Send"));
+    send->setShortName(QObject::tr("Send"));
+    send->setDescription(QObject::tr(
+            "How much of the signal to send in to the effect"));
+    send->setValueScaler(EffectManifestParameter::ValueScaler::Linear);
+    send->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    send->setDefaultLinkType(EffectManifestParameter::LinkType::Linked);
+    send->setDefaultLinkInversion(EffectManifestParameter::LinkInversion::NotInverted);
+    send->setRange(0, 0, 1);
+
+    return pManifest;
+}
+
+void ConvolutionReverbEffect::loadEngineEffectParameters(
+        const QMap<QString, EngineEffectParameterPointer>& parameters) {
+    m_pRoomParameter = parameters.value("room");
+    m_pSendParameter = parameters.value("send_amount");
+}
+
+void ConvolutionReverbEffect::processChannel(
+        ConvolutionReverbGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        const EffectEnableState enableState,
+        const GroupFeatureState& groupFeatures) {
+    Q_UNUSED(groupFeatures);
+
+    const int room = math_clamp(m_pRoomParameter->toInt(),
+            0,
+            ConvolutionReverbGroupState::kNumRooms - 1);
+    const auto sendCurrent = static_cast<CSAMPLE_GAIN>(m_pSendParameter->value());
+
+    if (room != pState->room) {
+        // Also clears the reverberation
+        pState->convolver.setImpulseResponse(pState->impulseResponses[room].get());
+        pState->room = room;
+    } else if (enableState == EffectEnableState::Enabling) {
+        // Prevent replaying the reverberation from the last time the
+        // effect was enabled.
+        pState->convolver.reset();
+    }
+
+    SampleUtil::copyWithRampingGain(pState->sendBuffer.data(),
+            pInput,
+            pState->sendPrevious,
+            sendCurrent,
+            engineParameters.samplesPerBuffer());
+    pState->convolver.process(pState->sendBuffer.data(),
+            pOutput,
+            engineParameters.framesPerBuffer());
+
+    // The ramping of the send parameter handles ramping when enabling, so
+    // this effect must handle ramping to dry when disabling itself (instead
+    // of being handled by EngineEffect::process).
+    if (enableState == EffectEnableState::Disabling) {
+        SampleUtil::applyRampingGain(pOutput, 1.0, 0.0, engineParameters.samplesPerBuffer());
+        pState->sendPrevious = 0;
+    } else {
+        pState->sendPrevious = sendCurrent;
+    }
+}
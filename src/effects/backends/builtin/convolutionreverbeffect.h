@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QMap>
+#include <array>
+#include <memory>
+
+#include "effects/backends/builtin/partitionedconvolver.h"
+#include "effects/backends/effectprocessor.h"
+#include "util/class.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+class ConvolutionReverbGroupState : public EffectState {
+  public:
+    enum Room {
+        SmallRoom = 0,
+        Hall = 1,
+        Cathedral = 2,
+    };
+    static constexpr int kNumRooms = 3;
+
+    /// Allocates everything that is needed for processing, including
+    /// the impulse responses of all rooms, so switching rooms in the
+    /// engine thread doesn't allocate. The impulse responses are created
+    /// for the current sample rate and are not recreated if it changes.
+    ConvolutionReverbGroupState(const mixxx::EngineParameters& engineParameters);
+    ~ConvolutionReverbGroupState() override = default;
+
+    std::array<std::shared_ptr<const PartitionedConvolver::ImpulseResponse>, kNumRooms>
+            impulseResponses;
+    PartitionedConvolver convolver;
+    mixxx::SampleBuffer sendBuffer;
+    int room;
+    CSAMPLE_GAIN sendPrevious;
+};
+
+/// A reverb that convolves the signal with the impulse response of a
+/// room. The impulse responses are synthesized, so no files need to be
+/// shipped or loaded.
+class ConvolutionReverbEffect : public EffectProcessorImpl<ConvolutionReverbGroupState> {
+  public:
+    ConvolutionReverbEffect() = default;
+    ~ConvolutionReverbEffect() override = default;
+
+    static QString getId();
+    static EffectManifestPointer getManifest();
+
+    void loadEngineEffectParameters(
+            const QMap<QString, EngineEffectParameterPointer>& parameters) override;
+
+    void processChannel(
+            ConvolutionReverbGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            const EffectEnableState enableState,
+            const GroupFeatureState& groupFeatures) override;
+
+  private:
+    QString debugString() const {
+        return getId();
+    }
+
+    EngineEffectParameterPointer m_pRoomParameter;
+    EngineEffectParameterPointer m_pSendParameter;
+
+    DISALLOW_COPY_AND_ASSIGN(ConvolutionReverbEffect);
+};
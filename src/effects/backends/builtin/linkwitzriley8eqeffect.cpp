@@ -120,13 +120,13 @@ void LinkwitzRiley8EQEffect::processChannel(
         pState->setFilters(engineParameters.sampleRate(), pState->m_loFreq, pState->m_hiFreq);
     }
 
-    pState->m_high2->process(pInput,
+    // HighPass first run, and LowPass first run for low and bandpass
+    pState->m_high2->processTogetherWith(pState->m_low2,
+            pInput,
             pState->m_pHighBuf,
-            engineParameters.samplesPerBuffer()); // HighPass first run
-    pState->m_low2->process(pInput,
+            pInput,
             pState->m_pLowBuf,
-            engineParameters
-                    .samplesPerBuffer()); // LowPass first run for low and bandpass
+            engineParameters.samplesPerBuffer());
 
     if (fMid != pState->old_mid || fHigh != pState->old_high) {
         SampleUtil::applyRampingGain(pState->m_pHighBuf,
@@ -146,13 +146,13 @@ void LinkwitzRiley8EQEffect::processChannel(
                 engineParameters.samplesPerBuffer());
     }
 
-    pState->m_high1->process(pState->m_pHighBuf,
+    // HighPass + BandPass second run, and LowPass second run
+    pState->m_high1->processTogetherWith(pState->m_low1,
+            pState->m_pHighBuf,
             pState->m_pMidBuf,
-            engineParameters
-                    .samplesPerBuffer()); // HighPass + BandPass second run
-    pState->m_low1->process(pState->m_pLowBuf,
             pState->m_pLowBuf,
-            engineParameters.samplesPerBuffer()); // LowPass second run
+            pState->m_pLowBuf,
+            engineParameters.samplesPerBuffer());
 
     if (fLow != pState->old_low) {
         SampleUtil::copy2WithRampingGain(pOutput,
@@ -103,12 +103,22 @@ class LVMixEQEffectGroupState : public EffectState {
             m_delay3->process(pInput, m_pHighBuf, numSamples);
         }
 
-        if (fMid != 0 || m_oldMid != 0) {
+        const bool processMid = fMid != 0 || m_oldMid != 0;
+        const bool processLow = fLow != 0 || m_oldLow != 0;
+        if (processMid) {
             m_delay2->process(pInput, m_pBandBuf, numSamples);
-            m_low2->process(m_pBandBuf, m_pBandBuf, numSamples);
         }
-
-        if (fLow != 0 || m_oldLow != 0) {
+        if (processMid && processLow) {
+            // Both low pass filters run in a single pass
+            m_low2->processTogetherWith(m_low1,
+                    m_pBandBuf,
+                    m_pBandBuf,
+                    pInput,
+                    m_pLowBuf,
+                    numSamples);
+        } else if (processMid) {
+            m_low2->process(m_pBandBuf, m_pBandBuf, numSamples);
+        } else if (processLow) {
             m_low1->process(pInput, m_pLowBuf, numSamples);
         }
 
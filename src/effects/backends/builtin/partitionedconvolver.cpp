@@ -0,0 +1,413 @@
+#include <dsp/transforms/FFT.h>
+
+// Class header comes after library includes here since our preprocessor
+// definitions interfere with qm-dsp's headers.
+#include "effects/backends/builtin/partitionedconvolver.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/counter.h"
+
+namespace {
+
+int numPartitionsFor(SINT length, int blockSize) {
+    return static_cast<int>((std::max<SINT>(length, 0) + blockSize - 1) / blockSize);
+}
+
+} // anonymous namespace
+
+ConvolutionSpectra::ConvolutionSpectra(
+        int blockSize, const CSAMPLE* pImpulseResponse, SINT length)
+        : blockSize(blockSize),
+          numPartitions(numPartitionsFor(length, blockSize)),
+          real(static_cast<std::size_t>(numPartitions) * numBins()),
+          imag(static_cast<std::size_t>(numPartitions) * numBins()) {
+    const int fftSize = 2 * blockSize;
+    FFTReal fft(fftSize);
+    std::vector<double> input(fftSize);
+    std::vector<double> fftReal(fftSize);
+    std::vector<double> fftImag(fftSize);
+    for (int partition = 0; partition < numPartitions; ++partition) {
+        const SINT offset = static_cast<SINT>(partition) * blockSize;
+        const SINT partitionLength = std::min<SINT>(blockSize, length - offset);
+        std::fill(input.begin(), input.end(), 0.0);
+        std::copy(pImpulseResponse + offset,
+                pImpulseResponse + offset + partitionLength,
+                input.begin());
+        fft.forward(input.data(), fftReal.data(), fftImag.data());
+        std::copy(fftReal.begin(),
+                fftReal.begin() + numBins(),
+                real.begin() + static_cast<std::size_t>(partition) * numBins());
+        std::copy(fftImag.begin(),
+                fftImag.begin() + numBins(),
+                imag.begin() + static_cast<std::size_t>(partition) * numBins());
+    }
+}
+
+UniformPartitionedConvolver::UniformPartitionedConvolver(int blockSize, int maxPartitions)
+        : m_blockSize(blockSize),
+          m_maxPartitions(maxPartitions),
+          m_pFft(std::make_unique<FFTReal>(2 * blockSize)),
+          m_pSpectra(nullptr),
+          m_delayLineReal(static_cast<std::size_t>(maxPartitions) * (blockSize + 1)),
+          m_delayLineImag(static_cast<std::size_t>(maxPartitions) * (blockSize + 1)),
+          m_currentBlock(0),
+          m_previousReal(blockSize + 1),
+          m_previousImag(blockSize + 1),
+          m_previousValid(false),
+          m_input(2 * blockSize),
+          m_inputFill(0),
+          m_fftReal(2 * blockSize),
+          m_fftImag(2 * blockSize),
+          m_sumReal(blockSize + 1),
+          m_sumImag(blockSize + 1),
+          m_output(2 * blockSize),
+          m_overlap(blockSize) {
+}
+
+// Out of line, FFTReal is incomplete in the header
+UniformPartitionedConvolver::~UniformPartitionedConvolver() = default;
+
+void UniformPartitionedConvolver::setImpulseResponse(const ConvolutionSpectra* pSpectra) {
+    VERIFY_OR_DEBUG_ASSERT(!pSpectra ||
+            (pSpectra->blockSize == m_blockSize &&
+                    pSpectra->numPartitions <= m_maxPartitions)) {
+        pSpectra = nullptr;
+    }
+    m_pSpectra = pSpectra;
+    reset();
+}
+
+void UniformPartitionedConvolver::reset() {
+    // Only the partitions in use need to be cleared
+    const std::size_t delayLineSize = m_pSpectra
+            ? static_cast<std::size_t>(m_pSpectra->numPartitions) * (m_blockSize + 1)
+            : 0;
+    std::fill(m_delayLineReal.begin(), m_delayLineReal.begin() + delayLineSize, 0.0);
+    std::fill(m_delayLineImag.begin(), m_delayLineImag.begin() + delayLineSize, 0.0);
+    m_currentBlock = 0;
+    m_previousValid = false;
+    std::fill(m_input.begin(), m_input.end(), 0.0);
+    m_inputFill = 0;
+    std::fill(m_overlap.begin(), m_overlap.end(), 0.0);
+}
+
+void UniformPartitionedConvolver::process(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames) {
+    if (!m_pSpectra || m_pSpectra->numPartitions == 0) {
+        std::fill(pOutput, pOutput + numFrames, CSAMPLE_ZERO);
+        return;
+    }
+    SINT frame = 0;
+    while (frame < numFrames) {
+        const int chunkFrames = static_cast<int>(
+                std::min<SINT>(numFrames - frame, m_blockSize - m_inputFill));
+        processWithinBlock(pInput + frame, pOutput + frame, chunkFrames);
+        frame += chunkFrames;
+    }
+}
+
+void UniformPartitionedConvolver::processWithinBlock(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, int numFrames) {
+    const int numBins = m_blockSize + 1;
+    const int numPartitions = m_pSpectra->numPartitions;
+
+    std::copy(pInput, pInput + numFrames, m_input.begin() + m_inputFill);
+
+    // The spectrum of the current, maybe incomplete block
+    m_pFft->forward(m_input.data(), m_fftReal.data(), m_fftImag.data());
+    double* pCurrentReal = &m_delayLineReal[static_cast<std::size_t>(m_currentBlock) * numBins];
+    double* pCurrentImag = &m_delayLineImag[static_cast<std::size_t>(m_currentBlock) * numBins];
+    std::copy(m_fftReal.begin(), m_fftReal.begin() + numBins, pCurrentReal);
+    std::copy(m_fftImag.begin(), m_fftImag.begin() + numBins, pCurrentImag);
+
+    if (!m_previousValid) {
+        multiplyPreviousBlocks();
+    }
+
+    const double* pIrReal = m_pSpectra->real.data();
+    const double* pIrImag = m_pSpectra->imag.data();
+    for (int bin = 0; bin < numBins; ++bin) {
+        m_sumReal[bin] = m_previousReal[bin] +
+                pCurrentReal[bin] * pIrReal[bin] - pCurrentImag[bin] * pIrImag[bin];
+        m_sumImag[bin] = m_previousImag[bin] +
+                pCurrentReal[bin] * pIrImag[bin] + pCurrentImag[bin] * pIrReal[bin];
+    }
+    m_pFft->inverse(m_sumReal.data(), m_sumImag.data(), m_output.data());
+
+    for (int i = 0; i < numFrames; ++i) {
+        pOutput[i] = static_cast<CSAMPLE>(
+                m_output[m_inputFill + i] + m_overlap[m_inputFill + i]);
+    }
+    m_inputFill += numFrames;
+
+    if (m_inputFill == m_blockSize) {
+        // The block is complete, its second half overlaps the next block
+        std::copy(m_output.begin() + m_blockSize, m_output.end(), m_overlap.begin());
+        std::fill(m_input.begin(), m_input.begin() + m_blockSize, 0.0);
+        m_inputFill = 0;
+        // The current block becomes the previous one
+        m_currentBlock = (m_currentBlock + numPartitions - 1) % numPartitions;
+        m_previousValid = false;
+    }
+}
+
+void UniformPartitionedConvolver::multiplyPreviousBlocks() {
+    const int numBins = m_blockSize + 1;
+    const int numPartitions = m_pSpectra->numPartitions;
+    std::fill(m_previousReal.begin(), m_previousReal.end(), 0.0);
+    std::fill(m_previousImag.begin(), m_previousImag.end(), 0.0);
+    for (int partition = 1; partition < numPartitions; ++partition) {
+        const int block = (m_currentBlock + partition) % numPartitions;
+        const double* pBlockReal = &m_delayLineReal[static_cast<std::size_t>(block) * numBins];
+        const double* pBlockImag = &m_delayLineImag[static_cast<std::size_t>(block) * numBins];
+        const double* pIrReal =
+                &m_pSpectra->real[static_cast<std::size_t>(partition) * numBins];
+        const double* pIrImag =
+                &m_pSpectra->imag[static_cast<std::size_t>(partition) * numBins];
+        for (int bin = 0; bin < numBins; ++bin) {
+            m_previousReal[bin] += pBlockReal[bin] * pIrReal[bin] - pBlockImag[bin] * pIrImag[bin];
+            m_previousImag[bin] += pBlockReal[bin] * pIrImag[bin] + pBlockImag[bin] * pIrReal[bin];
+        }
+    }
+    m_previousValid = true;
+}
+
+// static
+std::shared_ptr<ConvolutionTailWorker> ConvolutionTailWorker::instance() {
+    static QMutex s_mutex;
+    static std::weak_ptr<ConvolutionTailWorker> s_pInstance;
+    const auto locker = lockMutex(&s_mutex);
+    auto pInstance = s_pInstance.lock();
+    if (!pInstance) {
+        // The constructor is private
+        pInstance = std::shared_ptr<ConvolutionTailWorker>(new ConvolutionTailWorker());
+        pInstance->setObjectName(QStringLiteral("ConvolutionTailWorker"));
+        pInstance->start(QThread::HighPriority);
+        s_pInstance = pInstance;
+    }
+    return pInstance;
+}
+
+ConvolutionTailWorker::ConvolutionTailWorker()
+        : m_quit(false) {
+}
+
+ConvolutionTailWorker::~ConvolutionTailWorker() {
+    m_quit.store(true, std::memory_order_release);
+    m_semaphore.release();
+    wait();
+}
+
+void ConvolutionTailWorker::addConvolver(PartitionedConvolver* pConvolver) {
+    const auto locker = lockMutex(&m_mutex);
+    m_convolvers.push_back(pConvolver);
+}
+
+void ConvolutionTailWorker::removeConvolver(PartitionedConvolver* pConvolver) {
+    // Blocks while the worker is processing any tail
+    const auto locker = lockMutex(&m_mutex);
+    m_convolvers.erase(std::remove(m_convolvers.begin(), m_convolvers.end(), pConvolver),
+            m_convolvers.end());
+}
+
+void ConvolutionTailWorker::run() {
+    while (true) {
+        m_semaphore.acquire();
+        if (m_quit.load(std::memory_order_acquire)) {
+            return;
+        }
+        const auto locker = lockMutex(&m_mutex);
+        for (PartitionedConvolver* pConvolver : m_convolvers) {
+            if (pConvolver->m_jobPending.exchange(false, std::memory_order_acquire)) {
+                pConvolver->processTailBlock();
+                pConvolver->m_jobDone.store(true, std::memory_order_release);
+            }
+        }
+    }
+}
+
+PartitionedConvolver::ImpulseResponse::ImpulseResponse(
+        const CSAMPLE* pLeft, const CSAMPLE* pRight, SINT length)
+        : m_length(length) {
+    const CSAMPLE* channels[2] = {pLeft, pRight};
+    const SINT headLength = std::min(length, kHeadFrames);
+    const SINT tailLength = std::max<SINT>(length - kHeadFrames, 0);
+    for (int ch = 0; ch < 2; ++ch) {
+        m_head[ch] = std::make_unique<ConvolutionSpectra>(
+                kHeadBlockFrames, channels[ch], headLength);
+        m_tail[ch] = std::make_unique<ConvolutionSpectra>(
+                kTailBlockFrames, channels[ch] + headLength, tailLength);
+    }
+}
+
+PartitionedConvolver::PartitionedConvolver(SINT maxLength)
+        : m_maxLength(maxLength),
+          m_pImpulseResponse(nullptr),
+          m_pWorker(ConvolutionTailWorker::instance()),
+          m_collectingIndex(0),
+          m_playingIndex(0),
+          m_tailPlaying(false),
+          m_tailFill(0),
+          m_tailSubmitted(false),
+          m_pTailSpectra{nullptr, nullptr},
+          m_generation(0),
+          m_jobPending(false),
+          m_jobDone(true),
+          m_jobInputIndex(0),
+          m_jobOutputIndex(0),
+          m_jobGeneration(0),
+          m_pJobTailSpectra{nullptr, nullptr},
+          m_tailGeneration(0) {
+    const int maxHeadPartitions = numPartitionsFor(
+            std::min(maxLength, kHeadFrames), kHeadBlockFrames);
+    const int maxTailPartitions = numPartitionsFor(maxLength - kHeadFrames, kTailBlockFrames);
+    for (int ch = 0; ch < 2; ++ch) {
+        m_pHead[ch] = std::make_unique<UniformPartitionedConvolver>(
+                kHeadBlockFrames, maxHeadPartitions);
+        m_pTail[ch] = std::make_unique<UniformPartitionedConvolver>(
+                kTailBlockFrames, maxTailPartitions);
+        m_headInput[ch].resize(kHeadBlockFrames);
+        m_headOutput[ch].resize(kHeadBlockFrames);
+        for (int i = 0; i < 2; ++i) {
+            m_tailInput[i][ch].resize(kTailBlockFrames);
+            m_tailOutput[i][ch].resize(kTailBlockFrames);
+        }
+    }
+    m_pWorker->addConvolver(this);
+}
+
+PartitionedConvolver::~PartitionedConvolver() {
+    m_pWorker->removeConvolver(this);
+}
+
+void PartitionedConvolver::setImpulseResponse(const ImpulseResponse* pImpulseResponse) {
+    VERIFY_OR_DEBUG_ASSERT(!pImpulseResponse || pImpulseResponse->length() <= m_maxLength) {
+        pImpulseResponse = nullptr;
+    }
+    m_pImpulseResponse = pImpulseResponse;
+    for (int ch = 0; ch < 2; ++ch) {
+        m_pHead[ch]->setImpulseResponse(
+                pImpulseResponse ? pImpulseResponse->m_head[ch].get() : nullptr);
+        // The worker applies them with the next block
+        m_pTailSpectra[ch] = pImpulseResponse ? pImpulseResponse->m_tail[ch].get() : nullptr;
+    }
+    reset();
+}
+
+void PartitionedConvolver::reset() {
+    for (int ch = 0; ch < 2; ++ch) {
+        m_pHead[ch]->reset();
+    }
+    // The block that may be in flight is discarded. Its buffers are still
+    // in use by the worker, so the tail is muted instead of clearing them.
+    m_generation.fetch_add(1, std::memory_order_relaxed);
+    m_tailPlaying = false;
+    m_tailFill = 0;
+}
+
+void PartitionedConvolver::process(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames) {
+    if (!m_pImpulseResponse) {
+        std::fill(pOutput, pOutput + numFrames * 2, CSAMPLE_ZERO);
+        return;
+    }
+    SINT frame = 0;
+    while (frame < numFrames) {
+        // Chunks neither cross a head nor a tail block boundary
+        const int chunkFrames = static_cast<int>(std::min<SINT>(
+                {numFrames - frame,
+                        kHeadBlockFrames - m_tailFill % kHeadBlockFrames,
+                        kTailBlockFrames - m_tailFill}));
+        processWithinTailBlock(pInput + frame * 2, pOutput + frame * 2, chunkFrames);
+        frame += chunkFrames;
+    }
+}
+
+void PartitionedConvolver::processWithinTailBlock(
+        const CSAMPLE* pInput, CSAMPLE* pOutput, int numFrames) {
+    for (int i = 0; i < numFrames; ++i) {
+        m_headInput[0][i] = pInput[i * 2];
+        m_headInput[1][i] = pInput[i * 2 + 1];
+    }
+    for (int ch = 0; ch < 2; ++ch) {
+        m_pHead[ch]->process(m_headInput[ch].data(), m_headOutput[ch].data(), numFrames);
+        std::copy(m_headInput[ch].begin(),
+                m_headInput[ch].begin() + numFrames,
+                m_tailInput[m_collectingIndex][ch].begin() + m_tailFill);
+    }
+
+    if (m_tailPlaying) {
+        const CSAMPLE* pTailLeft = &m_tailOutput[m_playingIndex][0][m_tailFill];
+        const CSAMPLE* pTailRight = &m_tailOutput[m_playingIndex][1][m_tailFill];
+        for (int i = 0; i < numFrames; ++i) {
+            pOutput[i * 2] = m_headOutput[0][i] + pTailLeft[i];
+            pOutput[i * 2 + 1] = m_headOutput[1][i] + pTailRight[i];
+        }
+    } else {
+        for (int i = 0; i < numFrames; ++i) {
+            pOutput[i * 2] = m_headOutput[0][i];
+            pOutput[i * 2 + 1] = m_headOutput[1][i];
+        }
+    }
+
+    m_tailFill += numFrames;
+    if (m_tailFill == kTailBlockFrames) {
+        submitTailBlock();
+        m_tailFill = 0;
+    }
+}
+
+void PartitionedConvolver::submitTailBlock() {
+    const int generation = m_generation.load(std::memory_order_relaxed);
+    if (m_tailSubmitted) {
+        if (!m_jobDone.load(std::memory_order_acquire)) {
+            // Never wait for the worker in the engine thread. The input
+            // buffer is not in use by the worker and is collected again.
+            Counter(QStringLiteral("PartitionedConvolver::submitTailBlock late")).increment();
+            m_tailPlaying = false;
+            return;
+        }
+        m_tailSubmitted = false;
+        // The result of the previous block is played during the next one.
+        // This delays the tail by two blocks, which is the length of the
+        // head.
+        m_tailPlaying = m_jobGeneration == generation;
+        if (m_tailPlaying) {
+            m_playingIndex = m_jobOutputIndex;
+        }
+    } else {
+        // The silence of the playing buffer is played
+        m_tailPlaying = false;
+    }
+    m_jobInputIndex = m_collectingIndex;
+    m_jobOutputIndex = 1 - m_playingIndex;
+    m_jobGeneration = generation;
+    for (int ch = 0; ch < 2; ++ch) {
+        m_pJobTailSpectra[ch] = m_pTailSpectra[ch];
+    }
+    m_collectingIndex = 1 - m_collectingIndex;
+    m_jobDone.store(false, std::memory_order_relaxed);
+    m_jobPending.store(true, std::memory_order_release);
+    m_tailSubmitted = true;
+    m_pWorker->wake();
+}
+
+void PartitionedConvolver::processTailBlock() {
+    if (m_jobGeneration != m_generation.load(std::memory_order_relaxed)) {
+        // The convolver has been reset since the block was submitted
+        return;
+    }
+    if (m_jobGeneration != m_tailGeneration) {
+        for (int ch = 0; ch < 2; ++ch) {
+            m_pTail[ch]->setImpulseResponse(m_pJobTailSpectra[ch]);
+        }
+        m_tailGeneration = m_jobGeneration;
+    }
+    for (int ch = 0; ch < 2; ++ch) {
+        m_pTail[ch]->process(m_tailInput[m_jobInputIndex][ch].data(),
+                m_tailOutput[m_jobOutputIndex][ch].data(),
+                kTailBlockFrames);
+    }
+}
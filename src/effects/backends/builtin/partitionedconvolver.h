@@ -0,0 +1,235 @@
+#pragma once
+
+#include <QMutex>
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "util/types.h"
+
+class FFTReal;
+
+/// The spectra of the equally sized partitions of an impulse response
+/// of a single channel, as used by UniformPartitionedConvolver.
+///
+/// Each partition of blockSize frames is zero padded to an FFT size of
+/// 2 * blockSize, of which blockSize + 1 bins are stored.
+struct ConvolutionSpectra {
+    ConvolutionSpectra(int blockSize, const CSAMPLE* pImpulseResponse, SINT length);
+
+    int numBins() const {
+        return blockSize + 1;
+    }
+
+    int blockSize;
+    int numPartitions;
+    std::vector<double> real;
+    std::vector<double> imag;
+};
+
+/// A zero latency, uniformly partitioned FFT convolution of a single
+/// channel (overlap-add with a frequency domain delay line).
+///
+/// Calls of any size are supported. If a call ends within a block, the
+/// FFT of the incomplete block is calculated again by the next call, but
+/// the partitions of the previous blocks are only summed up once.
+///
+/// All buffers are allocated by the constructor, process() and reset()
+/// don't allocate.
+class UniformPartitionedConvolver {
+  public:
+    UniformPartitionedConvolver(int blockSize, int maxPartitions);
+    ~UniformPartitionedConvolver();
+
+    UniformPartitionedConvolver(const UniformPartitionedConvolver&) = delete;
+    UniformPartitionedConvolver& operator=(const UniformPartitionedConvolver&) = delete;
+
+    int blockSize() const {
+        return m_blockSize;
+    }
+
+    /// Switches to another impulse response and clears the state. The
+    /// spectra must have the same block size and must outlive their use.
+    /// Null mutes the output.
+    void setImpulseResponse(const ConvolutionSpectra* pSpectra);
+
+    void reset();
+
+    /// Writes the convolution of numFrames input frames to pOutput.
+    void process(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames);
+
+  private:
+    void processWithinBlock(const CSAMPLE* pInput, CSAMPLE* pOutput, int numFrames);
+    void multiplyPreviousBlocks();
+
+    const int m_blockSize;
+    const int m_maxPartitions;
+    const std::unique_ptr<FFTReal> m_pFft;
+    const ConvolutionSpectra* m_pSpectra;
+
+    // The spectra of the most recent input blocks, starting at
+    // m_currentBlock with the most recent block
+    std::vector<double> m_delayLineReal;
+    std::vector<double> m_delayLineImag;
+    int m_currentBlock;
+
+    // The sum of the products of all but the most recent block
+    std::vector<double> m_previousReal;
+    std::vector<double> m_previousImag;
+    bool m_previousValid;
+
+    // The current block, zero padded to the FFT size
+    std::vector<double> m_input;
+    int m_inputFill;
+
+    std::vector<double> m_fftReal;
+    std::vector<double> m_fftImag;
+    std::vector<double> m_sumReal;
+    std::vector<double> m_sumImag;
+    std::vector<double> m_output;
+    std::vector<double> m_overlap;
+};
+
+class PartitionedConvolver;
+
+/// The thread that convolves the tails of all PartitionedConvolvers.
+/// It is shared by all convolvers and stops when the last one is gone.
+class ConvolutionTailWorker : public QThread {
+  public:
+    static std::shared_ptr<ConvolutionTailWorker> instance();
+
+    ~ConvolutionTailWorker() override;
+
+    void addConvolver(PartitionedConvolver* pConvolver);
+    void removeConvolver(PartitionedConvolver* pConvolver);
+
+    /// Called from the engine thread after a job has been submitted
+    void wake() {
+        m_semaphore.release();
+    }
+
+  protected:
+    void run() override;
+
+  private:
+    ConvolutionTailWorker();
+
+    QMutex m_mutex;
+    std::vector<PartitionedConvolver*> m_convolvers;
+    QSemaphore m_semaphore;
+    std::atomic<bool> m_quit;
+};
+
+/// A non-uniformly partitioned, zero latency convolution of a stereo
+/// signal with long impulse responses.
+///
+/// The first 2 * kTailBlockFrames of the impulse response are convolved
+/// in the engine thread with small partitions of kHeadBlockFrames. The
+/// rest is convolved with large partitions of kTailBlockFrames by the
+/// ConvolutionTailWorker. A tail block is submitted to the worker when
+/// its input is complete, and its result is not played before one more
+/// block has passed, so the worker has the time of a whole block to
+/// finish it.
+///
+/// The engine thread never waits for the worker. If it is late, the tail
+/// of the next block is muted and the input of the current block is
+/// dropped. Blocks that have been submitted before reset() are discarded
+/// by a generation count, both by the worker and by the engine thread.
+class PartitionedConvolver {
+  public:
+    static constexpr int kHeadBlockFrames = 256;
+    static constexpr int kTailBlockFrames = 4096;
+    static constexpr SINT kHeadFrames = 2 * kTailBlockFrames;
+
+    /// The partitions of a stereo impulse response. Immutable and shared
+    /// by all convolvers that use it.
+    class ImpulseResponse {
+      public:
+        /// Takes the deinterleaved channels of the impulse response
+        ImpulseResponse(const CSAMPLE* pLeft, const CSAMPLE* pRight, SINT length);
+
+        SINT length() const {
+            return m_length;
+        }
+
+      private:
+        friend class PartitionedConvolver;
+
+        SINT m_length;
+        std::unique_ptr<ConvolutionSpectra> m_head[2];
+        std::unique_ptr<ConvolutionSpectra> m_tail[2];
+    };
+
+    /// Allocates the buffers for impulse responses up to maxLength frames
+    explicit PartitionedConvolver(SINT maxLength);
+    ~PartitionedConvolver();
+
+    PartitionedConvolver(const PartitionedConvolver&) = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    /// Switches to another impulse response and clears the state. Must
+    /// not be longer than the maximum length, null mutes the output. The
+    /// impulse response must outlive its use.
+    void setImpulseResponse(const ImpulseResponse* pImpulseResponse);
+
+    /// Clears the state, i.e. the reverberation of the previous input
+    void reset();
+
+    /// Writes the convolution of interleaved stereo frames to pOutput.
+    /// Does neither allocate nor lock.
+    void process(const CSAMPLE* pInput, CSAMPLE* pOutput, SINT numFrames);
+
+    /// Whether the worker has finished the last submitted tail block. The
+    /// result is exact if this is true whenever a tail block is submitted.
+    bool isTailBlockDone() const {
+        return !m_tailSubmitted || m_jobDone.load(std::memory_order_acquire);
+    }
+
+  private:
+    friend class ConvolutionTailWorker;
+
+    void processWithinTailBlock(const CSAMPLE* pInput, CSAMPLE* pOutput, int numFrames);
+    void submitTailBlock();
+    /// Called by the ConvolutionTailWorker
+    void processTailBlock();
+
+    const SINT m_maxLength;
+    const ImpulseResponse* m_pImpulseResponse;
+    std::shared_ptr<ConvolutionTailWorker> m_pWorker;
+
+    std::unique_ptr<UniformPartitionedConvolver> m_pHead[2];
+    std::unique_ptr<UniformPartitionedConvolver> m_pTail[2];
+
+    // Deinterleaved input and output of the head
+    std::vector<CSAMPLE> m_headInput[2];
+    std::vector<CSAMPLE> m_headOutput[2];
+
+    // The tail input is collected in one pair of buffers, while the
+    // worker processes the other one. The same applies to the output,
+    // which is played while the worker writes the next one.
+    std::vector<CSAMPLE> m_tailInput[2][2];
+    std::vector<CSAMPLE> m_tailOutput[2][2];
+    int m_collectingIndex;
+    int m_playingIndex;
+    // Whether m_playingIndex contains the tail of the current block,
+    // otherwise the tail is silent
+    bool m_tailPlaying;
+    int m_tailFill;
+    bool m_tailSubmitted;
+    const ConvolutionSpectra* m_pTailSpectra[2];
+    // Incremented by reset(), read by the worker to skip outdated blocks
+    std::atomic<int> m_generation;
+
+    // Handshake with the worker
+    std::atomic<bool> m_jobPending;
+    std::atomic<bool> m_jobDone;
+    // Read by the worker, only written while no job is in flight
+    int m_jobInputIndex;
+    int m_jobOutputIndex;
+    int m_jobGeneration;
+    const ConvolutionSpectra* m_pJobTailSpectra[2];
+    // Only accessed by the worker
+    int m_tailGeneration;
+};
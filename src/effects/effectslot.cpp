@@ -155,7 +155,7 @@ void EffectSlot::addToEngine() {
             m_pEffectsManager->registeredInputChannels(),
             m_pEffectsManager->registeredOutputChannels());
 
-    EffectsRequest* request = new EffectsRequest();
+    EffectsRequest* request = m_pMessenger->createRequest();
     request->type = EffectsRequest::ADD_EFFECT_TO_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
     request->AddEffectToChain.pEffect = m_pEngineEffect;
@@ -168,7 +168,7 @@ void EffectSlot::removeFromEngine() {
         return;
     }
 
-    EffectsRequest* request = new EffectsRequest();
+    EffectsRequest* request = m_pMessenger->createRequest();
     request->type = EffectsRequest::REMOVE_EFFECT_FROM_CHAIN;
     request->pTargetChain = m_pEngineEffectChain;
     request->RemoveEffectFromChain.pEffect = m_pEngineEffect;
@@ -183,17 +183,16 @@ void EffectSlot::updateEngineState() {
         return;
     }
 
-    EffectsRequest* pRequest = new EffectsRequest();
-    pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
-    pRequest->pTargetEffect = m_pEngineEffect;
-    pRequest->SetEffectParameters.enabled = m_pControlEnabled->toBool();
-    m_pMessenger->writeRequest(pRequest);
-
+    // Stage all parameter values and send them together with the enable
+    // state in a single request.
+    m_pMessenger->beginParameterBatch(m_pEngineEffect);
     for (const auto& parameterList : std::as_const(m_allParameters)) {
         for (auto const& pParameter : parameterList) {
             pParameter->updateEngineState();
         }
     }
+    m_pMessenger->endParameterBatch();
+    m_pMessenger->writeEffectParameters(m_pEngineEffect, m_pControlEnabled->toBool());
 }
 
 void EffectSlot::initalizeInputChannel(ChannelHandle inputChannel) {
@@ -292,6 +291,8 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
 
     m_pManifest = pManifest;
     addToEngine();
+    // The initial parameter values are sent by updateEngineState() below
+    m_pMessenger->beginParameterBatch(m_pEngineEffect);
 
     // Create EffectParameters. Every parameter listed in the manifest must have
     // an EffectParameter created, regardless of whether it is loaded in a slot.
@@ -364,6 +365,8 @@ void EffectSlot::loadEffectInner(const EffectManifestPointer pManifest,
     // ControlObjects are 1-indexed
     m_pControlLoadedEffect->setAndConfirm(m_pVisibleEffects->indexOf(pManifest) + 1);
 
+    m_pMessenger->endParameterBatch();
+
     emit effectChanged();
     updateEngineState();
 }
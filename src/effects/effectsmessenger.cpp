@@ -2,19 +2,48 @@
 
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "util/counter.h"
 #include "util/make_const_iterator.h"
 
+namespace {
+
+// Enough to absorb the requests of loading a whole chain preset
+constexpr int kMaxFreeRequests = 256;
+
+} // anonymous namespace
+
 EffectsMessenger::EffectsMessenger(
         EffectsRequestPipe&& requestPipe)
         : m_requestPipe(std::move(requestPipe)),
           m_nextRequestId(0),
-          m_bShuttingDown(false) {
+          m_bShuttingDown(false),
+          m_pBatchEffect(nullptr) {
+    m_freeRequests.reserve(kMaxFreeRequests);
 }
 
 EffectsMessenger::~EffectsMessenger() {
     for (auto it = m_activeRequests.begin(); it != m_activeRequests.end(); it++) {
         delete it.value();
     }
+    qDeleteAll(m_freeRequests);
+}
+
+EffectsRequest* EffectsMessenger::createRequest() {
+    if (m_freeRequests.isEmpty()) {
+        return new EffectsRequest();
+    }
+    EffectsRequest* pRequest = m_freeRequests.takeLast();
+    *pRequest = EffectsRequest();
+    return pRequest;
+}
+
+void EffectsMessenger::recycleRequest(EffectsRequest* pRequest) {
+    if (m_freeRequests.size() < kMaxFreeRequests) {
+        m_freeRequests.append(pRequest);
+    } else {
+        delete pRequest;
+    }
 }
 
 void EffectsMessenger::initiateShutdown() {
@@ -33,15 +62,65 @@ bool EffectsMessenger::writeRequest(EffectsRequest* request) {
     processEffectsResponses();
 
     request->request_id = m_nextRequestId++;
-    // TODO(XXX) use preallocated requests to avoid delete calls from engine
     if (m_requestPipe.writeMessage(request)) {
         m_activeRequests[request->request_id] = request;
+        // The number of requests that have not been answered by the engine
+        Counter(QStringLiteral("EffectsMessenger::writeRequest queue depth"))
+                .increment(static_cast<int>(m_activeRequests.size()));
         return true;
     }
-    delete request;
+    qWarning() << debugString() << "WARNING: Request pipe is full, dropping request";
+    Counter(QStringLiteral("EffectsMessenger::writeRequest dropped")).increment();
+    recycleRequest(request);
     return false;
 }
 
+bool EffectsMessenger::writeParameterValue(
+        EngineEffect* pEffect, int iParameter, double value) {
+    EngineEffectParameter* pParameter = pEffect->parameter(iParameter);
+    VERIFY_OR_DEBUG_ASSERT(pParameter) {
+        return false;
+    }
+    if (!pParameter->setPendingValue(value) || pEffect == m_pBatchEffect) {
+        // The engine picks up the new value with the pending request
+        Counter(QStringLiteral("EffectsMessenger::writeParameterValue coalesced")).increment();
+        return true;
+    }
+
+    EffectsRequest* pRequest = createRequest();
+    pRequest->type = EffectsRequest::SET_PARAMETER_PARAMETERS;
+    pRequest->pTargetEffect = pEffect;
+    pRequest->SetParameterParameters.iParameter = iParameter;
+    if (!writeRequest(pRequest)) {
+        // Allow the next update to send a request again
+        pParameter->cancelPendingValue();
+        return false;
+    }
+    return true;
+}
+
+bool EffectsMessenger::writeEffectParameters(EngineEffect* pEffect, bool enabled) {
+    DEBUG_ASSERT(pEffect != m_pBatchEffect);
+    EffectsRequest* pRequest = createRequest();
+    pRequest->type = EffectsRequest::SET_EFFECT_PARAMETERS;
+    pRequest->pTargetEffect = pEffect;
+    pRequest->SetEffectParameters.enabled = enabled;
+    if (!writeRequest(pRequest)) {
+        pEffect->cancelPendingParameterValues();
+        return false;
+    }
+    return true;
+}
+
+void EffectsMessenger::beginParameterBatch(EngineEffect* pEffect) {
+    DEBUG_ASSERT(!m_pBatchEffect);
+    m_pBatchEffect = pEffect;
+}
+
+void EffectsMessenger::endParameterBatch() {
+    m_pBatchEffect = nullptr;
+}
+
 void EffectsMessenger::processEffectsResponses() {
     EffectsResponse response;
     while (m_requestPipe.readMessage(&response)) {
@@ -63,7 +142,7 @@ void EffectsMessenger::processEffectsResponses() {
 
             collectGarbage(pRequest);
 
-            delete pRequest;
+            recycleRequest(pRequest);
             it = constErase(&m_activeRequests, it);
         }
     }
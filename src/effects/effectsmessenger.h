@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QVector>
+
 #include "engine/effects/message.h"
 
 /// EffectsMessenger sends EffectsRequests from the main thread and receives
@@ -12,27 +14,53 @@
 /// for background information and
 /// https://github.com/mixxxdj/mixxx/pull/180#issuecomment-37435684
 /// for why this design is used for effects rather than alternatives.
+///
+/// Parameter values are not sent as part of a request. They are staged in
+/// the EngineEffectParameter and a request is only sent if no update of the
+/// parameter is pending already, so sweeping a knob results in at most one
+/// request per parameter and engine callback.
 class EffectsMessenger {
   public:
     // passing by rvalue-ref because we want to ensure we're the only on with access to that pipe
     EffectsMessenger(EffectsRequestPipe&& requestPipe);
     ~EffectsMessenger();
+
+    /// Returns an initialized EffectsRequest that is passed to writeRequest().
+    /// Requests are recycled once their response has been received.
+    EffectsRequest* createRequest();
+
     /// Write an EffectsRequest to the EngineEffectsManager. EffectsMessenger takes
-    /// ownership of request and deletes it once a response is received.
+    /// ownership of request and recycles it once a response is received.
     bool writeRequest(EffectsRequest* request);
 
+    /// Stages the value of a parameter of pEffect and notifies the engine
+    /// unless an update of the parameter is pending already.
+    bool writeParameterValue(EngineEffect* pEffect, int iParameter, double value);
+
+    /// Sends the enable state of pEffect, which also applies all staged
+    /// parameter values of the effect in the same callback.
+    bool writeEffectParameters(EngineEffect* pEffect, bool enabled);
+
+    /// While a batch is open, parameter values of pEffect are only staged
+    /// until writeEffectParameters() sends all of them in a single request.
+    void beginParameterBatch(EngineEffect* pEffect);
+    void endParameterBatch();
+
     void initiateShutdown();
     void processEffectsResponses();
 
   private:
     void collectGarbage(const EffectsRequest* pRequest);
+    void recycleRequest(EffectsRequest* pRequest);
 
     QString debugString() const {
         return "EffectsMessenger";
     }
 
     QHash<qint64, EffectsRequest*> m_activeRequests;
+    QVector<EffectsRequest*> m_freeRequests;
     EffectsRequestPipe m_requestPipe;
     qint64 m_nextRequestId;
     bool m_bShuttingDown;
+    EngineEffect* m_pBatchEffect;
 };
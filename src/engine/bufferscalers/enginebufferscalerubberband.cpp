@@ -2,7 +2,9 @@
 
 #include <QFile>
 #include <QtDebug>
+#include <algorithm>
 
+#include "engine/bufferscalers/rubberbandprerenderworker.h"
 #include "engine/readaheadmanager.h"
 #include "moc_enginebufferscalerubberband.cpp"
 #include "util/counter.h"
@@ -17,25 +19,77 @@ using RubberBand::RubberBandStretcher;
 #define RUBBERBANDV3 (RUBBERBAND_API_MAJOR_VERSION >= 3 || \
         (RUBBERBAND_API_MAJOR_VERSION == 2 && RUBBERBAND_API_MINOR_VERSION >= 7))
 
+namespace {
+
+// The number of callbacks with unchanged parameters after which the
+// stretched audio is rendered ahead in the background.
+constexpr int kMinStableCallbacksForPrerendering = 8;
+
+// The number of stretched frames that are kept ahead of the playhead,
+// ~43 ms at 48 kHz. This is also the latency for loop changes that
+// don't cause a seek.
+constexpr SINT kPrerenderFrames = 2048;
+
+// Limits the input for a single background process() call. Large blocks
+// would cause RubberBand to grow its output buffers.
+constexpr SINT kMaxPrerenderInputFrames = 2048;
+
+} // anonymous namespace
+
 EngineBufferScaleRubberBand::EngineBufferScaleRubberBand(
         ReadAheadManager* pReadAheadManager)
         : m_pReadAheadManager(pReadAheadManager),
+          m_pRubberBand(&m_rubberBands[0]),
+          m_pStandbyRubberBand(nullptr),
           m_buffers(),
           m_bufferPtrs(),
           m_interleavedReadBuffer(MAX_BUFFER_LEN),
           m_bBackwards(false),
-          m_useEngineFiner(false) {
+          m_useEngineFiner(false),
+          m_stableCallbacks(0),
+          m_setupPending(false),
+          m_standbySetupPending(false),
+          m_resetPending(false),
+          m_parametersPending(false),
+          m_requestedPitchScale(-1.0),
+          m_requestedTimeRatioInverse(-1.0),
+          m_appliedTempoRatio(0.0) {
     // Initialize the internal buffers to prevent re-allocations
     // in the real-time thread.
     onSignalChanged();
 }
 
+EngineBufferScaleRubberBand::~EngineBufferScaleRubberBand() {
+    if (m_pPrerenderWorker) {
+        m_pPrerenderWorker->quitWait();
+    }
+}
+
+void EngineBufferScaleRubberBand::enablePrerendering(
+        EngineWorkerScheduler* pWorkerScheduler) {
+    VERIFY_OR_DEBUG_ASSERT(!m_pPrerenderWorker) {
+        return;
+    }
+    m_pPrerenderWorker = std::make_unique<RubberBandPrerenderWorker>();
+    m_pStandbyRubberBand = &m_rubberBands[1];
+    if (getOutputSignal().isValid()) {
+        m_pPrerenderWorker->setChannelCount(getOutputSignal().getChannelCount());
+        setupRubberBand(m_pStandbyRubberBand);
+    }
+    m_pPrerenderWorker->setScheduler(pWorkerScheduler);
+    m_pPrerenderWorker->start(QThread::HighPriority);
+}
+
 void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
                                                      double* pTempoRatio,
                                                      double* pPitchRatio) {
     // Negative speed means we are going backwards. pitch does not affect
     // the playback direction.
-    m_bBackwards = *pTempoRatio < 0;
+    const bool backwards = *pTempoRatio < 0;
+    if (backwards != m_bBackwards) {
+        m_stableCallbacks = 0;
+    }
+    m_bBackwards = backwards;
 
     // Due to a bug in RubberBand, setting the timeRatio to a large value can
     // cause division-by-zero SIGFPEs. We limit the minimum seek speed to
@@ -53,45 +107,79 @@ void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
             speed_abs = *pTempoRatio = 0;
         }
     }
-    // RubberBand handles checking for whether the change in pitchScale is a
-    // no-op.
     double pitchScale = fabs(base_rate * *pPitchRatio);
+    // Time ratio is the ratio of stretched to unstretched duration. So 1
+    // second in real duration is 0.5 seconds in stretched duration if tempo is
+    // 2.
+    double timeRatioInverse = base_rate * speed_abs;
+
+    if (pitchScale == m_requestedPitchScale &&
+            timeRatioInverse == m_requestedTimeRatioInverse) {
+        // RubberBand must not be modified while prerendering. Only restore
+        // the adjustments of the workaround in applyScaleParameters().
+        if (speed_abs != m_appliedTempoRatio) {
+            speed_abs = m_appliedTempoRatio;
+            *pTempoRatio = m_bBackwards ? -speed_abs : speed_abs;
+        }
+        m_dBaseRate = base_rate;
+        m_dTempoRatio = speed_abs;
+        m_dPitchRatio = *pPitchRatio;
+        return;
+    }
+
+    m_stableCallbacks = 0;
+    m_requestedPitchScale = pitchScale;
+    m_requestedTimeRatioInverse = timeRatioInverse;
+    m_appliedTempoRatio = speed_abs;
+    // Used by other methods so we need to keep them up to date.
+    m_dBaseRate = base_rate;
+    m_dTempoRatio = speed_abs;
+    m_dPitchRatio = *pPitchRatio;
+
+    if (isWorkerBusy() || m_setupPending) {
+        // Applied by scaleBuffer() after the worker has finished
+        m_parametersPending = true;
+        return;
+    }
+    applyScaleParameters();
+    if (m_appliedTempoRatio != speed_abs) {
+        // Let the caller know we adjusted their speed.
+        *pTempoRatio = m_bBackwards ? -m_appliedTempoRatio : m_appliedTempoRatio;
+    }
+}
+
+void EngineBufferScaleRubberBand::applyScaleParameters() {
+    DEBUG_ASSERT(!isWorkerBusy());
+    m_parametersPending = false;
+    const double pitchScale = m_requestedPitchScale;
+    double timeRatioInverse = m_requestedTimeRatioInverse;
 
     if (pitchScale > 0) {
         //qDebug() << "EngineBufferScaleRubberBand setPitchScale" << *pitch << pitchScale;
-        m_rubberBand.setPitchScale(pitchScale);
+        m_pRubberBand->setPitchScale(pitchScale);
     }
 
-    // RubberBand handles checking for whether the change in timeRatio is a
-    // no-op. Time ratio is the ratio of stretched to unstretched duration. So 1
-    // second in real duration is 0.5 seconds in stretched duration if tempo is
-    // 2.
-    double timeRatioInverse = base_rate * speed_abs;
     if (timeRatioInverse > 0) {
         //qDebug() << "EngineBufferScaleRubberBand setTimeRatio" << 1 / timeRatioInverse;
-        m_rubberBand.setTimeRatio(1.0 / timeRatioInverse);
+        m_pRubberBand->setTimeRatio(1.0 / timeRatioInverse);
     }
 
     if (runningEngineVersion() == 2) {
-        if (m_rubberBand.getInputIncrement() == 0) {
+        if (m_pRubberBand->getInputIncrement() == 0) {
             qWarning() << "EngineBufferScaleRubberBand inputIncrement is 0."
                        << "On RubberBand <=1.8.1 a SIGFPE is imminent despite"
                        << "our workaround. Taking evasive action."
                        << "Please file an issue on https://github.com/mixxxdj/mixxx/issues";
 
             // This is much slower than the minimum seek speed workaround above.
-            while (m_rubberBand.getInputIncrement() == 0) {
+            while (m_pRubberBand->getInputIncrement() == 0) {
                 timeRatioInverse += 0.001;
-                m_rubberBand.setTimeRatio(1.0 / timeRatioInverse);
+                m_pRubberBand->setTimeRatio(1.0 / timeRatioInverse);
             }
-            speed_abs = timeRatioInverse / base_rate;
-            *pTempoRatio = m_bBackwards ? -speed_abs : speed_abs;
+            m_appliedTempoRatio = timeRatioInverse / m_dBaseRate;
+            m_dTempoRatio = m_appliedTempoRatio;
         }
     }
-    // Used by other methods so we need to keep them up to date.
-    m_dBaseRate = base_rate;
-    m_dTempoRatio = speed_abs;
-    m_dPitchRatio = *pPitchRatio;
 }
 
 void EngineBufferScaleRubberBand::onSignalChanged() {
@@ -101,6 +189,22 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
     if (!getOutputSignal().isValid()) {
         return;
     }
+    // Parameters need to be passed to the new instance
+    m_requestedPitchScale = -1.0;
+    m_requestedTimeRatioInverse = -1.0;
+    m_parametersPending = false;
+    m_stableCallbacks = 0;
+    if (isWorkerBusy()) {
+        // Set up by scaleBuffer() after the worker has finished
+        m_setupPending = true;
+        return;
+    }
+    setup();
+}
+
+void EngineBufferScaleRubberBand::setup() {
+    DEBUG_ASSERT(!isWorkerBusy());
+    m_setupPending = false;
 
     uint8_t channelCount = getOutputSignal().getChannelCount();
     if (m_buffers.size() != channelCount) {
@@ -111,7 +215,10 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
         m_bufferPtrs.resize(channelCount);
     }
 
-    m_rubberBand.clear();
+    // Otherwise allocated by prerender() after the worker has finished
+    if (m_pPrerenderWorker && !m_pPrerenderWorker->isBusy()) {
+        m_pPrerenderWorker->setChannelCount(channelCount);
+    }
 
     for (int chIdx = 0; chIdx < channelCount; chIdx++) {
         if (m_buffers[chIdx].size() == MAX_BUFFER_LEN) {
@@ -121,6 +228,20 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
         m_bufferPtrs[chIdx] = m_buffers[chIdx].data();
     }
 
+    setupRubberBand(m_pRubberBand);
+    if (m_pStandbyRubberBand) {
+        // The standby stretcher may still be processed by the worker
+        // after it has been replaced by switchToStandbyRubberBand()
+        m_standbySetupPending = m_pPrerenderWorker->isProcessing(m_pStandbyRubberBand);
+        if (!m_standbySetupPending) {
+            setupRubberBand(m_pStandbyRubberBand);
+        }
+    }
+}
+
+void EngineBufferScaleRubberBand::setupRubberBand(RubberBandWrapper* pRubberBand) {
+    pRubberBand->clear();
+
     RubberBandStretcher::Options rubberbandOptions =
             RubberBandStretcher::OptionProcessRealTime;
 #if RUBBERBANDV3
@@ -133,19 +254,25 @@ void EngineBufferScaleRubberBand::onSignalChanged() {
     }
 #endif
 
-    m_rubberBand.setup(
+    pRubberBand->setup(
             getOutputSignal().getSampleRate(),
             getOutputSignal().getChannelCount(),
             rubberbandOptions);
     // Setting the time ratio to a very high value will cause RubberBand
     // to preallocate buffers large enough to (almost certainly)
     // avoid memory reallocations during playback.
-    m_rubberBand.setTimeRatio(2.0);
-    m_rubberBand.setTimeRatio(1.0);
+    pRubberBand->setTimeRatio(2.0);
+    pRubberBand->setTimeRatio(1.0);
 }
 
 void EngineBufferScaleRubberBand::clear() {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(m_pRubberBand->isValid()) {
+        return;
+    }
+    m_stableCallbacks = 0;
+    if (isWorkerBusy() || m_setupPending) {
+        // Reset by scaleBuffer() after the worker has finished
+        m_resetPending = true;
         return;
     }
     reset();
@@ -154,7 +281,7 @@ void EngineBufferScaleRubberBand::clear() {
 SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
         CSAMPLE* pBuffer,
         SINT frames) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(m_pRubberBand->isValid()) {
         return 0;
     }
     // NOTE: If we still need to throw away padding, then we can also
@@ -163,7 +290,7 @@ SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
     SINT received_frames;
     {
         ScopedTimer t(QStringLiteral("RubberBand::retrieve"));
-        received_frames = static_cast<SINT>(m_rubberBand.retrieve(
+        received_frames = static_cast<SINT>(m_pRubberBand->retrieve(
                 m_bufferPtrs.data(), frames + m_remainingPaddingInOutput, m_buffers[0].size()));
     }
     SINT frame_offset = 0;
@@ -224,69 +351,164 @@ SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
     return received_frames;
 }
 
-void EngineBufferScaleRubberBand::deinterleaveAndProcess(
-        const CSAMPLE* pBuffer,
+void EngineBufferScaleRubberBand::deinterleave(
+        float* const* pDest,
+        const CSAMPLE* pSrc,
         SINT frames) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
-        return;
-    }
-    DEBUG_ASSERT(frames <= static_cast<SINT>(m_buffers[0].size()));
-
     switch (getOutputSignal().getChannelCount()) {
     case mixxx::audio::ChannelCount::stereo():
         SampleUtil::deinterleaveBuffer(
-                m_buffers[0].data(),
-                m_buffers[1].data(),
-                pBuffer,
+                pDest[0],
+                pDest[1],
+                pSrc,
                 frames);
         break;
     case mixxx::audio::ChannelCount::stem():
         SampleUtil::deinterleaveBuffer(
-                m_buffers[0].data(),
-                m_buffers[1].data(),
-                m_buffers[2].data(),
-                m_buffers[3].data(),
-                m_buffers[4].data(),
-                m_buffers[5].data(),
-                m_buffers[6].data(),
-                m_buffers[7].data(),
-                pBuffer,
+                pDest[0],
+                pDest[1],
+                pDest[2],
+                pDest[3],
+                pDest[4],
+                pDest[5],
+                pDest[6],
+                pDest[7],
+                pSrc,
                 frames);
         break;
     default: {
         int chCount = getOutputSignal().getChannelCount();
-        // The sampler are ordered as following in pBuffer
+        // The sampler are ordered as following in pSrc
         //    1234..X1234...X...
         // And need to be reordered as following
-        // m_buffers#1 = 11..
-        // m_buffers#2 = 22..
-        // m_buffers#3 = 33..
-        // m_buffers#4 = 44..
-        // m_buffers#X = XX..
+        // pDest#1 = 11..
+        // pDest#2 = 22..
+        // pDest#3 = 33..
+        // pDest#4 = 44..
+        // pDest#X = XX..
         //
         // Because of the unanticipated number of buffer and channel, we cannot
         // use any SampleUtil in this case
         for (SINT frameIdx = 0; frameIdx < frames; ++frameIdx) {
             for (int channel = 0; channel < chCount; channel++) {
-                m_buffers[channel].data()[frameIdx] =
-                        pBuffer[frameIdx * chCount + channel];
+                pDest[channel][frameIdx] = pSrc[frameIdx * chCount + channel];
             }
         }
     } break;
     }
+}
+
+void EngineBufferScaleRubberBand::deinterleaveAndProcess(
+        const CSAMPLE* pBuffer,
+        SINT frames) {
+    VERIFY_OR_DEBUG_ASSERT(m_pRubberBand->isValid()) {
+        return;
+    }
+    DEBUG_ASSERT(frames <= static_cast<SINT>(m_buffers[0].size()));
+
+    deinterleave(m_bufferPtrs.data(), pBuffer, frames);
 
     {
         ScopedTimer t(QStringLiteral("RubberBand::process"));
-        m_rubberBand.process(m_bufferPtrs.data(),
+        m_pRubberBand->process(m_bufferPtrs.data(),
                 frames,
                 false);
     }
 }
 
+bool EngineBufferScaleRubberBand::isPrerendering() const {
+    return m_pPrerenderWorker &&
+            m_stableCallbacks >= kMinStableCallbacksForPrerendering;
+}
+
+void EngineBufferScaleRubberBand::prerender() {
+    if (m_pPrerenderWorker->isBusy()) {
+        return;
+    }
+    if (m_pPrerenderWorker->channelCount() != getOutputSignal().getChannelCount()) {
+        // The signal has changed while the worker was busy
+        m_pPrerenderWorker->setChannelCount(getOutputSignal().getChannelCount());
+    }
+    const SINT availableFrames = m_pRubberBand->available();
+    if (availableFrames >= kPrerenderFrames) {
+        return;
+    }
+    m_effectiveRate = m_dBaseRate * m_dTempoRatio;
+    // The input that is needed for the missing output at the current rate,
+    // but at least a full block
+    const SINT requiredFrames = std::max(
+            static_cast<SINT>(m_pRubberBand->getSamplesRequired()),
+            static_cast<SINT>(std::ceil(
+                    (kPrerenderFrames - availableFrames) * m_effectiveRate)));
+    const SINT frames = std::min({requiredFrames,
+            kMaxPrerenderInputFrames,
+            m_pPrerenderWorker->maxInputFrames(),
+            getOutputSignal().samples2frames(m_interleavedReadBuffer.size())});
+    const SINT availableSamples = m_pReadAheadManager->getNextSamples(
+            (m_bBackwards ? -1.0 : 1.0) * m_effectiveRate,
+            m_interleavedReadBuffer.data(),
+            getOutputSignal().frames2samples(frames),
+            getOutputSignal().getChannelCount());
+    const SINT readFrames = getOutputSignal().samples2frames(availableSamples);
+    if (readFrames <= 0) {
+        // Reading fails once after a loop has been triggered. The next
+        // callback will retry or fall back to live stretching.
+        return;
+    }
+    deinterleave(m_pPrerenderWorker->inputBuffers(),
+            m_interleavedReadBuffer.data(),
+            readFrames);
+    m_pPrerenderWorker->submit(m_pRubberBand, readFrames);
+}
+
+bool EngineBufferScaleRubberBand::isWorkerBusy() const {
+    return m_pPrerenderWorker && m_pPrerenderWorker->isProcessing(m_pRubberBand);
+}
+
+void EngineBufferScaleRubberBand::switchToStandbyRubberBand() {
+    VERIFY_OR_DEBUG_ASSERT(m_pStandbyRubberBand &&
+            !m_pPrerenderWorker->isProcessing(m_pStandbyRubberBand)) {
+        return;
+    }
+    // The worker only processes a single block at a time, so the
+    // stretcher it is processing becomes the standby stretcher. Its
+    // output is discarded.
+    std::swap(m_pRubberBand, m_pStandbyRubberBand);
+    if (m_setupPending) {
+        setup();
+    } else if (m_standbySetupPending) {
+        m_standbySetupPending = false;
+        setupRubberBand(m_pRubberBand);
+    }
+    if (m_requestedPitchScale > 0 || m_requestedTimeRatioInverse > 0) {
+        applyScaleParameters();
+    }
+    m_resetPending = false;
+    reset();
+    m_stableCallbacks = 0;
+}
+
+bool EngineBufferScaleRubberBand::applyPendingChanges() {
+    if (isWorkerBusy()) {
+        return false;
+    }
+    if (m_setupPending) {
+        setup();
+    }
+    if (m_parametersPending) {
+        applyScaleParameters();
+    }
+    if (m_resetPending) {
+        m_resetPending = false;
+        reset();
+    }
+    return true;
+}
+
 double EngineBufferScaleRubberBand::scaleBuffer(
         CSAMPLE* pOutputBuffer,
         SINT iOutputBufferSize) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(m_pRubberBand->isValid()) {
         return 0.0;
     }
     ScopedTimer t(QStringLiteral("EngineBufferScaleRubberBand::scaleBuffer"));
@@ -297,6 +519,16 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         return 0.0;
     }
 
+    if (!applyPendingChanges() && (m_setupPending || m_resetPending)) {
+        // The stretched frames that are available are outdated, but
+        // RubberBand can only be reset after the worker has finished.
+        // Never wait for the worker in the real-time thread, continue
+        // with live stretching instead.
+        Counter counter("EngineBufferScaleRubberBand::prerender pending reset");
+        counter.increment();
+        switchToStandbyRubberBand();
+    }
+
     double readFramesProcessed = 0;
     SINT remaining_frames = getOutputSignal().samples2frames(iOutputBufferSize);
     CSAMPLE* read = pOutputBuffer;
@@ -315,8 +547,19 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         readFramesProcessed += m_effectiveRate * received_frames;
         read += getOutputSignal().frames2samples(received_frames);
 
+        if (remaining_frames > 0 && !applyPendingChanges()) {
+            // The prerendered frames are exhausted and the block that is
+            // currently processed in the background would be needed now.
+            // Instead of waiting for the worker the remaining frames are
+            // stretched live from the following input. This skips the
+            // input of that block.
+            Counter counter("EngineBufferScaleRubberBand::prerender underflow");
+            counter.increment();
+            switchToStandbyRubberBand();
+        }
+
         const SINT next_block_frames_required =
-                static_cast<SINT>(m_rubberBand.getSamplesRequired());
+                static_cast<SINT>(m_pRubberBand->getSamplesRequired());
         if (remaining_frames > 0 && next_block_frames_required > 0) {
             // The requested setting becomes effective after all previous frames have been processed
             m_effectiveRate = m_dBaseRate * m_dTempoRatio;
@@ -359,6 +602,14 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         counter.increment();
     }
 
+    if (!m_parametersPending &&
+            m_stableCallbacks < kMinStableCallbacksForPrerendering) {
+        ++m_stableCallbacks;
+    }
+    if (isPrerendering()) {
+        prerender();
+    }
+
     // readFramesProcessed is interpreted as the total number of frames
     // consumed to produce the scaled buffer. Due to this, we do not take into
     // account directionality or starting point.
@@ -378,19 +629,19 @@ void EngineBufferScaleRubberBand::useEngineFiner(bool enable) {
 }
 
 size_t EngineBufferScaleRubberBand::getPreferredStartPad() const {
-    return m_rubberBand.getPreferredStartPad();
+    return m_pRubberBand->getPreferredStartPad();
 }
 
 size_t EngineBufferScaleRubberBand::getStartDelay() const {
-    return m_rubberBand.getStartDelay();
+    return m_pRubberBand->getStartDelay();
 }
 
 int EngineBufferScaleRubberBand::runningEngineVersion() {
-    return m_rubberBand.getEngineVersion();
+    return m_pRubberBand->getEngineVersion();
 }
 
 void EngineBufferScaleRubberBand::reset() {
-    m_rubberBand.reset();
+    m_pRubberBand->reset();
 
     // As mentioned in the docs (https://breakfastquay.com/rubberband/code-doc/)
     // and FAQ (https://breakfastquay.com/rubberband/integration.html#faqs), you
@@ -409,7 +660,7 @@ void EngineBufferScaleRubberBand::reset() {
         const size_t pad_samples = std::min<size_t>(remaining_padding, block_size);
         {
             ScopedTimer t(QStringLiteral("RubberBand::process"));
-            m_rubberBand.process(m_bufferPtrs.data(), pad_samples, false);
+            m_pRubberBand->process(m_bufferPtrs.data(), pad_samples, false);
         }
 
         remaining_padding -= pad_samples;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <gtest/gtest_prod.h>
 #include <rubberband/RubberBandStretcher.h>
 
 #include <array>
@@ -9,7 +10,9 @@
 #include "engine/bufferscalers/rubberbandwrapper.h"
 #include "util/samplebuffer.h"
 
+class EngineWorkerScheduler;
 class ReadAheadManager;
+class RubberBandPrerenderWorker;
 
 // Uses librubberband to scale audio.  This class is not thread safe.
 class EngineBufferScaleRubberBand final : public EngineBufferScale {
@@ -17,6 +20,7 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
   public:
     explicit EngineBufferScaleRubberBand(
             ReadAheadManager* pReadAheadManager);
+    ~EngineBufferScaleRubberBand() override;
 
     EngineBufferScaleRubberBand(const EngineBufferScaleRubberBand&) = delete;
     EngineBufferScaleRubberBand& operator=(const EngineBufferScaleRubberBand&) = delete;
@@ -30,6 +34,14 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     // Enable engine v3 if available
     void useEngineFiner(bool enable);
 
+    /// Render the stretched audio ahead of the playhead in a background
+    /// worker while the tempo and pitch are stable. Live stretching is only
+    /// used while they are changing. The real-time thread never waits for
+    /// the worker. Changes are deferred until it has finished, or a standby
+    /// stretcher continues live if the prerendered frames are outdated or
+    /// exhausted.
+    void enablePrerendering(EngineWorkerScheduler* pWorkerScheduler);
+
     void setScaleParameters(double base_rate,
                             double* pTempoRatio,
                             double* pPitchRatio) override;
@@ -42,8 +54,15 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     void clear() override;
 
   private:
+    FRIEND_TEST(EngineBufferScaleRubberBandTest, prerenderWithStableRate);
+    FRIEND_TEST(EngineBufferScaleRubberBandTest, deferChangesWhilePrerendering);
+    FRIEND_TEST(EngineBufferScaleRubberBandTest, stretchLiveWhileWorkerBusy);
+
     // Reset RubberBand library with new audio signal
     void onSignalChanged() override;
+    void setup();
+    void setupRubberBand(RubberBandWrapper* pRubberBand);
+    void applyScaleParameters();
 
     /// Calls `m_pRubberBand->getPreferredStartPad()`, with backwards
     /// compatibility for older librubberband versions.
@@ -59,11 +78,31 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
 
     void deinterleaveAndProcess(const CSAMPLE* pBuffer, SINT frames);
     SINT retrieveAndDeinterleave(CSAMPLE* pBuffer, SINT frames);
+    void deinterleave(float* const* pDest, const CSAMPLE* pSrc, SINT frames);
+
+    bool isPrerendering() const;
+    /// Reads input ahead of the playhead and passes it to the prerender
+    /// worker, if there is not enough stretched output available yet.
+    void prerender();
+    /// The active RubberBand instance must not be modified while busy.
+    bool isWorkerBusy() const;
+    /// Continues with live stretching on the standby stretcher, which is
+    /// set up and reset if needed. Must not be called while the worker is
+    /// processing the standby stretcher.
+    void switchToStandbyRubberBand();
+    /// Applies the changes that have been deferred while the worker was
+    /// busy. Returns false if the worker is still busy.
+    bool applyPendingChanges();
 
     // The read-ahead manager that we use to fetch samples
     ReadAheadManager* m_pReadAheadManager;
 
-    RubberBandWrapper m_rubberBand;
+    /// The standby stretcher is only used with prerendering. It takes over
+    /// when the worker is still processing the active stretcher, but it
+    /// would need to be reset or can't provide the frames that are needed.
+    std::array<RubberBandWrapper, 2> m_rubberBands;
+    RubberBandWrapper* m_pRubberBand;
+    RubberBandWrapper* m_pStandbyRubberBand;
 
     /// The audio buffers samples used to send audio to Rubber Band and to
     /// receive processed audio from Rubber Band. This is needed because Mixxx
@@ -85,4 +124,18 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     SINT m_remainingPaddingInOutput = 0;
 
     bool m_useEngineFiner;
+
+    std::unique_ptr<RubberBandPrerenderWorker> m_pPrerenderWorker;
+    /// The number of consecutive scaleBuffer() calls without changes of
+    /// the stretching parameters.
+    int m_stableCallbacks;
+    /// Changes that could not be applied while the worker was busy
+    bool m_setupPending;
+    bool m_standbySetupPending;
+    bool m_resetPending;
+    bool m_parametersPending;
+    /// The last requested parameters and the resulting tempo ratio.
+    double m_requestedPitchScale;
+    double m_requestedTimeRatioInverse;
+    double m_appliedTempoRatio;
 };
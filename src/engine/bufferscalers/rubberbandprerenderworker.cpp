@@ -0,0 +1,69 @@
+#include "engine/bufferscalers/rubberbandprerenderworker.h"
+
+#include <QThread>
+
+#include "engine/bufferscalers/rubberbandwrapper.h"
+#include "moc_rubberbandprerenderworker.cpp"
+#include "util/assert.h"
+#include "util/defs.h"
+#include "util/timer.h"
+
+RubberBandPrerenderWorker::RubberBandPrerenderWorker()
+        : m_pRubberBand(nullptr),
+          m_submittedFrames(0),
+          m_busy(false),
+          m_processedBlocks(0),
+          m_stop(0) {
+}
+
+void RubberBandPrerenderWorker::run() {
+    static auto lastId = QAtomicInt(0);
+    const auto id = lastId.fetchAndAddRelaxed(1) + 1;
+    QThread::currentThread()->setObjectName(
+            QStringLiteral("RubberBandPrerenderWorker ") + QString::number(id));
+
+    while (!m_stop.loadAcquire()) {
+        if (m_busy.load(std::memory_order_acquire)) {
+            {
+                ScopedTimer t(QStringLiteral("RubberBand::process prerender"));
+                m_pRubberBand->process(m_inputBufferPtrs.data(),
+                        m_submittedFrames,
+                        false);
+            }
+            m_processedBlocks.fetch_add(1, std::memory_order_relaxed);
+            m_busy.store(false, std::memory_order_release);
+        }
+        m_semaRun.acquire();
+    }
+}
+
+void RubberBandPrerenderWorker::quitWait() {
+    m_stop = 1;
+    m_semaRun.release();
+    wait();
+}
+
+void RubberBandPrerenderWorker::setChannelCount(mixxx::audio::ChannelCount channelCount) {
+    VERIFY_OR_DEBUG_ASSERT(!isBusy()) {
+        return;
+    }
+    m_inputBuffers.resize(channelCount);
+    m_inputBufferPtrs.resize(channelCount);
+    for (int chIdx = 0; chIdx < channelCount; chIdx++) {
+        if (m_inputBuffers[chIdx].size() != MAX_BUFFER_LEN) {
+            m_inputBuffers[chIdx] = mixxx::SampleBuffer(MAX_BUFFER_LEN);
+        }
+        m_inputBufferPtrs[chIdx] = m_inputBuffers[chIdx].data();
+    }
+}
+
+void RubberBandPrerenderWorker::submit(RubberBandWrapper* pRubberBand, SINT frames) {
+    VERIFY_OR_DEBUG_ASSERT(pRubberBand && !isBusy() && frames > 0 &&
+            frames <= maxInputFrames()) {
+        return;
+    }
+    m_pRubberBand = pRubberBand;
+    m_submittedFrames = frames;
+    m_busy.store(true, std::memory_order_release);
+    workReady();
+}
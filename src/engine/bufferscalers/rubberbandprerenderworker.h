@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <atomic>
+#include <vector>
+
+#include "audio/types.h"
+#include "engine/engineworker.h"
+#include "util/samplebuffer.h"
+
+class RubberBandWrapper;
+
+/// Feeds input into a RubberBandWrapper in the background while the audio
+/// callback is not active, so the stretched output is rendered ahead of
+/// the playhead. The callback only retrieves the pre-rendered frames.
+///
+/// RubberBand allows process() and retrieve() to be called from different
+/// threads, but the time and pitch ratio must not be changed while
+/// process() is running. Callers need to defer these changes and resetting
+/// the stretcher until the worker is no longer processing it, or continue
+/// with another stretcher. The worker is not running with real-time
+/// priority, so the audio callback must never wait for it.
+class RubberBandPrerenderWorker : public EngineWorker {
+    Q_OBJECT
+  public:
+    RubberBandPrerenderWorker();
+    ~RubberBandPrerenderWorker() override = default;
+
+    void run() override;
+
+    void quitWait();
+
+    /// Allocates the input buffers. Must not be called while busy.
+    void setChannelCount(mixxx::audio::ChannelCount channelCount);
+
+    /// The deinterleaved input buffers that are passed to RubberBand
+    /// by the next submit(). Must only be written while idle.
+    float* const* inputBuffers() {
+        return m_inputBufferPtrs.data();
+    }
+
+    SINT maxInputFrames() const {
+        return m_inputBuffers.empty() ? 0 : m_inputBuffers[0].size();
+    }
+
+    mixxx::audio::ChannelCount channelCount() const {
+        return mixxx::audio::ChannelCount(static_cast<int>(m_inputBuffers.size()));
+    }
+
+    bool isBusy() const {
+        return m_busy.load(std::memory_order_acquire);
+    }
+
+    /// Whether the given stretcher must not be modified, because the
+    /// worker is still processing it.
+    bool isProcessing(const RubberBandWrapper* pRubberBand) const {
+        return isBusy() && m_pRubberBand == pRubberBand;
+    }
+
+    /// Schedules processing the first frames of the input buffers with
+    /// the given stretcher after the current callback.
+    void submit(RubberBandWrapper* pRubberBand, SINT frames);
+
+    /// The number of submitted blocks that have been processed
+    int processedBlocks() const {
+        return m_processedBlocks.load(std::memory_order_relaxed);
+    }
+
+  private:
+    // Only written by the callback while idle
+    RubberBandWrapper* m_pRubberBand;
+
+    std::vector<mixxx::SampleBuffer> m_inputBuffers;
+    std::vector<float*> m_inputBufferPtrs;
+
+    SINT m_submittedFrames;
+    std::atomic<bool> m_busy;
+    std::atomic<int> m_processedBlocks;
+    QAtomicInt m_stop;
+};
@@ -1,14 +1,65 @@
 #include "engine/bufferscalers/rubberbandworkerpool.h"
 
-#include <rubberband/RubberBandStretcher.h>
+#include <algorithm>
 
+#include "control/controlobject.h"
+#include "engine/bufferscalers/rubberbandtask.h"
 #include "engine/engine.h"
 #include "util/assert.h"
+#include "util/counter.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+#include "util/time.h"
+
+#ifdef __LINUX__
+#include "util/rlimit.h"
+#endif
+
+namespace {
+
+const mixxx::Logger kLogger("RubberBandWorkerPool");
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+// One below the SCHED_FIFO priority of the PortAudio callback thread, so
+// the workers never preempt the thread they are helping.
+constexpr int kRealtimePriority = 81;
+
+// in 1/s, fits to the audio latency usage
+constexpr int kUsageUpdateRate = 30;
+constexpr qint64 kUsageUpdateIntervalNanos = 1000000000 / kUsageUpdateRate;
+
+RealtimeWorkerThreadOptions workerThreadOptions() {
+    RealtimeWorkerThreadOptions options;
+    options.pinToCores = true;
+#ifdef __LINUX__
+    options.realtimePriority = std::min(
+            static_cast<int>(RLimit::getCurRtPrio()), kRealtimePriority);
+#endif
+    return options;
+}
+
+struct TaskList {
+    const std::vector<std::unique_ptr<RubberBandTask>>* pTasks;
+};
+
+void runTask(void* pContext, int index) {
+    const auto* pTaskList = static_cast<const TaskList*>(pContext);
+    (*pTaskList->pTasks)[index]->run();
+}
+
+} // anonymous namespace
 
 RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
-        : QThreadPool() {
+        : m_pStretchUsage(std::make_unique<ControlObject>(
+                  ConfigKey(kAppGroup, QStringLiteral("keylock_stretch_usage")))),
+          m_pJoinWaitUsage(std::make_unique<ControlObject>(
+                  ConfigKey(kAppGroup, QStringLiteral("keylock_join_wait_usage")))),
+          m_stretchNanos(0),
+          m_joinWaitNanos(0),
+          m_lastUsageUpdateNanos(0) {
     bool multiThreadedOnStereo = pConfig &&
-            pConfig->getValue(ConfigKey(QStringLiteral("[App]"),
+            pConfig->getValue(ConfigKey(kAppGroup,
                                       QStringLiteral("keylock_multithreading")),
                     false);
     m_channelPerWorker = multiThreadedOnStereo
@@ -19,18 +70,60 @@ RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
     int numCore = QThread::idealThreadCount();
     int numRBTasks = qMin(numCore, mixxx::kMaxEngineChannelInputCount / m_channelPerWorker);
 
-    qDebug() << "RubberBand will use" << numRBTasks << "tasks to scale the audio signal";
+    const RealtimeWorkerThreadOptions options = workerThreadOptions();
+    kLogger.debug() << "RubberBand will use" << numRBTasks
+                    << "tasks to scale the audio signal, SCHED_FIFO priority"
+                    << options.realtimePriority;
+
+    // The pool will only be used to scale n-1 tasks, so the engine thread
+    // takes care of the last one and doesn't have to be idle. During
+    // performance testing, this has shown better results.
+    m_pWorkerPool = std::make_unique<RealtimeWorkerPool>(
+            numRBTasks - 1, QStringLiteral("RubberBandWorker"), options);
+}
+
+RubberBandWorkerPool::~RubberBandWorkerPool() = default;
 
-    setThreadPriority(QThread::HighPriority);
-    // The RB pool will only be used to scale n-1 buffer sample, so the engine
-    // thread takes care of the last buffer and doesn't have to be idle.
-    setMaxThreadCount(numRBTasks - 1);
+void RubberBandWorkerPool::process(
+        const std::vector<std::unique_ptr<RubberBandTask>>& tasks) {
+    PerformanceTimer timer;
+    timer.start();
+    TaskList taskList{&tasks};
+    mixxx::Duration joinWaitTime;
+    if (!m_pWorkerPool->tryRun(static_cast<int>(tasks.size()),
+                runTask,
+                &taskList,
+                &joinWaitTime)) {
+        // Another deck is stretching on the workers right now. Waiting for
+        // them would take longer than doing the work on this thread.
+        Counter("RubberBandWorkerPool::process inline").increment();
+        for (int i = 0; i < static_cast<int>(tasks.size()); ++i) {
+            runTask(&taskList, i);
+        }
+    }
+    m_joinWaitNanos.fetch_add(joinWaitTime.toIntegerNanos(), std::memory_order_relaxed);
+    addStretchTime(timer.elapsed());
+}
 
-    // We allocate one runner less than the total of maximum supported channel,
-    // so the engine thread will also perform a stretching operation, instead of
-    // waiting all workers to complete. During performance testing, this ahas
-    // show better results
-    for (int w = 0; w < maxThreadCount(); w++) {
-        reserveThread();
+void RubberBandWorkerPool::addStretchTime(mixxx::Duration stretchTime) {
+    m_stretchNanos.fetch_add(stretchTime.toIntegerNanos(), std::memory_order_relaxed);
+    updateUsage();
+}
+
+void RubberBandWorkerPool::updateUsage() {
+    const qint64 nowNanos = mixxx::Time::elapsed().toIntegerNanos();
+    qint64 lastUpdateNanos = m_lastUsageUpdateNanos.load(std::memory_order_relaxed);
+    const qint64 intervalNanos = nowNanos - lastUpdateNanos;
+    if (intervalNanos < kUsageUpdateIntervalNanos) {
+        return;
+    }
+    // Only one of the concurrent engine threads publishes the usage
+    if (!m_lastUsageUpdateNanos.compare_exchange_strong(
+                lastUpdateNanos, nowNanos, std::memory_order_relaxed)) {
+        return;
     }
+    const qint64 stretchNanos = m_stretchNanos.exchange(0, std::memory_order_relaxed);
+    const qint64 joinWaitNanos = m_joinWaitNanos.exchange(0, std::memory_order_relaxed);
+    m_pStretchUsage->set(static_cast<double>(stretchNanos) / intervalNanos);
+    m_pJoinWaitUsage->set(static_cast<double>(joinWaitNanos) / intervalNanos);
 }
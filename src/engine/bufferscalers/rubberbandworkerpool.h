@@ -1,26 +1,62 @@
 #pragma once
 
-#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "audio/types.h"
+#include "engine/realtimeworkerpool.h"
 #include "preferences/usersettings.h"
+#include "util/duration.h"
 #include "util/singleton.h"
 
-// RubberBandWorkerPool is a global pool manager for RubberBandWorkerPool. It
-// allows a the Engine thread to use a pool of agnostic RubberBandWorker which
-// can be distributed stretching job
-class RubberBandWorkerPool : public QThreadPool, public Singleton<RubberBandWorkerPool> {
+class ControlObject;
+class RubberBandTask;
+
+// RubberBandWorkerPool is a global pool of real-time workers that allows the
+// engine thread to distribute the stretching of a multi channel deck (stems)
+// over several RubberBandTasks. The engine thread processes one of the tasks
+// itself instead of waiting idle for the workers.
+class RubberBandWorkerPool : public Singleton<RubberBandWorkerPool> {
   public:
+    ~RubberBandWorkerPool();
+
     const mixxx::audio::ChannelCount& channelPerWorker() const {
         return m_channelPerWorker;
     }
 
+    /// The number of threads that are stretching concurrently, including
+    /// the calling engine thread.
+    int maxTaskCount() const {
+        return m_pWorkerPool->numWorkers() + 1;
+    }
+
+    /// Runs all tasks that have been set() before and returns when all of
+    /// them have completed. If the workers are already in use by another
+    /// engine thread, the tasks are processed by the calling thread.
+    void process(const std::vector<std::unique_ptr<RubberBandTask>>& tasks);
+
+    /// Accounts time that an engine thread has spent stretching outside
+    /// of process(), e.g. for a single instance stretcher.
+    void addStretchTime(mixxx::Duration stretchTime);
+
   protected:
     RubberBandWorkerPool(UserSettingsPointer pConfig = nullptr);
 
   private:
-    ;
+    void updateUsage();
+
     mixxx::audio::ChannelCount m_channelPerWorker;
+    std::unique_ptr<RealtimeWorkerPool> m_pWorkerPool;
+
+    // Attribution of the callback time to stretching. The engine threads
+    // accumulate the time and the first one after the update interval
+    // publishes the share of the wall time.
+    std::unique_ptr<ControlObject> m_pStretchUsage;
+    std::unique_ptr<ControlObject> m_pJoinWaitUsage;
+    std::atomic<qint64> m_stretchNanos;
+    std::atomic<qint64> m_joinWaitNanos;
+    std::atomic<qint64> m_lastUsageUpdateNanos;
 
     friend class Singleton<RubberBandWorkerPool>;
 };
@@ -3,6 +3,7 @@
 #include "engine/bufferscalers/rubberbandworkerpool.h"
 #include "engine/engine.h"
 #include "util/assert.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 
 using RubberBand::RubberBandStretcher;
@@ -53,7 +54,7 @@ mixxx::audio::ChannelCount getChannelPerWorker(mixxx::audio::ChannelCount chCoun
     }
     auto channelPerWorker = pPool->channelPerWorker();
     // The task count includes all the thread in the pool + the engine thread
-    auto maxThreadCount = pPool->maxThreadCount() + 1;
+    auto maxThreadCount = pPool->maxTaskCount();
     VERIFY_OR_DEBUG_ASSERT(chCount % channelPerWorker == 0) {
         return mixxx::kEngineChannelOutputCount;
     }
@@ -178,25 +179,23 @@ size_t RubberBandWrapper::getStartDelay() const {
 #endif
 }
 void RubberBandWrapper::process(const float* const* input, size_t samples, bool isFinal) {
+    RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
     if (m_pInstances.size() == 1) {
-        return m_pInstances[0]->process(input, samples, isFinal);
+        PerformanceTimer timer;
+        timer.start();
+        m_pInstances[0]->process(input, samples, isFinal);
+        if (pPool) {
+            pPool->addStretchTime(timer.elapsed());
+        }
     } else {
-        RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
+        VERIFY_OR_DEBUG_ASSERT(pPool) {
+            return;
+        }
         for (auto& pInstance : m_pInstances) {
             pInstance->set(input, samples, isFinal);
-            // We try to get the stretching job ran by the RBPool if there is a
-            // worker slot available
-            if (!pPool->tryStart(pInstance.get())) {
-                // Otherwise, it means the main thread should take care of the stretching
-                pInstance->run();
-            }
             input += m_channelPerWorker;
         }
-        // We always perform a wait, even for task that were ran in the main
-        // thread, so it resets the semaphore
-        for (auto& pInstance : m_pInstances) {
-            pInstance->waitReady();
-        }
+        pPool->process(m_pInstances);
     }
 }
 void RubberBandWrapper::reset() {
@@ -1,7 +1,9 @@
 #include "engine/cachingreader/cachingreader.h"
 
 #include <QtDebug>
+#include <algorithm>
 
+#include "mixer/playermanager.h"
 #include "moc_cachingreader.cpp"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
@@ -18,6 +20,10 @@ mixxx::Logger kLogger("CachingReader");
 // TODO() Do we suffer cache misses if we use an audio buffer of above 23 ms?
 constexpr SINT kDefaultHintFrames = 1024;
 
+// The maximum number of chunks that are requested from the worker
+// during a single callback.
+constexpr int kMaxChunkReadRequestsPerCallback = 16;
+
 // With CachingReaderChunk::kFrames = 8192 each chunk consumes
 // 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB for stereo frame.
 //
@@ -29,46 +35,113 @@ constexpr SINT kDefaultHintFrames = 1024;
 // CachingReader must be multiplied by the number of decks to calculate
 // the total amount!
 //
+// The number of chunks can be adjusted separately for decks and samplers
+// in the config. Only the chunks that are needed for the loaded track are
+// actually used, i.e. the memory of the remaining chunks is never touched.
+//
 // NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
-// (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
+// (kDefaultNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
 // to verify that the MRU/LRU cache works as expected. Even though
 // massive drop outs are expected to occur Mixxx should run reliably!
-constexpr SINT kNumberOfCachedChunksInMemory = 80;
+constexpr int kDefaultNumberOfCachedChunksInMemory = 80;
+constexpr int kMinNumberOfCachedChunksInMemory = 4;
+constexpr int kMaxNumberOfCachedChunksInMemory = 1024;
+
+const ConfigKey kNumberOfCachedChunksDeckConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("cachingreader_chunks_deck"));
+const ConfigKey kNumberOfCachedChunksSamplerConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("cachingreader_chunks_sampler"));
+
+// Decoding the whole track into memory is disabled by default. A stereo
+// track of 10 minutes at 48 kHz consumes about 220 MB. The memory is only
+// allocated for tracks that fit into the configured limit.
+const ConfigKey kDecodeWholeTrackConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("cachingreader_decode_whole_track"));
+const ConfigKey kDecodeWholeTrackMaxMBConfigKey =
+        ConfigKey(QStringLiteral("[App]"),
+                QStringLiteral("cachingreader_decode_whole_track_max_mb"));
+constexpr int kDefaultDecodeWholeTrackMaxMB = 1024;
+
+int numberOfCachedChunksInMemory(
+        const QString& group,
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig) {
+        return kDefaultNumberOfCachedChunksInMemory;
+    }
+    const ConfigKey& configKey = PlayerManager::isSamplerGroup(group)
+            ? kNumberOfCachedChunksSamplerConfigKey
+            : kNumberOfCachedChunksDeckConfigKey;
+    return std::clamp(
+            pConfig->getValue(configKey, kDefaultNumberOfCachedChunksInMemory),
+            kMinNumberOfCachedChunksInMemory,
+            kMaxNumberOfCachedChunksInMemory);
+}
+
+SINT maxWholeTrackSamples(const UserSettingsPointer& pConfig) {
+    if (!pConfig || !pConfig->getValue(kDecodeWholeTrackConfigKey, false)) {
+        return 0;
+    }
+    const SINT maxBytes = static_cast<SINT>(std::max(
+                                  pConfig->getValue(kDecodeWholeTrackMaxMBConfigKey,
+                                          kDefaultDecodeWholeTrackMaxMB),
+                                  0)) *
+            1024 * 1024;
+    return maxBytes / static_cast<SINT>(sizeof(CSAMPLE));
+}
 
 } // anonymous namespace
 
 CachingReader::CachingReader(const QString& group,
         UserSettingsPointer config,
         mixxx::audio::ChannelCount maxSupportedChannel)
+        : CachingReader(group,
+                  config,
+                  maxSupportedChannel,
+                  numberOfCachedChunksInMemory(group, config)) {
+}
+
+CachingReader::CachingReader(const QString& group,
+        UserSettingsPointer config,
+        mixxx::audio::ChannelCount maxSupportedChannel,
+        int numberOfCachedChunks)
         : m_pConfig(config),
           // Limit the number of in-flight requests to the worker. This should
           // prevent to overload the worker when it is not able to fetch those
           // requests from the FIFO timely. Otherwise outdated requests pile up
           // in the FIFO and it would take a long time to process them, just to
           // discard the results that most likely have already become obsolete.
-          // TODO(XXX): Ideally the request FIFO would be implemented as a ring
-          // buffer, where new requests replace old requests when full. Those
-          // old requests need to be returned immediately to the CachingReader
-          // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
+          // Chunks are only requested if there is room left in the FIFO,
+          // all others are deferred (see hintAndMaybeWake).
+          m_chunkReadRequestFIFO(numberOfCachedChunks / 4),
           // The capacity of the back channel must be equal to the number of
           // allocated chunks, because the worker use writeBlocking(). Otherwise
           // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          // One additional slot is reserved for the TRACK_DECODED update
+          // that is sent without a chunk.
+          m_readerStatusUpdateFIFO(numberOfCachedChunks + 1),
           m_state(STATE_IDLE),
+          m_chunkBudget(numberOfCachedChunks),
+          m_hintGeneration(0),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
           m_sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel *
-                  kNumberOfCachedChunksInMemory),
+                  numberOfCachedChunks),
+          m_pDecodedTrackSamples(nullptr),
           m_worker(group,
                   &m_chunkReadRequestFIFO,
                   &m_readerStatusUpdateFIFO,
-                  maxSupportedChannel) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+                  maxSupportedChannel,
+                  maxWholeTrackSamples(config)) {
+    kLogger.debug()
+            << group
+            << "uses"
+            << numberOfCachedChunks
+            << "chunks";
+    m_allocatedCachingReaderChunks.reserve(numberOfCachedChunks);
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
+    for (SINT i = 0; i < numberOfCachedChunks; ++i) {
         CachingReaderChunkForOwner* c =
                 new CachingReaderChunkForOwner(
                         mixxx::SampleBuffer::WritableSlice(
@@ -103,7 +176,7 @@ void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
     pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    m_freeChunks.push_front(pChunk);
 }
 
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
@@ -138,7 +211,8 @@ void CachingReader::freeAllChunks() {
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.empty()) {
+    if (m_freeChunks.empty() ||
+            m_allocatedCachingReaderChunks.size() >= m_chunkBudget) {
         return nullptr;
     }
     CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
@@ -151,11 +225,35 @@ CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
     return pChunk;
 }
 
+CachingReaderChunkForOwner* CachingReader::findChunkToExpire() const {
+    // Starting with the LRU chunk find the first chunk with the
+    // lowest hint priority.
+    CachingReaderChunkForOwner* pExpireChunk = nullptr;
+    int expirePriority = 0;
+    for (auto* pChunk = m_lruCachingReaderChunk; pChunk; pChunk = pChunk->getPrev()) {
+        const int priority = pChunk->effectiveHintPriority(m_hintGeneration);
+        if (!pExpireChunk || priority < expirePriority) {
+            pExpireChunk = pChunk;
+            expirePriority = priority;
+            if (priority == 0) {
+                // Not hinted recently, no need to look any further
+                break;
+            }
+        }
+    }
+    return pExpireChunk;
+}
+
 CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkIndex) {
     auto* pChunk = allocateChunk(chunkIndex);
     if (!pChunk) {
-        if (m_lruCachingReaderChunk) {
-            freeChunk(m_lruCachingReaderChunk);
+        auto* pExpireChunk = findChunkToExpire();
+        if (pExpireChunk) {
+            if (pExpireChunk->effectiveHintPriority(m_hintGeneration) > 0) {
+                Counter(QStringLiteral("CachingReader: Expired hinted chunk"))++;
+            }
+            Counter(QStringLiteral("CachingReader: Expired chunk"))++;
+            freeChunk(pExpireChunk);
             pChunk = allocateChunk(chunkIndex);
         } else {
             kLogger.warning() << "No cached LRU chunk available for freeing";
@@ -284,9 +382,35 @@ void CachingReader::process() {
                 }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                // Stop reading the decoded samples of the previous track
+                // before the worker releases them
+                m_pDecodedTrackSamples = nullptr;
+                m_decodedTrackFrameIndexRange = mixxx::IndexRange();
+                m_worker.trackStatusProcessed();
+                // Don't use more chunks than needed for caching the whole track
+                const int trackChunks =
+                        CachingReaderChunk::indexForFrame(
+                                m_readableFrameIndexRange.end() - 1) -
+                        CachingReaderChunk::indexForFrame(
+                                m_readableFrameIndexRange.start()) +
+                        1;
+                m_chunkBudget = std::clamp(trackChunks,
+                        std::min(kMinNumberOfCachedChunksInMemory,
+                                static_cast<int>(m_chunks.size())),
+                        static_cast<int>(m_chunks.size()));
                 m_state.storeRelease(STATE_TRACK_LOADED);
+            } else if (update.status == TRACK_DECODED) {
+                // Results for a previous track are outdated if a new
+                // track is loading
+                if (m_state.loadAcquire() == STATE_TRACK_LOADED) {
+                    m_pDecodedTrackSamples = update.decodedSamples();
+                    m_decodedTrackFrameIndexRange = update.readableFrameIndexRange();
+                }
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
+                m_pDecodedTrackSamples = nullptr;
+                m_decodedTrackFrameIndexRange = mixxx::IndexRange();
+                m_worker.trackStatusProcessed();
                 // This message could be processed later when a new
                 // track is already loading! In this case the TRACK_LOADED will
                 // be the very next status update.
@@ -359,6 +483,10 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
     // the first chunk and to update m_readableFrameIndexRange
     process();
 
+    if (m_pDecodedTrackSamples) {
+        return readDecodedTrack(sample, numSamples, reverse, buffer, channelCount);
+    }
+
     auto remainingFrameIndexRange =
             mixxx::IndexRange::forward(
                     CachingReaderChunk::samples2frames(sample, channelCount),
@@ -450,6 +578,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                 mixxx::IndexRange bufferedFrameIndexRange;
                 const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    Counter(QStringLiteral("CachingReader::read(): Cache hit"))++;
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -469,7 +598,8 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    Counter(QStringLiteral(
+                            "CachingReader::read(): Failed to read chunk on cache miss"))++;
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -536,17 +666,83 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
     return result;
 }
 
+CachingReader::ReadResult CachingReader::readDecodedTrack(SINT startSample,
+        SINT numSamples,
+        bool reverse,
+        CSAMPLE* buffer,
+        mixxx::audio::ChannelCount channelCount) {
+    DEBUG_ASSERT(m_pDecodedTrackSamples);
+    const auto frameIndexRange = mixxx::IndexRange::forward(
+            CachingReaderChunk::samples2frames(startSample, channelCount),
+            CachingReaderChunk::samples2frames(numSamples, channelCount));
+    const auto readableFrameIndexRange =
+            intersect(frameIndexRange, m_decodedTrackFrameIndexRange);
+    if (readableFrameIndexRange.empty()) {
+        SampleUtil::clear(buffer, numSamples);
+        return ReadResult::PARTIALLY_AVAILABLE;
+    }
+    // Silence before and after the decoded samples, i.e. preroll
+    // and beyond the end of the track
+    const SINT headSamples = CachingReaderChunk::frames2samples(
+            readableFrameIndexRange.start() - frameIndexRange.start(),
+            channelCount);
+    const SINT readableSamples = CachingReaderChunk::frames2samples(
+            readableFrameIndexRange.length(), channelCount);
+    const SINT tailSamples = numSamples - headSamples - readableSamples;
+    DEBUG_ASSERT(tailSamples >= 0);
+    const CSAMPLE* pSamples = m_pDecodedTrackSamples +
+            CachingReaderChunk::frames2samples(
+                    readableFrameIndexRange.start() -
+                            m_decodedTrackFrameIndexRange.start(),
+                    channelCount);
+    if (reverse) {
+        // The first frame is at the end of the buffer
+        SampleUtil::clear(buffer, tailSamples);
+        SampleUtil::copyReverse(
+                buffer + tailSamples, pSamples, readableSamples, channelCount);
+        SampleUtil::clear(buffer + tailSamples + readableSamples, headSamples);
+    } else {
+        SampleUtil::clear(buffer, headSamples);
+        SampleUtil::copy(buffer + headSamples, pSamples, readableSamples);
+        SampleUtil::clear(buffer + headSamples + readableSamples, tailSamples);
+    }
+    if (headSamples > 0 || tailSamples > 0) {
+        return ReadResult::PARTIALLY_AVAILABLE;
+    }
+    return ReadResult::AVAILABLE;
+}
+
 void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // If no file is loaded, skip.
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
         return;
     }
 
+    // All reads are served from memory, no need to fetch any chunks
+    if (m_pDecodedTrackSamples) {
+        return;
+    }
+
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
 
+    ++m_hintGeneration;
+
+    // The number of new read requests per callback is limited by the free
+    // capacity of the request FIFO and by a fixed cost budget. Each request
+    // might expire a cached chunk, which requires to scan the LRU list.
+    // Missing chunks that exceed the budget are deferred until one of the
+    // next callbacks when they are hinted again. The hints are ordered by
+    // importance, i.e. the playhead comes first and is never starved by
+    // a large number of hotcues.
+    int readRequestBudget = std::min(
+            m_chunkReadRequestFIFO.writeAvailable(),
+            kMaxChunkReadRequestsPerCallback);
+    int deferredReadRequests = 0;
+
     for (const auto& hint: hintList) {
+        const int hintPriority = Hint::priority(hint.type);
         SINT hintFrame = hint.frame;
         SINT hintFrameCount = hint.frameCount;
 
@@ -583,6 +779,10 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
             CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
             if (!pChunk) {
                 shouldWake = true;
+                if (readRequestBudget <= 0) {
+                    ++deferredReadRequests;
+                    continue;
+                }
                 pChunk = allocateChunkExpireLRU(chunkIndex);
                 if (!pChunk) {
                     kLogger.warning()
@@ -591,6 +791,7 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                             << "for read request";
                     continue;
                 }
+                pChunk->updateHint(hintPriority, m_hintGeneration);
                 // Do not insert the allocated chunk into the MRU/LRU list,
                 // because it will be handed over to the worker immediately
                 CachingReaderChunkReadRequest request;
@@ -600,22 +801,37 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                             << "Requesting read of chunk"
                             << request.chunk;
                 }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+                // The FIFO has a single writer and the budget doesn't
+                // exceed the free capacity, so this should never fail.
+                VERIFY_OR_DEBUG_ASSERT(m_chunkReadRequestFIFO.write(&request, 1) == 1) {
                     kLogger.warning()
                             << "Failed to submit read request for chunk"
                             << chunkIndex;
                     // Revoke the chunk from the worker and free it
                     pChunk->takeFromWorker();
                     freeChunk(pChunk);
+                    readRequestBudget = 0;
+                    continue;
+                }
+                --readRequestBudget;
+            } else if (pChunk->updateHint(hintPriority, m_hintGeneration)) {
+                // Overlapping hints are coalesced: Pending chunks are already
+                // on their way and each chunk is only freshened once per
+                // callback.
+                if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+                    // This will cause the chunk to be 'freshened' in the cache. The
+                    // chunk will be moved to the end of the LRU list.
+                    freshenChunk(pChunk);
                 }
-            } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
-                // This will cause the chunk to be 'freshened' in the cache. The
-                // chunk will be moved to the end of the LRU list.
-                freshenChunk(pChunk);
             }
         }
     }
 
+    if (deferredReadRequests > 0) {
+        Counter(QStringLiteral("CachingReader: Deferred read request")) +=
+                deferredReadRequests;
+    }
+
     // If there are chunks to be read, wake up.
     if (shouldWake) {
         m_worker.workReady();
@@ -18,13 +18,13 @@
 // the reader work thread.
 typedef struct Hint {
     enum class Type {
-        SlipPosition,     // prio 1 (so far unused Mixxx 2.3 priority for reference)
-        CurrentPosition,  // prio 1
-        LoopStartEnabled, // prio 2
-        MainCue,          // prio 10
-        HotCue,           // prio 10
-        LoopEndEnabled,   // prio 10
-        LoopStart,        // prio 10
+        SlipPosition,
+        CurrentPosition,
+        LoopStartEnabled,
+        MainCue,
+        HotCue,
+        LoopEndEnabled,
+        LoopStart,
         FirstSound,
         IntroStart,
         IntroEnd,
@@ -36,13 +36,38 @@ typedef struct Hint {
     // If a range of frames should be present, use frameCount to indicate that the
     // range (frame, frame + frameCount) should be present in memory.
     SINT frameCount;
-    // Currently unused -- but in the future could be used to prioritize certain
-    // hints over others.
+    // Used to prioritize certain hints over others when the cache is full,
+    // see priority().
     Type type;
 
     // for the default frame count in forward direction
     static constexpr SINT kFrameCountForward = 0;
     static constexpr SINT kFrameCountBackward = -1;
+
+    // The retention priority of chunks that have been hinted with the given
+    // type. When evicting chunks from the cache those with a lower priority
+    // are evicted first. The chunks around the playhead are read continuously
+    // and thus freshened anyway, while the chunks at cue and loop positions
+    // must survive until the user jumps there.
+    static constexpr int priority(Type type) {
+        switch (type) {
+        case Type::SlipPosition:
+        case Type::CurrentPosition:
+            return 1;
+        case Type::FirstSound:
+        case Type::IntroStart:
+        case Type::IntroEnd:
+        case Type::OutroStart:
+            return 2;
+        case Type::MainCue:
+        case Type::HotCue:
+        case Type::LoopStart:
+        case Type::LoopStartEnabled:
+        case Type::LoopEndEnabled:
+            return 3;
+        }
+        return 0;
+    }
 } Hint;
 
 // Note that we use a QVarLengthArray here instead of a QVector. Since this list
@@ -74,8 +99,17 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least recently used chunks. When a chunk is "freshened" (i.e. accessed via
 // read or hinted via hintAndMaybeWake) then it is moved to the back of the
 // least-recently-used list. When a chunk needs to be allocated and there are no
-// free chunks then the least recently used chunk is free'd (see
-// allocateChunkExpireLRU).
+// free chunks then the least recently used chunk with the lowest hint priority
+// is free'd (see allocateChunkExpireLRU). Chunks that are kept alive by hints
+// for cue or loop positions are only evicted if no other chunks are left.
+//
+// The number of chunks is configurable per type of deck and the number of
+// chunks in use is limited by the length of the loaded track, so that short
+// samples don't touch more memory than needed.
+//
+// Optionally the worker decodes the whole track into memory in the background
+// after loading it. Once finished all reads are served directly from this
+// buffer and the chunk cache is bypassed.
 class CachingReader : public QObject {
     Q_OBJECT
 
@@ -84,6 +118,12 @@ class CachingReader : public QObject {
     CachingReader(const QString& group,
             UserSettingsPointer _config,
             mixxx::audio::ChannelCount maxSupportedChannel);
+    // Construct a CachingReader with the given number of chunks instead
+    // of the number that is configured for the group.
+    CachingReader(const QString& group,
+            UserSettingsPointer _config,
+            mixxx::audio::ChannelCount maxSupportedChannel,
+            int numberOfCachedChunks);
     ~CachingReader() override;
 
     void process();
@@ -111,6 +151,9 @@ class CachingReader : public QObject {
     // that is not in the cache. If any hints do request a chunk not in cache,
     // then wake the reader so that it can process them. Must only be called
     // from the engine callback.
+    // Overlapping hints are coalesced and the number of chunks that are
+    // requested per call is limited. Missing chunks that exceed this limit
+    // are requested again by one of the next calls.
     void hintAndMaybeWake(const HintVector& hintList);
 
     // Request that the CachingReader load a new track. These requests are
@@ -162,12 +205,23 @@ class CachingReader : public QObject {
     // Returns all allocated chunks to the free list
     void freeAllChunks();
 
+    // Reads from the whole track that has been decoded into memory.
+    ReadResult readDecodedTrack(SINT startSample,
+            SINT numSamples,
+            bool reverse,
+            CSAMPLE* buffer,
+            mixxx::audio::ChannelCount channelCount);
+
     // Gets a chunk from the free list. Returns nullptr if none available.
     CachingReaderChunkForOwner* allocateChunk(SINT chunkIndex);
 
-    // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
+    // Gets a chunk from the free list, frees the LRU CachingReaderChunk with
+    // the lowest hint priority if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // Finds the chunk in the MRU/LRU list that should be evicted next.
+    CachingReaderChunkForOwner* findChunkToExpire() const;
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -179,8 +233,17 @@ class CachingReader : public QObject {
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
+    // The maximum number of chunks that may be in use for the current
+    // track, at most m_chunks.size().
+    int m_chunkBudget;
+
+    // Incremented on every call of hintAndMaybeWake() to identify
+    // the chunks that have been hinted recently.
+    unsigned int m_hintGeneration;
+
     // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
+    // and deletions. Iteration is not necessary. Used as a stack to reuse the
+    // memory of recently freed chunks.
     std::list<CachingReaderChunkForOwner*> m_freeChunks;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
@@ -197,5 +260,10 @@ class CachingReader : public QObject {
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The whole track if it has been decoded into memory by the worker,
+    // otherwise nullptr. Owned by the worker!
+    const CSAMPLE* m_pDecodedTrackSamples;
+    mixxx::IndexRange m_decodedTrackFrameIndexRange;
+
     CachingReaderWorker m_worker;
 };
@@ -1,6 +1,7 @@
 #include "engine/cachingreader/cachingreaderchunk.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "sources/audiosourcestereoproxy.h"
 #include "engine/engine.h"
@@ -131,6 +132,8 @@ CachingReaderChunkForOwner::CachingReaderChunkForOwner(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : CachingReaderChunk(std::move(sampleBuffer)),
           m_state(FREE),
+          m_hintPriority(0),
+          m_hintGeneration(0),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
@@ -144,6 +147,8 @@ void CachingReaderChunkForOwner::init(SINT index) {
 
     CachingReaderChunk::init(index);
     m_state = READY;
+    m_hintPriority = 0;
+    m_hintGeneration = 0;
 }
 
 void CachingReaderChunkForOwner::free() {
@@ -157,6 +162,29 @@ void CachingReaderChunkForOwner::free() {
     m_state = FREE;
 }
 
+bool CachingReaderChunkForOwner::updateHint(int priority, unsigned int generation) {
+    if (m_hintGeneration == generation) {
+        // Multiple hints may refer to the same chunk during a single
+        // callback, the most important one wins.
+        m_hintPriority = std::max(m_hintPriority, priority);
+        return false;
+    }
+    m_hintPriority = priority;
+    m_hintGeneration = generation;
+    return true;
+}
+
+int CachingReaderChunkForOwner::effectiveHintPriority(unsigned int generation) const {
+    // Chunks that have not been hinted during the current or the previous
+    // callback are no longer of any particular interest. The previous
+    // callback is included, because chunks are evicted while the hints of
+    // the current callback are still being processed.
+    if (generation - m_hintGeneration > 1) {
+        return 0;
+    }
+    return m_hintPriority;
+}
+
 void CachingReaderChunkForOwner::insertIntoListBefore(
         CachingReaderChunkForOwner** ppHead,
         CachingReaderChunkForOwner** ppTail,
@@ -113,6 +113,21 @@ public:
         return m_state;
   }
 
+    // The predecessor in the double-linked MRU/LRU list, i.e. the
+    // next more recently used chunk.
+    CachingReaderChunkForOwner* getPrev() const noexcept {
+        return m_pPrev;
+    }
+
+    // Records the priority of a hint that referred to this chunk during
+    // the callback with the given generation (see CachingReader). Returns
+    // true for the first hint during this callback and false if the chunk
+    // has already been hinted before.
+    bool updateHint(int priority, unsigned int generation);
+    // The priority of the most recent hint or 0 if this chunk has not
+    // been hinted recently.
+    int effectiveHintPriority(unsigned int generation) const;
+
     // The state is controlled by the cache as the owner of each chunk!
     void giveToWorker() {
         // Must not be referenced in MRU/LRU list!
@@ -146,6 +161,9 @@ public:
 private:
   State m_state;
 
+  int m_hintPriority;
+  unsigned int m_hintGeneration;
+
   CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
   CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
 };
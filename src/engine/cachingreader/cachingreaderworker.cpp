@@ -2,9 +2,11 @@
 
 #include <QAtomicInt>
 #include <QtDebug>
+#include <algorithm>
 
 #include "analyzer/analyzersilence.h"
 #include "moc_cachingreaderworker.cpp"
+#include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/compatibility/qmutex.h"
@@ -26,12 +28,18 @@ CachingReaderWorker::CachingReaderWorker(
         const QString& group,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
         FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
-        mixxx::audio::ChannelCount maxSupportedChannel)
+        mixxx::audio::ChannelCount maxSupportedChannel,
+        SINT maxWholeTrackSamples)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
           m_pReaderStatusFIFO(pReaderStatusFIFO),
-          m_maxSupportedChannel(maxSupportedChannel) {
+          m_maxSupportedChannel(maxSupportedChannel),
+          m_maxWholeTrackSamples(maxWholeTrackSamples),
+          m_decodingWholeTrack(false),
+          m_wholeTrackDecodeFrameIndex(0),
+          m_trackStatusUpdatesWritten(0),
+          m_trackStatusUpdatesProcessed(0) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
@@ -120,6 +128,7 @@ void CachingReaderWorker::run() {
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
+        freeRetiredWholeTrackBuffers();
         // Request is initialized by reading from FIFO
         CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable.loadAcquire()) {
@@ -150,6 +159,10 @@ void CachingReaderWorker::run() {
             // Read the requested chunk and send the result
             const ReaderStatusUpdate update = processReadRequest(request);
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        } else if (m_decodingWholeTrack) {
+            // Pending read requests have precedence, continue
+            // decoding the whole track only if idle
+            decodeWholeTrackStep();
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -166,9 +179,20 @@ void CachingReaderWorker::discardAllPendingRequests() {
     }
 }
 
+void CachingReaderWorker::writeTrackStatusUpdate(const ReaderStatusUpdate& update) {
+    DEBUG_ASSERT(update.status == TRACK_LOADED || update.status == TRACK_UNLOADED);
+    ++m_trackStatusUpdatesWritten;
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+}
+
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
+    // The engine might still read the decoded samples until it receives
+    // the next track status update
+    stopDecodingWholeTrack();
+    retireWholeTrackBuffer();
+
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
         m_pAudioSource->close();
@@ -183,8 +207,7 @@ void CachingReaderWorker::closeAudioSource() {
 void CachingReaderWorker::unloadTrack() {
     closeAudioSource();
 
-    const auto update = ReaderStatusUpdate::trackUnloaded();
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    writeTrackStatusUpdate(ReaderStatusUpdate::trackUnloaded());
 }
 
 #ifdef __STEM__
@@ -204,8 +227,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << m_group
                 << "File not found"
                 << pTrack->getFileInfo();
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackStatusUpdate(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be found.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -223,8 +245,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << m_group
                 << "Failed to open file"
                 << pTrack->getFileInfo();
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackStatusUpdate(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -238,8 +259,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             m_pAudioSource->getSignalInfo().getChannelCount() <=
                     m_maxSupportedChannel) {
         m_pAudioSource.reset(); // Close open file handles
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackStatusUpdate(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be loaded because it contains %2 "
                    "channels, and only 1 to %3 are supported.")
@@ -259,8 +279,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << m_group
                 << "Failed to open empty file"
                 << pTrack->getFileInfo();
-        const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeTrackStatusUpdate(ReaderStatusUpdate::trackUnloaded());
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' is empty and could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -275,10 +294,9 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
-    const auto update =
+    writeTrackStatusUpdate(
             ReaderStatusUpdate::trackLoaded(
-                    m_pAudioSource->frameIndexRange());
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+                    m_pAudioSource->frameIndexRange()));
 
     // Emit that the track is loaded.
 
@@ -299,6 +317,134 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
             m_pAudioSource->getSignalInfo().getSampleRate(),
             m_pAudioSource->getSignalInfo().getChannelCount(),
             mixxx::audio::FramePos(m_pAudioSource->frameLength()));
+
+    startDecodingWholeTrack();
+}
+
+void CachingReaderWorker::startDecodingWholeTrack() {
+    DEBUG_ASSERT(m_pAudioSource);
+    DEBUG_ASSERT(!m_decodingWholeTrack);
+    if (m_maxWholeTrackSamples <= 0) {
+        return;
+    }
+    // Same channel layout as in CachingReaderChunk::bufferSampleFrames()
+    const auto sourceChannelCount = m_pAudioSource->getSignalInfo().getChannelCount();
+    m_wholeTrackChannelCount =
+            sourceChannelCount % mixxx::audio::ChannelCount::stereo() != 0
+            ? mixxx::audio::ChannelCount::stereo()
+            : sourceChannelCount;
+    m_wholeTrackFrameIndexRange = m_pAudioSource->frameIndexRange();
+    const SINT wholeTrackSamples = CachingReaderChunk::frames2samples(
+            m_wholeTrackFrameIndexRange.length(),
+            m_wholeTrackChannelCount);
+    if (wholeTrackSamples > m_maxWholeTrackSamples) {
+        kLogger.info()
+                << m_group
+                << "Track is too long for decoding it into memory:"
+                << wholeTrackSamples
+                << ">"
+                << m_maxWholeTrackSamples
+                << "samples";
+        return;
+    }
+    mixxx::SampleBuffer(wholeTrackSamples).swap(m_wholeTrackBuffer);
+    if (m_wholeTrackBuffer.size() != wholeTrackSamples) {
+        kLogger.warning()
+                << m_group
+                << "Failed to allocate memory for decoding the whole track";
+        return;
+    }
+    m_wholeTrackDecodeFrameIndex = m_wholeTrackFrameIndexRange.start();
+    m_decodingWholeTrack = true;
+}
+
+void CachingReaderWorker::stopDecodingWholeTrack() {
+    m_decodingWholeTrack = false;
+    m_wholeTrackDecodeFrameIndex = 0;
+}
+
+void CachingReaderWorker::retireWholeTrackBuffer() {
+    if (m_wholeTrackBuffer.size() == 0) {
+        return;
+    }
+    // The next track status update is written after closing the
+    // audio source
+    m_retiredWholeTrackBuffers.push_back(RetiredWholeTrackBuffer{
+            m_trackStatusUpdatesWritten + 1,
+            std::move(m_wholeTrackBuffer)});
+    DEBUG_ASSERT(m_wholeTrackBuffer.size() == 0);
+}
+
+void CachingReaderWorker::freeRetiredWholeTrackBuffers() {
+    if (m_retiredWholeTrackBuffers.empty()) {
+        return;
+    }
+    const int trackStatusUpdatesProcessed = m_trackStatusUpdatesProcessed.loadAcquire();
+    m_retiredWholeTrackBuffers.erase(
+            std::remove_if(m_retiredWholeTrackBuffers.begin(),
+                    m_retiredWholeTrackBuffers.end(),
+                    [trackStatusUpdatesProcessed](const auto& retired) {
+                        return retired.trackStatusUpdates <= trackStatusUpdatesProcessed;
+                    }),
+            m_retiredWholeTrackBuffers.end());
+}
+
+void CachingReaderWorker::decodeWholeTrackStep() {
+    DEBUG_ASSERT(m_decodingWholeTrack);
+    DEBUG_ASSERT(m_pAudioSource);
+    const auto frameIndexRange = intersect(
+            mixxx::IndexRange::forward(
+                    m_wholeTrackDecodeFrameIndex,
+                    CachingReaderChunk::kFrames),
+            m_wholeTrackFrameIndexRange);
+    DEBUG_ASSERT(!frameIndexRange.empty());
+    auto writableSlice = mixxx::SampleBuffer::WritableSlice(
+            m_wholeTrackBuffer,
+            CachingReaderChunk::frames2samples(
+                    frameIndexRange.start() - m_wholeTrackFrameIndexRange.start(),
+                    m_wholeTrackChannelCount),
+            CachingReaderChunk::frames2samples(
+                    frameIndexRange.length(),
+                    m_wholeTrackChannelCount));
+    mixxx::ReadableSampleFrames decodedSampleFrames;
+    if (frameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange())) {
+        if (m_wholeTrackChannelCount != m_pAudioSource->getSignalInfo().getChannelCount()) {
+            mixxx::AudioSourceStereoProxy audioSourceProxy(
+                    m_pAudioSource,
+                    mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+            decodedSampleFrames = audioSourceProxy.readSampleFrames(
+                    mixxx::WritableSampleFrames(frameIndexRange, writableSlice));
+        } else {
+            decodedSampleFrames = m_pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(frameIndexRange, writableSlice));
+        }
+    }
+    // The readable range of the audio source shrinks on decoding errors.
+    // Only tracks that could be decoded completely are handed over.
+    if (decodedSampleFrames.frameIndexRange() != frameIndexRange) {
+        kLogger.warning()
+                << m_group
+                << "Failed to decode the whole track:"
+                << "expected =" << frameIndexRange
+                << ", actual =" << decodedSampleFrames.frameIndexRange();
+        stopDecodingWholeTrack();
+        // Not yet shared with the engine, safe to release
+        mixxx::SampleBuffer().swap(m_wholeTrackBuffer);
+        return;
+    }
+    m_wholeTrackDecodeFrameIndex = frameIndexRange.end();
+    if (m_wholeTrackDecodeFrameIndex < m_wholeTrackFrameIndexRange.end()) {
+        return;
+    }
+    stopDecodingWholeTrack();
+    kLogger.debug()
+            << m_group
+            << "Decoded the whole track into memory:"
+            << m_wholeTrackFrameIndexRange;
+    const auto update = ReaderStatusUpdate::trackDecoded(
+            m_wholeTrackBuffer.data(),
+            m_wholeTrackFrameIndexRange);
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
 }
 
 void CachingReaderWorker::quitWait() {
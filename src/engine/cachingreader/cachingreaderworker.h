@@ -2,6 +2,7 @@
 
 #include <QMutex>
 #include <QString>
+#include <vector>
 
 #include "audio/frame.h"
 #include "audio/types.h"
@@ -27,6 +28,8 @@ typedef struct CachingReaderChunkReadRequest {
 enum ReaderStatus {
     TRACK_LOADED,
     TRACK_UNLOADED,
+    TRACK_DECODED, // response without chunk, but with the decoded samples
+
     CHUNK_READ_SUCCESS,
     CHUNK_READ_EOF,
     CHUNK_READ_INVALID,
@@ -37,6 +40,7 @@ enum ReaderStatus {
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
+    const CSAMPLE* samples;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
 
@@ -49,6 +53,7 @@ typedef struct ReaderStatusUpdate {
             const mixxx::IndexRange& readableFrameIndexRangeArg) {
         status = statusArg;
         chunk = chunkArg;
+        samples = nullptr;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
     }
@@ -74,6 +79,20 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    // The samples remain owned by the worker and stay valid until the
+    // engine has processed the next TRACK_LOADED or TRACK_UNLOADED update
+    // and reported it with CachingReaderWorker::trackStatusProcessed().
+    static ReaderStatusUpdate trackDecoded(
+            const CSAMPLE* decodedSamples,
+            const mixxx::IndexRange& decodedFrameIndexRange) {
+        DEBUG_ASSERT(decodedSamples);
+        DEBUG_ASSERT(!decodedFrameIndexRange.empty());
+        ReaderStatusUpdate update;
+        update.init(TRACK_DECODED, nullptr, decodedFrameIndexRange);
+        update.samples = decodedSamples;
+        return update;
+    }
+
     CachingReaderChunkForOwner* takeFromWorker() {
         CachingReaderChunkForOwner* pChunk = nullptr;
         if (chunk) {
@@ -85,6 +104,10 @@ typedef struct ReaderStatusUpdate {
         return pChunk;
     }
 
+    const CSAMPLE* decodedSamples() const {
+        return samples;
+    }
+
     mixxx::IndexRange readableFrameIndexRange() const {
         return mixxx::IndexRange::between(
                 readableFrameIndexRangeStart,
@@ -96,11 +119,14 @@ class CachingReaderWorker : public EngineWorker {
     Q_OBJECT
 
   public:
-    // Construct a CachingReader with the given group.
+    // Construct a CachingReader with the given group. If maxWholeTrackSamples
+    // is not 0 all tracks that fit into this number of samples are decoded
+    // into memory in the background after they have been loaded.
     CachingReaderWorker(const QString& group,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
             FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
-            mixxx::audio::ChannelCount maxSupportedChannel);
+            mixxx::audio::ChannelCount maxSupportedChannel,
+            SINT maxWholeTrackSamples = 0);
     ~CachingReaderWorker() override = default;
 
     // Request to load a new track. wake() must be called afterwards.
@@ -116,6 +142,13 @@ class CachingReaderWorker : public EngineWorker {
 
     void quitWait();
 
+    // Called by the engine after processing a TRACK_LOADED or
+    // TRACK_UNLOADED status update. The engine no longer accesses
+    // the decoded samples of the previous track afterwards.
+    void trackStatusProcessed() {
+        m_trackStatusUpdatesProcessed.fetchAndAddRelease(1);
+    }
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -152,6 +185,9 @@ class CachingReaderWorker : public EngineWorker {
 
     void discardAllPendingRequests();
 
+    /// Sends a TRACK_LOADED or TRACK_UNLOADED status update
+    void writeTrackStatusUpdate(const ReaderStatusUpdate& update);
+
     /// call to be prepare for new tracks
     /// Make sure engine has been stopped before
     void closeAudioSource();
@@ -170,6 +206,20 @@ class CachingReaderWorker : public EngineWorker {
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    /// Prepares decoding of the whole track if enabled and if
+    /// the track is not too long
+    void startDecodingWholeTrack();
+    /// Decodes the next part of the whole track and hands over the decoded
+    /// samples to the cache when finished
+    void decodeWholeTrackStep();
+    void stopDecodingWholeTrack();
+    /// Keeps the decoded samples of the current track alive until the
+    /// engine has released them
+    void retireWholeTrackBuffer();
+    /// Frees the decoded samples of previous tracks that are no longer
+    /// accessed by the engine
+    void freeRetiredWholeTrackBuffers();
+
     void verifyFirstSound(const CachingReaderChunk* pChunk,
             mixxx::audio::ChannelCount channelCount);
 
@@ -185,5 +235,29 @@ class CachingReaderWorker : public EngineWorker {
     // The maximum number of channel that this reader can support
     mixxx::audio::ChannelCount m_maxSupportedChannel;
 
+    // The whole track decoded into memory. The buffer is shared with the
+    // cache after decoding has finished. When loading or unloading a track
+    // the engine might still read from it until it has processed the
+    // following TRACK_LOADED or TRACK_UNLOADED status update, so it is
+    // retired instead of released immediately.
+    const SINT m_maxWholeTrackSamples;
+    mixxx::SampleBuffer m_wholeTrackBuffer;
+    mixxx::audio::ChannelCount m_wholeTrackChannelCount;
+    mixxx::IndexRange m_wholeTrackFrameIndexRange;
+    bool m_decodingWholeTrack;
+    // The frame index of the next frame to be decoded
+    SINT m_wholeTrackDecodeFrameIndex;
+
+    struct RetiredWholeTrackBuffer {
+        // The number of TRACK_LOADED/TRACK_UNLOADED status updates that
+        // must have been processed by the engine before releasing the buffer
+        int trackStatusUpdates;
+        mixxx::SampleBuffer buffer;
+    };
+    std::vector<RetiredWholeTrackBuffer> m_retiredWholeTrackBuffers;
+    // Only accessed by the worker
+    int m_trackStatusUpdatesWritten;
+    QAtomicInt m_trackStatusUpdatesProcessed;
+
     QAtomicInt m_stop;
 };
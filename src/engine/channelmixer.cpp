@@ -4,6 +4,26 @@
 #include "util/sample.h"
 #include "util/timer.h"
 
+// static
+EngineMixer::GainRamp ChannelMixer::updateGain(
+        const EngineMixer::GainCalculator& gainCalculator,
+        EngineMixer::ChannelInfo* pChannelInfo,
+        EngineMixer::GainCache* pGainCache) {
+    EngineMixer::GainRamp gainRamp;
+    gainRamp.m_oldGain = pGainCache->m_gain;
+    gainRamp.m_fadeout = pGainCache->m_fadeout ||
+            (pChannelInfo->m_pChannel &&
+                    !pChannelInfo->m_pChannel->isActive());
+    if (gainRamp.m_fadeout) {
+        gainRamp.m_newGain = 0;
+        pGainCache->m_fadeout = false;
+    } else {
+        gainRamp.m_newGain = gainCalculator.getGain(pChannelInfo);
+    }
+    pGainCache->m_gain = gainRamp.m_newGain;
+    return gainRamp;
+}
+
 // static
 void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator& gainCalculator,
         const QVarLengthArray<EngineMixer::ChannelInfo*, kPreallocatedChannels>& activeChannels,
@@ -25,19 +45,9 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
     SampleUtil::clear(pOutput, bufferSize);
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsAndMixChannels"));
     for (auto* pChannelInfo : activeChannels) {
-        EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
-        CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
-        }
-        gainCache.m_gain = newGain;
+        const EngineMixer::GainRamp gainRamp = updateGain(gainCalculator,
+                pChannelInfo,
+                &(*channelGainCache)[pChannelInfo->m_index]);
         pEngineEffectsManager->processPostFaderAndMix(pChannelInfo->m_handle,
                 outputHandle,
                 pChannelInfo->m_pBuffer.data(),
@@ -45,9 +55,9 @@ void ChannelMixer::applyEffectsAndMixChannels(const EngineMixer::GainCalculator&
                 bufferSize,
                 sampleRate,
                 pChannelInfo->m_features,
-                oldGain,
-                newGain,
-                fadeout);
+                gainRamp.m_oldGain,
+                gainRamp.m_newGain,
+                gainRamp.m_fadeout);
     }
 }
 
@@ -71,28 +81,18 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsInPlaceAndMixChannels"));
     SampleUtil::clear(pOutput, bufferSize);
     for (auto* pChannelInfo : activeChannels) {
-        EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
-        CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
-        }
-        gainCache.m_gain = newGain;
+        const EngineMixer::GainRamp gainRamp = updateGain(gainCalculator,
+                pChannelInfo,
+                &(*channelGainCache)[pChannelInfo->m_index]);
         pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
                 outputHandle,
                 pChannelInfo->m_pBuffer.data(),
                 bufferSize,
                 sampleRate,
                 pChannelInfo->m_features,
-                oldGain,
-                newGain,
-                fadeout);
+                gainRamp.m_oldGain,
+                gainRamp.m_newGain,
+                gainRamp.m_fadeout);
         SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), bufferSize);
     }
 }
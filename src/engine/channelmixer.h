@@ -8,6 +8,13 @@
 
 class ChannelMixer {
   public:
+    // Calculates the gain of a channel for the current callback, starting
+    // from the gain of the previous callback in pGainCache, and updates it.
+    static EngineMixer::GainRamp updateGain(
+            const EngineMixer::GainCalculator& gainCalculator,
+            EngineMixer::ChannelInfo* pChannelInfo,
+            EngineMixer::GainCache* pGainCache);
+
     // This does not modify the input channel buffers. All manipulation of the input
     // channel buffers is done after copying to a temporary buffer, then they are mixed
     // to make the output buffer.
@@ -11,6 +11,11 @@ namespace {
 // Used during initialization where the SoundSevice is not set up
 constexpr auto kInitalSampleRate = mixxx::audio::SampleRate(96000);
 
+// The longest time an effect may stay silent before its tail continues,
+// like the gap between the repetitions of the Echo with its maximum delay
+// of 3 s. Effects are only skipped when they have been silent for longer.
+constexpr double kIdleAfterSeconds = 4.0;
+
 } // namespace
 
 EngineEffect::EngineEffect(EffectManifestPointer pManifest,
@@ -31,10 +36,13 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
 
     for (const ChannelHandleAndGroup& inputChannel : registeredInputChannels) {
         ChannelHandleMap<EffectEnableState> outputChannelMap;
+        ChannelHandleMap<SINT> framesSinceActiveMap;
         for (const ChannelHandleAndGroup& outputChannel : registeredOutputChannels) {
             outputChannelMap.insert(outputChannel.handle(), EffectEnableState::Disabled);
+            framesSinceActiveMap.insert(outputChannel.handle(), 0);
         }
         m_effectEnableStateForChannelMatrix.insert(inputChannel.handle(), outputChannelMap);
+        m_framesSinceActiveForChannelMatrix.insert(inputChannel.handle(), framesSinceActiveMap);
     }
 
     m_pProcessor->loadEngineEffectParameters(m_parametersById);
@@ -53,6 +61,18 @@ EngineEffect::~EngineEffect() {
     }
 }
 
+void EngineEffect::cancelPendingParameterValues() {
+    for (const auto& pParameter : std::as_const(m_parameters)) {
+        pParameter->cancelPendingValue();
+    }
+}
+
+void EngineEffect::applyPendingParameterValues() {
+    for (const auto& pParameter : std::as_const(m_parameters)) {
+        pParameter->applyPendingValue();
+    }
+}
+
 void EngineEffect::initalizeInputChannel(ChannelHandle inputChannel) {
     if (m_pProcessor->hasStatesForInputChannel(inputChannel)) {
         // already initialized for this input channel
@@ -96,6 +116,10 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
             }
         }
 
+        // All parameter values that have been staged together with the
+        // enable state are applied with this single request.
+        applyPendingParameterValues();
+
         response.success = true;
         pResponsePipe->writeMessage(response);
         return true;
@@ -103,13 +127,14 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
     case EffectsRequest::SET_PARAMETER_PARAMETERS:
         if (kEffectDebugOutput) {
             qDebug() << debugString() << "SET_PARAMETER_PARAMETERS"
-                     << "parameter" << message.SetParameterParameters.iParameter
-                     << "value" << message.value;
+                     << "parameter" << message.SetParameterParameters.iParameter;
         }
         pParameter = m_parameters.value(
                 message.SetParameterParameters.iParameter, EngineEffectParameterPointer());
         if (pParameter) {
-            pParameter->setValue(message.value);
+            // The value might have been applied already by a preceding
+            // SET_EFFECT_PARAMETERS request, which is fine.
+            pParameter->applyPendingValue();
             response.success = true;
         } else {
             response.success = false;
@@ -123,6 +148,31 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
     return false;
 }
 
+bool EngineEffect::isIdle(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        const mixxx::audio::SampleRate sampleRate) {
+    // Intermediate enabling/disabling signals must always reach the
+    // EffectProcessor.
+    if (m_effectEnableStateForChannelMatrix[inputHandle][outputHandle] !=
+            EffectEnableState::Enabled) {
+        return false;
+    }
+    return m_framesSinceActiveForChannelMatrix[inputHandle][outputHandle] >=
+            kIdleAfterSeconds * sampleRate.toDouble();
+}
+
+void EngineEffect::updateActivity(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        bool active,
+        SINT numFrames) {
+    SINT& framesSinceActive = m_framesSinceActiveForChannelMatrix[inputHandle][outputHandle];
+    if (active) {
+        framesSinceActive = 0;
+    } else {
+        framesSinceActive += numFrames;
+    }
+}
+
 bool EngineEffect::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         const CSAMPLE* pInput,
@@ -32,6 +32,16 @@ class EngineEffect final : public EffectsRequestHandler {
     /// Called from the main thread to make sure that the channel already has states
     void initalizeInputChannel(ChannelHandle inputChannel);
 
+    /// Called from the main thread to stage parameter values, see
+    /// EngineEffectParameter::setPendingValue()
+    EngineEffectParameter* parameter(int index) const {
+        return m_parameters.value(index).data();
+    }
+
+    /// Called from the main thread if the request that applies the staged
+    /// parameter values could not be sent.
+    void cancelPendingParameterValues();
+
     /// Called in audio thread
     bool processEffectsRequest(
             EffectsRequest& message,
@@ -47,6 +57,22 @@ class EngineEffect final : public EffectsRequestHandler {
             const EffectEnableState chainEnableState,
             const GroupFeatureState& groupFeatures);
 
+    /// Called in audio thread. Whether the effect is enabled for the channel,
+    /// but has neither received nor produced a signal for so long, that its
+    /// tail, like echoes or reverberation, has rung out. Processing it with
+    /// a silent input would only produce silence.
+    bool isIdle(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            const mixxx::audio::SampleRate sampleRate);
+
+    /// Called in audio thread after process() has processed the channel.
+    /// The effect was active if either its input or its output was not
+    /// silent.
+    void updateActivity(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            bool active,
+            SINT numFrames);
+
     const EffectManifestPointer getManifest() const {
         return m_pManifest;
     }
@@ -64,9 +90,13 @@ class EngineEffect final : public EffectsRequestHandler {
         return QString("EngineEffect(%1)").arg(m_pManifest->name());
     }
 
+    void applyPendingParameterValues();
+
     EffectManifestPointer m_pManifest;
     std::unique_ptr<EffectProcessor> m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
+    // The time since the effect was last active, see updateActivity()
+    ChannelHandleMap<ChannelHandleMap<SINT>> m_framesSinceActiveForChannelMatrix;
     bool m_effectRampsFromDry;
     // Must not be modified after construction.
     QVector<EngineEffectParameterPointer> m_parameters;
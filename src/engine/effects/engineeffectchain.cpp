@@ -1,18 +1,36 @@
 #include "engine/effects/engineeffectchain.h"
 
+#include "control/controlobject.h"
 #include "engine/effects/engineeffect.h"
+#include "engine/engine.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 
+namespace {
+
+// -100 dBFS, far below the noise floor of any recording
+constexpr CSAMPLE kSilenceThreshold = 0.00001f;
+
+bool isSilent(const CSAMPLE* pBuffer, std::size_t numSamples) {
+    return SampleUtil::maxAbsAmplitude(pBuffer, static_cast<SINT>(numSamples)) <
+            kSilenceThreshold;
+}
+
+} // anonymous namespace
+
 EngineEffectChain::EngineEffectChain(const QString& group,
         const QSet<ChannelHandleAndGroup>& registeredInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_group(group),
           m_enableState(EffectEnableState::Enabled),
+          m_enableStateProcessed(true),
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
           m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_buffer2(kMaxEngineSamples),
+          m_pCpuUsage(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cpu_usage")))) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
@@ -79,10 +97,19 @@ bool EngineEffectChain::updateParameters(const EffectsRequest& message) {
     m_mixMode = message.SetEffectChainParameters.mix_mode;
     m_dMix = static_cast<CSAMPLE>(message.SetEffectChainParameters.mix);
 
-    if (m_enableState != EffectEnableState::Disabled && !message.SetEffectParameters.enabled) {
+    // The chain can be switched again before the intermediate state has
+    // been processed, then the effects get the latest one.
+    const bool enabled = message.SetEffectChainParameters.enabled;
+    if (!enabled &&
+            (m_enableState == EffectEnableState::Enabled ||
+                    m_enableState == EffectEnableState::Enabling)) {
         m_enableState = EffectEnableState::Disabling;
-    } else if (m_enableState == EffectEnableState::Disabled && message.SetEffectParameters.enabled) {
+        m_enableStateProcessed = false;
+    } else if (enabled &&
+            (m_enableState == EffectEnableState::Disabled ||
+                    m_enableState == EffectEnableState::Disabling)) {
         m_enableState = EffectEnableState::Enabling;
+        m_enableStateProcessed = false;
     }
     return true;
 }
@@ -153,6 +180,8 @@ bool EngineEffectChain::enableForInputChannel(ChannelHandle inputHandle) {
     for (auto&& outputChannelStatus : outputMap) {
         DEBUG_ASSERT(outputChannelStatus.enableState != EffectEnableState::Enabled);
         outputChannelStatus.enableState = EffectEnableState::Enabling;
+        // Disabled channels are not processed, start with the current mix
+        outputChannelStatus.oldMixKnob = m_dMix;
     }
     return true;
 }
@@ -171,6 +200,60 @@ bool EngineEffectChain::disableForInputChannel(ChannelHandle inputHandle) {
     return true;
 }
 
+void EngineEffectChain::onCallbackStart() {
+    // The intermediate enabling/disabling state of the chain is kept for a
+    // whole callback, so all channels that are processed by this chain get
+    // the same signal regardless of the order they are processed in.
+    if (!m_enableStateProcessed) {
+        if (isEnabledForAnyChannel()) {
+            return;
+        }
+        // The chain is not processed at all, so there are no effects that
+        // need to get the intermediate state. Channels that are enabled
+        // later start with the Enabling state on their own.
+        m_enableStateProcessed = true;
+    }
+    if (m_enableState == EffectEnableState::Disabling) {
+        m_enableState = EffectEnableState::Disabled;
+    } else if (m_enableState == EffectEnableState::Enabling) {
+        m_enableState = EffectEnableState::Enabled;
+    }
+}
+
+void EngineEffectChain::updateCpuUsage(mixxx::Duration interval) {
+    VERIFY_OR_DEBUG_ASSERT(interval > mixxx::Duration()) {
+        return;
+    }
+    m_pCpuUsage->set(m_processTime.toDoubleSeconds() / interval.toDoubleSeconds());
+    m_processTime = mixxx::Duration();
+}
+
+bool EngineEffectChain::isEnabledForChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    // Only the registered channels are contained in the matrix, e.g. stems
+    // are only processed by their own quick effect chain.
+    if (!inputHandle.valid() ||
+            inputHandle.handle() >= m_chainStatusForChannelMatrix.size()) {
+        return false;
+    }
+    const auto& outputMap = m_chainStatusForChannelMatrix.at(inputHandle);
+    if (!outputHandle.valid() || outputHandle.handle() >= outputMap.size()) {
+        return false;
+    }
+    return outputMap.at(outputHandle).enableState != EffectEnableState::Disabled;
+}
+
+bool EngineEffectChain::isEnabledForAnyChannel() const {
+    for (const auto& outputMap : m_chainStatusForChannelMatrix) {
+        for (const auto& outputChannelStatus : outputMap) {
+            if (outputChannelStatus.enableState != EffectEnableState::Disabled) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -181,6 +264,9 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         bool fadeout) {
     DEBUG_ASSERT(numSamples <= kMaxEngineSamples);
 
+    PerformanceTimer timer;
+    timer.start();
+
     // Compute the effective enable state from the channel input routing switch and
     // the chain's enable state. When either of these are turned on/off, send the
     // effects the intermediate enabling/disabling signal.
@@ -211,6 +297,24 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
     CSAMPLE currentMixKnob = m_dMix;
     CSAMPLE lastCallbackMixKnob = channelStatus.oldMixKnob;
 
+    // In both mix modes the output is the dry input if the mix knob is at
+    // zero, so the effects are disabled until it is turned up again. This
+    // sends them the intermediate signals, so the effects are flushed and
+    // don't replay an old tail when they continue.
+    if (effectiveChainEnableState != EffectEnableState::Disabled) {
+        if (currentMixKnob == 0 && lastCallbackMixKnob == 0) {
+            effectiveChainEnableState = channelStatus.bypassedAtZeroMix
+                    ? EffectEnableState::Disabled
+                    : EffectEnableState::Disabling;
+            channelStatus.bypassedAtZeroMix = true;
+        } else if (channelStatus.bypassedAtZeroMix) {
+            if (effectiveChainEnableState == EffectEnableState::Enabled) {
+                effectiveChainEnableState = EffectEnableState::Enabling;
+            }
+            channelStatus.bypassedAtZeroMix = false;
+        }
+    }
+
     bool processingOccured = false;
     if (effectiveChainEnableState != EffectEnableState::Disabled) {
         // Ramping code inside the effects need to access the original samples
@@ -221,9 +325,24 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         CSAMPLE* pIntermediateOutput;
         SINT effectChainGroupDelayFrames = 0;
         bool firstAddDryToWetEffectProcessed = false;
+        const auto numFrames = static_cast<SINT>(numSamples) / mixxx::kEngineChannelOutputCount;
+        // Idle effects are only skipped in the fully enabled state, the
+        // intermediate signals always reach them.
+        const bool skipIdleEffects = effectiveChainEnableState == EffectEnableState::Enabled;
+        // Whether pIntermediateInput is silent
+        bool intermediateInputSilent = skipIdleEffects && isSilent(pIntermediateInput, numSamples);
 
         for (EngineEffect* pEffect : std::as_const(m_effects)) {
             if (pEffect != nullptr) {
+                if (intermediateInputSilent &&
+                        pEffect->isIdle(inputHandle, outputHandle, sampleRate)) {
+                    // Its output would be silent as well. Keep the latency
+                    // constant, it will be processed again with the next
+                    // signal.
+                    effectChainGroupDelayFrames += pEffect->getGroupDelayFrames();
+                    continue;
+                }
+
                 // Select an unused intermediate buffer for the next output
                 if (pIntermediateInput == m_buffer1.data()) {
                     pIntermediateOutput = m_buffer2.data();
@@ -265,6 +384,16 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                     processingOccured = true;
                     effectChainGroupDelayFrames += pEffect->getGroupDelayFrames();
 
+                    // The intermediate signals restart the tail, so they
+                    // count as activity.
+                    bool active = true;
+                    if (skipIdleEffects) {
+                        const bool outputSilent = isSilent(pIntermediateOutput, numSamples);
+                        active = !intermediateInputSilent || !outputSilent;
+                        intermediateInputSilent = outputSilent;
+                    }
+                    pEffect->updateActivity(inputHandle, outputHandle, active, numFrames);
+
                     // Output of this effect becomes the input of the next effect
                     pIntermediateInput = pIntermediateOutput;
                 }
@@ -320,11 +449,8 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         channelStatus.enableState = EffectEnableState::Enabling;
     }
 
-    if (m_enableState == EffectEnableState::Disabling) {
-        m_enableState = EffectEnableState::Disabled;
-    } else if (m_enableState == EffectEnableState::Enabling) {
-        m_enableState = EffectEnableState::Enabled;
-    }
+    m_enableStateProcessed = true;
+    m_processTime += timer.elapsed();
 
     return processingOccured;
 }
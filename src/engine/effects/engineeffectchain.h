@@ -1,16 +1,21 @@
 #pragma once
 
+#include <gtest/gtest_prod.h>
+
 #include <QList>
 #include <QString>
+#include <memory>
 
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/engineeffectsdelay.h"
 #include "engine/effects/message.h"
 #include "util/class.h"
+#include "util/duration.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
 
+class ControlObject;
 class EngineEffect;
 
 /// EngineEffectChain is the audio thread counterpart of EffectChain.
@@ -21,6 +26,15 @@ class EngineEffect;
 /// EngineEffectChain processes a list of EngineEffects in series.
 /// EngineEffectChain manages the input channel routing switches,
 /// the mix knob, and the chain enable switch.
+///
+/// Idle chains are cheap: While the mix knob is settled at zero the effects
+/// are not processed at all. Effects that get a silent input are skipped
+/// once their tail has rung out, see EngineEffect::isIdle().
+///
+/// A chain is not thread-safe. Chains that are enabled for different
+/// channels must not be processed concurrently, see isEnabledForChannel().
+/// Chains that are only enabled for a single channel, like the quick
+/// effect chains, are processed in parallel with the other channels.
 class EngineEffectChain final : public EffectsRequestHandler {
   public:
     /// called from main thread
@@ -35,7 +49,20 @@ class EngineEffectChain final : public EffectsRequestHandler {
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
 
-    /// called from audio thread
+    /// called from audio thread before any chain is processed
+    void onCallbackStart();
+
+    /// called from audio thread before any chain is processed. Publishes
+    /// the share of the interval that was spent processing this chain.
+    void updateCpuUsage(mixxx::Duration interval);
+
+    /// called from audio thread. Only the channels for which the chain is
+    /// enabled need to be processed, the chain doesn't access any state
+    /// while checking this.
+    bool isEnabledForChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
+
+    /// called from audio thread, possibly concurrently with other chains
     bool process(const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
             CSAMPLE* pIn,
@@ -49,10 +76,14 @@ class EngineEffectChain final : public EffectsRequestHandler {
     struct ChannelStatus {
         ChannelStatus()
                 : oldMixKnob(0),
-                  enableState(EffectEnableState::Disabled) {
+                  enableState(EffectEnableState::Disabled),
+                  bypassedAtZeroMix(false) {
         }
         CSAMPLE oldMixKnob;
         EffectEnableState enableState;
+        // The effects have been disabled, because the mix knob has settled
+        // at zero. They are enabled again when the knob is turned up.
+        bool bypassedAtZeroMix;
     };
 
     QString debugString() const {
@@ -64,9 +95,12 @@ class EngineEffectChain final : public EffectsRequestHandler {
     bool removeEffect(EngineEffect* pEffect, int iIndex);
     bool enableForInputChannel(ChannelHandle inputHandle);
     bool disableForInputChannel(ChannelHandle inputHandle);
+    bool isEnabledForAnyChannel() const;
 
     QString m_group;
     EffectEnableState m_enableState;
+    // Whether the effects have received m_enableState since it has changed
+    bool m_enableStateProcessed;
     EffectChainMixMode::Type m_mixMode;
     CSAMPLE m_dMix;
     QList<EngineEffect*> m_effects;
@@ -75,5 +109,11 @@ class EngineEffectChain final : public EffectsRequestHandler {
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
     EngineEffectsDelay m_effectsDelay;
 
+    mixxx::Duration m_processTime;
+    std::unique_ptr<ControlObject> m_pCpuUsage;
+
+    FRIEND_TEST(EngineEffectChainTest, toggleWithoutRoutedChannel);
+    FRIEND_TEST(EngineEffectChainTest, toggleBeforeProcessing);
+
     DISALLOW_COPY_AND_ASSIGN(EngineEffectChain);
 };
@@ -2,6 +2,7 @@
 
 #include <QString>
 #include <QVariant>
+#include <atomic>
 
 #include "effects/backends/effectmanifestparameter.h"
 #include "util/class.h"
@@ -9,7 +10,9 @@
 class EngineEffectParameter {
   public:
     EngineEffectParameter(EffectManifestParameterPointer pParameterManifest)
-            : m_pParameterManifest(pParameterManifest) {
+            : m_pParameterManifest(pParameterManifest),
+              m_pendingValue(0.0),
+              m_updatePending(false) {
         m_value = m_pParameterManifest->getDefault();
     }
     virtual ~EngineEffectParameter() {
@@ -31,6 +34,29 @@ class EngineEffectParameter {
         }
         m_value = value;
     }
+
+    /// Called from the main thread. Stores a value that is picked up by the
+    /// next applyPendingValue() in the audio thread. Returns false if an
+    /// earlier value is still pending, in which case that update is
+    /// replaced and the audio thread does not need to be notified again.
+    bool setPendingValue(const double value) {
+        m_pendingValue.store(value, std::memory_order_relaxed);
+        return !m_updatePending.exchange(true, std::memory_order_acq_rel);
+    }
+    /// Called from the main thread if the audio thread could not be notified
+    /// about a pending value.
+    void cancelPendingValue() {
+        m_updatePending.store(false, std::memory_order_release);
+    }
+    /// Called from the audio thread. Returns false if no value was pending.
+    bool applyPendingValue() {
+        if (!m_updatePending.exchange(false, std::memory_order_acq_rel)) {
+            return false;
+        }
+        setValue(m_pendingValue.load(std::memory_order_relaxed));
+        return true;
+    }
+
     inline int toInt() const {
         return static_cast<int>(m_value);
     }
@@ -41,6 +67,9 @@ class EngineEffectParameter {
   private:
     EffectManifestParameterPointer m_pParameterManifest;
     double m_value;
+    // Last write wins, see setPendingValue()
+    std::atomic<double> m_pendingValue;
+    std::atomic<bool> m_updatePending;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectParameter);
 };
@@ -5,6 +5,16 @@
 #include "engine/effects/engineeffectchain.h"
 #include "util/defs.h"
 #include "util/sample.h"
+#include "util/time.h"
+
+namespace {
+
+// in 1/s, fits to the audio latency usage
+constexpr int kCpuUsageUpdateRate = 30;
+constexpr auto kCpuUsageUpdateInterval =
+        mixxx::Duration::fromNanos(1000000000 / kCpuUsageUpdateRate);
+
+} // anonymous namespace
 
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe&& responsePipe)
         : m_responsePipe(std::move(responsePipe)),
@@ -15,6 +25,24 @@ EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe&& responsePipe)
 }
 
 void EngineEffectsManager::onCallbackStart() {
+    const mixxx::Duration now = mixxx::Time::elapsed();
+    const mixxx::Duration cpuUsageInterval = now - m_lastCpuUsageUpdate;
+    const bool updateCpuUsage = cpuUsageInterval >= kCpuUsageUpdateInterval;
+    if (updateCpuUsage) {
+        m_lastCpuUsageUpdate = now;
+    }
+    for (const auto& chains : std::as_const(m_chainsByStage)) {
+        for (EngineEffectChain* pChain : chains) {
+            if (!pChain) {
+                continue;
+            }
+            pChain->onCallbackStart();
+            if (updateCpuUsage) {
+                pChain->updateCpuUsage(cpuUsageInterval);
+            }
+        }
+    }
+
     EffectsRequest* request = nullptr;
     while (m_responsePipe.readMessage(&request)) {
         EffectsResponse response(*request);
@@ -92,6 +120,21 @@ void EngineEffectsManager::onCallbackStart() {
     }
 }
 
+bool EngineEffectsManager::sharesEffectChain(SignalProcessingStage stage,
+        const ChannelHandle& inputHandle1,
+        const ChannelHandle& inputHandle2,
+        const ChannelHandle& outputHandle) const {
+    const QList<EngineEffectChain*>& chains = m_chainsByStage.value(stage);
+    for (const EngineEffectChain* pChain : chains) {
+        if (pChain &&
+                pChain->isEnabledForChannel(inputHandle1, outputHandle) &&
+                pChain->isEnabledForChannel(inputHandle2, outputHandle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pInOut,
@@ -169,6 +212,9 @@ void EngineEffectsManager::processInner(
         CSAMPLE_GAIN oldGain,
         CSAMPLE_GAIN newGain,
         bool fadeout) {
+    // EngineMixer may process channels concurrently, but never two channels
+    // that share a chain. The chains that are disabled for this channel must
+    // not be touched, they might be processed by another thread.
     const QList<EngineEffectChain*>& chains = m_chainsByStage.value(stage);
 
     if (pIn == pOut) {
@@ -176,7 +222,7 @@ void EngineEffectsManager::processInner(
         // modifying the original input buffer
         SampleUtil::applyRampingGain(pIn, oldGain, newGain, numSamples);
         for (EngineEffectChain* pChain : chains) {
-            if (pChain) {
+            if (pChain && pChain->isEnabledForChannel(inputHandle, outputHandle)) {
                 if (pChain->process(inputHandle,
                             outputHandle,
                             pIn,
@@ -207,7 +253,7 @@ void EngineEffectsManager::processInner(
 
         CSAMPLE* pIntermediateOutput;
         for (EngineEffectChain* pChain : chains) {
-            if (pChain) {
+            if (pChain && pChain->isEnabledForChannel(inputHandle, outputHandle)) {
                 // Select an unused intermediate buffer for the next output
                 if (pIntermediateInput == m_buffer1.data()) {
                     pIntermediateOutput = m_buffer2.data();
@@ -3,6 +3,7 @@
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
+#include "util/duration.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
 
@@ -26,8 +27,16 @@ class EngineEffectsManager final : public EffectsRequestHandler {
 
     void onCallbackStart();
 
+    /// Whether an EngineEffectChain of the stage is enabled for both input
+    /// channels. These channels must not be processed concurrently.
+    bool sharesEffectChain(SignalProcessingStage stage,
+            const ChannelHandle& inputHandle1,
+            const ChannelHandle& inputHandle2,
+            const ChannelHandle& outputHandle) const;
+
     /// Process the prefader EngineEffectChains on the pInOut buffer, modifying
-    /// the contents of the input buffer.
+    /// the contents of the input buffer. May be called concurrently for
+    /// channels that don't share an effect chain.
     void processPreFaderInPlace(
             const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
@@ -36,7 +45,8 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             mixxx::audio::SampleRate sampleRate);
 
     /// Process the postfader EngineEffectChains on the pInOut buffer, modifying
-    /// the contents of the input buffer.
+    /// the contents of the input buffer. May be called concurrently for
+    /// channels that don't share an effect chain.
     void processPostFaderInPlace(
             const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
@@ -53,6 +63,7 @@ class EngineEffectsManager final : public EffectsRequestHandler {
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
     /// buffer for every channel, which would potentially require allocation on the
     /// audio thread because ChannelMixer supports an arbitrary number of channels.
+    /// Must not be called concurrently, because the temporary buffers are shared.
     void processPostFaderAndMix(
             const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
@@ -102,4 +113,6 @@ class EngineEffectsManager final : public EffectsRequestHandler {
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    mixxx::Duration m_lastCpuUsageUpdate;
 };
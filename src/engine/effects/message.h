@@ -38,8 +38,7 @@ struct EffectsRequest {
     // they initialize all the values of the struct corresponding to the type they select.
     EffectsRequest()
             : type(NUM_REQUEST_TYPES),
-              request_id(-1),
-              value(0.0) {
+              request_id(-1) {
         pTargetChain = nullptr;
         pTargetEffect = nullptr;
     }
@@ -93,13 +92,13 @@ struct EffectsRequest {
         struct {
             bool enabled;
         } SetEffectParameters;
+        // The value is not part of the message. It is staged in the
+        // EngineEffectParameter, so that all updates of a parameter until
+        // the next callback are coalesced into a single request.
         struct {
             int iParameter;
         } SetParameterParameters;
     };
-
-    // Used by SET_EFFECT_PARAMETER.
-    double value;
 };
 
 struct EffectsResponse {
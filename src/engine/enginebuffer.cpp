@@ -51,6 +51,10 @@ constexpr double kLinearScalerElipsis =
 constexpr int kPlaypositionUpdateRate = 15; // updates per second
 
 const QString kAppGroup = QStringLiteral("[App]");
+#ifdef __RUBBERBAND__
+const ConfigKey kKeylockPrerenderingKey =
+        ConfigKey(kAppGroup, QStringLiteral("keylock_prerendering"));
+#endif
 
 } // anonymous namespace
 
@@ -330,6 +334,11 @@ EngineBuffer::~EngineBuffer() {
 
 void EngineBuffer::bindWorkers(EngineWorkerScheduler* pWorkerScheduler) {
     m_pReader->setScheduler(pWorkerScheduler);
+#ifdef __RUBBERBAND__
+    if (m_pConfig && m_pConfig->getValue(kKeylockPrerenderingKey, false)) {
+        m_pScaleRB->enablePrerendering(pWorkerScheduler);
+    }
+#endif
 }
 
 void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
@@ -889,7 +898,9 @@ void EngineBuffer::processTrackLocked(
     }
 
     // Sync requests can affect rate, so process those first.
-    processSyncRequests();
+    if (!m_bProcessedConcurrently) {
+        processSyncRequests();
+    }
 
     // Note: play is also active during cue preview
     bool paused = !m_playButton->toBool();
@@ -1310,6 +1321,12 @@ void EngineBuffer::processSlip(std::size_t bufferSize) {
     }
 }
 
+bool EngineBuffer::isSyncDependent() const {
+    return m_pSyncControl->isSynchronized() ||
+            atomicLoadRelaxed(m_iEnableSyncQueued) != SYNC_REQUEST_NONE ||
+            atomicLoadRelaxed(m_iSyncModeQueued) != static_cast<int>(SyncMode::Invalid);
+}
+
 void EngineBuffer::processSyncRequests() {
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
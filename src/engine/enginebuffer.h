@@ -160,6 +160,17 @@ class EngineBuffer : public EngineObject {
 
     void collectFeatures(GroupFeatureState* pGroupFeatures) const override;
 
+    /// Checks if processing this buffer may modify the shared EngineSync,
+    /// i.e. if it is synchronized or has queued sync requests. Buffers
+    /// that are not sync dependent can be processed concurrently.
+    bool isSyncDependent() const;
+
+    /// While a buffer is processed concurrently, queued sync requests are
+    /// deferred until it is processed on its own again.
+    void setProcessedConcurrently(bool processedConcurrently) {
+        m_bProcessedConcurrently = processedConcurrently;
+    }
+
     // For dependency injection of scalers.
     void setScalerForTest(
             EngineBufferScale* pScaleVinyl,
@@ -465,6 +476,7 @@ class EngineBuffer : public EngineObject {
     QAtomicInt m_iSeekPhaseQueued;
     QAtomicInt m_iEnableSyncQueued;
     QAtomicInt m_iSyncModeQueued;
+    bool m_bProcessedConcurrently = false;
     ControlValueAtomic<QueuedSeek> m_queuedSeek;
     bool m_previousBufferSeek = false;
 
@@ -1,5 +1,7 @@
 #include "engine/enginemixer.h"
 
+#include <QtDebug>
+#include <algorithm>
 #include <memory>
 
 #include "audio/types.h"
@@ -17,6 +19,7 @@
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
 #include "engine/enginexfader.h"
+#include "engine/realtimeworkerpool.h"
 #include "engine/sidechain/enginesidechain.h"
 #include "engine/sync/enginesync.h"
 #include "mixer/playermanager.h"
@@ -27,6 +30,7 @@
 #include "util/parented_ptr.h"
 #include "util/sample.h"
 #include "util/samplebuffer.h"
+#include "util/timer.h"
 
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
@@ -34,6 +38,7 @@ const QString kLegacyGroup = QStringLiteral("[Master]");
 const QString kMainGroup = QStringLiteral("[Main]");
 
 const ConfigKey kInternalClockBpmKey{QStringLiteral("[InternalClock]"), QStringLiteral("bpm")};
+const ConfigKey kEngineMultiThreadingKey{kAppGroup, QStringLiteral("engine_multithreading")};
 } // namespace
 
 EngineMixer::EngineMixer(UserSettingsPointer pConfig,
@@ -164,6 +169,17 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
     m_bExternalRecordBroadcastInputConnected = false;
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    // Processing channels in parallel is opt-in and requires a restart
+    if (pConfig->getValue(kEngineMultiThreadingKey, false)) {
+        const int numWorkers = RealtimeWorkerPool::defaultNumWorkers();
+        qDebug() << "EngineMixer will use" << numWorkers
+                 << "additional threads to process channels";
+        if (numWorkers > 0) {
+            m_pChannelWorkerPool = std::make_unique<RealtimeWorkerPool>(
+                    numWorkers, QStringLiteral("EngineMixerWorker"));
+        }
+    }
+
     m_pSampleRate->addAlias(ConfigKey(group, QStringLiteral("samplerate")));
     m_pSampleRate->set(44100.);
 
@@ -319,17 +335,11 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        auto& pChannel = pChannelInfo->m_pChannel;
-        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
-        pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    if (m_pChannelWorkerPool) {
+        processActiveChannelsConcurrently(activeChannelsStartIndex, bufferSize);
+    } else {
+        for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+            processChannel(m_activeChannels[i], bufferSize);
         }
     }
     // Do internal sync lock post-processing before the other
@@ -358,6 +368,153 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
             });
 }
 
+void EngineMixer::processActiveChannelsConcurrently(
+        int activeChannelsStartIndex, std::size_t bufferSize) {
+    // Synchronized decks modify the shared EngineSync while they are
+    // processed. They are processed one after the other, starting with
+    // the sync leader, before all remaining channels are processed in
+    // parallel. The effect chains that are applied while processing a
+    // channel, i.e. the equalizer and quick effect chains of the channel
+    // and its stems, are only enabled for this channel.
+    m_concurrentChannels.clear();
+    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+        if (i == 0 || (pBuffer && pBuffer->isSyncDependent())) {
+            processChannel(pChannelInfo, bufferSize);
+        } else {
+            if (pBuffer) {
+                pBuffer->setProcessedConcurrently(true);
+            }
+            m_concurrentChannels.append(pChannelInfo);
+        }
+    }
+
+    struct Context {
+        EngineMixer* pMixer;
+        std::size_t bufferSize;
+    };
+    Context context{this, bufferSize};
+    m_pChannelWorkerPool->run(static_cast<int>(m_concurrentChannels.size()),
+            [](void* pData, int index) {
+                const auto* pContext = static_cast<const Context*>(pData);
+                pContext->pMixer->processChannel(
+                        pContext->pMixer->m_concurrentChannels[index],
+                        pContext->bufferSize);
+            },
+            &context);
+
+    for (ChannelInfo* pChannelInfo : std::as_const(m_concurrentChannels)) {
+        EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+        if (pBuffer) {
+            pBuffer->setProcessedConcurrently(false);
+        }
+    }
+}
+
+void EngineMixer::processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize) {
+    auto& pChannel = pChannelInfo->m_pChannel;
+    ScopedTimer t(QStringLiteral("EngineMixer::processChannel %1"),
+            pChannel->getGroup());
+    DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
+    pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
+void EngineMixer::applyEffectsInPlaceAndMixBusesConcurrently(std::size_t bufferSize) {
+    ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsInPlaceAndMixBusesConcurrently"));
+    // Each channel is assigned to a single orientation, so the effects of
+    // all channels can be processed in parallel.
+    m_channelEffectsJobs.clear();
+    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+        for (ChannelInfo* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+            const GainRamp gainRamp = ChannelMixer::updateGain(m_mainGain,
+                    pChannelInfo,
+                    // no [o] because the old gain follows an orientation switch
+                    &m_channelMainGainCache[pChannelInfo->m_index]);
+            const int index = static_cast<int>(m_channelEffectsJobs.size());
+            m_channelEffectsJobs.append(ChannelEffectsJob{pChannelInfo, gainRamp, index});
+        }
+    }
+
+    // The effect chains are not thread-safe. Channels that share a chain,
+    // e.g. an effect unit that is enabled for several decks, are assigned
+    // to the same job and processed one after the other in the same order
+    // as by ChannelMixer.
+    const auto firstChannelOfJob = [this](int index) {
+        while (m_channelEffectsJobs[index].m_firstChannel != index) {
+            index = m_channelEffectsJobs[index].m_firstChannel;
+        }
+        return index;
+    };
+    for (int i = 1; i < m_channelEffectsJobs.size(); ++i) {
+        for (int j = 0; j < i; ++j) {
+            if (!m_pEngineEffectsManager->sharesEffectChain(
+                        SignalProcessingStage::Postfader,
+                        m_channelEffectsJobs[i].m_pChannelInfo->m_handle,
+                        m_channelEffectsJobs[j].m_pChannelInfo->m_handle,
+                        m_mainHandle.handle())) {
+                continue;
+            }
+            const int first1 = firstChannelOfJob(i);
+            const int first2 = firstChannelOfJob(j);
+            m_channelEffectsJobs[std::max(first1, first2)].m_firstChannel =
+                    std::min(first1, first2);
+        }
+    }
+    m_channelEffectsJobFirstChannels.clear();
+    for (int i = 0; i < m_channelEffectsJobs.size(); ++i) {
+        m_channelEffectsJobs[i].m_firstChannel = firstChannelOfJob(i);
+        if (m_channelEffectsJobs[i].m_firstChannel == i) {
+            m_channelEffectsJobFirstChannels.append(i);
+        }
+    }
+
+    struct Context {
+        EngineMixer* pMixer;
+        std::size_t bufferSize;
+    };
+    Context context{this, bufferSize};
+    m_pChannelWorkerPool->run(static_cast<int>(m_channelEffectsJobFirstChannels.size()),
+            [](void* pData, int index) {
+                const auto* pContext = static_cast<const Context*>(pData);
+                EngineMixer* pMixer = pContext->pMixer;
+                const int firstChannel = pMixer->m_channelEffectsJobFirstChannels[index];
+                for (int i = firstChannel; i < pMixer->m_channelEffectsJobs.size(); ++i) {
+                    const ChannelEffectsJob& job = pMixer->m_channelEffectsJobs[i];
+                    if (job.m_firstChannel != firstChannel) {
+                        continue;
+                    }
+                    pMixer->m_pEngineEffectsManager->processPostFaderInPlace(
+                            job.m_pChannelInfo->m_handle,
+                            pMixer->m_mainHandle.handle(),
+                            job.m_pChannelInfo->m_pBuffer.data(),
+                            pContext->bufferSize,
+                            pMixer->m_sampleRate,
+                            job.m_pChannelInfo->m_features,
+                            job.m_gainRamp.m_oldGain,
+                            job.m_gainRamp.m_newGain,
+                            job.m_gainRamp.m_fadeout);
+                }
+            },
+            &context);
+
+    // Mix in the same order as ChannelMixer to get the same result
+    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+        CSAMPLE* pOutput = m_outputBusBuffers[o].data();
+        SampleUtil::clear(pOutput, bufferSize);
+        for (ChannelInfo* pChannelInfo : std::as_const(m_activeBusChannels[o])) {
+            SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), bufferSize);
+        }
+    }
+}
+
 void EngineMixer::process(const std::size_t bufferSize) {
     DEBUG_ASSERT(bufferSize <= static_cast<int>(kMaxEngineSamples));
 
@@ -492,16 +649,20 @@ void EngineMixer::process(const std::size_t bufferSize) {
     // channel volume faders and crossfader.
     m_mainGain.setGains(crossfaderLeftGain, 1.0f, crossfaderRightGain);
 
-    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
-        ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
-                m_activeBusChannels[o],
-                &m_channelMainGainCache, // no [o] because the old gain
-                                         // follows an orientation switch
-                m_outputBusBuffers[o].data(),
-                m_mainHandle.handle(),
-                bufferSize,
-                m_sampleRate,
-                m_pEngineEffectsManager);
+    if (m_pChannelWorkerPool) {
+        applyEffectsInPlaceAndMixBusesConcurrently(bufferSize);
+    } else {
+        for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+            ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
+                    m_activeBusChannels[o],
+                    &m_channelMainGainCache, // no [o] because the old gain
+                                             // follows an orientation switch
+                    m_outputBusBuffers[o].data(),
+                    m_mainHandle.handle(),
+                    bufferSize,
+                    m_sampleRate,
+                    m_pEngineEffectsManager);
+        }
     }
 
     // Process crossfader orientation bus channel effects
@@ -881,6 +1042,9 @@ void EngineMixer::addChannel(std::unique_ptr<EngineChannel> pChannel) {
     m_activeBusChannels[EngineChannel::RIGHT].reserve(m_channels.size());
     m_activeHeadphoneChannels.reserve(m_channels.size());
     m_activeTalkoverChannels.reserve(m_channels.size());
+    m_concurrentChannels.reserve(m_channels.size());
+    m_channelEffectsJobs.reserve(m_channels.size());
+    m_channelEffectsJobFirstChannels.reserve(m_channels.size());
 
     if (pBuffer != nullptr) {
         pBuffer->bindWorkers(m_pWorkerScheduler);
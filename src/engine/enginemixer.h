@@ -31,6 +31,7 @@ class EngineEffectsManager;
 class EngineSync;
 class EngineTalkoverDucking;
 class EngineDelay;
+class RealtimeWorkerPool;
 
 // The number of channels to pre-allocate in various structures in the
 // engine. Prevents memory allocation in EngineMixer::addChannel.
@@ -127,6 +128,13 @@ class EngineMixer : public QObject, public AudioSource {
         bool m_fadeout;
     };
 
+    // The gain that is applied to a channel during one callback
+    struct GainRamp {
+        CSAMPLE_GAIN m_oldGain;
+        CSAMPLE_GAIN m_newGain;
+        bool m_fadeout;
+    };
+
     class GainCalculator {
       public:
         virtual ~GainCalculator() = default;
@@ -254,6 +262,18 @@ class EngineMixer : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(std::size_t bufferSize);
+    // Processes the active channels that don't depend on each other in
+    // parallel, see m_pChannelWorkerPool.
+    void processActiveChannelsConcurrently(
+            int activeChannelsStartIndex,
+            std::size_t bufferSize);
+    // Processes a single channel and collects its features. May be called
+    // concurrently for different channels.
+    void processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize);
+    // Applies the postfader effects of the channels of all crossfader
+    // orientation buses in parallel and mixes them after all have finished.
+    // Channels that share an effect chain are processed by the same job.
+    void applyEffectsInPlaceAndMixBusesConcurrently(std::size_t bufferSize);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(std::size_t bufferSize);
@@ -279,6 +299,16 @@ class EngineMixer : public QObject, public AudioSource {
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeBusChannels[3];
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeHeadphoneChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeTalkoverChannels;
+    QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_concurrentChannels;
+    struct ChannelEffectsJob {
+        ChannelInfo* m_pChannelInfo;
+        GainRamp m_gainRamp;
+        // The index of the first channel that is processed by the same job,
+        // because it shares an effect chain with this channel
+        int m_firstChannel;
+    };
+    QVarLengthArray<ChannelEffectsJob, kPreallocatedChannels> m_channelEffectsJobs;
+    QVarLengthArray<int, kPreallocatedChannels> m_channelEffectsJobFirstChannels;
 
     mixxx::audio::SampleRate m_sampleRate;
 
@@ -292,6 +322,8 @@ class EngineMixer : public QObject, public AudioSource {
 
     parented_ptr<EngineWorkerScheduler> m_pWorkerScheduler;
     std::unique_ptr<EngineSync> m_pEngineSync;
+    // Only exists if multi-threaded channel processing has been enabled
+    std::unique_ptr<RealtimeWorkerPool> m_pChannelWorkerPool;
 
     std::unique_ptr<ControlObject> m_pMainGain;
     std::unique_ptr<ControlObject> m_pBoothGain;
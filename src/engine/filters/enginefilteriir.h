@@ -9,6 +9,7 @@
 #include "engine/engine.h"
 #include "engine/engineobject.h"
 #include "util/sample.h"
+#include "util/simddouble2.h"
 
 // set to 1 to print some analysis data using qDebug()
 // It prints the resulting delay after 50 % of impulse have passed
@@ -44,6 +45,8 @@ class EngineFilterIIR : public EngineFilterIIRBase {
               m_doStart(false),
               m_startFromDry(false) {
         memset(m_coef, 0, sizeof(m_coef));
+        memset(m_oldCoef, 0, sizeof(m_oldCoef));
+        copyCoefsToLanes();
         pauseFilter();
     }
 
@@ -85,11 +88,11 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        for (unsigned int i = 0; i < SIZE; ++i) {
+            m_oldBuf[i] = m_buf[i];
+        }
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        clearBuffers();
         m_doRamping = true;
     }
 
@@ -110,6 +113,7 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         memcpy(m_oldCoef, m_coef, sizeof(m_coef));
 
         m_coef[0] = fid_design_coef(m_coef + 1, SIZE, spec_d, sampleRate, freq0, freq1, adj);
+        copyCoefsToLanes();
 
         initBuffers();
 
@@ -184,6 +188,7 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                         freq02,
                         freq12,
                         adj2);
+        copyCoefsToLanes();
 
         initBuffers();
 
@@ -237,10 +242,12 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
     virtual void process(const CSAMPLE* pIn, CSAMPLE* pOutput, const std::size_t bufferSize) {
+        // Both channels are processed together in the two lanes
+        // of SimdDouble2
         if (!m_doRamping) {
             for (std::size_t i = 0; i < bufferSize; i += 2) {
-                pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                processSample(m_laneCoef, m_buf, mixxx::SimdDouble2::fromFrame(&pIn[i]))
+                        .storeFrame(&pOutput[i]);
             }
         } else {
             double cross_mix = 0.0;
@@ -257,31 +264,26 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
-                double old1;
-                double old2;
+                const auto in = mixxx::SimdDouble2::fromFrame(&pIn[i]);
+                mixxx::SimdDouble2 old;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf1, pIn[i]));
-                    old2 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                    old = processSample(m_oldLaneCoef, m_oldBuf, in).roundedToSample();
                 } else {
                     if (m_startFromDry) {
-                        old1 = pIn[i];
-                        old2 = pIn[i + 1];
+                        old = in;
                     } else {
-                        old1 = 0;
-                        old2 = 0;
+                        old = mixxx::SimdDouble2::zero();
                     }
                 }
-                double new1 = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                double new2 = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const auto fresh = processSample(m_laneCoef, m_buf, in).roundedToSample();
 
                 if (i < bufferSize / 2) {
-                    pOutput[i] = static_cast<CSAMPLE>(old1);
-                    pOutput[i + 1] = static_cast<CSAMPLE>(old2);
+                    old.storeFrame(&pOutput[i]);
                 } else {
-                    pOutput[i] = static_cast<CSAMPLE>(new1 * cross_mix + old1 * (1.0 - cross_mix));
-                    pOutput[i + 1] = static_cast<CSAMPLE>(
-                            new2 * cross_mix + old2 * (1.0 - cross_mix));
+                    (fresh * mixxx::SimdDouble2::broadcast(cross_mix) +
+                            old * mixxx::SimdDouble2::broadcast(1.0 - cross_mix))
+                            .storeFrame(&pOutput[i]);
                     cross_mix += cross_inc;
                 }
             }
@@ -290,12 +292,65 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         }
     }
 
+    /// Processes this filter and another filter of the same filter bank,
+    /// e.g. two band filters of an equalizer, in a single pass. The
+    /// recursions of both filters are independent and are interleaved,
+    /// so the CPU can execute them in parallel instead of waiting for the
+    /// latency of each step of a single filter.
+    ///
+    /// The result is the same as calling process() on both filters, but
+    /// pOutput must not be the input of the other filter.
+    template<unsigned int OTHER_SIZE, enum IIRPass OTHER_PASS>
+    void processTogetherWith(EngineFilterIIR<OTHER_SIZE, OTHER_PASS>* pOther,
+            const CSAMPLE* pIn,
+            CSAMPLE* pOutput,
+            const CSAMPLE* pOtherIn,
+            CSAMPLE* pOtherOutput,
+            const std::size_t bufferSize) {
+        DEBUG_ASSERT(pOutput != pOtherIn);
+        if (m_doRamping || pOther->m_doRamping) {
+            // Ramping is rare, it is not worth to be interleaved
+            process(pIn, pOutput, bufferSize);
+            pOther->process(pOtherIn, pOtherOutput, bufferSize);
+            return;
+        }
+        for (std::size_t i = 0; i < bufferSize; i += 2) {
+            const auto in = mixxx::SimdDouble2::fromFrame(&pIn[i]);
+            const auto otherIn = mixxx::SimdDouble2::fromFrame(&pOtherIn[i]);
+            const auto out = processSample(m_laneCoef, m_buf, in);
+            const auto otherOut = pOther->processSample(
+                    pOther->m_laneCoef, pOther->m_buf, otherIn);
+            out.storeFrame(&pOutput[i]);
+            otherOut.storeFrame(&pOtherOutput[i]);
+        }
+    }
+
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    template<unsigned int, enum IIRPass>
+    friend class EngineFilterIIR;
+
+    // Calculates one step of the filter. T is either double for a single
+    // channel or SimdDouble2 for both channels, with the coefficients
+    // broadcasted to both lanes.
+    template<typename T>
+    inline T processSample(const T* coef, T* buf, T val);
+
+    inline void clearBuffers() {
+        for (unsigned int i = 0; i < SIZE; ++i) {
+            m_buf[i] = mixxx::SimdDouble2::zero();
+        }
+    }
+
+    inline void copyCoefsToLanes() {
+        for (unsigned int i = 0; i < SIZE + 1; ++i) {
+            m_laneCoef[i] = mixxx::SimdDouble2::broadcast(m_coef[i]);
+            m_oldLaneCoef[i] = mixxx::SimdDouble2::broadcast(m_oldCoef[i]);
+        }
+    }
+
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        clearBuffers();
         m_doRamping = true;
         m_doStart = true;
     }
@@ -304,15 +359,14 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
+    // The coefficients broadcasted to both lanes
+    mixxx::SimdDouble2 m_laneCoef[SIZE + 1];
+    mixxx::SimdDouble2 m_oldLaneCoef[SIZE + 1];
 
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    // State of both channels
+    mixxx::SimdDouble2 m_buf[SIZE];
+    // Old buffer needed for ramping
+    mixxx::SimdDouble2 m_oldBuf[SIZE];
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -323,10 +377,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -337,10 +390,9 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_BP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -351,10 +403,9 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -365,10 +416,9 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -384,10 +434,9 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_BP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -414,10 +463,9 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -433,10 +481,9 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_LP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -463,10 +510,9 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<16, IIR_BP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -515,10 +561,9 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_HP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -546,10 +591,9 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<5, IIR_BP>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -560,10 +604,9 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LPMO>::processSample(const T* coef, T* buf, T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -586,10 +629,9 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HPMO>::processSample(const T* coef, T* buf, T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -611,10 +653,9 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP2>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -632,10 +673,9 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP2>::processSample(const T* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
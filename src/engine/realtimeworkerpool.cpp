@@ -0,0 +1,240 @@
+#include "engine/realtimeworkerpool.h"
+
+#include <QSemaphore>
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#endif
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+const mixxx::Logger kLogger("RealtimeWorkerPool");
+
+// The number of polls before an idle worker blocks on its semaphore.
+// Corresponds to a few microseconds, which is enough to pick up the
+// next batch of jobs that is dispatched within the same callback.
+constexpr int kIdleSpinCount = 4000;
+
+// The number of polls before the calling thread blocks while waiting
+// for the workers to finish. The workers usually finish within the same
+// time as the calling thread, a worker that takes longer has most likely
+// been preempted and needs the core of the calling thread.
+constexpr int kJoinSpinCount = 4000;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(_M_ARM64)
+    __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+void applyThreadOptions(const RealtimeWorkerThreadOptions& options, int workerIndex) {
+#ifdef __LINUX__
+    if (options.pinToCores) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        CPU_SET((workerIndex + 1) % QThread::idealThreadCount(), &cpuSet);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+            kLogger.warning()
+                    << "Failed to pin"
+                    << QThread::currentThread()->objectName();
+        }
+    }
+    if (options.realtimePriority > 0) {
+        struct sched_param param = {};
+        param.sched_priority = options.realtimePriority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            kLogger.warning()
+                    << "Failed to schedule"
+                    << QThread::currentThread()->objectName()
+                    << "with SCHED_FIFO priority"
+                    << options.realtimePriority;
+        }
+    }
+#else
+    Q_UNUSED(options);
+    Q_UNUSED(workerIndex);
+#endif
+}
+
+} // anonymous namespace
+
+class RealtimeWorkerPool::Worker final : public QThread {
+  public:
+    Worker(RealtimeWorkerPool* pPool,
+            int index,
+            RealtimeWorkerThreadOptions options)
+            : m_pPool(pPool),
+              m_index(index),
+              m_options(options) {
+    }
+
+    void wake() {
+        m_semaphore.release();
+    }
+
+  protected:
+    void run() override {
+        applyThreadOptions(m_options, m_index);
+        while (waitForJobs()) {
+            m_pPool->processJobs();
+            if (m_pPool->m_busyWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                // The last worker wakes up the calling thread
+                m_pPool->m_joinSemaphore.release();
+            }
+        }
+    }
+
+  private:
+    bool waitForJobs() {
+        bool acquired = false;
+        for (int i = 0; i < kIdleSpinCount; ++i) {
+            if (m_semaphore.tryAcquire()) {
+                acquired = true;
+                break;
+            }
+            cpuRelax();
+        }
+        if (!acquired) {
+            m_semaphore.acquire();
+        }
+        return !m_pPool->m_quit.load(std::memory_order_acquire);
+    }
+
+    RealtimeWorkerPool* const m_pPool;
+    const int m_index;
+    const RealtimeWorkerThreadOptions m_options;
+    QSemaphore m_semaphore;
+};
+
+RealtimeWorkerPool::RealtimeWorkerPool(int numWorkers,
+        const QString& name,
+        RealtimeWorkerThreadOptions options)
+        : m_job(nullptr),
+          m_pContext(nullptr),
+          m_count(0),
+          m_nextIndex(0),
+          m_busyWorkers(0),
+          m_inUse(false),
+          m_quit(false) {
+    DEBUG_ASSERT(numWorkers >= 0);
+    m_workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i) {
+        auto pWorker = std::make_unique<Worker>(this, i, options);
+        pWorker->setObjectName(QStringLiteral("%1 %2").arg(name, QString::number(i + 1)));
+        pWorker->start(QThread::TimeCriticalPriority);
+        m_workers.push_back(std::move(pWorker));
+    }
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool() {
+    m_quit.store(true, std::memory_order_release);
+    for (const auto& pWorker : m_workers) {
+        pWorker->wake();
+    }
+    for (const auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+}
+
+// static
+int RealtimeWorkerPool::defaultNumWorkers() {
+    return std::max(QThread::idealThreadCount() - 1, 0);
+}
+
+mixxx::Duration RealtimeWorkerPool::run(int count, Job job, void* pContext) {
+    mixxx::Duration joinWaitTime;
+    const bool ran = tryRun(count, job, pContext, &joinWaitTime);
+    VERIFY_OR_DEBUG_ASSERT(ran) {
+        // Concurrent use is a programming error, but the jobs must
+        // not be dropped.
+        for (int i = 0; i < count; ++i) {
+            job(pContext, i);
+        }
+    }
+    return joinWaitTime;
+}
+
+bool RealtimeWorkerPool::tryRun(int count,
+        Job job,
+        void* pContext,
+        mixxx::Duration* pJoinWaitTime) {
+    if (m_inUse.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+    const mixxx::Duration joinWaitTime = runJobs(count, job, pContext);
+    m_inUse.store(false, std::memory_order_release);
+    if (pJoinWaitTime) {
+        *pJoinWaitTime = joinWaitTime;
+    }
+    return true;
+}
+
+mixxx::Duration RealtimeWorkerPool::runJobs(int count, Job job, void* pContext) {
+    DEBUG_ASSERT(job);
+    if (count <= 0) {
+        return mixxx::Duration();
+    }
+    const int numBusyWorkers = std::min(numWorkers(), count - 1);
+    if (numBusyWorkers == 0) {
+        for (int i = 0; i < count; ++i) {
+            job(pContext, i);
+        }
+        return mixxx::Duration();
+    }
+    DEBUG_ASSERT(m_busyWorkers.load(std::memory_order_relaxed) == 0);
+
+    // Publishing the job is ordered by releasing the semaphores
+    m_job = job;
+    m_pContext = pContext;
+    m_count = count;
+    m_nextIndex.store(0, std::memory_order_relaxed);
+    m_busyWorkers.store(numBusyWorkers, std::memory_order_relaxed);
+    for (int i = 0; i < numBusyWorkers; ++i) {
+        m_workers[i]->wake();
+    }
+
+    processJobs();
+
+    // The semaphore is released exactly once per run, by the last worker
+    PerformanceTimer joinTimer;
+    joinTimer.start();
+    bool joined = false;
+    for (int i = 0; i < kJoinSpinCount; ++i) {
+        if (m_joinSemaphore.tryAcquire()) {
+            joined = true;
+            break;
+        }
+        cpuRelax();
+    }
+    if (!joined) {
+        // Don't take the core away from a worker that has been preempted
+        m_joinSemaphore.acquire();
+    }
+    DEBUG_ASSERT(m_busyWorkers.load(std::memory_order_relaxed) == 0);
+    return joinTimer.elapsed();
+}
+
+void RealtimeWorkerPool::processJobs() {
+    const int count = m_count;
+    int index = m_nextIndex.fetch_add(1, std::memory_order_relaxed);
+    while (index < count) {
+        m_job(m_pContext, index);
+        index = m_nextIndex.fetch_add(1, std::memory_order_relaxed);
+    }
+}
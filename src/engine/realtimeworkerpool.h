@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "util/duration.h"
+
+/// Scheduling of the threads of a RealtimeWorkerPool. Pinning and
+/// real-time scheduling are only supported on Linux. Workers keep
+/// QThread::TimeCriticalPriority if they are not permitted.
+struct RealtimeWorkerThreadOptions {
+    /// The SCHED_FIFO priority of the workers, 0 keeps the default policy
+    int realtimePriority = 0;
+    /// Pin each worker to its own core, starting with the second core
+    bool pinToCores = false;
+};
+
+/// A fixed set of pre-spawned threads that help the engine callback thread
+/// to process independent jobs of a single callback in parallel.
+///
+/// Unlike QThreadPool, dispatching jobs neither allocates memory nor
+/// takes a lock. Idle workers spin for a short while before they block
+/// on a (futex based) semaphore, so jobs that are dispatched in quick
+/// succession are picked up without a kernel round trip. The calling
+/// thread waits for the workers the same way.
+class RealtimeWorkerPool final {
+  public:
+    /// The job is called once for each index in [0, count). It may be
+    /// called concurrently from the calling thread and all workers.
+    using Job = void (*)(void* pContext, int index);
+
+    RealtimeWorkerPool(int numWorkers,
+            const QString& name,
+            RealtimeWorkerThreadOptions options = RealtimeWorkerThreadOptions());
+    ~RealtimeWorkerPool();
+
+    RealtimeWorkerPool(const RealtimeWorkerPool&) = delete;
+    RealtimeWorkerPool& operator=(const RealtimeWorkerPool&) = delete;
+
+    int numWorkers() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    /// Runs the job for all indices and returns when all of them have
+    /// finished. The calling thread processes jobs, too. Must not be
+    /// called concurrently.
+    ///
+    /// Returns the time the calling thread has waited for the workers
+    /// after it ran out of jobs.
+    mixxx::Duration run(int count, Job job, void* pContext);
+
+    /// Like run(), but returns false without running any job if the pool
+    /// is in use by another thread.
+    bool tryRun(int count,
+            Job job,
+            void* pContext,
+            mixxx::Duration* pJoinWaitTime = nullptr);
+
+    /// The number of workers to use for processing concurrently on this
+    /// machine, leaving one core for the calling thread.
+    static int defaultNumWorkers();
+
+  private:
+    class Worker;
+
+    mixxx::Duration runJobs(int count, Job job, void* pContext);
+    void processJobs();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    Job m_job;
+    void* m_pContext;
+    int m_count;
+    std::atomic<int> m_nextIndex;
+    std::atomic<int> m_busyWorkers;
+    QSemaphore m_joinSemaphore;
+    std::atomic<bool> m_inUse;
+    std::atomic<bool> m_quit;
+};
@@ -0,0 +1,319 @@
+#include "library/analysis/libraryanalysisrunner.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSqlDatabase>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+
+#include "database/mixxxdb.h"
+#include "library/coverartcache.h"
+#include "library/dao/analysisdao.h"
+#include "library/dao/trackdao.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
+#include "moc_libraryanalysisrunner.cpp"
+#include "preferences/waveformsettings.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/versionstore.h"
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryAnalysisRunner");
+
+constexpr int kExitCodeSuccess = 0;
+constexpr int kExitCodeFailure = 1;
+
+// Print the progress at most once per interval
+constexpr qint64 kReportIntervalMillis = 1000;
+
+// The BPM detection might improve with a new release
+QString noBpmMarkerVersion() {
+    return VersionStore::version();
+}
+
+// A modified file is analyzed again
+QString noBpmMarkerDescription(const QString& location) {
+    return QString::number(
+            QFileInfo(location).lastModified().toMSecsSinceEpoch());
+}
+
+class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TrackAnalysisSchedulerEnvironmentImpl(
+            const TrackCollectionManager* pTrackCollectionManager)
+            : m_pTrackCollectionManager(pTrackCollectionManager) {
+        DEBUG_ASSERT(m_pTrackCollectionManager);
+    }
+    ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
+
+    TrackPointer loadTrackById(TrackId trackId) const final {
+        return m_pTrackCollectionManager->getTrackById(trackId);
+    }
+
+  private:
+    const TrackCollectionManager* const m_pTrackCollectionManager;
+};
+
+} // anonymous namespace
+
+LibraryAnalysisRunner::LibraryAnalysisRunner(UserSettingsPointer pConfig)
+        : m_pConfig(std::move(pConfig)),
+          m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_totalTracksCount(0),
+          m_reportedTracksCount(0),
+          m_finished(false) {
+}
+
+LibraryAnalysisRunner::~LibraryAnalysisRunner() {
+    finalize();
+}
+
+bool LibraryAnalysisRunner::initialize() {
+    if (!SoundSourceProxy::registerProviders()) {
+        kLogger.critical() << "Failed to register any SoundSource providers";
+        return false;
+    }
+
+    m_pDbConnectionPool = MixxxDb(m_pConfig).connectionPool();
+    if (!m_pDbConnectionPool) {
+        return false;
+    }
+    // Create a connection for the main thread
+    m_pDbConnectionPool->createThreadLocalConnection();
+    {
+        QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+        if (!dbConnection.isOpen()) {
+            kLogger.critical() << "Unable to establish a database connection";
+            return false;
+        }
+        if (!MixxxDb::initDatabaseSchema(dbConnection)) {
+            return false;
+        }
+    }
+
+    CoverArtCache::createInstance();
+    m_pTrackCollectionManager = std::make_unique<TrackCollectionManager>(
+            nullptr,
+            m_pConfig,
+            m_pDbConnectionPool);
+    return true;
+}
+
+void LibraryAnalysisRunner::finalize() {
+    // Same order as in CoreServices::finalize()
+    m_pTrackAnalysisScheduler.reset();
+    if (m_pTrackCollectionManager) {
+        CoverArtCache::destroy();
+        // Saves all tracks that are still cached
+        m_pTrackCollectionManager.reset();
+    }
+    if (m_pDbConnectionPool) {
+        m_pDbConnectionPool->destroyThreadLocalConnection();
+        m_pDbConnectionPool.reset();
+    }
+}
+
+int LibraryAnalysisRunner::exec() {
+    if (!initialize()) {
+        return kExitCodeFailure;
+    }
+
+    // Always detect the BPM like the analysis feature of the library. No
+    // LowPriority, because nothing else is running that could be disturbed.
+    int modeFlags = AnalyzerModeFlags::WithBeats;
+    const bool withWaveform =
+            WaveformSettings(m_pConfig).waveformGenerationWithAnalysisEnabled();
+    if (withWaveform) {
+        modeFlags |= AnalyzerModeFlags::WithWaveform;
+    }
+
+    // Tracks that have been analyzed by a previous, interrupted
+    // invocation are skipped.
+    QList<TrackId> trackIds =
+            m_pTrackCollectionManager->internalCollection()
+                    ->getTrackDAO()
+                    .getUnanalyzedTrackIds(withWaveform);
+    const auto unanalyzedTracksCount = trackIds.size();
+    trackIds.erase(
+            std::remove_if(trackIds.begin(),
+                    trackIds.end(),
+                    [this](const TrackId& trackId) {
+                        return hasNoBpmMarker(trackId);
+                    }),
+            trackIds.end());
+    if (trackIds.size() < unanalyzedTracksCount) {
+        kLogger.info()
+                << "Skipping"
+                << unanalyzedTracksCount - trackIds.size()
+                << "tracks without a detectable BPM";
+    }
+    if (trackIds.isEmpty()) {
+        std::fputs("All tracks in the library have already been analyzed\n", stdout);
+        return kExitCodeSuccess;
+    }
+
+    const int numWorkerThreads = math_max(1, QThread::idealThreadCount());
+    m_pTrackAnalysisScheduler = TrackAnalysisScheduler::createInstance(
+            std::make_unique<const TrackAnalysisSchedulerEnvironmentImpl>(
+                    m_pTrackCollectionManager.get()),
+            numWorkerThreads,
+            m_pDbConnectionPool,
+            m_pConfig,
+            static_cast<AnalyzerModeFlags>(modeFlags));
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::trackProgress,
+            this,
+            &LibraryAnalysisRunner::slotTrackProgress);
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::progress,
+            this,
+            &LibraryAnalysisRunner::slotProgress);
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::finished,
+            this,
+            &LibraryAnalysisRunner::slotFinished);
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::stopped,
+            this,
+            &LibraryAnalysisRunner::slotStopped);
+
+    QList<AnalyzerScheduledTrack> tracks;
+    tracks.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        tracks.append(AnalyzerScheduledTrack(trackId));
+    }
+    m_totalTracksCount = m_pTrackAnalysisScheduler->scheduleTracks(tracks);
+    if (m_totalTracksCount <= 0) {
+        return kExitCodeFailure;
+    }
+    std::fprintf(stdout,
+            "Analyzing %d tracks with %d threads\n",
+            m_totalTracksCount,
+            numWorkerThreads);
+    std::fflush(stdout);
+
+    m_elapsedTimer.start();
+    m_reportTimer.start();
+    m_pTrackAnalysisScheduler->resume();
+    // Returns after all worker threads have exited
+    m_eventLoop.exec();
+
+    reportProgress(m_totalTracksCount);
+    m_pTrackAnalysisScheduler.reset();
+    return kExitCodeSuccess;
+}
+
+bool LibraryAnalysisRunner::hasNoBpmMarker(TrackId trackId) {
+    TrackCollection* const pTrackCollection =
+            m_pTrackCollectionManager->internalCollection();
+    AnalysisDao& analysisDao = pTrackCollection->getAnalysisDAO();
+    const QList<AnalysisDao::AnalysisInfo> markers =
+            analysisDao.getAnalysesForTrackByType(
+                    trackId, AnalysisDao::TYPE_NO_BPM);
+    if (markers.isEmpty()) {
+        return false;
+    }
+    const QString description = noBpmMarkerDescription(
+            pTrackCollection->getTrackDAO().getTrackLocation(trackId));
+    bool valid = false;
+    for (const auto& marker : markers) {
+        if (!valid &&
+                marker.version == noBpmMarkerVersion() &&
+                marker.description == description) {
+            valid = true;
+            continue;
+        }
+        // Outdated or duplicate
+        analysisDao.deleteAnalysis(marker.analysisId);
+    }
+    return valid;
+}
+
+void LibraryAnalysisRunner::saveNoBpmMarker(const Track& track) {
+    AnalysisDao& analysisDao =
+            m_pTrackCollectionManager->internalCollection()->getAnalysisDAO();
+    // Replaces an outdated marker of a modified file
+    const TrackId trackId = track.getId();
+    const QList<AnalysisDao::AnalysisInfo> markers =
+            analysisDao.getAnalysesForTrackByType(
+                    trackId, AnalysisDao::TYPE_NO_BPM);
+    AnalysisDao::AnalysisInfo marker =
+            markers.isEmpty() ? AnalysisDao::AnalysisInfo() : markers.first();
+    marker.trackId = trackId;
+    marker.type = AnalysisDao::TYPE_NO_BPM;
+    marker.version = noBpmMarkerVersion();
+    marker.description = noBpmMarkerDescription(track.getLocation());
+    if (!analysisDao.saveAnalysis(&marker)) {
+        kLogger.warning()
+                << "Failed to mark track"
+                << trackId
+                << "without a detectable BPM";
+    }
+}
+
+void LibraryAnalysisRunner::reportProgress(int totalTracksCount) {
+    const int finishedTracksCount = m_pTrackAnalysisScheduler
+                                            ->statistics(TrackAnalysisScheduler::Priority::Batch)
+                                            .finishedTracksCount;
+    if (finishedTracksCount == m_reportedTracksCount) {
+        return;
+    }
+    m_reportedTracksCount = finishedTracksCount;
+    const double elapsedSeconds = m_elapsedTimer.elapsed() / 1000.0;
+    const double tracksPerSecond =
+            elapsedSeconds > 0 ? finishedTracksCount / elapsedSeconds : 0.0;
+    std::fprintf(stdout,
+            "Analyzed %d/%d tracks (%.2f tracks/s)\n",
+            finishedTracksCount,
+            totalTracksCount,
+            tracksPerSecond);
+    std::fflush(stdout);
+}
+
+void LibraryAnalysisRunner::slotTrackProgress(
+        TrackId trackId, AnalyzerProgress analyzerProgress) {
+    if (analyzerProgress != kAnalyzerProgressDone) {
+        return;
+    }
+    // The track is still cached after the analysis. The marker is
+    // stored immediately, i.e. also if the analysis is interrupted.
+    const TrackPointer pTrack = m_pTrackCollectionManager->getTrackById(trackId);
+    if (pTrack && pTrack->getBpm() <= 0) {
+        saveNoBpmMarker(*pTrack);
+    }
+}
+
+void LibraryAnalysisRunner::slotProgress(
+        AnalyzerProgress currentTrackProgress,
+        int currentTrackNumber,
+        int totalTracksCount) {
+    Q_UNUSED(currentTrackProgress);
+    Q_UNUSED(currentTrackNumber);
+    if (!m_reportTimer.hasExpired(kReportIntervalMillis)) {
+        return;
+    }
+    m_reportTimer.restart();
+    reportProgress(totalTracksCount);
+}
+
+void LibraryAnalysisRunner::slotFinished() {
+    if (m_finished) {
+        // Also emitted while the worker threads are exiting
+        return;
+    }
+    m_finished = true;
+    kLogger.info() << "Finished analysis after" << m_elapsedTimer.elapsed() << "ms";
+    // Wait for the worker threads before closing the database
+    m_pTrackAnalysisScheduler->stop();
+}
+
+void LibraryAnalysisRunner::slotStopped() {
+    m_eventLoop.quit();
+}
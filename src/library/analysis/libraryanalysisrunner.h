@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QObject>
+#include <memory>
+
+#include "analyzer/trackanalysisscheduler.h"
+#include "preferences/usersettings.h"
+#include "util/db/dbconnectionpool.h"
+
+class Track;
+class TrackCollectionManager;
+
+/// Analyzes all tracks in the library without a user interface.
+///
+/// Used for `mixxx --analyze-library`. Only the database and the track
+/// collection are initialized, neither sound devices nor controllers.
+/// The analysis utilizes all available cores. The results of each track
+/// are stored in the database as soon as the track has been analyzed.
+/// Only tracks without results are selected for analysis, i.e. an
+/// interrupted analysis continues where it stopped when invoked again.
+/// Tracks for which the analysis did not detect a BPM are marked in the
+/// database and are not selected again until the file has been modified.
+class LibraryAnalysisRunner : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit LibraryAnalysisRunner(UserSettingsPointer pConfig);
+    ~LibraryAnalysisRunner() override;
+
+    /// Blocks until all tracks have been analyzed and returns
+    /// the exit code of the application.
+    int exec();
+
+  private slots:
+    void slotTrackProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
+    void slotProgress(
+            AnalyzerProgress currentTrackProgress,
+            int currentTrackNumber,
+            int totalTracksCount);
+    void slotFinished();
+    void slotStopped();
+
+  private:
+    bool initialize();
+    void finalize();
+
+    void reportProgress(int totalTracksCount);
+
+    /// Deletes outdated markers
+    bool hasNoBpmMarker(TrackId trackId);
+    void saveNoBpmMarker(const Track& track);
+
+    const UserSettingsPointer m_pConfig;
+
+    mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    std::unique_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+    TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+
+    QEventLoop m_eventLoop;
+    QElapsedTimer m_elapsedTimer;
+    QElapsedTimer m_reportTimer;
+    int m_totalTracksCount;
+    int m_reportedTracksCount;
+    bool m_finished;
+};
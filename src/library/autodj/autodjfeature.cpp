@@ -3,6 +3,7 @@
 #include <QMenu>
 #include <QtDebug>
 
+#include "analyzer/analyzerscheduledtrack.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "library/autodj/autodjprocessor.h"
 #include "library/autodj/dlgautodj.h"
@@ -121,6 +122,13 @@ AutoDJFeature::AutoDJFeature(Library* pLibrary,
             &QAction::triggered,
             this,
             &AutoDJFeature::slotClearQueue);
+    // Create context-menu item for analyzing all tracks in the auto-DJ queue
+    // before any batch analysis
+    m_pAnalyzeQueueAction = make_parented<QAction>(tr("Analyze Auto DJ Queue"), this);
+    connect(m_pAnalyzeQueueAction.get(),
+            &QAction::triggered,
+            this,
+            &AutoDJFeature::slotAnalyzeQueue);
     // Create context menu item to allow crates to be removed from AutoDJ sources.
     // onRightClickChild() gets the clicked crate's id form the sidebar model and
     // assigns it to this action's data.
@@ -267,6 +275,19 @@ void AutoDJFeature::slotClearQueue() {
     clear();
 }
 
+void AutoDJFeature::slotAnalyzeQueue() {
+    const QList<TrackId> trackIds =
+            m_playlistDao.getTrackIdsInPlaylistOrder(m_iAutoDJPlaylistId);
+    QList<AnalyzerScheduledTrack> tracks;
+    tracks.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        tracks.append(AnalyzerScheduledTrack(trackId,
+                AnalyzerTrack::Options(),
+                AnalyzerScheduledTrack::Priority::AutoDJ));
+    }
+    emit m_pLibrary->analyzeTracks(tracks);
+}
+
 // Add a crate to the AutoDJ sources
 void AutoDJFeature::slotAddCrateToAutoDj(CrateId crateId) {
     m_pTrackCollection->updateAutoDjCrate(crateId, true);
@@ -376,6 +397,7 @@ void AutoDJFeature::onRightClick(const QPoint& globalPos) {
         menu.addAction(m_pDisableAutoDJAction.get());
     }
     menu.addAction(m_pClearQueueAction.get());
+    menu.addAction(m_pAnalyzeQueueAction.get());
     menu.exec(globalPos);
 }
 
@@ -84,6 +84,7 @@ class AutoDJFeature : public LibraryFeature {
     parented_ptr<QAction> m_pEnableAutoDJAction;
     parented_ptr<QAction> m_pDisableAutoDJAction;
     parented_ptr<QAction> m_pClearQueueAction;
+    parented_ptr<QAction> m_pAnalyzeQueueAction;
 
     // A context-menu item that allows crates to be removed from the
     // auto-DJ list.
@@ -95,6 +96,7 @@ class AutoDJFeature : public LibraryFeature {
     void slotEnableAutoDJ();
     void slotDisableAutoDJ();
     void slotClearQueue();
+    void slotAnalyzeQueue();
 
     // Add a crate to the auto-DJ queue.
     void slotAddCrateToAutoDj(CrateId crateId);
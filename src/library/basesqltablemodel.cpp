@@ -45,6 +45,8 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
+          m_tablePositionColumn(-1),
+          m_bTableRowsValid(false),
           m_bInitialized(false) {
 }
 
@@ -210,6 +212,16 @@ void BaseSqlTableModel::select() {
     PerformanceTimer time;
     time.start();
 
+    if (!queryTableRows()) {
+        return;
+    }
+    updateRows();
+
+    qDebug() << this << "select() returned" << m_rowInfo.size()
+             << "results in" << time.elapsed().debugMillisWithUnit();
+}
+
+bool BaseSqlTableModel::queryTableRows() {
     // Prepare query for id and all columns not in m_trackSource
     QString queryString = QString("SELECT %1 FROM %2 %3")
                                   .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
@@ -224,23 +236,17 @@ void BaseSqlTableModel::select() {
     query.setForwardOnly(true);
     if (!query.prepare(queryString)) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
     QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
     int idColumn = -1;
     int posColumn = -1;
     while (query.next()) {
@@ -262,14 +268,11 @@ void BaseSqlTableModel::select() {
             qCritical()
                     << "ID column not available in database query results:"
                     << m_idColumn;
-            return;
+            return false;
         }
 
-        TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
-
         RowInfo rowInfo;
-        rowInfo.trackId = trackId;
+        rowInfo.trackId = TrackId(sqlRecord.value(idColumn));
         rowInfo.row = rowInfos.size();
 
         rowInfo.columnValues.reserve(sqlRecord.count());
@@ -283,7 +286,29 @@ void BaseSqlTableModel::select() {
         qDebug() << "Rows actually received:" << rowInfos.size();
     }
 
+    m_tableRows = std::move(rowInfos);
+    m_tablePositionColumn = posColumn;
+    m_bTableRowsValid = true;
+    return true;
+}
+
+void BaseSqlTableModel::updateRows() {
+    // Remove all the rows from the table after(!) the query has been
+    // executed successfully. See issue #6782.
+    // TODO(rryan) we could edit the table in place instead of clearing it?
+    clearRows();
+
+    // Copied for reordering, the column values are implicitly shared
+    QVector<RowInfo> rowInfos = m_tableRows;
+    const int posColumn = m_tablePositionColumn;
+
     if (m_trackSource) {
+        QSet<TrackId> trackIds;
+        trackIds.reserve(rowInfos.size());
+        for (const auto& rowInfo : std::as_const(rowInfos)) {
+            trackIds.insert(rowInfo.trackId);
+        }
+
         m_trackSource->filterAndSort(trackIds,
                 m_currentSearch,
                 m_currentSearchFilter,
@@ -348,9 +373,6 @@ void BaseSqlTableModel::select() {
             std::move(trackPosToRows));
     // Both rowInfo and trackIdToRows (might) have been moved and
     // must not be used afterwards!
-
-    qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -363,6 +385,9 @@ void BaseSqlTableModel::setTable(QString tableName,
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
     m_tableColumns = std::move(tableColumns);
+    m_tableRows.clear();
+    m_tablePositionColumn = -1;
+    m_bTableRowsValid = false;
 
     if (m_trackSource) {
         disconnect(m_trackSource.data(),
@@ -431,7 +456,24 @@ void BaseSqlTableModel::search(const QString& searchText, const QString& extraFi
         qDebug() << this << "search" << searchText;
     }
     setSearch(searchText, extraFilter);
-    select();
+    if (!m_bInitialized) {
+        return;
+    }
+    if (!m_bTableRowsValid) {
+        select();
+        return;
+    }
+
+    // Only the track source evaluates the search, so the rows of the table
+    // from the last select() are reused. Together with the in-memory index
+    // of BaseTrackCache typing a search doesn't query the database.
+    PerformanceTimer time;
+    time.start();
+
+    updateRows();
+
+    qDebug() << this << "search() returned" << m_rowInfo.size()
+             << "results in" << time.elapsed().debugMillisWithUnit();
 }
 
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
@@ -156,6 +156,10 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     typedef QHash<TrackId, QVector<int>> TrackId2Rows;
     typedef QHash<int, int> TrackPos2Row;
 
+    // Queries the rows of the table into m_tableRows
+    bool queryTableRows();
+    // Filters and sorts m_tableRows by the track source into m_rowInfo
+    void updateRows();
     void clearRows();
     void replaceRows(
             QVector<RowInfo>&& rows,
@@ -164,6 +168,12 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     QVector<RowInfo> m_rowInfo;
 
+    // The unfiltered rows of the last select(). They are reused by search(),
+    // because the search is only applied to the track source.
+    QVector<RowInfo> m_tableRows;
+    int m_tablePositionColumn;
+    bool m_bTableRowsValid;
+
     QString m_idColumn;
     QSharedPointer<BaseTrackCache> m_trackSource;
     QStringList m_tableColumns;
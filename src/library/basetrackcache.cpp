@@ -1,5 +1,8 @@
 #include "library/basetrackcache.h"
 
+#include <QBitArray>
+
+#include "library/dao/trackschema.h"
 #include "library/queryutil.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
@@ -14,6 +17,30 @@ namespace {
 
 constexpr bool sDebug = false;
 
+// All other columns are stored as texts in the index
+const QStringList kNumberColumns = {
+        LIBRARYTABLE_ID,
+        LIBRARYTABLE_PLAYED,
+        LIBRARYTABLE_TIMESPLAYED,
+        LIBRARYTABLE_RATING,
+        LIBRARYTABLE_KEY_ID,
+        LIBRARYTABLE_BPM,
+        LIBRARYTABLE_BPM_LOCK,
+        LIBRARYTABLE_DURATION,
+        LIBRARYTABLE_BITRATE,
+        LIBRARYTABLE_REPLAYGAIN,
+        LIBRARYTABLE_SAMPLERATE,
+        LIBRARYTABLE_CHANNELS,
+        LIBRARYTABLE_MIXXXDELETED,
+        TRACKLOCATIONSTABLE_FSDELETED,
+        LIBRARYTABLE_COLOR,
+        LIBRARYTABLE_COVERART_SOURCE,
+        LIBRARYTABLE_COVERART_TYPE,
+        LIBRARYTABLE_COVERART_COLOR,
+        LIBRARYTABLE_COVERART_HASH,
+        PLAYLISTTRACKSTABLE_POSITION,
+};
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -26,11 +53,12 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_idColumn(std::move(idColumn)),
           m_columnCount(columns.size()),
           m_columnsJoined(columns.join(",")),
-          m_columnCache(std::move(columns)),
+          m_columnCache(columns),
           m_pQueryParser(std::make_unique<SearchQueryParser>(
                   pTrackCollection, std::move(searchColumns))),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
+          m_index(columns, kNumberColumns),
           m_database(pTrackCollection->database()) {
 }
 
@@ -83,6 +111,7 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     }
     for (const auto& trackId : std::as_const(trackIds)) {
         m_trackInfo.remove(trackId);
+        m_index.removeTrack(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -176,6 +205,7 @@ bool BaseTrackCache::updateTrackInIndex(
         for (int i = 0; i < numColumns; ++i) {
             record[i] = getTrackValueForColumn(pTrack, i);
         }
+        m_index.setTrack(trackId, record);
         if (m_bIsCaching) {
             replaceRecentTrack(trackId, pTrack);
         }
@@ -227,6 +257,7 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        m_index.setTrack(trackId, record);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -249,6 +280,7 @@ void BaseTrackCache::buildIndex() {
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
     m_trackInfo.clear();
+    m_index.clear();
     if (m_bIsCaching) {
         resetRecentTrack();
     }
@@ -459,6 +491,16 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
+    if (filterAndSortInIndex(trackIds,
+                searchQuery,
+                extraFilter,
+                !orderByClause.isEmpty(),
+                sortColumns,
+                columnOffset,
+                trackToIndex)) {
+        return;
+    }
+
     QStringList idStrings;
     // TODO(rryan) consider making this the data passed in and a separate
     // QVector for output
@@ -601,6 +643,120 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+bool BaseTrackCache::filterAndSortInIndex(const QSet<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        bool sort,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QHash<TrackId, int>* trackToIndex) {
+    PerformanceTimer timer;
+    timer.start();
+
+    // The same sort columns as in BaseSqlTableModel::setSort()
+    std::vector<ColumnarTrackIndex::SortKey> sortKeys;
+    if (sort) {
+        for (const auto& sortColumn : sortColumns) {
+            int column;
+            if (sortColumn.m_column == 0) {
+                // The id column
+                column = 0;
+            } else if (sortColumn.m_column <= columnOffset) {
+                // Other columns of the model can't be sorted here
+                continue;
+            } else {
+                column = sortColumn.m_column - columnOffset;
+            }
+            VERIFY_OR_DEBUG_ASSERT(column < columnCount()) {
+                return false;
+            }
+            auto mode = ColumnarTrackIndex::SortMode::Default;
+            if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
+                mode = ColumnarTrackIndex::SortMode::Key;
+                // Like the database, which sorts by the key id
+                const int keyIdColumn = fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID);
+                if (keyIdColumn >= 0) {
+                    column = keyIdColumn;
+                }
+            } else if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER)) {
+                mode = ColumnarTrackIndex::SortMode::Integer;
+            }
+            sortKeys.push_back({column, sortColumn.m_order, mode});
+        }
+    }
+
+    // Tracks that are not indexed yet, e.g. because they were added to
+    // the database without a notification
+    QStringList missingIdStrings;
+    for (const auto& trackId : trackIds) {
+        if (!m_trackInfo.contains(trackId)) {
+            missingIdStrings << trackId.toString();
+        }
+    }
+    if (!missingIdStrings.isEmpty()) {
+        updateIndexWithQuery(QString("SELECT %1 FROM %2 WHERE %3 in (%4)")
+                                     .arg(m_columnsJoined,
+                                             m_tableName,
+                                             m_idColumn,
+                                             missingIdStrings.join(",")));
+    }
+    updateDirtyTracksInIndex(trackIds);
+
+    const std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(searchQuery, extraFilter);
+    QBitArray matchingRows(m_index.rowCount());
+    if (!pQuery->selectRows(m_index, &matchingRows)) {
+        return false;
+    }
+
+    std::vector<int> rows;
+    rows.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        const int row = m_index.rowForTrack(trackId);
+        if (row >= 0 && matchingRows.testBit(row)) {
+            rows.push_back(row);
+        }
+    }
+    if (!sortKeys.empty()) {
+        m_index.sortRows(&rows, sortKeys, m_columnCache.keyNotation());
+    }
+
+    m_trackOrder.resize(0); // keeps allocated memory
+    m_trackOrder.reserve(static_cast<int>(rows.size()));
+    trackToIndex->clear();
+    trackToIndex->reserve(static_cast<int>(rows.size()));
+    for (const int row : rows) {
+        const TrackId trackId = m_index.trackIdForRow(row);
+        (*trackToIndex)[trackId] = m_trackOrder.size();
+        m_trackOrder.append(trackId);
+    }
+
+    if (sDebug) {
+        qDebug() << this << "filterAndSortInIndex took"
+                 << timer.elapsed().debugMillisWithUnit();
+    }
+    return true;
+}
+
+void BaseTrackCache::updateDirtyTracksInIndex(const QSet<TrackId>& trackIds) {
+    if (!m_bIsCaching) {
+        return;
+    }
+    // Copied, because saving an evicted track modifies m_dirtyTracks
+    const QSet<TrackId> dirtyTracks = m_dirtyTracks;
+    for (const auto& trackId : dirtyTracks) {
+        if (!trackIds.contains(trackId)) {
+            continue;
+        }
+        // Only get the track if it is in the cache. Tracks that
+        // are not cached in memory cannot be dirty.
+        TrackPointer pTrack = GlobalTrackCacheLocker().lookupTrackById(trackId);
+        if (pTrack) {
+            updateTrackInIndex(pTrack);
+        }
+    }
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
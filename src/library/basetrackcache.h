@@ -10,6 +10,7 @@
 #include <QVector>
 #include <memory>
 
+#include "library/columnartrackindex.h"
 #include "library/columncache.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
@@ -98,6 +99,17 @@ class BaseTrackCache : public QObject {
     void updateTracksInIndex(const QSet<TrackId>& trackIds);
     QVariant getTrackValueForColumn(TrackPointer pTrack, int column) const;
 
+    // Returns false if the query or the sort order can only be evaluated
+    // by the database.
+    bool filterAndSortInIndex(const QSet<TrackId>& trackIds,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            bool sort,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QHash<TrackId, int>* trackToIndex);
+    void updateDirtyTracksInIndex(const QSet<TrackId>& trackIds);
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -137,6 +149,8 @@ class BaseTrackCache : public QObject {
     bool m_bIndexBuilt;
     bool m_bIsCaching;
     QHash<TrackId, QVector<QVariant>> m_trackInfo;
+    // The same values as m_trackInfo for searching and sorting
+    ColumnarTrackIndex m_index;
     QSqlDatabase m_database;
 
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
@@ -0,0 +1,416 @@
+#include "library/columnartrackindex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+constexpr double kNull = std::numeric_limits<double>::quiet_NaN();
+// Null values are sorted first in ascending order
+constexpr double kNullSortValue = -std::numeric_limits<double>::infinity();
+
+double toNumber(const QVariant& value) {
+    if (value.isNull()) {
+        return kNull;
+    }
+    bool ok = false;
+    const double number = value.toDouble(&ok);
+    return ok ? number : kNull;
+}
+
+/// Like CAST(text AS INTEGER) in SQLite, which is 0 for texts that don't
+/// start with a number.
+double leadingInteger(const QString& text) {
+    int i = 0;
+    while (i < text.size() && text[i].isSpace()) {
+        ++i;
+    }
+    const bool negative = i < text.size() && text[i] == QChar('-');
+    if (i < text.size() && (text[i] == QChar('-') || text[i] == QChar('+'))) {
+        ++i;
+    }
+    double value = 0;
+    for (; i < text.size() && text[i] >= QChar('0') && text[i] <= QChar('9'); ++i) {
+        value = value * 10 + text[i].digitValue();
+    }
+    return negative ? -value : value;
+}
+
+constexpr int kTrigramLength = 3;
+
+quint64 trigramAt(const QString& text, int i) {
+    return (static_cast<quint64>(text[i].unicode()) << 32) |
+            (static_cast<quint64>(text[i + 1].unicode()) << 16) |
+            static_cast<quint64>(text[i + 2].unicode());
+}
+
+} // anonymous namespace
+
+ColumnarTrackIndex::ColumnarTrackIndex(
+        const QStringList& columnNames, const QStringList& numberColumns) {
+    m_columns.resize(columnNames.size());
+    for (int i = 0; i < columnNames.size(); ++i) {
+        m_columnIndexByName.insert(columnNames[i], i);
+        m_columns[i].type = numberColumns.contains(columnNames[i])
+                ? ColumnType::Number
+                : ColumnType::Text;
+    }
+}
+
+void ColumnarTrackIndex::clear() {
+    for (auto& column : m_columns) {
+        column.text = TextColumn();
+        column.numbers.clear();
+    }
+    m_trackIds.clear();
+    m_rowByTrackId.clear();
+}
+
+int ColumnarTrackIndex::internText(TextColumn* pColumn, const QString& text) {
+    const auto it = pColumn->idByText.constFind(text);
+    if (it != pColumn->idByText.constEnd()) {
+        return it.value();
+    }
+    const auto id = static_cast<int>(pColumn->texts.size());
+    QString latinLowText = text;
+    mixxx::DbConnection::makeStringLatinLow(&latinLowText);
+    pColumn->texts.push_back(text);
+    pColumn->latinLowTexts.push_back(std::move(latinLowText));
+    pColumn->idByText.insert(text, id);
+    return id;
+}
+
+void ColumnarTrackIndex::setTrack(TrackId trackId, const QVector<QVariant>& values) {
+    DEBUG_ASSERT(trackId.isValid());
+    int row = rowForTrack(trackId);
+    if (row < 0) {
+        row = rowCount();
+        m_trackIds.push_back(trackId);
+        m_rowByTrackId.insert(trackId, row);
+        for (auto& column : m_columns) {
+            if (column.type == ColumnType::Text) {
+                column.text.ids.push_back(-1);
+            } else {
+                column.numbers.push_back(kNull);
+            }
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(m_columns.size()); ++i) {
+        Column& column = m_columns[i];
+        const QVariant value = values.value(i);
+        if (column.type == ColumnType::Text) {
+            column.text.ids[row] = value.isNull()
+                    ? -1
+                    : internText(&column.text, value.toString());
+        } else {
+            column.numbers[row] = toNumber(value);
+        }
+    }
+}
+
+void ColumnarTrackIndex::removeTrack(TrackId trackId) {
+    const int row = rowForTrack(trackId);
+    if (row < 0) {
+        return;
+    }
+    // Fill the gap with the last row
+    const int lastRow = rowCount() - 1;
+    if (row != lastRow) {
+        m_trackIds[row] = m_trackIds[lastRow];
+        m_rowByTrackId.insert(m_trackIds[row], row);
+        for (auto& column : m_columns) {
+            if (column.type == ColumnType::Text) {
+                column.text.ids[row] = column.text.ids[lastRow];
+            } else {
+                column.numbers[row] = column.numbers[lastRow];
+            }
+        }
+    }
+    m_trackIds.pop_back();
+    m_rowByTrackId.remove(trackId);
+    for (auto& column : m_columns) {
+        if (column.type == ColumnType::Text) {
+            column.text.ids.pop_back();
+        } else {
+            column.numbers.pop_back();
+        }
+    }
+}
+
+double ColumnarTrackIndex::number(int row, int column) const {
+    const Column& col = m_columns[column];
+    if (col.type != ColumnType::Number) {
+        return kNull;
+    }
+    return col.numbers[row];
+}
+
+QString ColumnarTrackIndex::text(int row, int column) const {
+    const Column& col = m_columns[column];
+    if (col.type != ColumnType::Text || col.text.ids[row] < 0) {
+        return QString();
+    }
+    return col.text.texts[col.text.ids[row]];
+}
+
+void ColumnarTrackIndex::selectText(int column,
+        const std::function<bool(const QString&)>& predicate,
+        QBitArray* pRows) const {
+    DEBUG_ASSERT(pRows->size() == rowCount());
+    const Column& col = m_columns[column];
+    if (col.type == ColumnType::Number) {
+        for (int row = 0; row < rowCount(); ++row) {
+            const double number = col.numbers[row];
+            if (!std::isnan(number) && predicate(QString::number(number))) {
+                pRows->setBit(row);
+            }
+        }
+        return;
+    }
+
+    std::vector<char> matches(col.text.texts.size());
+    for (std::size_t id = 0; id < matches.size(); ++id) {
+        matches[id] = predicate(col.text.latinLowTexts[id]);
+    }
+    selectTextIds(col.text, matches, pRows);
+}
+
+// static
+void ColumnarTrackIndex::updateTrigrams(const TextColumn& column) {
+    for (auto id = column.trigramTextCount; id < column.latinLowTexts.size(); ++id) {
+        const QString& text = column.latinLowTexts[id];
+        for (int i = 0; i + kTrigramLength <= text.size(); ++i) {
+            std::vector<int>& ids = column.idsByTrigram[trigramAt(text, i)];
+            // A text may contain the same trigram more than once
+            if (ids.empty() || ids.back() != static_cast<int>(id)) {
+                ids.push_back(static_cast<int>(id));
+            }
+        }
+    }
+    column.trigramTextCount = column.latinLowTexts.size();
+}
+
+void ColumnarTrackIndex::selectTextContaining(int column,
+        const QString& latinLowNeedle,
+        QBitArray* pRows) const {
+    DEBUG_ASSERT(pRows->size() == rowCount());
+    const Column& col = m_columns[column];
+    if (col.type == ColumnType::Number || latinLowNeedle.size() < kTrigramLength) {
+        selectText(column,
+                [&latinLowNeedle](const QString& text) {
+                    return text.contains(latinLowNeedle);
+                },
+                pRows);
+        return;
+    }
+
+    updateTrigrams(col.text);
+    std::vector<const std::vector<int>*> trigramIds;
+    for (int i = 0; i + kTrigramLength <= latinLowNeedle.size(); ++i) {
+        const auto it = col.text.idsByTrigram.constFind(trigramAt(latinLowNeedle, i));
+        if (it == col.text.idsByTrigram.constEnd()) {
+            // No text contains this trigram
+            return;
+        }
+        trigramIds.push_back(&it.value());
+    }
+    // Intersect starting with the rarest trigram to keep the candidates few
+    std::sort(trigramIds.begin(),
+            trigramIds.end(),
+            [](const std::vector<int>* pLhs, const std::vector<int>* pRhs) {
+                return pLhs->size() < pRhs->size();
+            });
+    std::vector<int> candidates = *trigramIds.front();
+    std::vector<int> intersection;
+    for (std::size_t i = 1; i < trigramIds.size() && !candidates.empty(); ++i) {
+        intersection.clear();
+        std::set_intersection(candidates.begin(),
+                candidates.end(),
+                trigramIds[i]->begin(),
+                trigramIds[i]->end(),
+                std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+
+    std::vector<char> matches(col.text.texts.size());
+    for (const int id : candidates) {
+        // The trigrams are not necessarily adjacent in the text
+        matches[id] = col.text.latinLowTexts[id].contains(latinLowNeedle);
+    }
+    selectTextIds(col.text, matches, pRows);
+}
+
+void ColumnarTrackIndex::selectTextIds(const TextColumn& column,
+        const std::vector<char>& matches,
+        QBitArray* pRows) const {
+    for (int row = 0; row < rowCount(); ++row) {
+        const int id = column.ids[row];
+        if (id >= 0 && matches[id]) {
+            pRows->setBit(row);
+        }
+    }
+}
+
+void ColumnarTrackIndex::selectNumber(int column,
+        const std::function<bool(double)>& predicate,
+        QBitArray* pRows) const {
+    DEBUG_ASSERT(pRows->size() == rowCount());
+    const Column& col = m_columns[column];
+    if (col.type == ColumnType::Text) {
+        std::vector<char> matches(col.text.texts.size());
+        for (std::size_t id = 0; id < matches.size(); ++id) {
+            matches[id] = predicate(col.text.texts[id].toDouble());
+        }
+        selectTextIds(col.text, matches, pRows);
+        return;
+    }
+
+    for (int row = 0; row < rowCount(); ++row) {
+        const double number = col.numbers[row];
+        if (!std::isnan(number) && predicate(number)) {
+            pRows->setBit(row);
+        }
+    }
+}
+
+void ColumnarTrackIndex::selectNull(int column, QBitArray* pRows) const {
+    DEBUG_ASSERT(pRows->size() == rowCount());
+    const Column& col = m_columns[column];
+    for (int row = 0; row < rowCount(); ++row) {
+        if (col.type == ColumnType::Text ? col.text.ids[row] < 0
+                                         : std::isnan(col.numbers[row])) {
+            pRows->setBit(row);
+        }
+    }
+}
+
+void ColumnarTrackIndex::selectTracks(
+        const std::vector<TrackId>& trackIds, QBitArray* pRows) const {
+    DEBUG_ASSERT(pRows->size() == rowCount());
+    for (const auto& trackId : trackIds) {
+        const int row = rowForTrack(trackId);
+        if (row >= 0) {
+            pRows->setBit(row);
+        }
+    }
+}
+
+const std::vector<int>& ColumnarTrackIndex::collationRanks(const TextColumn& column) const {
+    // Texts are only appended until the index is cleared
+    if (column.ranks.size() == column.texts.size()) {
+        return column.ranks;
+    }
+
+    std::vector<QCollatorSortKey> sortKeys;
+    sortKeys.reserve(column.texts.size());
+    for (const auto& text : column.texts) {
+        sortKeys.push_back(m_collator.sortKey(text));
+    }
+    std::vector<int> order(column.texts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&sortKeys](int lhs, int rhs) {
+        return sortKeys[lhs].compare(sortKeys[rhs]) < 0;
+    });
+
+    // Texts that collate equally get the same rank
+    column.ranks.resize(column.texts.size());
+    int rank = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        if (i > 0 && sortKeys[order[i - 1]].compare(sortKeys[order[i]]) != 0) {
+            ++rank;
+        }
+        column.ranks[order[i]] = rank;
+    }
+    return column.ranks;
+}
+
+std::vector<double> ColumnarTrackIndex::sortValues(const std::vector<int>& rows,
+        const SortKey& sortKey,
+        KeyUtils::KeyNotation keyNotation) const {
+    const Column& col = m_columns[sortKey.column];
+    std::vector<double> values(rows.size(), kNullSortValue);
+    if (col.type == ColumnType::Number) {
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const double number = col.numbers[rows[i]];
+            if (std::isnan(number)) {
+                continue;
+            }
+            if (sortKey.mode == SortMode::Key) {
+                values[i] = KeyUtils::keyToCircleOfFifthsOrder(
+                        static_cast<mixxx::track::io::key::ChromaticKey>(
+                                static_cast<int>(number)),
+                        keyNotation);
+            } else {
+                values[i] = number;
+            }
+        }
+        return values;
+    }
+
+    // The values are computed once for each distinct text
+    std::vector<double> textValues(col.text.texts.size());
+    switch (sortKey.mode) {
+    case SortMode::Default: {
+        const std::vector<int>& ranks = collationRanks(col.text);
+        std::copy(ranks.begin(), ranks.end(), textValues.begin());
+        break;
+    }
+    case SortMode::Integer:
+        for (std::size_t id = 0; id < textValues.size(); ++id) {
+            textValues[id] = leadingInteger(col.text.texts[id]);
+        }
+        break;
+    case SortMode::Key:
+        for (std::size_t id = 0; id < textValues.size(); ++id) {
+            textValues[id] = KeyUtils::keyToCircleOfFifthsOrder(
+                    KeyUtils::guessKeyFromText(col.text.texts[id]), keyNotation);
+        }
+        break;
+    }
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const int id = col.text.ids[rows[i]];
+        if (id >= 0) {
+            values[i] = textValues[id];
+        }
+    }
+    return values;
+}
+
+void ColumnarTrackIndex::sortRows(std::vector<int>* pRows,
+        const std::vector<SortKey>& sortKeys,
+        KeyUtils::KeyNotation keyNotation) const {
+    std::vector<std::vector<double>> values;
+    values.reserve(sortKeys.size());
+    for (const auto& sortKey : sortKeys) {
+        values.push_back(sortValues(*pRows, sortKey, keyNotation));
+    }
+
+    std::vector<int> order(pRows->size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+        for (std::size_t i = 0; i < sortKeys.size(); ++i) {
+            const double lhsValue = values[i][lhs];
+            const double rhsValue = values[i][rhs];
+            if (lhsValue != rhsValue) {
+                return sortKeys[i].order == Qt::AscendingOrder
+                        ? lhsValue < rhsValue
+                        : lhsValue > rhsValue;
+            }
+        }
+        return m_trackIds[(*pRows)[lhs]] < m_trackIds[(*pRows)[rhs]];
+    });
+
+    std::vector<int> sortedRows;
+    sortedRows.reserve(order.size());
+    for (const int i : order) {
+        sortedRows.push_back((*pRows)[i]);
+    }
+    *pRows = std::move(sortedRows);
+}
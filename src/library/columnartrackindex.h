@@ -0,0 +1,149 @@
+#pragma once
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <functional>
+#include <vector>
+
+#include "track/keyutils.h"
+#include "track/trackid.h"
+#include "util/string.h"
+
+/// A column oriented copy of the track values in BaseTrackCache, which
+/// allows to search and sort without querying the database.
+///
+/// Numbers are stored unboxed. Texts are interned per column, so predicates
+/// on texts are evaluated only once for each distinct value, and texts are
+/// sorted by precomputed collation ranks.
+class ColumnarTrackIndex {
+  public:
+    enum class ColumnType {
+        Text,
+        Number,
+    };
+
+    /// How the values of a column are ordered, see the sort expressions in
+    /// ColumnCache.
+    enum class SortMode {
+        /// Numbers by value and texts by collation
+        Default,
+        /// Texts by their leading integer, like CAST(text AS INTEGER)
+        Integer,
+        /// Key ids in the order of the circle of fifths
+        Key,
+    };
+
+    struct SortKey {
+        int column;
+        Qt::SortOrder order;
+        SortMode mode;
+    };
+
+    /// Columns are texts unless listed in numberColumns
+    ColumnarTrackIndex(const QStringList& columnNames, const QStringList& numberColumns);
+
+    int rowCount() const {
+        return static_cast<int>(m_trackIds.size());
+    }
+
+    /// Returns -1 if there is no column with this name
+    int columnIndex(const QString& columnName) const {
+        return m_columnIndexByName.value(columnName, -1);
+    }
+
+    ColumnType columnType(int column) const {
+        return m_columns[column].type;
+    }
+
+    /// Returns -1 if the track is not indexed
+    int rowForTrack(TrackId trackId) const {
+        return m_rowByTrackId.value(trackId, -1);
+    }
+
+    TrackId trackIdForRow(int row) const {
+        return m_trackIds[row];
+    }
+
+    void clear();
+
+    /// Inserts or replaces the values of a track, with one value per column
+    void setTrack(TrackId trackId, const QVector<QVariant>& values);
+    void removeTrack(TrackId trackId);
+
+    /// Returns NaN for null values and for text columns
+    double number(int row, int column) const;
+    /// Returns a null string for null values and for number columns
+    QString text(int row, int column) const;
+
+    // The select functions set the bits of the rows that match in pRows,
+    // which must have rowCount() bits. Null values never match.
+
+    /// The predicate is evaluated with the texts converted by
+    /// DbConnection::makeStringLatinLow.
+    void selectText(int column,
+            const std::function<bool(const QString&)>& predicate,
+            QBitArray* pRows) const;
+    /// Texts are converted like by QString::toDouble(), i.e. to 0 if they
+    /// are not a number.
+    void selectNumber(int column,
+            const std::function<bool(double)>& predicate,
+            QBitArray* pRows) const;
+    /// Selects the texts that contain the latin-low needle. The texts are
+    /// looked up by the trigrams of the needle, so only texts that contain
+    /// all of them are compared.
+    void selectTextContaining(int column,
+            const QString& latinLowNeedle,
+            QBitArray* pRows) const;
+    void selectNull(int column, QBitArray* pRows) const;
+    void selectTracks(const std::vector<TrackId>& trackIds, QBitArray* pRows) const;
+
+    /// Sorts by the keys in order. Null values are sorted first in ascending
+    /// order like SQLite does and ties are sorted by track id.
+    void sortRows(std::vector<int>* pRows,
+            const std::vector<SortKey>& sortKeys,
+            KeyUtils::KeyNotation keyNotation) const;
+
+  private:
+    struct TextColumn {
+        // One id into the texts per row, -1 for null values
+        std::vector<int> ids;
+        std::vector<QString> texts;
+        std::vector<QString> latinLowTexts;
+        QHash<QString, int> idByText;
+        // The rank of each text in collation order, outdated when it has
+        // fewer entries than texts
+        mutable std::vector<int> ranks;
+        // The ids of the texts that contain each trigram of the latin-low
+        // texts in ascending order. Only the first trigramTextCount texts
+        // are indexed, the others are added before the next lookup.
+        mutable QHash<quint64, std::vector<int>> idsByTrigram;
+        mutable std::size_t trigramTextCount = 0;
+    };
+
+    struct Column {
+        ColumnType type;
+        TextColumn text;
+        // One value per row, NaN for null values
+        std::vector<double> numbers;
+    };
+
+    int internText(TextColumn* pColumn, const QString& text);
+    static void updateTrigrams(const TextColumn& column);
+    void selectTextIds(const TextColumn& column,
+            const std::vector<char>& matches,
+            QBitArray* pRows) const;
+    const std::vector<int>& collationRanks(const TextColumn& column) const;
+    std::vector<double> sortValues(const std::vector<int>& rows,
+            const SortKey& sortKey,
+            KeyUtils::KeyNotation keyNotation) const;
+
+    const mixxx::StringCollator m_collator;
+    QHash<QString, int> m_columnIndexByName;
+    std::vector<Column> m_columns;
+    std::vector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowByTrackId;
+};
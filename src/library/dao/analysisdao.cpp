@@ -10,6 +10,7 @@
 #include "waveform/waveform.h"
 
 const QString AnalysisDao::s_analysisTableName = "track_analysis";
+const QString AnalysisDao::s_cachedAnalysisTableName = "cached_analysis";
 
 // For a track that takes 1.2MB to store the big waveform, the default
 // compression level (-1) takes the size down to about 600KB. The difference
@@ -350,8 +351,8 @@ void AnalysisDao::saveTrackAnalyses(
                  << "waveform analysis for trackId" << trackId
                  << "analysisId" << analysis.analysisId;
 
-    // Clear analysisId since we are re-using the AnalysisInfo
-    analysis.analysisId = -1;
+    // Reset analysisId since we are re-using the AnalysisInfo
+    analysis.analysisId = pWaveSummary->getId();
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
@@ -416,3 +417,52 @@ bool AnalysisDao::deleteAnalysesByType(
 
     return true;
 }
+
+QByteArray AnalysisDao::getCachedResults(
+        const QString& contentHash,
+        const QString& analyzer,
+        const QString& version) const {
+    if (!m_database.isOpen() || contentHash.isEmpty()) {
+        return QByteArray();
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "SELECT data FROM %1 "
+            "WHERE content_hash=:contentHash AND analyzer=:analyzer AND version=:version")
+                          .arg(s_cachedAnalysisTableName));
+    query.bindValue(":contentHash", contentHash);
+    query.bindValue(":analyzer", analyzer);
+    query.bindValue(":version", version);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't get cached analysis";
+        return QByteArray();
+    }
+    if (!query.next()) {
+        return QByteArray();
+    }
+    return query.value(0).toByteArray();
+}
+
+bool AnalysisDao::saveCachedResults(
+        const QString& contentHash,
+        const QString& analyzer,
+        const QString& version,
+        const QByteArray& data) const {
+    if (!m_database.isOpen() || contentHash.isEmpty() || data.isEmpty()) {
+        return false;
+    }
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+            "INSERT OR REPLACE INTO %1 (content_hash, analyzer, version, data) "
+            "VALUES (:contentHash,:analyzer,:version,:data)")
+                          .arg(s_cachedAnalysisTableName));
+    query.bindValue(":contentHash", contentHash);
+    query.bindValue(":analyzer", analyzer);
+    query.bindValue(":version", version);
+    query.bindValue(":data", data);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't save cached analysis";
+        return false;
+    }
+    return true;
+}
@@ -12,11 +12,15 @@ class QSqlDatabase;
 class AnalysisDao : public DAO {
   public:
     static const QString s_analysisTableName;
+    static const QString s_cachedAnalysisTableName;
 
     enum AnalysisType {
         TYPE_UNKNOWN = 0,
         TYPE_WAVEFORM,
-        TYPE_WAVESUMMARY
+        TYPE_WAVESUMMARY,
+        // Marks a track for which the analysis finished without detecting
+        // a BPM, e.g. spoken word. Contains no data.
+        TYPE_NO_BPM
     };
 
     struct AnalysisInfo {
@@ -57,6 +61,20 @@ class AnalysisDao : public DAO {
             ConstWaveformPointer pWaveform,
             ConstWaveformPointer pWaveSummary);
 
+    // Results of a single analyzer that are shared by all tracks with
+    // the same audio content. Returns an empty byte array if no results
+    // with a matching version are available.
+    QByteArray getCachedResults(
+            const QString& contentHash,
+            const QString& analyzer,
+            const QString& version) const;
+    // Replaces any results of this analyzer, independent of their version
+    bool saveCachedResults(
+            const QString& contentHash,
+            const QString& analyzer,
+            const QString& version,
+            const QByteArray& data) const;
+
   private:
     QDir getAnalysisStoragePath() const;
     QByteArray loadDataFromFile(const QString& fileName) const;
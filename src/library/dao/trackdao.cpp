@@ -329,6 +329,32 @@ QSet<QString> TrackDAO::getAllMissingTrackLocations() const {
     return collectTrackLocations(query);
 }
 
+QList<TrackId> TrackDAO::getUnanalyzedTrackIds(bool withWaveform) const {
+    QString queryString = QStringLiteral(
+            "SELECT library.id FROM library INNER JOIN track_locations "
+            "ON library.location = track_locations.id "
+            "WHERE library.mixxx_deleted=0 AND track_locations.fs_deleted=0 "
+            "AND (library.bpm IS NULL OR library.bpm<=0");
+    if (withWaveform) {
+        queryString += QStringLiteral(
+                " OR library.id NOT IN "
+                "(SELECT track_id FROM %1 WHERE type=%2)")
+                               .arg(AnalysisDao::s_analysisTableName,
+                                       QString::number(AnalysisDao::TYPE_WAVESUMMARY));
+    }
+    queryString += QStringLiteral(") ORDER BY library.id");
+    FwdSqlQuery query(m_database, queryString);
+    VERIFY_OR_DEBUG_ASSERT(!query.hasError() && query.execPrepared()) {
+        LOG_FAILED_QUERY(query);
+        return {};
+    }
+    QList<TrackId> trackIds;
+    while (query.next()) {
+        trackIds.append(TrackId(query.fieldValue(0)));
+    }
+    return trackIds;
+}
+
 // Some code (eg. drag and drop) needs to just get a track's location, and it's
 // not worth retrieving a whole Track.
 QString TrackDAO::getTrackLocation(TrackId trackId) const {
@@ -868,7 +894,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const QString& filePath,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::PreparedTrackImport* pPreparedImport) {
     const auto fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePath));
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
@@ -899,7 +926,10 @@ TrackPointer TrackDAO::addTracksAddFile(
             DEBUG_ASSERT(pTrack->getDateAdded().isValid());
             return pTrack;
         }
-        // The track is cached, but not yet in the database
+        // The track is cached, but not yet in the database. The file
+        // might have been modified since it has been parsed for the
+        // prepared import.
+        pPreparedImport = nullptr;
         break;
     }
     case GlobalTrackCacheLookupResult::Miss:
@@ -936,7 +966,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pPreparedImport);
     if (!pTrack->checkSourceSynchronized()) {
         kLogger.warning() << "addTracksAddFile:"
                           << "Failed to parse track metadata from file"
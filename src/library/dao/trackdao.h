@@ -9,6 +9,7 @@
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 
@@ -69,6 +70,11 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     QSet<QString> getAllMissingTrackLocations() const;
     QString getTrackLocation(TrackId trackId) const;
 
+    // Returns the ids of all existing tracks in the library that have
+    // not been analyzed yet, i.e. without a BPM or optionally without
+    // a waveform summary. Ordered by id for reproducible processing.
+    QList<TrackId> getUnanalyzedTrackIds(bool withWaveform) const;
+
     // Only used by friend class LibraryScanner, but public for testing!
     bool detectMovedTracks(
             QList<RelocatedTrack>* pRelocatedTracks,
@@ -158,9 +164,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    // The prepared import is only applied if a new track object is
+    // created for the file, i.e. if the file is not loaded yet.
     TrackPointer addTracksAddFile(
             const QString& filePath,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::PreparedTrackImport* pPreparedImport = nullptr);
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
@@ -3,6 +3,14 @@
 #include "moc_importfilestask.cpp"
 #include "util/timer.h"
 
+namespace {
+
+// Limits the number of tracks that are queued for the scanner thread,
+// which adds them to the database.
+constexpr int kMaxNewTracksPerBatch = 32;
+
+} // anonymous namespace
+
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
         const ScannerGlobalPointer scannerGlobal,
         const QString& dirPath,
@@ -22,6 +30,9 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(QStringLiteral("ImportFilesTask::run"));
+    const QList<QFileInfo> possibleCovers(
+            m_possibleCovers.begin(), m_possibleCovers.end());
+    QList<ScannedTrackFile> newTracks;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -49,9 +60,22 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            // Parse the file here in the worker thread. Only adding the
+            // track to the database is left for the scanner thread.
+            newTracks.append(ScannedTrackFile{trackLocation,
+                    SoundSourceProxy::prepareTrackImportFromNewFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            possibleCovers,
+                            m_scannerGlobal->resetMissingTagMetadataOnImport())});
+            if (newTracks.size() >= kMaxNewTracksPerBatch) {
+                emit addNewTracks(newTracks);
+                newTracks.clear();
+            }
         }
     }
+    if (!newTracks.isEmpty()) {
+        emit addNewTracks(newTracks);
+    }
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
     setSuccess(true);
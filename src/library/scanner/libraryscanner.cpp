@@ -1,7 +1,11 @@
 #include "library/scanner/libraryscanner.h"
 
+#include <QDir>
+#include <algorithm>
+
 #include "library/coverartutils.h"
 #include "library/library_decl.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "library/scanner/libraryscannerdlg.h"
 #include "library/scanner/recursivescandirectorytask.h"
@@ -21,8 +25,22 @@
 namespace {
 
 // TODO(rryan) make configurable
+// The directories are walked by a single thread, because a directory
+// that is reachable by multiple paths must always be discovered by the
+// same path, see testAndMarkDirectoryScanned().
 constexpr int kScannerThreadPoolSize = 1;
 
+// Parsing the metadata of new files is CPU bound, while the file system
+// is mostly accessed sequentially
+constexpr int kMaxImportThreadPoolSize = 4;
+
+const QString kJournalFileName = QStringLiteral("library_scan_journal.json");
+
+// Directories that have been modified shortly before the previous scan
+// are scanned again. The clocks of network file systems might differ
+// from the local clock.
+constexpr int kJournalCursorToleranceSeconds = 10 * 60;
+
 mixxx::Logger kLogger("LibraryScanner");
 
 QAtomicInt s_instanceCounter(0);
@@ -99,6 +117,7 @@ LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao, m_analysisDao, m_libraryHashDao, pConfig),
           m_stateSema(1), // only one transaction is possible at a time
@@ -108,11 +127,14 @@ LibraryScanner::LibraryScanner(
     // queue to our event loop.
     moveToThread(this);
     m_pool.moveToThread(this);
+    m_importPool.moveToThread(this);
 
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
     m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    m_importPool.setMaxThreadCount(std::clamp(
+            QThread::idealThreadCount(), 1, kMaxImportThreadPoolSize));
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -174,10 +196,25 @@ void LibraryScanner::run() {
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
 
+#ifdef __LINUX__
+        // The journal relies on inotify for watching all library directories
+        if (m_pConfig->getValue(mixxx::library::prefs::kIncrementalRescanConfigKey, false)) {
+            m_pJournal = std::make_unique<ScannerJournal>(
+                    QDir(m_pConfig->getSettingsPath()).filePath(kJournalFileName));
+            m_pJournal->load();
+            m_pJournal->watchDirectories(m_libraryHashDao.getDirectoryHashes().keys());
+        }
+#endif
+
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        if (m_pJournal) {
+            m_pJournal->save();
+            m_pJournal.reset();
+        }
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -212,11 +249,31 @@ void LibraryScanner::slotStartScan() {
     m_numRelocatedTracks = 0;
 
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackLocations,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)
+                            .resetMissingTagMetadataOnImport));
 
     m_scannerGlobal->startTimer();
 
+    m_scanStartedAt = QDateTime::currentDateTimeUtc();
+    if (m_pJournal) {
+        const bool incrementalScan = m_pJournal->isValid();
+        const QSet<QString> changedDirectories = m_pJournal->beginScan();
+        if (incrementalScan) {
+            kLogger.info()
+                    << "Scanning"
+                    << changedDirectories.size()
+                    << "changed directories and all directories modified since"
+                    << m_pJournal->cursor();
+            m_scannerGlobal->setChangedDirectories(changedDirectories,
+                    m_pJournal->cursor().addSecs(-kJournalCursorToleranceSeconds));
+        }
+    }
+
     emit scanStarted();
 
     // First, we're going to mark all the directories that we've previously
@@ -422,6 +479,14 @@ void LibraryScanner::slotFinishUnhashedScan() {
         cleanUpScan();
     }
 
+    if (m_pJournal) {
+        m_pJournal->finishScan(
+                !m_scannerGlobal->shouldCancel() && bScanFinishedCleanly,
+                m_scanStartedAt);
+        // Watch new directories and stop watching deleted directories
+        m_pJournal->watchDirectories(m_libraryHashDao.getDirectoryHashes().keys());
+    }
+
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         const auto dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
         updateQueryPlannerStatisticsForDatabase(dbConnection);
@@ -465,6 +530,10 @@ void LibraryScanner::slotFinishUnhashedScan() {
         }
     }
     const int tracksTotal = existingTracks.size();
+    // Only the files in changed/added directories have been looked at
+    const int numScannedFiles = numVerifiedTracks +
+            static_cast<int>(m_scannerGlobal->addedTracks().size());
+    const double scannedFilesPerSecond = seconds > 0 ? numScannedFiles / seconds : 0;
 
     qInfo() << "-------------------------------------------------------";
     qInfo("Library scan finished after %s", durationString.toLocal8Bit().constData());
@@ -477,6 +546,7 @@ void LibraryScanner::slotFinishUnhashedScan() {
     qInfo(" %d missing tracks total", numMissingTracks);
     qInfo(" %d rediscovered tracks", numRediscoveredTracks);
     qInfo(" %d tracks total", tracksTotal);
+    qInfo(" %.1f files/s scanned in changed/added directories", scannedFilesPerSecond);
     qInfo() << "-------------------------------------------------------";
 
     LibraryScanResultSummary result;
@@ -542,13 +612,28 @@ void LibraryScanner::cancel() {
     // have pointers to the LibraryScanner and can cause a segfault if they run
     // after the LibraryScanner has been destroyed.
     m_pool.waitForDone();
+    m_importPool.waitForDone();
 }
 
 void LibraryScanner::queueTask(ScannerTask* pTask) {
     //kLogger.debug() << "queueTask" << pTask;
     ScopedTimer timer(QStringLiteral("LibraryScanner::queueTask"));
+    if (watchTask(pTask)) {
+        m_pool.start(pTask);
+    }
+}
+
+void LibraryScanner::queueImportTask(ScannerTask* pTask) {
+    //kLogger.debug() << "queueImportTask" << pTask;
+    ScopedTimer timer(QStringLiteral("LibraryScanner::queueImportTask"));
+    if (watchTask(pTask)) {
+        m_importPool.start(pTask);
+    }
+}
+
+bool LibraryScanner::watchTask(ScannerTask* pTask) {
     if (m_scannerGlobal.isNull() || m_scannerGlobal->shouldCancel()) {
-        return;
+        return false;
     }
     m_scannerGlobal->getTaskWatcher().watchTask();
     connect(pTask,
@@ -568,9 +653,9 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::slotTrackExists);
     connect(pTask,
-            &ScannerTask::addNewTrack,
+            &ScannerTask::addNewTracks,
             this,
-            &LibraryScanner::slotAddNewTrack);
+            &LibraryScanner::slotAddNewTracks);
 
     // Progress signals.
     // Pass directly to the main thread
@@ -582,8 +667,7 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             &ScannerTask::progressHashing,
             this,
             &LibraryScanner::progressHashing);
-
-    m_pool.start(pTask);
+    return true;
 }
 
 void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
@@ -623,32 +707,37 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
     }
 }
 
-// triggered by ScannerTask::addNewTrack / in ImportFilesTask::run()
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
-    //kLogger.debug() << "slotAddNewTrack" << trackPath;
-    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTrack"));
-    // For statistics tracking and to detect moved tracks
-    TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
-    if (!pTrack) {
-        // This happens only when there is an issue with the database which
-        // has been logged already. No need for yet another warning here.
-        return;
-    }
+// triggered by ScannerTask::addNewTracks / in ImportFilesTask::run()
+void LibraryScanner::slotAddNewTracks(const QList<ScannedTrackFile>& newTracks) {
+    //kLogger.debug() << "slotAddNewTracks" << newTracks.size();
+    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTracks"));
+    for (const auto& newTrack : newTracks) {
+        // All tracks are inserted within the transaction that has been
+        // started by addTracksPrepare()
+        TrackPointer pTrack = m_trackDao.addTracksAddFile(
+                newTrack.location,
+                false,
+                &newTrack.preparedImport);
+        if (!pTrack) {
+            // This happens only when there is an issue with the database which
+            // has been logged already. No need for yet another warning here.
+            continue;
+        }
 
-    DEBUG_ASSERT(!pTrack->isDirty());
-    // The track's actual location might differ from the
-    // given trackPath
-    const QString trackLocation = pTrack->getLocation();
-    // Acknowledge successful track addition
-    if (m_scannerGlobal) {
-        m_scannerGlobal->trackAdded(trackLocation);
+        DEBUG_ASSERT(!pTrack->isDirty());
+        // The track's actual location might differ from the
+        // given trackPath
+        const QString trackLocation = pTrack->getLocation();
+        // Acknowledge successful track addition
+        // For statistics tracking and to detect moved tracks
+        if (m_scannerGlobal) {
+            m_scannerGlobal->trackAdded(trackLocation);
+        }
+        // Signal the main instance of TrackDAO, that there is
+        // a new track in the database.
+        emit trackAdded(pTrack);
+        emit progressLoading(trackLocation);
     }
-    // Signal the main instance of TrackDAO, that there is
-    // a new track in the database.
-    emit trackAdded(pTrack);
-    emit progressLoading(trackLocation);
 }
 
 bool LibraryScanner::changeScannerState(ScannerState newState) {
@@ -2,11 +2,13 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <QDateTime>
 #include <QList>
 #include <QScopedPointer>
 #include <QSemaphore>
 #include <QThread>
 #include <QThreadPool>
+#include <memory>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -15,10 +17,11 @@
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
 #include "library/scanner/scannerglobal.h"
+#include "library/scanner/scannerjournal.h"
+#include "library/scanner/scannertask.h"
 #include "track/track_decl.h"
 #include "util/db/dbconnectionpool.h"
 
-class ScannerTask;
 class LibraryScannerDlg;
 class QString;
 struct LibraryScanResultSummary;
@@ -63,6 +66,8 @@ class LibraryScanner : public QThread {
 
   public slots:
     void queueTask(ScannerTask* pTask);
+    // Queues a task that parses the metadata of files
+    void queueImportTask(ScannerTask* pTask);
 
   private slots:
     void slotStartScan();
@@ -74,7 +79,7 @@ class LibraryScanner : public QThread {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
     void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotAddNewTracks(const QList<ScannedTrackFile>& newTracks);
 
   private:
     enum ScannerState {
@@ -100,10 +105,15 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    bool watchTask(ScannerTask* pTask);
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
+    // The pool of threads that parse the metadata of new files
+    QThreadPool m_importPool;
 
     // The library scanner thread's DAOs.
     LibraryHashDAO m_libraryHashDao;
@@ -116,6 +126,10 @@ class LibraryScanner : public QThread {
     // Global scanner state for scan currently in progress.
     ScannerGlobalPointer m_scannerGlobal;
 
+    // Only if incremental scans are enabled
+    std::unique_ptr<ScannerJournal> m_pJournal;
+    QDateTime m_scanStartedAt;
+
     // The Semaphore guards the state transitions queued to the
     // Qt even Queue in the way, that you cannot start a
     // new scan while the old one is canceled
@@ -30,6 +30,27 @@ void RecursiveScanDirectoryTask::run() {
     //qDebug() << "Burn CPU";
     //for (int i = 0;i < 1000000000; i++) asm("nop");
 
+    if (m_scannerGlobal->directoryUnchangedSinceLastScan(m_dirAccess.info())) {
+        // Neither listing nor hashing the directory is needed. The
+        // subdirectories are known from the previous scans.
+        const QString dirLocation = m_dirAccess.info().location();
+        emit directoryUnchanged(dirLocation);
+        const QStringList subdirLocations = m_scannerGlobal->knownSubdirectories(dirLocation);
+        for (const QString& subdirLocation : subdirLocations) {
+            const auto dirInfo = mixxx::FileInfo(subdirLocation);
+            if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
+                m_pScanner->queueTask(
+                        new RecursiveScanDirectoryTask(
+                                m_pScanner,
+                                m_scannerGlobal,
+                                mixxx::FileAccess(dirInfo, m_dirAccess.token()),
+                                m_scanUnhashed));
+            }
+        }
+        setSuccess(true);
+        return;
+    }
+
     // Note, we save on filesystem operations (and random work) by initializing
     // a QDirIterator with a QDir instead of a QString -- but it inherits its
     // Filter from the QDir so we have to set it first. If the QDir has not done
@@ -97,7 +118,7 @@ void RecursiveScanDirectoryTask::run() {
             // Rescan that mofo! If importing fails then the scan was cancelled so
             // we return immediately.
             if (!filesToImport.empty()) {
-                m_pScanner->queueTask(new ImportFilesTask(m_pScanner,
+                m_pScanner->queueImportTask(new ImportFilesTask(m_pScanner,
                         m_scannerGlobal,
                         dirLocation,
                         prevHashExists,
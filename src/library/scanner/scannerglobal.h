@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QDateTime>
 #include <QDir>
 #include <QHash>
 #include <QMutex>
@@ -20,12 +21,14 @@ class ScannerGlobal {
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            bool resetMissingTagMetadataOnImport)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_resetMissingTagMetadataOnImport(resetMissingTagMetadataOnImport),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
@@ -47,10 +50,62 @@ class ScannerGlobal {
         return m_directoryHashes.value(directoryPath, mixxx::invalidCacheKey());
     }
 
+    // Enables an incremental scan that skips listing the directories that
+    // are neither in changedDirectories nor have been modified since
+    // unmodifiedBefore, see ScannerJournal.
+    void setChangedDirectories(
+            QSet<QString> changedDirectories,
+            QDateTime unmodifiedBefore) {
+        m_changedDirectories = std::move(changedDirectories);
+        m_unmodifiedBefore = std::move(unmodifiedBefore);
+        m_knownSubdirectories.clear();
+        for (auto it = m_directoryHashes.constBegin();
+                it != m_directoryHashes.constEnd();
+                ++it) {
+            const QString& directoryPath = it.key();
+            const int separatorIndex = directoryPath.lastIndexOf(QChar('/'));
+            if (separatorIndex > 0) {
+                m_knownSubdirectories[directoryPath.left(separatorIndex)].append(
+                        directoryPath);
+            }
+        }
+    }
+
+    bool isIncrementalScan() const {
+        return m_unmodifiedBefore.isValid();
+    }
+
+    // Returns whether the directory has a hash and has not been changed
+    // since it has been hashed. Only for incremental scans.
+    bool directoryUnchangedSinceLastScan(const mixxx::FileInfo& directory) const {
+        if (!isIncrementalScan()) {
+            return false;
+        }
+        const QString directoryPath = directory.location();
+        if (!mixxx::isValidCacheKey(directoryHashInDatabase(directoryPath)) ||
+                m_changedDirectories.contains(directoryPath)) {
+            return false;
+        }
+        // Adding, removing, or renaming entries updates the modification
+        // time of a directory. Invalid for missing directories.
+        const QDateTime lastModified = directory.lastModified();
+        return lastModified.isValid() && lastModified < m_unmodifiedBefore;
+    }
+
+    // The subdirectories of a directory that have a hash
+    QStringList knownSubdirectories(const QString& directoryPath) const {
+        return m_knownSubdirectories.value(directoryPath);
+    }
+
     bool directoryBlacklisted(const QString& directoryPath) const {
         return m_directoriesBlacklist.contains(directoryPath);
     }
 
+    // Passed to SoundSourceProxy when importing the metadata of new files
+    bool resetMissingTagMetadataOnImport() const {
+        return m_resetMissingTagMetadataOnImport;
+    }
+
     const QRegularExpression& supportedExtensionsRegex() const {
         return m_supportedExtensionsMatcher;
     }
@@ -167,6 +222,11 @@ class ScannerGlobal {
     QSet<QString> m_trackLocations;
     QHash<QString, mixxx::cache_key_t> m_directoryHashes;
 
+    // Only for incremental scans
+    QSet<QString> m_changedDirectories;
+    QDateTime m_unmodifiedBefore;
+    QHash<QString, QStringList> m_knownSubdirectories;
+
     mutable QMutex m_supportedExtensionsMatcherMutex;
     QRegularExpression m_supportedExtensionsMatcher;
 
@@ -190,6 +250,8 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const bool m_resetMissingTagMetadataOnImport;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
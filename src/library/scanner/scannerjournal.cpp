@@ -0,0 +1,202 @@
+#include "library/scanner/scannerjournal.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("ScannerJournal");
+
+const QString kCursorKey = QStringLiteral("cursor");
+const QString kChangedDirectoriesKey = QStringLiteral("changedDirectories");
+
+} // anonymous namespace
+
+ScannerJournal::ScannerJournal(QString filePath)
+        : m_filePath(std::move(filePath)),
+          m_watchFailed(false),
+          m_valid(false) {
+}
+
+void ScannerJournal::load() {
+    m_valid = false;
+    m_cursor = QDateTime();
+    m_changedDirectories.clear();
+
+    QFile file(m_filePath);
+    if (!file.exists()) {
+        kLogger.info()
+                << "No journal from the previous session, the next library scan"
+                << "will be a full scan";
+        return;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open"
+                << m_filePath
+                << file.errorString();
+        return;
+    }
+    QJsonParseError parseError;
+    const QJsonObject json = QJsonDocument::fromJson(file.readAll(), &parseError).object();
+    file.close();
+    // The file is only restored by save() when the scanner shuts down
+    // normally.
+    if (!file.remove()) {
+        kLogger.warning()
+                << "Failed to remove"
+                << m_filePath
+                << file.errorString();
+        return;
+    }
+    if (parseError.error != QJsonParseError::NoError) {
+        kLogger.warning()
+                << "Failed to parse"
+                << m_filePath
+                << parseError.errorString();
+        return;
+    }
+
+    const QDateTime cursor = QDateTime::fromString(
+            json.value(kCursorKey).toString(), Qt::ISODateWithMs);
+    if (!cursor.isValid()) {
+        kLogger.warning()
+                << "Invalid cursor in"
+                << m_filePath;
+        return;
+    }
+    const QJsonArray changedDirectories = json.value(kChangedDirectoriesKey).toArray();
+    for (const auto& dirPath : changedDirectories) {
+        m_changedDirectories.insert(dirPath.toString());
+    }
+    m_cursor = cursor.toUTC();
+    m_valid = true;
+    kLogger.info()
+            << "Loaded journal with"
+            << m_changedDirectories.size()
+            << "changed directories since"
+            << m_cursor;
+}
+
+void ScannerJournal::save() const {
+    if (!m_valid || m_watchFailed) {
+        return;
+    }
+    QJsonArray changedDirectories;
+    for (const auto& dirPath : m_changedDirectories) {
+        changedDirectories.append(dirPath);
+    }
+    // The directories of an unfinished scan still need to be scanned
+    for (const auto& dirPath : m_scanningDirectories) {
+        changedDirectories.append(dirPath);
+    }
+    QJsonObject json;
+    json.insert(kCursorKey, m_cursor.toString(Qt::ISODateWithMs));
+    json.insert(kChangedDirectoriesKey, changedDirectories);
+
+    QFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        kLogger.warning()
+                << "Failed to open"
+                << m_filePath
+                << file.errorString();
+        return;
+    }
+    if (file.write(QJsonDocument(json).toJson(QJsonDocument::Compact)) < 0) {
+        kLogger.warning()
+                << "Failed to write"
+                << m_filePath
+                << file.errorString();
+        file.remove();
+    }
+}
+
+void ScannerJournal::watchDirectories(const QStringList& dirPaths) {
+    if (!m_pWatcher) {
+        m_pWatcher = std::make_unique<QFileSystemWatcher>();
+        QObject::connect(m_pWatcher.get(),
+                &QFileSystemWatcher::directoryChanged,
+                m_pWatcher.get(),
+                [this](const QString& dirPath) {
+                    markDirectoryChanged(dirPath);
+                });
+    }
+
+    const QStringList watchedDirPaths = m_pWatcher->directories();
+    const QSet<QString> dirPathSet(dirPaths.begin(), dirPaths.end());
+    QStringList removedDirPaths;
+    for (const auto& dirPath : watchedDirPaths) {
+        if (!dirPathSet.contains(dirPath)) {
+            removedDirPaths.append(dirPath);
+        }
+    }
+    if (!removedDirPaths.isEmpty()) {
+        m_pWatcher->removePaths(removedDirPaths);
+    }
+
+    const QSet<QString> watchedDirPathSet(watchedDirPaths.begin(), watchedDirPaths.end());
+    QStringList addedDirPaths;
+    for (const auto& dirPath : dirPaths) {
+        if (!watchedDirPathSet.contains(dirPath)) {
+            addedDirPaths.append(dirPath);
+        }
+    }
+    if (addedDirPaths.isEmpty()) {
+        return;
+    }
+    QStringList failedDirPaths = m_pWatcher->addPaths(addedDirPaths);
+    // Directories that have been deleted since the last scan cannot be
+    // watched, but are detected by the modification time of their parent.
+    failedDirPaths.erase(
+            std::remove_if(failedDirPaths.begin(),
+                    failedDirPaths.end(),
+                    [](const QString& dirPath) {
+                        return !QFileInfo(dirPath).isDir();
+                    }),
+            failedDirPaths.end());
+    if (!failedDirPaths.isEmpty()) {
+        // Changes of these directories would go unnoticed until the
+        // next full scan
+        kLogger.warning()
+                << "Failed to watch"
+                << failedDirPaths.size()
+                << "of"
+                << dirPaths.size()
+                << "library directories for changes, e.g."
+                << failedDirPaths.first()
+                << "- the journal is disabled until the next restart."
+                << "On Linux the limit is fs.inotify.max_user_watches.";
+        m_watchFailed = true;
+        m_valid = false;
+    }
+}
+
+QSet<QString> ScannerJournal::beginScan() {
+    // Usually empty, unless the previous scan has not been finished
+    m_scanningDirectories.unite(m_changedDirectories);
+    m_changedDirectories.clear();
+    return m_scanningDirectories;
+}
+
+void ScannerJournal::finishScan(bool finishedCleanly, const QDateTime& scanStartedAt) {
+    if (finishedCleanly) {
+        // All changes that happened before the scan has been started are
+        // reflected by the library now.
+        m_scanningDirectories.clear();
+        m_cursor = scanStartedAt.toUTC();
+        m_valid = !m_watchFailed;
+    } else {
+        m_changedDirectories.unite(m_scanningDirectories);
+        m_scanningDirectories.clear();
+    }
+}
+
+void ScannerJournal::markDirectoryChanged(const QString& dirPath) {
+    m_changedDirectories.insert(dirPath);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+/// Records the library directories that have changed since the last
+/// library scan, so that the next scan only needs to list and hash these
+/// directories instead of all directories.
+///
+/// While Mixxx is running the directories are watched for changes (inotify
+/// on Linux). Changes while Mixxx is not running are detected by comparing
+/// the modification time of the directories with the cursor, i.e. the time
+/// when the last scan has been started.
+///
+/// The journal is persisted in a file when the scanner shuts down. The file
+/// is deleted while the journal is in use, so the journal is discarded and
+/// the next scan is a full scan after a crash.
+///
+/// Only accessed from the LibraryScanner thread.
+class ScannerJournal {
+  public:
+    explicit ScannerJournal(QString filePath);
+
+    /// Load the journal of the previous session and delete the file
+    void load();
+    /// Save the journal if it is valid
+    void save() const;
+
+    /// A valid journal contains all directories that have been changed
+    /// before the cursor, but have not been scanned since.
+    bool isValid() const {
+        return m_valid;
+    }
+
+    const QDateTime& cursor() const {
+        return m_cursor;
+    }
+
+    /// Start watching the directories. The journal becomes invalid if
+    /// a directory cannot be watched, e.g. if the system limit for
+    /// watches has been reached.
+    void watchDirectories(const QStringList& dirPaths);
+
+    /// Returns the changed directories that need to be scanned. They are
+    /// only removed from the journal if the scan finishes cleanly.
+    QSet<QString> beginScan();
+    void finishScan(bool finishedCleanly, const QDateTime& scanStartedAt);
+
+    /// Record a changed directory
+    void markDirectoryChanged(const QString& dirPath);
+
+    /// The changed directories that have not been scanned yet
+    const QSet<QString>& changedDirectories() const {
+        return m_changedDirectories;
+    }
+
+  private:
+    const QString m_filePath;
+
+    std::unique_ptr<QFileSystemWatcher> m_pWatcher;
+    bool m_watchFailed;
+
+    bool m_valid;
+    QDateTime m_cursor;
+    QSet<QString> m_changedDirectories;
+    // The changed directories of the scan in progress
+    QSet<QString> m_scanningDirectories;
+};
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <QList>
 #include <QObject>
 #include <QRunnable>
 
 #include "library/scanner/scannerglobal.h"
+#include "sources/soundsourceproxy.h"
 
 class LibraryScanner;
 
+/// A new file and its metadata that has been parsed by ImportFilesTask
+struct ScannedTrackFile {
+    QString location;
+    SoundSourceProxy::PreparedTrackImport preparedImport;
+};
+
+Q_DECLARE_METATYPE(ScannedTrackFile);
+
 class ScannerTask : public QObject, public QRunnable {
     Q_OBJECT
   public:
@@ -23,7 +33,7 @@ class ScannerTask : public QObject, public QRunnable {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
     void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    void addNewTracks(const QList<ScannedTrackFile>& newTracks);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
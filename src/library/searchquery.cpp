@@ -1,7 +1,9 @@
 #include "library/searchquery.h"
 
+#include <QBitArray>
 #include <QRegularExpression>
 
+#include "library/columnartrackindex.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
 #include "library/trackset/crate/crateschema.h"
@@ -102,6 +104,42 @@ QString concatSqlClauses(
     }
 }
 
+/// Returns false if a column is not in the index
+bool columnIndices(const ColumnarTrackIndex& index,
+        const QStringList& sqlColumns,
+        QVector<int>* pColumns) {
+    for (const auto& sqlColumn : sqlColumns) {
+        const int column = index.columnIndex(sqlColumn);
+        if (column < 0) {
+            return false;
+        }
+        pColumns->append(column);
+    }
+    return true;
+}
+
+/// A comparison with NULL evaluates to NULL. Nodes that OR the
+/// comparisons with their columns evaluate to NULL if none of them is
+/// true and at least one of the values is NULL.
+bool selectNullComparisonRows(const QueryNode& node,
+        const ColumnarTrackIndex& index,
+        const QStringList& sqlColumns,
+        QBitArray* pRows) {
+    QVector<int> columns;
+    if (!columnIndices(index, sqlColumns, &columns)) {
+        return false;
+    }
+    for (const int column : std::as_const(columns)) {
+        index.selectNull(column, pRows);
+    }
+    QBitArray matchingRows(pRows->size());
+    if (!node.selectRows(index, &matchingRows)) {
+        return false;
+    }
+    *pRows &= ~matchingRows;
+    return true;
+}
+
 } // namespace
 
 bool AndNode::match(const TrackPointer& pTrack) const {
@@ -127,6 +165,46 @@ QString AndNode::toSql() const {
     return concatSqlClauses(queryFragments, "AND");
 }
 
+bool AndNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    pRows->fill(true);
+    QBitArray nodeRows(pRows->size());
+    for (const auto& pNode : m_nodes) {
+        // Consistent with the generated SQL query, which omits them
+        if (pNode->toSql().isEmpty()) {
+            continue;
+        }
+        nodeRows.fill(false);
+        if (!pNode->selectRows(index, &nodeRows)) {
+            return false;
+        }
+        *pRows &= nodeRows;
+    }
+    return true;
+}
+
+bool AndNode::selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    // NULL unless any node is false or all nodes are true
+    QBitArray trueRows(pRows->size(), true);
+    QBitArray falseRows(pRows->size());
+    QBitArray nodeRows(pRows->size());
+    QBitArray nodeNullRows(pRows->size());
+    for (const auto& pNode : m_nodes) {
+        if (pNode->toSql().isEmpty()) {
+            continue;
+        }
+        nodeRows.fill(false);
+        nodeNullRows.fill(false);
+        if (!pNode->selectRows(index, &nodeRows) ||
+                !pNode->selectNullRows(index, &nodeNullRows)) {
+            return false;
+        }
+        trueRows &= nodeRows;
+        falseRows |= ~(nodeRows | nodeNullRows);
+    }
+    *pRows = ~(trueRows | falseRows);
+    return true;
+}
+
 bool OrNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (pNode->match(pTrack)) {
@@ -151,6 +229,44 @@ QString OrNode::toSql() const {
     return concatSqlClauses(queryFragments, "OR");
 }
 
+bool OrNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    QBitArray nodeRows(pRows->size());
+    for (const auto& pNode : m_nodes) {
+        if (pNode->toSql().isEmpty()) {
+            continue;
+        }
+        nodeRows.fill(false);
+        if (!pNode->selectRows(index, &nodeRows)) {
+            return false;
+        }
+        *pRows |= nodeRows;
+    }
+    return true;
+}
+
+bool OrNode::selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    // NULL if no node is true and any node is NULL
+    QBitArray trueRows(pRows->size());
+    QBitArray nodeRows(pRows->size());
+    for (const auto& pNode : m_nodes) {
+        if (pNode->toSql().isEmpty()) {
+            continue;
+        }
+        nodeRows.fill(false);
+        if (!pNode->selectRows(index, &nodeRows)) {
+            return false;
+        }
+        trueRows |= nodeRows;
+        nodeRows.fill(false);
+        if (!pNode->selectNullRows(index, &nodeRows)) {
+            return false;
+        }
+        *pRows |= nodeRows;
+    }
+    *pRows &= ~trueRows;
+    return true;
+}
+
 bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
@@ -167,6 +283,22 @@ QString NotNode::toSql() const {
     }
 }
 
+bool NotNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    QBitArray nodeRows(pRows->size());
+    QBitArray nullRows(pRows->size());
+    if (!m_pNode->selectRows(index, &nodeRows) ||
+            !m_pNode->selectNullRows(index, &nullRows)) {
+        return false;
+    }
+    // NOT NULL is still NULL, i.e. these rows don't match either
+    *pRows = ~(nodeRows | nullRows);
+    return true;
+}
+
+bool NotNode::selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    return m_pNode->selectNullRows(index, pRows);
+}
+
 TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QStringList& sqlColumns,
         const QString& argument,
@@ -228,6 +360,30 @@ QString TextFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool TextFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    QVector<int> columns;
+    if (!columnIndices(index, m_sqlColumns, &columns)) {
+        return false;
+    }
+    for (const int column : std::as_const(columns)) {
+        if (m_matchMode == StringMatch::Equals) {
+            index.selectText(column,
+                    [this](const QString& value) {
+                        return value == m_argument;
+                    },
+                    pRows);
+        } else {
+            index.selectTextContaining(column, m_argument, pRows);
+        }
+    }
+    return true;
+}
+
+bool TextFilterNode::selectNullRows(
+        const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    return selectNullComparisonRows(*this, index, m_sqlColumns, pRows);
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -248,6 +404,25 @@ QString NullOrEmptyTextFilterNode::toSql() const {
     return QString();
 }
 
+bool NullOrEmptyTextFilterNode::selectRows(
+        const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    if (m_sqlColumns.isEmpty()) {
+        return true;
+    }
+    // only use the major column
+    const int column = index.columnIndex(m_sqlColumns.first());
+    if (column < 0) {
+        return false;
+    }
+    index.selectNull(column, pRows);
+    index.selectText(column,
+            [](const QString& value) {
+                return value.isEmpty();
+            },
+            pRows);
+    return true;
+}
+
 CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
         const QString& crateNameLike)
         : m_pCrateStorage(pCrateStorage),
@@ -255,7 +430,7 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
           m_matchInitialized(false) {
 }
 
-bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+const std::vector<TrackId>& CrateFilterNode::matchingTrackIds() const {
     if (!m_matchInitialized) {
         CrateTrackSelectResult crateTracks(
                 m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
@@ -266,8 +441,12 @@ bool CrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+    return m_matchingTrackIds;
+}
 
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    const std::vector<TrackId>& trackIds = matchingTrackIds();
+    return std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
 }
 
 QString CrateFilterNode::toSql() const {
@@ -276,12 +455,17 @@ QString CrateFilterNode::toSql() const {
                     m_crateNameLike));
 }
 
+bool CrateFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    index.selectTracks(matchingTrackIds(), pRows);
+    return true;
+}
+
 NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
         : m_pCrateStorage(pCrateStorage),
           m_matchInitialized(false) {
 }
 
-bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+const std::vector<TrackId>& NoCrateFilterNode::matchingTrackIds() const {
     if (!m_matchInitialized) {
         TrackSelectResult tracks(
                 m_pCrateStorage->selectAllTracksSorted());
@@ -292,8 +476,13 @@ bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+    return m_matchingTrackIds;
+}
 
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    // The track ids of all tracks that are in a crate
+    const std::vector<TrackId>& trackIds = matchingTrackIds();
+    return !std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
 }
 
 QString NoCrateFilterNode::toSql() const {
@@ -302,6 +491,13 @@ QString NoCrateFilterNode::toSql() const {
                     CrateStorage::formatQueryForTrackIdsWithCrate());
 }
 
+bool NoCrateFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    QBitArray crateRows(pRows->size());
+    index.selectTracks(matchingTrackIds(), &crateRows);
+    *pRows = ~crateRows;
+    return true;
+}
+
 NumericFilterNode::NumericFilterNode(const QStringList& sqlColumns)
         : m_sqlColumns(sqlColumns),
           m_bOperatorQuery(false),
@@ -365,23 +561,52 @@ bool NumericFilterNode::match(const TrackPointer& pTrack) const {
             continue;
         }
 
-        double dValue = value.toDouble();
-        if (m_bOperatorQuery) {
-            if ((m_operator == "=" && dValue == m_dOperatorArgument) ||
-                    (m_operator == "<" && dValue < m_dOperatorArgument) ||
-                    (m_operator == ">" && dValue > m_dOperatorArgument) ||
-                    (m_operator == "<=" && dValue <= m_dOperatorArgument) ||
-                    (m_operator == ">=" && dValue >= m_dOperatorArgument)) {
-                return true;
-            }
-        } else if (m_bRangeQuery && dValue >= m_dRangeLow &&
-                dValue <= m_dRangeHigh) {
+        if (matchesValue(value.toDouble())) {
             return true;
         }
     }
     return false;
 }
 
+bool NumericFilterNode::matchesValue(double value) const {
+    if (m_bOperatorQuery) {
+        return (m_operator == "=" && value == m_dOperatorArgument) ||
+                (m_operator == "<" && value < m_dOperatorArgument) ||
+                (m_operator == ">" && value > m_dOperatorArgument) ||
+                (m_operator == "<=" && value <= m_dOperatorArgument) ||
+                (m_operator == ">=" && value >= m_dOperatorArgument);
+    }
+    return m_bRangeQuery && value >= m_dRangeLow && value <= m_dRangeHigh;
+}
+
+bool NumericFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    QVector<int> columns;
+    if (!columnIndices(index, m_sqlColumns, &columns)) {
+        return false;
+    }
+    for (const int column : std::as_const(columns)) {
+        if (m_bNullQuery) {
+            index.selectNull(column, pRows);
+        } else {
+            index.selectNumber(column,
+                    [this](double value) {
+                        return matchesValue(value);
+                    },
+                    pRows);
+        }
+    }
+    return true;
+}
+
+bool NumericFilterNode::selectNullRows(
+        const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    if (m_bNullQuery || !(m_bOperatorQuery || m_bRangeQuery)) {
+        // Either IS NULL or no expression at all
+        return true;
+    }
+    return selectNullComparisonRows(*this, index, m_sqlColumns, pRows);
+}
+
 QString NumericFilterNode::toSql() const {
     if (m_bNullQuery) {
         for (const auto& sqlColumn : m_sqlColumns) {
@@ -440,6 +665,19 @@ QString NullNumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NullNumericFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    if (m_sqlColumns.isEmpty()) {
+        return true;
+    }
+    // only use the major column
+    const int column = index.columnIndex(m_sqlColumns.first());
+    if (column < 0) {
+        return false;
+    }
+    index.selectNull(column, pRows);
+    return true;
+}
+
 DurationFilterNode::DurationFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns) {
@@ -696,9 +934,10 @@ bool BpmFilterNode::match(const TrackPointer& pTrack) const {
     if (m_matchMode == MatchMode::Locked) {
         return pTrack->isBpmLocked();
     }
+    return matchesBpm(pTrack->getBpm());
+}
 
-    double value = pTrack->getBpm();
-
+bool BpmFilterNode::matchesBpm(double value) const {
     switch (m_matchMode) {
     case MatchMode::Null: {
         return value == 0.0;
@@ -775,6 +1014,45 @@ QString BpmFilterNode::toSql() const {
     }
 }
 
+bool BpmFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    if (m_matchMode == MatchMode::Locked) {
+        const int column = index.columnIndex(LIBRARYTABLE_BPM_LOCK);
+        if (column < 0) {
+            return false;
+        }
+        index.selectNumber(column,
+                [](double value) {
+                    return value != 0;
+                },
+                pRows);
+        return true;
+    }
+    const int column = index.columnIndex(LIBRARYTABLE_BPM);
+    if (column < 0) {
+        return false;
+    }
+    index.selectNumber(column,
+            [this](double value) {
+                return matchesBpm(value);
+            },
+            pRows);
+    return true;
+}
+
+bool BpmFilterNode::selectNullRows(
+        const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    switch (m_matchMode) {
+    case MatchMode::Invalid:
+    case MatchMode::Null:
+    case MatchMode::Locked:
+        // Compared with IS, which never evaluates to NULL
+        return true;
+    default:
+        return selectNullComparisonRows(
+                *this, index, QStringList{LIBRARYTABLE_BPM}, pRows);
+    }
+}
+
 KeyFilterNode::KeyFilterNode(mixxx::track::io::key::ChromaticKey key,
         bool fuzzy) {
     if (fuzzy) {
@@ -796,6 +1074,21 @@ QString KeyFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool KeyFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    const int column = index.columnIndex(LIBRARYTABLE_KEY_ID);
+    if (column < 0) {
+        return false;
+    }
+    index.selectNumber(column,
+            [this](double value) {
+                return m_matchKeys.contains(
+                        static_cast<mixxx::track::io::key::ChromaticKey>(
+                                static_cast<int>(value)));
+            },
+            pRows);
+    return true;
+}
+
 YearFilterNode::YearFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns, argument) {
@@ -821,3 +1114,22 @@ QString YearFilterNode::toSql() const {
 
     return QString();
 }
+
+bool YearFilterNode::selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+    if (!m_bNullQuery && (m_bOperatorQuery || m_bRangeQuery)) {
+        QVector<int> columns;
+        if (!columnIndices(index, m_sqlColumns, &columns)) {
+            return false;
+        }
+        // Only the first four digits are the year, like in toSql()
+        for (const int column : std::as_const(columns)) {
+            index.selectText(column,
+                    [this](const QString& value) {
+                        return matchesValue(value.left(4).toDouble());
+                    },
+                    pRows);
+        }
+        return true;
+    }
+    return NumericFilterNode::selectRows(index, pRows);
+}
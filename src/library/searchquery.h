@@ -13,7 +13,9 @@
 #include "track/track_decl.h"
 #include "util/assert.h"
 
+class ColumnarTrackIndex;
 class CrateStorage;
+class QBitArray;
 class TrackId;
 
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
@@ -31,6 +33,21 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Sets the bits of the matching rows of the index in pRows, which
+    /// must be cleared. Returns false if the node can only be evaluated
+    /// by the database.
+    virtual bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const = 0;
+
+    /// Sets the bits of the rows for which the SQL expression evaluates
+    /// to NULL in pRows, which must be cleared. Those rows match neither
+    /// the node nor its negation. The default is for nodes that never
+    /// evaluate to NULL.
+    virtual bool selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const {
+        Q_UNUSED(index);
+        Q_UNUSED(pRows);
+        return true;
+    }
+
   protected:
     QueryNode() = default;
 };
@@ -53,12 +70,16 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
+    bool selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
+    bool selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 };
 
 class NotNode : public QueryNode {
@@ -70,6 +91,8 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
+    bool selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -84,6 +107,8 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
+    bool selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   private:
     QSqlDatabase m_database;
@@ -102,6 +127,7 @@ class NullOrEmptyTextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   private:
     QSqlDatabase m_database;
@@ -115,8 +141,11 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   private:
+    const std::vector<TrackId>& matchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -129,8 +158,11 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   private:
+    const std::vector<TrackId>& matchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -143,6 +175,8 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
+    bool selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -156,6 +190,8 @@ class NumericFilterNode : public QueryNode {
 
     virtual double parse(const QString& arg, bool* ok);
 
+    bool matchesValue(double value) const;
+
     QStringList m_sqlColumns;
     bool m_bOperatorQuery;
     bool m_bNullQuery;
@@ -172,6 +208,7 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
     QStringList m_sqlColumns;
 };
@@ -214,9 +251,12 @@ class BpmFilterNode : public QueryNode {
     }
 
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
+    bool selectNullRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   private:
     bool match(const TrackPointer& pTrack) const override;
+    bool matchesBpm(double value) const;
 
     MatchMode m_matchMode;
 
@@ -239,6 +279,7 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
@@ -264,6 +305,13 @@ class SqlNode : public QueryNode {
         return m_sql;
     }
 
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override {
+        // Arbitrary SQL can only be evaluated by the database
+        Q_UNUSED(index);
+        Q_UNUSED(pRows);
+        return false;
+    }
+
   private:
     QString m_sql;
 };
@@ -272,6 +320,7 @@ class YearFilterNode : public NumericFilterNode {
   public:
     YearFilterNode(const QStringList& sqlColumns, const QString& argument);
     QString toSql() const override;
+    bool selectRows(const ColumnarTrackIndex& index, QBitArray* pRows) const override;
 };
 
 #endif /* SEARCHQUERY_H */
@@ -16,6 +16,7 @@
 #include "controllers/controllermanager.h"
 #include "coreservices.h"
 #include "errordialoghandler.h"
+#include "library/analysis/libraryanalysisrunner.h"
 #include "mixxxapplication.h"
 #ifdef MIXXX_USE_QML
 #include "mixer/playermanager.h"
@@ -118,6 +119,14 @@ int runMixxx(MixxxApplication* pApp, const CmdlineArgs& args) {
     return exitCode;
 }
 
+int runLibraryAnalysis(MixxxApplication* pApp, const CmdlineArgs& args) {
+    // Only the settings, logging, and translations are initialized by
+    // CoreServices. Neither sound devices nor controllers are opened.
+    mixxx::CoreServices coreServices(args, pApp);
+    LibraryAnalysisRunner runner(coreServices.getSettings());
+    return runner.exec();
+}
+
 void adjustScaleFactor(CmdlineArgs* pArgs) {
     if (qEnvironmentVariableIsSet(kScaleFactorEnvVar)) {
         bool ok;
@@ -233,6 +242,11 @@ int main(int argc, char * argv[]) {
 
     adjustScaleFactor(&args);
 
+    if (args.getAnalyzeLibrary() && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        // No window is shown and no display is required
+        qputenv("QT_QPA_PLATFORM", QByteArrayLiteral("offscreen"));
+    }
+
     MixxxApplication app(argc, argv);
 
 #if defined(Q_OS_WIN)
@@ -290,7 +304,9 @@ int main(int argc, char * argv[]) {
     // When the last window is closed, terminate the Qt event loop.
     QObject::connect(&app, &MixxxApplication::lastWindowClosed, &app, &MixxxApplication::quit);
 
-    int exitCode = runMixxx(&app, args);
+    int exitCode = args.getAnalyzeLibrary()
+            ? runLibraryAnalysis(&app, args)
+            : runMixxx(&app, args);
 
     qDebug() << "Mixxx shutdown complete with code" << exitCode;
 
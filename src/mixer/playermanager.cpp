@@ -183,9 +183,12 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
             &Library::slotLoadLocationToPlayer);
 
     DEBUG_ASSERT(!m_pTrackAnalysisScheduler);
+    // Tracks that have been loaded into a deck might be played soon. Spread
+    // the analysis of each track across multiple cores to finish it asap.
     m_pTrackAnalysisScheduler = pLibrary->createTrackAnalysisScheduler(
             kNumberOfAnalyzerThreads,
-            AnalyzerModeFlags::WithWaveform);
+            static_cast<AnalyzerModeFlags>(
+                    AnalyzerModeFlags::WithWaveform | AnalyzerModeFlags::Pipelined));
 
     connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::trackProgress,
             this, &PlayerManager::onTrackAnalysisProgress);
@@ -825,7 +828,10 @@ void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId())) {
+        if (m_pTrackAnalysisScheduler->scheduleTrack(AnalyzerScheduledTrack(
+                    track->getId(),
+                    AnalyzerTrack::Options(),
+                    AnalyzerScheduledTrack::Priority::Deck))) {
             m_pTrackAnalysisScheduler->resume();
         }
         // The first progress signal will suspend a running batch analysis
@@ -91,6 +91,10 @@ DlgPrefLibrary::DlgPrefLibrary(
 #ifdef Q_OS_IOS
     checkBox_edit_metadata_selected_clicked->setEnabled(false);
 #endif
+#ifndef __LINUX__
+    // Watching the library directories is only implemented with inotify
+    checkBox_library_scan_incremental->hide();
+#endif
 
     comboBox_search_bpm_fuzzy_range->clear();
     comboBox_search_bpm_fuzzy_range->addItem("25 %", 25);
@@ -241,6 +245,7 @@ void DlgPrefLibrary::populateDirList() {
 
 void DlgPrefLibrary::slotResetToDefaults() {
     checkBox_library_scan->setChecked(false);
+    checkBox_library_scan_incremental->setChecked(false);
     spinbox_history_track_duplicate_distance->setValue(
             kHistoryTrackDuplicateDistanceDefault);
     spinbox_history_min_tracks_to_keep->setValue(1);
@@ -279,6 +284,8 @@ void DlgPrefLibrary::slotUpdate() {
             kRescanOnStartupConfigKey, false));
     checkBox_library_scan_summary->setChecked(m_pConfig->getValue(
             kShowScanSummaryConfigKey, true));
+    checkBox_library_scan_incremental->setChecked(m_pConfig->getValue(
+            kIncrementalRescanConfigKey, false));
 
     spinbox_history_track_duplicate_distance->setValue(m_pConfig->getValue(
             kHistoryTrackDuplicateDistanceConfigKey,
@@ -513,6 +520,8 @@ void DlgPrefLibrary::slotApply() {
 
     m_pConfig->set(kShowScanSummaryConfigKey,
             ConfigValue((int)checkBox_library_scan_summary->isChecked()));
+    m_pConfig->set(kIncrementalRescanConfigKey,
+            ConfigValue((int)checkBox_library_scan_incremental->isChecked()));
 
     m_pConfig->set(kHistoryTrackDuplicateDistanceConfigKey,
             ConfigValue(spinbox_history_track_duplicate_distance->value()));
@@ -0,0 +1,162 @@
+#include "shaders/waveformsignalshader.h"
+
+using namespace mixxx;
+
+namespace {
+
+// The x texture coordinate is the frame of the summary level, the y texture
+// coordinate the signed distance from the axis in units of halfBreadth,
+// negative above the axis.
+const QString kFragmentShaderCommonCode = QStringLiteral(R"--(
+uniform sampler2D waveformTexture;
+uniform highp vec2 textureSize;
+uniform highp float levelOffset;
+uniform highp float levelDataSize;
+uniform highp float framesPerPixel;
+uniform highp float halfBreadth;
+uniform bool splitStereoSignal;
+uniform bool upperHalfOnly;
+uniform highp float allGain;
+uniform highp vec3 bandGains;
+uniform highp vec3 axesColor;
+uniform highp vec3 lowColor;
+uniform highp vec3 midColor;
+uniform highp vec3 highColor;
+varying highp vec2 vTexcoord;
+
+// The summary level is chosen so that less than 4 frames fall into a pixel,
+// see Waveform::getSummaryLevelForPixel()
+const int kMaxFramesPerPixel = 8;
+
+highp vec4 getWaveformData(highp float index)
+{
+    highp float textureIndex = levelOffset + index;
+    highp float row = floor(textureIndex / textureSize.x);
+    highp float column = textureIndex - row * textureSize.x;
+    return texture2D(waveformTexture, (vec2(column, row) + 0.5) / textureSize);
+}
+
+// The maximum of the frames of this pixel, per channel
+void getMaxima(out highp vec4 maxLeft, out highp vec4 maxRight)
+{
+    // Snapped to whole pixels like in the vertex based renderers,
+    // otherwise the waveform flickers while scrolling
+    highp float frame = floor(vTexcoord.x / framesPerPixel) * framesPerPixel;
+    highp float firstFrame = floor(frame - framesPerPixel / 2.0 + 0.5);
+    highp float endFrame = max(floor(frame + framesPerPixel / 2.0 + 0.5), firstFrame + 1.0);
+    maxLeft = vec4(0.0);
+    maxRight = vec4(0.0);
+    for (int i = 0; i < kMaxFramesPerPixel; i++) {
+        highp float currentFrame = firstFrame + float(i);
+        if (currentFrame >= endFrame) {
+            break;
+        }
+        // The L and R values are interleaved
+        if (currentFrame >= 0.0 && currentFrame * 2.0 + 1.0 < levelDataSize) {
+            maxLeft = max(maxLeft, getWaveformData(currentFrame * 2.0));
+            maxRight = max(maxRight, getWaveformData(currentFrame * 2.0 + 1.0));
+        }
+    }
+}
+)--");
+
+const QString kFragmentShaderRGBCode = QStringLiteral(R"--(
+void main()
+{
+    if (upperHalfOnly && vTexcoord.y > 0.0) {
+        discard;
+    }
+    highp vec4 maxLeft;
+    highp vec4 maxRight;
+    getMaxima(maxLeft, maxRight);
+    highp vec4 data = splitStereoSignal
+            ? (vTexcoord.y < 0.0 ? maxLeft : maxRight)
+            : max(maxLeft, maxRight);
+
+    // The amplitude is scaled by the magnitude of the gained bands
+    highp vec3 bands = data.xyz * bandGains;
+    highp float sum = dot(data.xyz, data.xyz);
+    highp float amplitude = allGain * data.w;
+    if (sum > 0.0) {
+        amplitude *= sqrt(dot(bands, bands) / sum);
+    }
+
+    highp float axisDistance = abs(vTexcoord.y);
+    if (axisDistance < amplitude) {
+        highp vec3 color = bands.x * lowColor + bands.y * midColor + bands.z * highColor;
+        highp float maxComponent = max(color.r, max(color.g, color.b));
+        gl_FragColor = vec4(maxComponent > 0.0 ? color / maxComponent : vec3(0.0), 1.0);
+    } else if (axisDistance * halfBreadth <= 0.5) {
+        gl_FragColor = vec4(axesColor, 1.0);
+    } else {
+        discard;
+    }
+}
+)--");
+
+const QString kFragmentShaderFilteredCode = QStringLiteral(R"--(
+void main()
+{
+    if (upperHalfOnly && vTexcoord.y > 0.0) {
+        discard;
+    }
+    highp vec4 maxLeft;
+    highp vec4 maxRight;
+    getMaxima(maxLeft, maxRight);
+    // The left channel above the axis, the right channel below
+    highp vec3 bands = (vTexcoord.y < 0.0 ? maxLeft.xyz : maxRight.xyz) * bandGains * allGain;
+
+    // The high band covers the mid band, which covers the low band
+    highp float axisDistance = abs(vTexcoord.y);
+    if (axisDistance < bands.z) {
+        gl_FragColor = vec4(highColor, 1.0);
+    } else if (axisDistance < bands.y) {
+        gl_FragColor = vec4(midColor, 1.0);
+    } else if (axisDistance < bands.x) {
+        gl_FragColor = vec4(lowColor, 1.0);
+    } else if (axisDistance * halfBreadth <= 0.5) {
+        gl_FragColor = vec4(axesColor, 1.0);
+    } else {
+        discard;
+    }
+}
+)--");
+
+} // anonymous namespace
+
+void WaveformSignalShader::init(Type type) {
+    QString vertexShaderCode = QStringLiteral(R"--(
+uniform highp mat4 matrix;
+attribute highp vec4 position; // use vec4 here (will be padded) for matrix multiplication
+attribute highp vec2 texcoord;
+varying highp vec2 vTexcoord;
+void main()
+{
+    vTexcoord = texcoord;
+    gl_Position = matrix * position;
+}
+)--");
+
+    QString fragmentShaderCode = kFragmentShaderCommonCode +
+            (type == Type::RGB ? kFragmentShaderRGBCode : kFragmentShaderFilteredCode);
+
+    load(vertexShaderCode, fragmentShaderCode);
+
+    m_matrixLocation = uniformLocation("matrix");
+    m_positionLocation = attributeLocation("position");
+    m_texcoordLocation = attributeLocation("texcoord");
+    m_textureLocation = uniformLocation("waveformTexture");
+    m_textureSizeLocation = uniformLocation("textureSize");
+    m_levelOffsetLocation = uniformLocation("levelOffset");
+    m_levelDataSizeLocation = uniformLocation("levelDataSize");
+    m_framesPerPixelLocation = uniformLocation("framesPerPixel");
+    m_halfBreadthLocation = uniformLocation("halfBreadth");
+    m_splitStereoSignalLocation = uniformLocation("splitStereoSignal");
+    m_upperHalfOnlyLocation = uniformLocation("upperHalfOnly");
+    m_allGainLocation = uniformLocation("allGain");
+    m_bandGainsLocation = uniformLocation("bandGains");
+    m_axesColorLocation = uniformLocation("axesColor");
+    m_lowColorLocation = uniformLocation("lowColor");
+    m_midColorLocation = uniformLocation("midColor");
+    m_highColorLocation = uniformLocation("highColor");
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "shaders/shader.h"
+
+namespace mixxx {
+class WaveformSignalShader;
+}
+
+/// Renders the filtered waveform signal from a level of an
+/// allshader::WaveformTexture. Each fragment aggregates the few frames
+/// of the level that fall into its pixel, so the CPU only needs to set
+/// the uniforms for a single quad per frame.
+class mixxx::WaveformSignalShader final : public mixxx::Shader {
+  public:
+    enum class Type {
+        // Amplitude of the all signal, colored by the mix of the bands
+        RGB,
+        // The low, mid and high bands stacked on top of each other
+        Filtered,
+    };
+
+    WaveformSignalShader() = default;
+    ~WaveformSignalShader() = default;
+    void init(Type type);
+
+    int matrixLocation() const {
+        return m_matrixLocation;
+    }
+    int positionLocation() const {
+        return m_positionLocation;
+    }
+    int texcoordLocation() const {
+        return m_texcoordLocation;
+    }
+    int textureLocation() const {
+        return m_textureLocation;
+    }
+    int textureSizeLocation() const {
+        return m_textureSizeLocation;
+    }
+    int levelOffsetLocation() const {
+        return m_levelOffsetLocation;
+    }
+    int levelDataSizeLocation() const {
+        return m_levelDataSizeLocation;
+    }
+    int framesPerPixelLocation() const {
+        return m_framesPerPixelLocation;
+    }
+    int halfBreadthLocation() const {
+        return m_halfBreadthLocation;
+    }
+    int splitStereoSignalLocation() const {
+        return m_splitStereoSignalLocation;
+    }
+    int upperHalfOnlyLocation() const {
+        return m_upperHalfOnlyLocation;
+    }
+    int allGainLocation() const {
+        return m_allGainLocation;
+    }
+    int bandGainsLocation() const {
+        return m_bandGainsLocation;
+    }
+    int axesColorLocation() const {
+        return m_axesColorLocation;
+    }
+    int lowColorLocation() const {
+        return m_lowColorLocation;
+    }
+    int midColorLocation() const {
+        return m_midColorLocation;
+    }
+    int highColorLocation() const {
+        return m_highColorLocation;
+    }
+
+  private:
+    int m_matrixLocation;
+    int m_positionLocation;
+    int m_texcoordLocation;
+    int m_textureLocation;
+    int m_textureSizeLocation;
+    int m_levelOffsetLocation;
+    int m_levelDataSizeLocation;
+    int m_framesPerPixelLocation;
+    int m_halfBreadthLocation;
+    int m_splitStereoSignalLocation;
+    int m_upperHalfOnlyLocation;
+    int m_allGainLocation;
+    int m_bandGainsLocation;
+    int m_axesColorLocation;
+    int m_lowColorLocation;
+    int m_midColorLocation;
+    int m_highColorLocation;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformSignalShader)
+};
@@ -0,0 +1,567 @@
+#include "sources/decodedaudiocache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+
+#include "sources/audiosourceproxy.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/sample.h"
+#include "util/versionstore.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("DecodedAudioCache");
+
+const ConfigKey kEnabledConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("decoded_audio_cache"));
+const ConfigKey kMaxSizeMBConfigKey =
+        ConfigKey(QStringLiteral("[App]"), QStringLiteral("decoded_audio_cache_max_mb"));
+constexpr int kDefaultMaxSizeMB = 4096;
+
+const QString kCacheDirName = QStringLiteral("pcmcache");
+const QString kFileSuffix = QStringLiteral(".pcm");
+
+// Increment if either the file format or the decoded sample
+// data of existing entries might change.
+constexpr quint32 kFormatVersion = 1;
+
+constexpr char kFileMagic[8] = {'M', 'I', 'X', 'X', 'X', 'P', 'C', 'M'};
+
+// All numbers are stored in native byte order. Files from a platform
+// with a different byte order are rejected due to the version mismatch.
+struct FileHeader {
+    char magic[8];
+    quint32 version;
+    quint32 channelCount;
+    quint32 sampleRate;
+    quint32 bitrate;
+    qint64 frameIndexStart;
+    qint64 frameIndexEnd;
+};
+static_assert(sizeof(FileHeader) == 40, "unexpected padding");
+
+// Reads the samples of a cached entry from a memory mapped file
+class AudioSourceMappedFile final : public AudioSource {
+  public:
+    AudioSourceMappedFile(
+            const QUrl& url,
+            const QString& filePath)
+            : AudioSource(url),
+              m_file(filePath),
+              m_pMappedData(nullptr),
+              m_pSamples(nullptr) {
+    }
+    ~AudioSourceMappedFile() override {
+        close();
+    }
+
+    void close() override {
+        if (m_pMappedData) {
+            m_file.unmap(m_pMappedData);
+            m_pMappedData = nullptr;
+            m_pSamples = nullptr;
+        }
+        m_file.close();
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            return OpenResult::Failed;
+        }
+        const qint64 fileSize = m_file.size();
+        if (fileSize < static_cast<qint64>(sizeof(FileHeader))) {
+            return OpenResult::Failed;
+        }
+        m_pMappedData = m_file.map(0, fileSize);
+        if (!m_pMappedData) {
+            kLogger.warning()
+                    << "Failed to map file"
+                    << m_file.fileName()
+                    << m_file.errorString();
+            return OpenResult::Failed;
+        }
+        FileHeader header;
+        std::memcpy(&header, m_pMappedData, sizeof(header));
+        if (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 ||
+                header.version != kFormatVersion ||
+                header.frameIndexStart < 0 ||
+                header.frameIndexEnd <= header.frameIndexStart) {
+            kLogger.warning()
+                    << "Invalid file header"
+                    << m_file.fileName();
+            return OpenResult::Failed;
+        }
+        const qint64 expectedFileSize = static_cast<qint64>(sizeof(FileHeader)) +
+                (header.frameIndexEnd - header.frameIndexStart) *
+                        header.channelCount * static_cast<qint64>(sizeof(CSAMPLE));
+        if (fileSize != expectedFileSize) {
+            kLogger.warning()
+                    << "Unexpected file size"
+                    << m_file.fileName()
+                    << fileSize
+                    << "<>"
+                    << expectedFileSize;
+            return OpenResult::Failed;
+        }
+        if (!initChannelCountOnce(static_cast<int>(header.channelCount)) ||
+                !initSampleRateOnce(static_cast<SINT>(header.sampleRate)) ||
+                !initFrameIndexRangeOnce(IndexRange::between(
+                        static_cast<SINT>(header.frameIndexStart),
+                        static_cast<SINT>(header.frameIndexEnd)))) {
+            return OpenResult::Failed;
+        }
+        if (header.bitrate > 0) {
+            initBitrateOnce(static_cast<SINT>(header.bitrate));
+        }
+        m_pSamples = reinterpret_cast<const CSAMPLE*>(m_pMappedData + sizeof(FileHeader));
+        return OpenResult::Succeeded;
+    }
+
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& writableSampleFrames) override {
+        DEBUG_ASSERT(m_pSamples);
+        const auto frameIndexRange = writableSampleFrames.frameIndexRange();
+        CSAMPLE* const pData = writableSampleFrames.writableData();
+        if (!pData) {
+            // Skipping frames
+            return ReadableSampleFrames(frameIndexRange);
+        }
+        const SINT sampleCount = getSignalInfo().frames2samples(frameIndexRange.length());
+        SampleUtil::copy(pData,
+                m_pSamples +
+                        getSignalInfo().frames2samples(
+                                frameIndexRange.start() - frameIndexMin()),
+                sampleCount);
+        return ReadableSampleFrames(
+                frameIndexRange,
+                SampleBuffer::ReadableSlice(pData, sampleCount));
+    }
+
+  private:
+    QFile m_file;
+    uchar* m_pMappedData;
+    const CSAMPLE* m_pSamples;
+};
+
+// Writes a new cache entry in the background, so reading from the
+// decoder is not slowed down by writing hundreds of MB to disk. The
+// chunks are written in order by at most one job at a time.
+class CacheEntryWriter final : public std::enable_shared_from_this<CacheEntryWriter> {
+  public:
+    CacheEntryWriter(
+            std::shared_ptr<DecodedAudioCache> pCache,
+            const QString& filePath)
+            : m_pCache(std::move(pCache)),
+              m_filePath(filePath),
+              m_file(filePath),
+              m_queuedBytes(0),
+              m_finished(false),
+              m_commit(false),
+              m_canceled(false),
+              m_jobRunning(false) {
+    }
+
+    /// Returns false if the entry has been canceled, because the
+    /// writer could not keep up or writing has failed.
+    bool append(QByteArray chunk) {
+        const auto locker = lockMutex(&m_mutex);
+        if (m_canceled) {
+            return false;
+        }
+        if (m_queuedBytes + chunk.size() > kMaxQueuedBytes) {
+            kLogger.warning()
+                    << "Discarding cache entry"
+                    << m_filePath
+                    << "that can't be written fast enough";
+            m_canceled = true;
+            // Discard what has already been written
+            startJob();
+            return false;
+        }
+        m_queuedBytes += chunk.size();
+        m_chunks.push_back(std::move(chunk));
+        startJob();
+        return true;
+    }
+
+    /// Commits the entry after all chunks have been written, or discards
+    /// it if incomplete.
+    void finish(bool commit) {
+        const auto locker = lockMutex(&m_mutex);
+        DEBUG_ASSERT(!m_finished);
+        m_finished = true;
+        m_commit = commit;
+        if (m_canceled) {
+            // Already discarded
+            return;
+        }
+        startJob();
+    }
+
+  private:
+    // Limits the memory if the decoder is much faster than the disk
+    static constexpr qint64 kMaxQueuedBytes = 64 * 1024 * 1024;
+
+    // m_mutex must be locked
+    void startJob() {
+        if (m_jobRunning) {
+            return;
+        }
+        m_jobRunning = true;
+        QThreadPool::globalInstance()->start(
+                [pWriter = shared_from_this()] { pWriter->writeQueuedChunks(); });
+    }
+
+    void writeQueuedChunks() {
+        while (true) {
+            QByteArray chunk;
+            bool commit = false;
+            {
+                const auto locker = lockMutex(&m_mutex);
+                if (m_canceled || m_chunks.empty()) {
+                    m_jobRunning = false;
+                    m_chunks.clear();
+                    m_queuedBytes = 0;
+                    if (!m_canceled && !m_finished) {
+                        // More chunks will be appended
+                        return;
+                    }
+                    commit = !m_canceled && m_commit;
+                } else {
+                    chunk = std::move(m_chunks.front());
+                    m_chunks.pop_front();
+                    m_queuedBytes -= chunk.size();
+                }
+            }
+            if (chunk.isNull()) {
+                // No other job is started after the entry has been
+                // finished or canceled
+                close(commit);
+                return;
+            }
+            if (!write(chunk)) {
+                const auto locker = lockMutex(&m_mutex);
+                m_canceled = true;
+            }
+        }
+    }
+
+    bool write(const QByteArray& chunk) {
+        if (!m_file.isOpen() && !m_file.open(QIODevice::WriteOnly)) {
+            kLogger.warning()
+                    << "Failed to create cache entry"
+                    << m_file.fileName()
+                    << m_file.errorString();
+            return false;
+        }
+        if (m_file.write(chunk) != chunk.size()) {
+            kLogger.warning()
+                    << "Failed to write cache entry"
+                    << m_file.fileName()
+                    << m_file.errorString();
+            return false;
+        }
+        return true;
+    }
+
+    void close(bool commit) {
+        if (!m_file.isOpen()) {
+            return;
+        }
+        if (!commit) {
+            // Discard the temporary file of the incomplete entry
+            m_file.cancelWriting();
+            m_file.commit();
+            return;
+        }
+        if (!m_file.commit()) {
+            kLogger.warning()
+                    << "Failed to commit cache entry"
+                    << m_file.fileName()
+                    << m_file.errorString();
+            return;
+        }
+        kLogger.debug()
+                << "Stored decoded audio data in"
+                << m_file.fileName();
+        m_pCache->evictLeastRecentlyUsed();
+    }
+
+    const std::shared_ptr<DecodedAudioCache> m_pCache;
+    const QString m_filePath;
+    // Only accessed by the job
+    QSaveFile m_file;
+
+    QMutex m_mutex;
+    std::deque<QByteArray> m_chunks;
+    qint64 m_queuedBytes;
+    bool m_finished;
+    bool m_commit;
+    bool m_canceled;
+    bool m_jobRunning;
+};
+
+// Records all sample frames that are read contiguously from the start
+// into a new cache entry. Frames that are read out of order are ignored
+// and recording continues when reading the next frame again.
+class AudioSourceRecorder final : public AudioSourceProxy {
+  public:
+    AudioSourceRecorder(
+            AudioSourcePointer&& pAudioSource,
+            std::shared_ptr<DecodedAudioCache> pCache,
+            const QString& filePath)
+            : AudioSourceProxy(std::move(pAudioSource)),
+              m_pWriter(std::make_shared<CacheEntryWriter>(std::move(pCache), filePath)),
+              m_recordFrameIndexRange(frameIndexRange()),
+              m_nextFrameIndex(m_recordFrameIndexRange.start()),
+              m_recording(startRecording()) {
+    }
+    ~AudioSourceRecorder() override {
+        stopRecording();
+    }
+
+    void close() override {
+        stopRecording();
+        AudioSourceProxy::close();
+    }
+
+  protected:
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& sampleFrames) override {
+        const auto readableSampleFrames =
+                AudioSourceProxy::readSampleFramesClamped(sampleFrames);
+        if (m_recording) {
+            recordSampleFrames(readableSampleFrames);
+        }
+        return readableSampleFrames;
+    }
+
+  private:
+    bool startRecording() {
+        if (m_recordFrameIndexRange.empty()) {
+            return false;
+        }
+        FileHeader header;
+        std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+        header.version = kFormatVersion;
+        header.channelCount = getSignalInfo().getChannelCount();
+        header.sampleRate = getSignalInfo().getSampleRate();
+        header.bitrate = getBitrate().isValid() ? getBitrate().value() : 0;
+        header.frameIndexStart = m_recordFrameIndexRange.start();
+        header.frameIndexEnd = m_recordFrameIndexRange.end();
+        return m_pWriter->append(QByteArray(
+                reinterpret_cast<const char*>(&header), sizeof(header)));
+    }
+
+    void stopRecording() {
+        if (!m_recording) {
+            return;
+        }
+        m_recording = false;
+        m_pWriter->finish(false);
+    }
+
+    void recordSampleFrames(const ReadableSampleFrames& readableSampleFrames) {
+        const auto readableFrameIndexRange = readableSampleFrames.frameIndexRange();
+        if (!readableSampleFrames.readableData() ||
+                readableFrameIndexRange.start() > m_nextFrameIndex ||
+                readableFrameIndexRange.end() <= m_nextFrameIndex) {
+            // Not contiguous
+            return;
+        }
+        if (frameIndexRange() != m_recordFrameIndexRange) {
+            // The readable range has been adjusted due to decoding errors
+            kLogger.info()
+                    << "Discarding cache entry for"
+                    << getUrlString();
+            stopRecording();
+            return;
+        }
+        const SINT frameOffset = m_nextFrameIndex - readableFrameIndexRange.start();
+        const SINT frameCount = readableFrameIndexRange.end() - m_nextFrameIndex;
+        const qint64 byteCount = getSignalInfo().frames2samples(frameCount) *
+                static_cast<qint64>(sizeof(CSAMPLE));
+        const char* pData = reinterpret_cast<const char*>(
+                readableSampleFrames.readableData(
+                        getSignalInfo().frames2samples(frameOffset)));
+        if (!m_pWriter->append(QByteArray(pData, byteCount))) {
+            stopRecording();
+            return;
+        }
+        m_nextFrameIndex = readableFrameIndexRange.end();
+        if (m_nextFrameIndex < m_recordFrameIndexRange.end()) {
+            return;
+        }
+        m_recording = false;
+        m_pWriter->finish(true);
+    }
+
+    const std::shared_ptr<CacheEntryWriter> m_pWriter;
+    const IndexRange m_recordFrameIndexRange;
+    SINT m_nextFrameIndex;
+    bool m_recording;
+};
+
+} // anonymous namespace
+
+//static
+std::shared_ptr<DecodedAudioCache> DecodedAudioCache::createFromConfig(
+        const UserSettingsPointer& pConfig) {
+    if (!pConfig || !pConfig->getValue(kEnabledConfigKey, false)) {
+        return nullptr;
+    }
+    const QDir cacheDir(QDir(pConfig->getSettingsPath()).filePath(kCacheDirName));
+    if (!cacheDir.exists() && !QDir().mkpath(cacheDir.absolutePath())) {
+        kLogger.warning()
+                << "Failed to create cache directory"
+                << cacheDir.absolutePath();
+        return nullptr;
+    }
+    const qint64 maxSizeBytes = static_cast<qint64>(std::max(
+                                        pConfig->getValue(kMaxSizeMBConfigKey, kDefaultMaxSizeMB),
+                                        0)) *
+            1024 * 1024;
+    return std::make_shared<DecodedAudioCache>(cacheDir, maxSizeBytes);
+}
+
+DecodedAudioCache::DecodedAudioCache(
+        const QDir& cacheDir,
+        qint64 maxSizeBytes)
+        : m_cacheDir(cacheDir),
+          m_maxSizeBytes(maxSizeBytes) {
+    kLogger.info()
+            << "Caching decoded audio data in"
+            << m_cacheDir.absolutePath()
+            << "up to"
+            << m_maxSizeBytes / (1024 * 1024)
+            << "MB";
+}
+
+//static
+bool DecodedAudioCache::isFileTypeCacheable(const QString& fileType) {
+    const QString lowerFileType = fileType.toLower();
+    return lowerFileType != QLatin1String("wav") &&
+            lowerFileType != QLatin1String("aif") &&
+            lowerFileType != QLatin1String("aiff");
+}
+
+//static
+QString DecodedAudioCache::cacheKey(
+        const QString& filePath,
+        const QString& decoderName,
+        const AudioSource::OpenParams& params) {
+    // Hashing the file content would require to read the whole file
+    // before decoding can start. Modifications are detected by the
+    // size and the time stamp instead.
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists()) {
+        return QString();
+    }
+    // Only needs to detect modified files, not to resist any attacks
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileInfo.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(fileInfo.size()));
+    hash.addData(QByteArray::number(
+            fileInfo.lastModified().toMSecsSinceEpoch()));
+    // Implementation details of decoders might change between releases
+    hash.addData(VersionStore::version().toUtf8());
+    hash.addData(decoderName.toUtf8());
+    hash.addData(QByteArray::number(kFormatVersion));
+    hash.addData(QByteArray::number(
+            static_cast<int>(params.getSignalInfo().getChannelCount())));
+    hash.addData(QByteArray::number(
+            static_cast<int>(params.getSignalInfo().getSampleRate())));
+#ifdef __STEM__
+    const uint stemMask = params.stemMask();
+    hash.addData(QByteArray::number(stemMask));
+#endif
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+QString DecodedAudioCache::filePathForKey(const QString& key) const {
+    return m_cacheDir.filePath(key + kFileSuffix);
+}
+
+AudioSourcePointer DecodedAudioCache::openAudioSource(
+        const QString& key,
+        const QUrl& url) {
+    DEBUG_ASSERT(!key.isEmpty());
+    const QString filePath = filePathForKey(key);
+    if (!QFile::exists(filePath)) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<AudioSourceMappedFile>(url, filePath);
+    if (pAudioSource->open(AudioSource::OpenMode::Strict) !=
+            AudioSource::OpenResult::Succeeded) {
+        kLogger.warning()
+                << "Deleting invalid cache entry"
+                << filePath;
+        pAudioSource->close();
+        QFile::remove(filePath);
+        return nullptr;
+    }
+    // Mark as recently used
+    QFile file(filePath);
+    if (file.open(QIODevice::ReadOnly)) {
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+    return pAudioSource;
+}
+
+AudioSourcePointer DecodedAudioCache::recordAudioSource(
+        const QString& key,
+        AudioSourcePointer pAudioSource) {
+    DEBUG_ASSERT(!key.isEmpty());
+    DEBUG_ASSERT(pAudioSource);
+    return std::make_shared<AudioSourceRecorder>(
+            std::move(pAudioSource),
+            shared_from_this(),
+            filePathForKey(key));
+}
+
+void DecodedAudioCache::evictLeastRecentlyUsed() {
+    const auto locker = lockMutex(&m_evictMutex);
+    QFileInfoList fileInfos = m_cacheDir.entryInfoList(
+            QStringList{QStringLiteral("*") + kFileSuffix},
+            QDir::Files);
+    qint64 totalSizeBytes = 0;
+    for (const auto& fileInfo : std::as_const(fileInfos)) {
+        totalSizeBytes += fileInfo.size();
+    }
+    if (totalSizeBytes <= m_maxSizeBytes) {
+        return;
+    }
+    std::sort(fileInfos.begin(),
+            fileInfos.end(),
+            [](const QFileInfo& lhs, const QFileInfo& rhs) {
+                return lhs.lastModified() < rhs.lastModified();
+            });
+    for (const auto& fileInfo : std::as_const(fileInfos)) {
+        if (totalSizeBytes <= m_maxSizeBytes) {
+            break;
+        }
+        // Deleting might fail on some platforms while the
+        // file is still mapped by another reader
+        if (QFile::remove(fileInfo.filePath())) {
+            kLogger.debug()
+                    << "Evicted cache entry"
+                    << fileInfo.filePath();
+            totalSizeBytes -= fileInfo.size();
+        }
+    }
+}
+
+} // namespace mixxx
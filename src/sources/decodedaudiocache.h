@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QDir>
+#include <QMutex>
+#include <memory>
+
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+
+namespace mixxx {
+
+/// A persistent cache of decoded audio data on disk.
+///
+/// Each entry contains the interleaved float samples of a whole track as
+/// decoded by a SoundSource. Entries are identified by a hash of the file
+/// path, size and modification time, the decoder, and the requested signal
+/// properties. Retagging a file changes the key and the outdated entry is
+/// evicted eventually.
+///
+/// Cached entries are memory mapped when reading. New entries are recorded
+/// transparently while decoding a track sequentially from start to end, e.g.
+/// during analysis or when decoding the whole track into memory. The decoded
+/// samples are written to disk by a job on the global QThreadPool.
+///
+/// The total size of all entries is limited. The least recently used
+/// entries are deleted when the limit has been exceeded.
+///
+/// All functions are thread-safe.
+class DecodedAudioCache : public std::enable_shared_from_this<DecodedAudioCache> {
+  public:
+    /// Returns nullptr if the cache has not been enabled.
+    static std::shared_ptr<DecodedAudioCache> createFromConfig(
+            const UserSettingsPointer& pConfig);
+
+    DecodedAudioCache(
+            const QDir& cacheDir,
+            qint64 maxSizeBytes);
+
+    /// Only compressed files are cached. Decoding uncompressed
+    /// files is as fast as reading the cache.
+    static bool isFileTypeCacheable(const QString& fileType);
+
+    /// Calculates the cache key for the given file. Returns an empty
+    /// string if the file doesn't exist.
+    static QString cacheKey(
+            const QString& filePath,
+            const QString& decoderName,
+            const AudioSource::OpenParams& params);
+
+    /// Opens a cached entry for reading. Returns nullptr if the entry
+    /// is not available.
+    AudioSourcePointer openAudioSource(
+            const QString& key,
+            const QUrl& url);
+
+    /// Wraps an audio source for recording the decoded sample data
+    /// into a new entry.
+    AudioSourcePointer recordAudioSource(
+            const QString& key,
+            AudioSourcePointer pAudioSource);
+
+    /// Deletes the least recently used entries until the total size
+    /// of all entries doesn't exceed the limit.
+    void evictLeastRecentlyUsed();
+
+    const QDir& cacheDir() const {
+        return m_cacheDir;
+    }
+
+  private:
+    QString filePathForKey(const QString& key) const;
+
+    const QDir m_cacheDir;
+    const qint64 m_maxSizeBytes;
+
+    QMutex m_evictMutex;
+};
+
+} // namespace mixxx
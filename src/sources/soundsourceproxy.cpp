@@ -6,6 +6,7 @@
 #include <QStandardPaths>
 
 #include "sources/audiosourcetrackproxy.h"
+#include "sources/decodedaudiocache.h"
 
 #ifdef __MAD__
 #include "sources/soundsourcemp3.h"
@@ -43,6 +44,7 @@
 #include "library/coverartutils.h"
 #include "track/globaltrackcache.h"
 #include "track/track.h"
+#include "util/compatibility/qmutex.h"
 #include "util/logger.h"
 #include "util/regex.h"
 
@@ -51,6 +53,8 @@
 /*static*/ QStringList SoundSourceProxy::s_supportedFileNamePatterns;
 /*static*/ QRegularExpression SoundSourceProxy::s_supportedFileNamesRegex;
 /*static*/ QHash<QMimeType, QString> SoundSourceProxy::s_fileTypeByMimeType;
+/*static*/ QMutex SoundSourceProxy::s_decodedAudioCacheMutex;
+/*static*/ std::shared_ptr<mixxx::DecodedAudioCache> SoundSourceProxy::s_pDecodedAudioCache;
 
 namespace {
 
@@ -591,6 +595,43 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
     }
 }
 
+//static
+SoundSourceProxy::PreparedTrackImport SoundSourceProxy::prepareTrackImportFromNewFile(
+        const mixxx::FileAccess& trackFileAccess,
+        const QList<QFileInfo>& possibleCovers,
+        bool resetMissingTagMetadata) {
+    PreparedTrackImport preparedImport;
+    if (!trackFileAccess.info().checkFileExists()) {
+        return preparedImport;
+    }
+
+    // Unlike importTrackMetadataAndCoverImageFromFile() the file is not
+    // locked via the global track cache, which would serialize all callers.
+    QImage coverImage;
+    std::tie(preparedImport.importResult, preparedImport.sourceSynchronizedAt) =
+            SoundSourceProxy(trackFileAccess.info().toQUrl())
+                    .importTrackMetadataAndCoverImage(
+                            &preparedImport.trackMetadata,
+                            &coverImage,
+                            resetMissingTagMetadata);
+    if (preparedImport.importResult != mixxx::MetadataSource::ImportResult::Succeeded) {
+        return preparedImport;
+    }
+
+    // Guess the cover art like updateTrackFromSource()
+    if (coverImage.isNull()) {
+        preparedImport.coverInfo = CoverArtUtils::selectCoverArtForTrack(
+                trackFileAccess.info(),
+                preparedImport.trackMetadata.getAlbumInfo().getTitle(),
+                possibleCovers);
+    } else {
+        preparedImport.coverInfo.source = CoverInfo::GUESSED;
+        preparedImport.coverInfo.type = CoverInfo::METADATA;
+        preparedImport.coverInfo.setImageDigest(coverImage);
+    }
+    return preparedImport;
+}
+
 std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
 SoundSourceProxy::importTrackMetadataAndCoverImage(
         mixxx::TrackMetadata* pTrackMetadata,
@@ -636,7 +677,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const PreparedTrackImport* pPreparedImport) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -713,13 +755,27 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
+    // The prepared import is only valid for new track objects, i.e. if
+    // the existing metadata that it would be merged into is still empty.
+    if (sourceSyncStatus != mixxx::TrackRecord::SourceSyncStatus::Void ||
+            !updateMetadataFromSource || !pCoverImg) {
+        pPreparedImport = nullptr;
+    }
+
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    std::pair<mixxx::MetadataSource::ImportResult, QDateTime> importResult;
+    if (pPreparedImport) {
+        trackMetadata = pPreparedImport->trackMetadata;
+        importResult = std::make_pair(pPreparedImport->importResult,
+                pPreparedImport->sourceSynchronizedAt);
+    } else {
+        importResult = importTrackMetadataAndCoverImage(
+                &trackMetadata,
+                pCoverImg,
+                syncParams.resetMissingTagMetadataOnImport);
+    }
+    auto [metadataImportResult, sourceSynchronizedAt] = importResult;
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -869,11 +925,12 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
 
     if (pCoverImg) {
         // If the pointer is not null then the cover art should be guessed
-        auto coverInfo =
-                CoverInfoGuesser().guessCoverInfo(
-                        m_pTrack->getFileInfo(),
-                        m_pTrack->getAlbum(),
-                        *pCoverImg);
+        auto coverInfo = pPreparedImport
+                ? pPreparedImport->coverInfo
+                : CoverInfoGuesser().guessCoverInfo(
+                          m_pTrack->getFileInfo(),
+                          m_pTrack->getAlbum(),
+                          *pCoverImg);
         DEBUG_ASSERT(coverInfo.source == CoverInfo::GUESSED);
         m_pTrack->setCoverInfo(coverInfo);
     }
@@ -947,16 +1004,59 @@ bool SoundSourceProxy::openSoundSource(
     return false;
 }
 
+//static
+void SoundSourceProxy::setDecodedAudioCache(
+        std::shared_ptr<mixxx::DecodedAudioCache> pDecodedAudioCache) {
+    const auto locker = lockMutex(&s_decodedAudioCacheMutex);
+    s_pDecodedAudioCache.swap(pDecodedAudioCache);
+    // The previous cache is released outside of the lock
+}
+
+//static
+std::shared_ptr<mixxx::DecodedAudioCache> SoundSourceProxy::getDecodedAudioCache() {
+    const auto locker = lockMutex(&s_decodedAudioCacheMutex);
+    return s_pDecodedAudioCache;
+}
+
 mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
         const mixxx::AudioSource::OpenParams& params) {
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return nullptr;
     }
+    // Hold a reference while opening, the cache might be reset concurrently
+    const auto pDecodedAudioCache = getDecodedAudioCache();
+    const auto pProvider = m_pProvider;
+    QString cacheKey;
+    if (pDecodedAudioCache && pProvider &&
+            mixxx::DecodedAudioCache::isFileTypeCacheable(
+                    m_pTrack->getFileInfo().suffix())) {
+        cacheKey = mixxx::DecodedAudioCache::cacheKey(
+                m_pTrack->getLocation(),
+                pProvider->getDisplayName(),
+                params);
+        if (!cacheKey.isEmpty()) {
+            auto pCachedAudioSource = pDecodedAudioCache->openAudioSource(cacheKey, m_url);
+            if (pCachedAudioSource) {
+                kLogger.debug()
+                        << "Reading decoded audio data from cache"
+                        << m_url;
+                m_pTrack->updateStreamInfoFromSource(
+                        pCachedAudioSource->getStreamInfo());
+                return mixxx::AudioSourceTrackProxy::create(
+                        m_pTrack, std::move(pCachedAudioSource));
+            }
+        }
+    }
     if (!openSoundSource(params)) {
         return nullptr;
     }
     // Overwrite metadata with actual audio properties
     m_pTrack->updateStreamInfoFromSource(
             m_pSoundSource->getStreamInfo());
+    // The cache key is only valid for the initially selected provider
+    if (!cacheKey.isEmpty() && m_pProvider == pProvider) {
+        return mixxx::AudioSourceTrackProxy::create(m_pTrack,
+                pDecodedAudioCache->recordAudioSource(cacheKey, m_pSoundSource));
+    }
     return mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
 }
@@ -2,13 +2,19 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <QDateTime>
+#include <QFileInfo>
 #include <QMimeType>
+#include <QMutex>
 
+#include "library/coverart.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
+#include "track/trackmetadata.h"
 
 namespace mixxx {
 
+class DecodedAudioCache;
 class FileAccess;
 class FileInfo;
 
@@ -39,6 +45,14 @@ class SoundSourceProxy {
         return s_fileTypeByMimeType.value(mimeType);
     }
 
+    /// Sets the persistent cache of decoded audio data that is used by
+    /// openAudioSource(). Pass nullptr to disable caching.
+    ///
+    /// Thread-safe. Readers that are still inside openAudioSource() or
+    /// recording into the previous cache keep it alive until they are done.
+    static void setDecodedAudioCache(
+            std::shared_ptr<mixxx::DecodedAudioCache> pDecodedAudioCache);
+
     /// Get the list of supported file extensions
     ///
     /// A single file type may map to multiple file suffixes, e.g.
@@ -107,6 +121,32 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata);
 
+    /// Track metadata and guessed cover art of a file that have been
+    /// imported before a track object for the file has been created.
+    struct PreparedTrackImport {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        CoverInfoRelative coverInfo;
+    };
+
+    /// Import the track metadata of a file that is not in the library yet
+    /// and guess its cover art, i.e. everything that updateTrackFromSource()
+    /// needs to read from the file system for a new track object.
+    ///
+    /// Unlike importTrackMetadataAndCoverImageFromFile() the file is not
+    /// locked in GlobalTrackCache while reading. This allows to parse many
+    /// files in parallel, but is only safe if no track object for the file
+    /// exists that could export its metadata concurrently.
+    ///
+    /// The possible cover files in the file's directory are passed by the
+    /// caller, because it usually has listed the directory anyway.
+    static PreparedTrackImport prepareTrackImportFromNewFile(
+            const mixxx::FileAccess& trackFileAccess,
+            const QList<QFileInfo>& possibleCovers,
+            bool resetMissingTagMetadata);
+
     /// Import both track metadata and/or the cover image of the
     /// captured track object from the corresponding file.
     ///
@@ -174,10 +214,14 @@ class SoundSourceProxy {
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
     ///
+    /// The file is not parsed again for a new track object if the metadata
+    /// has already been imported by prepareTrackImportFromNewFile().
+    ///
     /// Returns true if the track has been modified and false otherwise.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const PreparedTrackImport* pPreparedImport = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
@@ -193,6 +237,9 @@ class SoundSourceProxy {
     /// sound sources might be resumed and continue until a
     /// usable provider that could open the stream has been
     /// found.
+    ///
+    /// If a decoded audio cache has been set the audio data is read
+    /// from the cache if available instead of decoding the file.
     mixxx::AudioSourcePointer openAudioSource(
             const mixxx::AudioSource::OpenParams& params = mixxx::AudioSource::OpenParams());
 
@@ -201,6 +248,9 @@ class SoundSourceProxy {
     static QStringList s_supportedFileNamePatterns;
     static QRegularExpression s_supportedFileNamesRegex;
     static QHash<QMimeType, QString> s_fileTypeByMimeType;
+    static std::shared_ptr<mixxx::DecodedAudioCache> getDecodedAudioCache();
+    static QMutex s_decodedAudioCacheMutex;
+    static std::shared_ptr<mixxx::DecodedAudioCache> s_pDecodedAudioCache;
 
     friend class TrackCollectionManager;
     FRIEND_TEST(TrackMetadataExportTest, keepWithespaceKey);
@@ -0,0 +1,145 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <limits>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr SINT kSamplesPerChunk = 64;
+constexpr int kNumberOfChunks = 4;
+constexpr int kNumberOfAnalyzers = 3;
+
+// Records all samples and optionally fails after
+// processing a number of samples.
+class RecordingAnalyzer : public Analyzer {
+  public:
+    RecordingAnalyzer(std::vector<CSAMPLE>* pSamples, SINT maxSamples)
+            : m_pSamples(pSamples),
+              m_maxSamples(maxSamples) {
+    }
+
+    bool initialize(const AnalyzerTrack&,
+            mixxx::audio::SampleRate,
+            mixxx::audio::ChannelCount,
+            SINT) override {
+        m_pSamples->clear();
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        // Yield to provoke interleaving with the producer
+        QThread::yieldCurrentThread();
+        m_pSamples->insert(m_pSamples->end(), pIn, pIn + count);
+        return static_cast<SINT>(m_pSamples->size()) < m_maxSamples;
+    }
+
+    void storeResults(TrackPointer) override {
+    }
+
+    void cleanup() override {
+    }
+
+  private:
+    std::vector<CSAMPLE>* const m_pSamples;
+    const SINT m_maxSamples;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    void addAnalyzer(SINT maxSamples) {
+        m_recordedSamples.emplace_back();
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<RecordingAnalyzer>(
+                        &m_recordedSamples.back(), maxSamples)));
+    }
+
+    void initializeAnalyzers() {
+        const auto track = AnalyzerTrack(Track::newTemporary());
+        for (auto&& analyzer : m_analyzers) {
+            analyzer.initialize(track,
+                    mixxx::audio::SampleRate(44100),
+                    mixxx::audio::ChannelCount::stereo(),
+                    0);
+        }
+    }
+
+    void finishAnalyzers() {
+        for (auto&& analyzer : m_analyzers) {
+            analyzer.cancel();
+        }
+    }
+
+    // Publishes chunks with increasing sample values
+    std::vector<CSAMPLE> publishChunks(AnalyzerPipeline* pPipeline, int numberOfChunks) {
+        std::vector<CSAMPLE> publishedSamples;
+        for (int i = 0; i < numberOfChunks; ++i) {
+            const auto chunk = pPipeline->nextChunk();
+            EXPECT_EQ(kSamplesPerChunk, chunk.length());
+            // Publish a shorter chunk with an offset from time to time
+            const SINT offset = i % 3;
+            for (SINT j = offset; j < chunk.length(); ++j) {
+                chunk[j] = static_cast<CSAMPLE>(publishedSamples.size());
+                publishedSamples.push_back(chunk[j]);
+            }
+            pPipeline->publishChunk(chunk.data(offset), chunk.length(offset));
+        }
+        return publishedSamples;
+    }
+
+    // Must be reserved upfront, because the analyzers keep
+    // pointers into this vector
+    std::vector<std::vector<CSAMPLE>> m_recordedSamples;
+    std::vector<AnalyzerWithState> m_analyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, allAnalyzersReceiveAllChunksInOrder) {
+    m_recordedSamples.reserve(kNumberOfAnalyzers);
+    for (int i = 0; i < kNumberOfAnalyzers; ++i) {
+        addAnalyzer(std::numeric_limits<SINT>::max());
+    }
+    AnalyzerPipeline pipeline(
+            QStringLiteral("AnalyzerPipelineTest"),
+            &m_analyzers,
+            kSamplesPerChunk,
+            kNumberOfChunks);
+
+    // Multiple tracks are analyzed subsequently
+    for (int track = 0; track < 2; ++track) {
+        initializeAnalyzers();
+        const auto publishedSamples = publishChunks(&pipeline, 10 * kNumberOfChunks);
+        pipeline.waitUntilProcessed();
+        for (const auto& recordedSamples : m_recordedSamples) {
+            EXPECT_EQ(publishedSamples, recordedSamples);
+        }
+        finishAnalyzers();
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, failingAnalyzerBecomesInactive) {
+    m_recordedSamples.reserve(2);
+    addAnalyzer(std::numeric_limits<SINT>::max());
+    addAnalyzer(kSamplesPerChunk);
+    AnalyzerPipeline pipeline(
+            QStringLiteral("AnalyzerPipelineTest"),
+            &m_analyzers,
+            kSamplesPerChunk,
+            kNumberOfChunks);
+
+    initializeAnalyzers();
+    const auto publishedSamples = publishChunks(&pipeline, 3 * kNumberOfChunks);
+    pipeline.waitUntilProcessed();
+    EXPECT_TRUE(m_analyzers[0].isActive());
+    EXPECT_EQ(publishedSamples, m_recordedSamples[0]);
+    EXPECT_FALSE(m_analyzers[1].isActive());
+    EXPECT_GT(publishedSamples.size(), m_recordedSamples[1].size());
+    finishAnalyzers();
+}
+
+} // anonymous namespace
@@ -0,0 +1,64 @@
+#include "analyzer/audiocontenthash.h"
+
+#include <gtest/gtest.h>
+
+#include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzerkey.h"
+#include "analyzer/constants.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+class AudioContentHashTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    QString hashFile(const QString& fileName) {
+        auto pTrack = Track::newTemporary(getOrInitTestDir().filePath(fileName));
+        mixxx::AudioSource::OpenParams openParams;
+        openParams.setChannelCount(mixxx::kAnalysisMaxChannels);
+        const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+        EXPECT_TRUE(pAudioSource);
+        if (!pAudioSource) {
+            return QString();
+        }
+        return mixxx::calculateAudioContentHash(
+                pAudioSource,
+                mixxx::SampleBuffer::WritableSlice(m_buffer));
+    }
+
+  private:
+    mixxx::SampleBuffer m_buffer{mixxx::kAnalysisSamplesPerChunk};
+};
+
+TEST_F(AudioContentHashTest, independentOfTags) {
+    // Both files contain the same MPEG frames, but different covers
+    const QString hash = hashFile(QStringLiteral("id3-test-data/cover-test-jpg.mp3"));
+    EXPECT_FALSE(hash.isEmpty());
+    EXPECT_EQ(hash, hashFile(QStringLiteral("id3-test-data/cover-test-png.mp3")));
+}
+
+TEST_F(AudioContentHashTest, dependsOnAudioContent) {
+    // Long enough for hashing only some windows of the track
+    const QString hash = hashFile(QStringLiteral("sine-30.wav"));
+    EXPECT_FALSE(hash.isEmpty());
+    EXPECT_EQ(hash, hashFile(QStringLiteral("sine-30.wav")));
+    EXPECT_NE(hash, hashFile(QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+}
+
+TEST_F(AudioContentHashTest, cachedResultsDependOnStemStrategy) {
+    // Cached results of stereo files must not be reused for stem files
+    // that are analyzed differently
+    BeatDetectionSettings bpmSettings(config());
+    KeyDetectionSettings keySettings(config());
+    bpmSettings.setStemStrategy(BeatDetectionSettings::StemStrategy::Disabled);
+    keySettings.setStemStrategy(KeyDetectionSettings::StemStrategy::Disabled);
+    const QString beatsVersion = AnalyzerBeats(config()).cachedResultsVersion();
+    const QString keyVersion = AnalyzerKey(keySettings).cachedResultsVersion();
+
+    bpmSettings.setStemStrategy(BeatDetectionSettings::StemStrategy::Enforced);
+    EXPECT_NE(beatsVersion, AnalyzerBeats(config()).cachedResultsVersion());
+    EXPECT_EQ(keyVersion, AnalyzerKey(keySettings).cachedResultsVersion());
+
+    keySettings.setStemStrategy(KeyDetectionSettings::StemStrategy::Enforced);
+    EXPECT_NE(keyVersion, AnalyzerKey(keySettings).cachedResultsVersion());
+}
@@ -0,0 +1,22 @@
+#include <benchmark/benchmark.h>
+
+#include "test/cachingreaderdecks.h"
+
+static void BM_CachingReaderHints(benchmark::State& state) {
+    CachingReaderDecks decks(kNumberOfDecks);
+    if (!decks.loadTrack()) {
+        state.SkipWithError("Failed to load track");
+        return;
+    }
+
+    std::vector<HintVector> hintLists(kNumberOfDecks);
+    SINT playFrame = 0;
+    for (auto _ : state) {
+        for (auto& hintList : hintLists) {
+            hintList = deckHints(playFrame, kTrackFrames);
+        }
+        decks.process(hintLists);
+        playFrame = (playFrame + kBufferFrames * state.range(0)) % kTrackFrames;
+    }
+}
+BENCHMARK(BM_CachingReaderHints)->Range(1, 64);
@@ -0,0 +1,28 @@
+#include "engine/cachingreader/cachingreader.h"
+
+#include <gtest/gtest.h>
+
+#include "test/cachingreaderdecks.h"
+#include "test/mixxxtest.h"
+
+class CachingReaderTest : public MixxxTest {
+};
+
+TEST_F(CachingReaderTest, hintedChunksBecomeAvailable) {
+    CachingReaderDecks decks(1);
+    ASSERT_TRUE(decks.loadTrack());
+
+    // The hotcues require more chunks than may be requested during a
+    // single callback. The remaining chunks are requested subsequently.
+    const std::vector<HintVector> hintLists{deckHints(0, kTrackFrames)};
+    CachingReader* pReader = decks.readers().front().get();
+    EXPECT_TRUE(decks.processUntil(hintLists, [&] {
+        for (const auto& hint : hintLists.front()) {
+            if (hint.frameCount == Hint::kFrameCountForward &&
+                    !decks.isAvailable(pReader, hint.frame)) {
+                return false;
+            }
+        }
+        return true;
+    }));
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <memory>
+#include <vector>
+
+#include "engine/cachingreader/cachingreader.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+// Shared by the CachingReader tests and benchmarks
+
+constexpr int kNumberOfCachedChunks = 80;
+constexpr int kNumberOfDecks = 4;
+constexpr int kNumberOfHotCues = 36;
+constexpr SINT kBufferFrames = 1024;
+constexpr qint64 kTimeoutMillis = 10000;
+
+inline QString cachingReaderTestFilePath() {
+    return MixxxTest::getOrInitTestDir().filePath(QStringLiteral("sine-30.wav"));
+}
+
+// Provides CachingReaders for multiple decks that share a
+// single EngineWorkerScheduler like in EngineMixer.
+class CachingReaderDecks : public SoundSourceProviderRegistration {
+  public:
+    explicit CachingReaderDecks(int numberOfDecks)
+            : m_pScheduler(std::make_unique<EngineWorkerScheduler>()) {
+        m_pScheduler->start(QThread::HighPriority);
+        for (int i = 0; i < numberOfDecks; ++i) {
+            auto pReader = std::make_unique<CachingReader>(
+                    QStringLiteral("[Channel%1]").arg(i + 1),
+                    UserSettingsPointer(),
+                    mixxx::audio::ChannelCount::stereo(),
+                    kNumberOfCachedChunks);
+            pReader->setScheduler(m_pScheduler.get());
+            m_readers.push_back(std::move(pReader));
+        }
+    }
+    ~CachingReaderDecks() {
+        // Stop the scheduler before the workers of the readers
+        m_pScheduler.reset();
+    }
+
+    const std::vector<std::unique_ptr<CachingReader>>& readers() const {
+        return m_readers;
+    }
+
+    // Simulates a single engine callback
+    void process(const std::vector<HintVector>& hintLists) {
+        for (std::size_t i = 0; i < m_readers.size(); ++i) {
+            m_readers[i]->process();
+            m_readers[i]->hintAndMaybeWake(hintLists[i]);
+        }
+        m_pScheduler->runWorkers();
+    }
+
+    // Loads the test file into all readers and waits until the first
+    // frames can be read.
+    bool loadTrack() {
+        for (const auto& pReader : m_readers) {
+            pReader->newTrack(Track::newTemporary(cachingReaderTestFilePath()));
+        }
+        HintVector hintList;
+        hintList.append(Hint{0, kBufferFrames, Hint::Type::CurrentPosition});
+        const std::vector<HintVector> hintLists(m_readers.size(), hintList);
+        return processUntil(hintLists, [this] {
+            for (const auto& pReader : m_readers) {
+                if (!isAvailable(pReader.get(), 0)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    template<typename Predicate>
+    bool processUntil(const std::vector<HintVector>& hintLists, Predicate predicate) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!timer.hasExpired(kTimeoutMillis)) {
+            process(hintLists);
+            if (predicate()) {
+                return true;
+            }
+            QThread::msleep(1);
+        }
+        return false;
+    }
+
+    bool isAvailable(CachingReader* pReader, SINT frame) {
+        const auto channelCount = mixxx::audio::ChannelCount::stereo();
+        return pReader->read(frame * channelCount,
+                       kBufferFrames * channelCount,
+                       false,
+                       m_buffer.data(),
+                       channelCount) == CachingReader::ReadResult::AVAILABLE;
+    }
+
+  private:
+    std::vector<std::unique_ptr<CachingReader>> m_readers;
+    std::unique_ptr<EngineWorkerScheduler> m_pScheduler;
+    mixxx::SampleBuffer m_buffer{kBufferFrames * 2};
+};
+
+// The hints of a deck with the given play position, loop and all
+// hotcues set, similar to EngineBuffer::hintReader()
+inline HintVector deckHints(SINT playFrame, SINT trackFrames) {
+    HintVector hintList;
+    hintList.append(Hint{playFrame, Hint::kFrameCountForward, Hint::Type::CurrentPosition});
+    hintList.append(Hint{playFrame, Hint::kFrameCountBackward, Hint::Type::CurrentPosition});
+    hintList.append(Hint{0, Hint::kFrameCountForward, Hint::Type::MainCue});
+    const SINT hotCueDistance = trackFrames / (kNumberOfHotCues + 1);
+    for (int i = 1; i <= kNumberOfHotCues; ++i) {
+        hintList.append(Hint{i * hotCueDistance, Hint::kFrameCountForward, Hint::Type::HotCue});
+    }
+    const SINT loopStart = trackFrames / 3;
+    hintList.append(Hint{loopStart, Hint::kFrameCountForward, Hint::Type::LoopStartEnabled});
+    hintList.append(Hint{loopStart + 4 * kBufferFrames,
+            Hint::kFrameCountBackward,
+            Hint::Type::LoopEndEnabled});
+    return hintList;
+}
+
+constexpr SINT kTrackFrames = 30 * 44100;
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include <QBitArray>
+#include <QSet>
+#include <QSqlDatabase>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "library/columnartrackindex.h"
+#include "library/searchquery.h"
+
+namespace {
+
+const QStringList kColumns = {"id",
+        "artist",
+        "title",
+        "year",
+        "tracknumber",
+        "bpm",
+        "bpm_lock",
+        "key_id"};
+const QStringList kNumberColumns = {"id", "bpm", "bpm_lock", "key_id"};
+
+TrackId trackId(int id) {
+    return TrackId(QVariant(id));
+}
+
+} // namespace
+
+// Searches and sorts a library of 500k tracks with 20k artists like
+// BaseTrackCache does for each change of the search query.
+static void BM_ColumnarTrackIndexSearch(benchmark::State& state) {
+    std::mt19937 generator(1234);
+    QStringList words = {"love", "night", "dance"};
+    std::uniform_int_distribution<int> syllable(0, 25);
+    while (words.size() < 5000) {
+        QString word;
+        for (int i = 0; i < 3; ++i) {
+            word += QChar('a' + syllable(generator));
+            word += QChar("aeiou"[syllable(generator) % 5]);
+        }
+        words.append(word);
+    }
+    std::uniform_int_distribution<int> wordIndex(0, words.size() - 1);
+    std::uniform_int_distribution<int> artistIndex(0, 19999);
+    std::uniform_real_distribution<double> bpm(70, 180);
+    std::uniform_int_distribution<int> keyId(0, 24);
+    std::uniform_int_distribution<int> year(1960, 2024);
+
+    ColumnarTrackIndex index(kColumns, kNumberColumns);
+    constexpr int kTrackCount = 500000;
+    QSet<TrackId> trackIds;
+    for (int id = 1; id <= kTrackCount; ++id) {
+        const QString title = words[wordIndex(generator)] + ' ' +
+                words[wordIndex(generator)] + ' ' + words[wordIndex(generator)];
+        index.setTrack(trackId(id),
+                {id,
+                        QStringLiteral("Artist %1").arg(artistIndex(generator)),
+                        title,
+                        QString::number(year(generator)),
+                        QString::number(id % 20),
+                        bpm(generator),
+                        false,
+                        keyId(generator)});
+        trackIds.insert(trackId(id));
+    }
+
+    const int artist = kColumns.indexOf("artist");
+    const int title = kColumns.indexOf("title");
+    QString bpmRange = "120-130";
+    for (auto _ : state) {
+        AndNode query;
+        query.addNode(std::make_unique<TextFilterNode>(
+                QSqlDatabase(), QStringList{"artist", "title"}, "love"));
+        query.addNode(std::make_unique<BpmFilterNode>(bpmRange, false));
+        QBitArray rows(index.rowCount());
+        query.selectRows(index, &rows);
+
+        std::vector<int> resultRows;
+        for (const auto& trackId : std::as_const(trackIds)) {
+            const int row = index.rowForTrack(trackId);
+            if (rows.testBit(row)) {
+                resultRows.push_back(row);
+            }
+        }
+        index.sortRows(&resultRows,
+                {{artist, Qt::AscendingOrder, ColumnarTrackIndex::SortMode::Default},
+                        {title, Qt::AscendingOrder, ColumnarTrackIndex::SortMode::Default}},
+                KeyUtils::KeyNotation::OpenKey);
+        state.counters["results"] = static_cast<double>(resultRows.size());
+    }
+}
+BENCHMARK(BM_ColumnarTrackIndexSearch)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+
+#include <QBitArray>
+#include <QSqlDatabase>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "library/columnartrackindex.h"
+#include "library/searchquery.h"
+
+namespace {
+
+const QStringList kColumns = {"id",
+        "artist",
+        "title",
+        "year",
+        "tracknumber",
+        "bpm",
+        "bpm_lock",
+        "key_id"};
+const QStringList kNumberColumns = {"id", "bpm", "bpm_lock", "key_id"};
+
+QVector<QVariant> trackValues(int id,
+        const QString& artist,
+        const QString& title,
+        const QVariant& year,
+        const QString& trackNumber,
+        const QVariant& bpm,
+        bool bpmLocked,
+        const QVariant& keyId) {
+    return {id, artist, title, year, trackNumber, bpm, bpmLocked, keyId};
+}
+
+TrackId trackId(int id) {
+    return TrackId(QVariant(id));
+}
+
+std::unique_ptr<TextFilterNode> textFilter(const QString& argument,
+        StringMatch matchMode = StringMatch::Contains) {
+    return std::make_unique<TextFilterNode>(
+            QSqlDatabase(), QStringList{"artist", "title"}, argument, matchMode);
+}
+
+class ColumnarTrackIndexTest : public testing::Test {
+  protected:
+    ColumnarTrackIndexTest()
+            : m_index(kColumns, kNumberColumns) {
+        m_index.setTrack(trackId(1),
+                trackValues(1,
+                        "Daft Punk",
+                        "One More Time",
+                        "2000",
+                        "1",
+                        123.0,
+                        false,
+                        mixxx::track::io::key::C_MAJOR));
+        m_index.setTrack(trackId(2),
+                trackValues(2,
+                        QString::fromUtf8("Röyksopp"),
+                        "Eple",
+                        "2001-05-01",
+                        "10",
+                        110.0,
+                        true,
+                        mixxx::track::io::key::A_MINOR));
+        m_index.setTrack(trackId(3),
+                trackValues(3,
+                        "daft punk",
+                        "Around the World",
+                        QVariant(),
+                        "2",
+                        QVariant(),
+                        false,
+                        QVariant()));
+        m_index.setTrack(trackId(4),
+                trackValues(4,
+                        "Air",
+                        "La Femme d'Argent",
+                        "1998",
+                        "3/10",
+                        93.0,
+                        false,
+                        mixxx::track::io::key::A_MINOR));
+    }
+
+    std::vector<int> selectedTracks(const QueryNode& node) const {
+        QBitArray rows(m_index.rowCount());
+        EXPECT_TRUE(node.selectRows(m_index, &rows));
+        std::vector<int> ids;
+        for (int row = 0; row < m_index.rowCount(); ++row) {
+            if (rows.testBit(row)) {
+                ids.push_back(m_index.trackIdForRow(row).toVariant().toInt());
+            }
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    std::vector<int> sortedTracks(const std::vector<ColumnarTrackIndex::SortKey>& sortKeys) const {
+        std::vector<int> rows(m_index.rowCount());
+        for (int row = 0; row < m_index.rowCount(); ++row) {
+            rows[row] = row;
+        }
+        m_index.sortRows(&rows, sortKeys, KeyUtils::KeyNotation::OpenKey);
+        std::vector<int> ids;
+        for (const int row : rows) {
+            ids.push_back(m_index.trackIdForRow(row).toVariant().toInt());
+        }
+        return ids;
+    }
+
+    ColumnarTrackIndex m_index;
+};
+
+TEST_F(ColumnarTrackIndexTest, textFilter) {
+    EXPECT_EQ(std::vector<int>({1, 3}), selectedTracks(*textFilter("DAFT")));
+    EXPECT_EQ(std::vector<int>({2}), selectedTracks(*textFilter("royksopp")));
+    EXPECT_EQ(std::vector<int>({4}), selectedTracks(*textFilter("air", StringMatch::Equals)));
+    EXPECT_EQ(std::vector<int>(), selectedTracks(*textFilter("ai", StringMatch::Equals)));
+}
+
+TEST_F(ColumnarTrackIndexTest, trigramLookup) {
+    EXPECT_EQ(std::vector<int>({3}), selectedTracks(*textFilter("around")));
+    EXPECT_EQ(std::vector<int>({4}), selectedTracks(*textFilter("d'argent")));
+
+    // Texts that are added after a lookup are found
+    m_index.setTrack(trackId(5),
+            trackValues(5,
+                    "Daft Punk",
+                    "Run Around",
+                    "2001",
+                    "5",
+                    120.0,
+                    false,
+                    QVariant()));
+    EXPECT_EQ(std::vector<int>({3, 5}), selectedTracks(*textFilter("around")));
+    // "run around" contains the trigrams "run" and "und" but not "rund"
+    EXPECT_EQ(std::vector<int>(), selectedTracks(*textFilter("rund")));
+    // Needles that are shorter than a trigram
+    EXPECT_EQ(std::vector<int>({1, 3, 4}), selectedTracks(*textFilter("e ")));
+}
+
+TEST_F(ColumnarTrackIndexTest, groupNodes) {
+    AndNode andNode;
+    andNode.addNode(textFilter("daft"));
+    andNode.addNode(std::make_unique<NotNode>(textFilter("world")));
+    EXPECT_EQ(std::vector<int>({1}), selectedTracks(andNode));
+
+    OrNode orNode;
+    orNode.addNode(textFilter("eple"));
+    orNode.addNode(textFilter("femme"));
+    EXPECT_EQ(std::vector<int>({2, 4}), selectedTracks(orNode));
+
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), selectedTracks(AndNode()));
+    EXPECT_EQ(std::vector<int>(), selectedTracks(OrNode()));
+}
+
+TEST_F(ColumnarTrackIndexTest, numericFilters) {
+    QString bpmRange = "120-125";
+    EXPECT_EQ(std::vector<int>({1}), selectedTracks(BpmFilterNode(bpmRange, false)));
+    QString bpmLocked = "locked";
+    EXPECT_EQ(std::vector<int>({2}), selectedTracks(BpmFilterNode(bpmLocked, false)));
+    EXPECT_EQ(std::vector<int>({3}), selectedTracks(NullNumericFilterNode({"bpm"})));
+    EXPECT_EQ(std::vector<int>({1, 2}), selectedTracks(YearFilterNode({"year"}, ">1999")));
+    EXPECT_EQ(std::vector<int>({3}), selectedTracks(YearFilterNode({"year"}, "\"\"")));
+    EXPECT_EQ(std::vector<int>({2, 3}), selectedTracks(NumericFilterNode({"tracknumber"}, "2-10")));
+    EXPECT_EQ(std::vector<int>({2, 4}),
+            selectedTracks(KeyFilterNode(mixxx::track::io::key::A_MINOR, false)));
+}
+
+TEST_F(ColumnarTrackIndexTest, negationExcludesNullValues) {
+    // Like in SQL, where comparisons with NULL are neither true nor false,
+    // the track without a year, BPM and key matches neither the filter
+    // nor its negation
+    QString bpmRange = "120-125";
+    EXPECT_EQ(std::vector<int>({2, 4}),
+            selectedTracks(NotNode(std::make_unique<BpmFilterNode>(bpmRange, false))));
+    EXPECT_EQ(std::vector<int>({4}),
+            selectedTracks(NotNode(std::make_unique<YearFilterNode>(
+                    QStringList{"year"}, ">1999"))));
+    EXPECT_EQ(std::vector<int>({1}),
+            selectedTracks(NotNode(std::make_unique<NotNode>(
+                    std::make_unique<BpmFilterNode>(bpmRange, false)))));
+
+    // IS NULL and IS never evaluate to NULL
+    EXPECT_EQ(std::vector<int>({1, 2, 4}),
+            selectedTracks(NotNode(std::make_unique<NullNumericFilterNode>(
+                    QStringList{"bpm"}))));
+    EXPECT_EQ(std::vector<int>({1, 3}),
+            selectedTracks(NotNode(std::make_unique<KeyFilterNode>(
+                    mixxx::track::io::key::A_MINOR, false))));
+
+    // TRUE OR NULL is TRUE
+    auto pOrNode = std::make_unique<OrNode>();
+    pOrNode->addNode(std::make_unique<BpmFilterNode>(bpmRange, false));
+    pOrNode->addNode(textFilter("daft"));
+    EXPECT_EQ(std::vector<int>({2, 4}), selectedTracks(NotNode(std::move(pOrNode))));
+
+    // TRUE AND NULL is NULL
+    auto pAndNode = std::make_unique<AndNode>();
+    pAndNode->addNode(textFilter("daft"));
+    pAndNode->addNode(std::make_unique<YearFilterNode>(QStringList{"year"}, ">1999"));
+    EXPECT_EQ(std::vector<int>({2, 4}), selectedTracks(NotNode(std::move(pAndNode))));
+}
+
+TEST_F(ColumnarTrackIndexTest, nodesWithoutSqlAreIgnored) {
+    // Like in the SQL query, an invalid year does not restrict the result
+    AndNode andNode;
+    andNode.addNode(textFilter("daft"));
+    andNode.addNode(std::make_unique<YearFilterNode>(QStringList{"year"}, "abc"));
+    EXPECT_EQ(std::vector<int>({1, 3}), selectedTracks(andNode));
+}
+
+TEST_F(ColumnarTrackIndexTest, sqlIsNotEvaluated) {
+    AndNode andNode;
+    andNode.addNode(textFilter("daft"));
+    andNode.addNode(std::make_unique<SqlNode>("mixxx_deleted=0"));
+    QBitArray rows(m_index.rowCount());
+    EXPECT_FALSE(andNode.selectRows(m_index, &rows));
+
+    // Unknown columns
+    QBitArray otherRows(m_index.rowCount());
+    EXPECT_FALSE(TextFilterNode(QSqlDatabase(), {"comment"}, "daft")
+                         .selectRows(m_index, &otherRows));
+}
+
+TEST_F(ColumnarTrackIndexTest, tracksAreReplacedAndRemoved) {
+    m_index.setTrack(trackId(3),
+            trackValues(3,
+                    "Daft Punk",
+                    "Da Funk",
+                    "1995",
+                    "2",
+                    111.0,
+                    false,
+                    QVariant()));
+    EXPECT_EQ(4, m_index.rowCount());
+    EXPECT_EQ(std::vector<int>({3}), selectedTracks(*textFilter("funk")));
+    EXPECT_EQ(std::vector<int>(), selectedTracks(*textFilter("world")));
+
+    m_index.removeTrack(trackId(1));
+    EXPECT_EQ(3, m_index.rowCount());
+    EXPECT_EQ(-1, m_index.rowForTrack(trackId(1)));
+    EXPECT_EQ(std::vector<int>({3}), selectedTracks(*textFilter("daft")));
+    EXPECT_EQ(111.0, m_index.number(m_index.rowForTrack(trackId(3)), kColumns.indexOf("bpm")));
+    EXPECT_EQ(QStringLiteral("Da Funk"), m_index.text(m_index.rowForTrack(trackId(3)), kColumns.indexOf("title")));
+}
+
+TEST_F(ColumnarTrackIndexTest, sortRows) {
+    const int artist = kColumns.indexOf("artist");
+    const int bpm = kColumns.indexOf("bpm");
+    const int trackNumber = kColumns.indexOf("tracknumber");
+    const int keyId = kColumns.indexOf("key_id");
+    using SortMode = ColumnarTrackIndex::SortMode;
+
+    // Equal artists are sorted by track id
+    EXPECT_EQ(std::vector<int>({4, 1, 3, 2}),
+            sortedTracks({{artist, Qt::AscendingOrder, SortMode::Default}}));
+    // Null values last in descending order
+    EXPECT_EQ(std::vector<int>({1, 2, 4, 3}),
+            sortedTracks({{bpm, Qt::DescendingOrder, SortMode::Default}}));
+    EXPECT_EQ(std::vector<int>({1, 3, 4, 2}),
+            sortedTracks({{trackNumber, Qt::AscendingOrder, SortMode::Integer}}));
+    EXPECT_EQ(std::vector<int>({3, 1, 4, 2}),
+            sortedTracks({{keyId, Qt::AscendingOrder, SortMode::Key},
+                    {artist, Qt::AscendingOrder, SortMode::Default}}));
+}
+
+} // namespace
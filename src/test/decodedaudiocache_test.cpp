@@ -0,0 +1,138 @@
+#include "sources/decodedaudiocache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kReadFrameCount = 4096;
+
+} // anonymous namespace
+
+class DecodedAudioCacheTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    void TearDown() override {
+        SoundSourceProxy::setDecodedAudioCache(nullptr);
+    }
+
+    QString testFilePath() const {
+        return getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.flac"));
+    }
+
+    void setDecodedAudioCache(qint64 maxSizeBytes) {
+        ASSERT_TRUE(m_cacheDir.isValid());
+        m_pCache = std::make_shared<mixxx::DecodedAudioCache>(
+                QDir(m_cacheDir.path()), maxSizeBytes);
+        SoundSourceProxy::setDecodedAudioCache(m_pCache);
+    }
+
+    int countCacheEntries() const {
+        return QDir(m_cacheDir.path())
+                .entryList(QStringList{QStringLiteral("*.pcm")}, QDir::Files)
+                .size();
+    }
+
+    // Reads all samples sequentially from start to end
+    static std::vector<CSAMPLE> readAllSamples(const QString& filePath) {
+        auto pTrack = Track::newTemporary(filePath);
+        auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource();
+        EXPECT_NE(nullptr, pAudioSource);
+        if (!pAudioSource) {
+            return {};
+        }
+        const auto signalInfo = pAudioSource->getSignalInfo();
+        mixxx::SampleBuffer buffer(signalInfo.frames2samples(kReadFrameCount));
+        std::vector<CSAMPLE> samples;
+        const auto frameIndexRange = pAudioSource->frameIndexRange();
+        SINT frameIndex = frameIndexRange.start();
+        while (frameIndex < frameIndexRange.end()) {
+            const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            mixxx::IndexRange::forward(frameIndex,
+                                    std::min(kReadFrameCount,
+                                            frameIndexRange.end() - frameIndex)),
+                            mixxx::SampleBuffer::WritableSlice(buffer)));
+            const auto readRange = readableSampleFrames.frameIndexRange();
+            EXPECT_FALSE(readRange.empty());
+            if (readRange.empty()) {
+                break;
+            }
+            samples.insert(samples.end(),
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableData() +
+                            signalInfo.frames2samples(readRange.length()));
+            frameIndex = readRange.end();
+        }
+        pAudioSource->close();
+        // New entries are written in the background
+        QThreadPool::globalInstance()->waitForDone();
+        return samples;
+    }
+
+    QTemporaryDir m_cacheDir;
+    std::shared_ptr<mixxx::DecodedAudioCache> m_pCache;
+};
+
+TEST_F(DecodedAudioCacheTest, storeAndReadCachedSamples) {
+    setDecodedAudioCache(1024 * 1024 * 1024);
+    ASSERT_EQ(0, countCacheEntries());
+
+    const auto decodedSamples = readAllSamples(testFilePath());
+    ASSERT_FALSE(decodedSamples.empty());
+    EXPECT_EQ(1, countCacheEntries());
+
+    const auto cachedSamples = readAllSamples(testFilePath());
+    EXPECT_EQ(1, countCacheEntries());
+    EXPECT_EQ(decodedSamples, cachedSamples);
+}
+
+TEST_F(DecodedAudioCacheTest, uncompressedFilesAreNotCached) {
+    setDecodedAudioCache(1024 * 1024 * 1024);
+
+    const auto decodedSamples = readAllSamples(
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.wav")));
+    ASSERT_FALSE(decodedSamples.empty());
+    EXPECT_EQ(0, countCacheEntries());
+}
+
+TEST_F(DecodedAudioCacheTest, evictLeastRecentlyUsed) {
+    // Each entry exceeds the size limit and is evicted immediately
+    setDecodedAudioCache(0);
+
+    const auto decodedSamples = readAllSamples(testFilePath());
+    ASSERT_FALSE(decodedSamples.empty());
+    EXPECT_EQ(0, countCacheEntries());
+}
+
+TEST_F(DecodedAudioCacheTest, cacheKeyDependsOnModificationTime) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("cover-test.flac"));
+    ASSERT_TRUE(QFile::copy(testFilePath(), filePath));
+    const auto params = mixxx::AudioSource::OpenParams();
+    const QString decoderName = QStringLiteral("decoder");
+
+    const QString key = mixxx::DecodedAudioCache::cacheKey(filePath, decoderName, params);
+    ASSERT_FALSE(key.isEmpty());
+    EXPECT_EQ(key, mixxx::DecodedAudioCache::cacheKey(filePath, decoderName, params));
+
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(
+            QDateTime::currentDateTimeUtc().addSecs(60),
+            QFileDevice::FileModificationTime));
+    file.close();
+    EXPECT_NE(key, mixxx::DecodedAudioCache::cacheKey(filePath, decoderName, params));
+
+    EXPECT_TRUE(mixxx::DecodedAudioCache::cacheKey(
+            tempDir.filePath(QStringLiteral("missing.flac")), decoderName, params)
+                        .isEmpty());
+}
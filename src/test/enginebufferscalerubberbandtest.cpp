@@ -0,0 +1,149 @@
+#ifdef __RUBBERBAND__
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <memory>
+
+#include "engine/bufferscalers/enginebufferscalerubberband.h"
+#include "engine/bufferscalers/rubberbandprerenderworker.h"
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+#include "engine/engineworkerscheduler.h"
+#include "engine/readaheadmanager.h"
+#include "test/mixxxtest.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kOutputBufferSize = 1024;
+
+// More than the number of stable callbacks that are required
+// before prerendering is started
+constexpr int kStableCallbacks = 16;
+
+class ReadAheadManagerFake : public ReadAheadManager {
+  public:
+    SINT getNextSamples(double dRate,
+            CSAMPLE* buffer,
+            SINT requested_samples,
+            mixxx::audio::ChannelCount channelCount) override {
+        Q_UNUSED(dRate);
+        Q_UNUSED(channelCount);
+        for (SINT i = 0; i < requested_samples; ++i) {
+            buffer[i] = (i % 2 == 0) ? 0.5f : -0.5f;
+        }
+        return requested_samples;
+    }
+};
+
+} // anonymous namespace
+
+class EngineBufferScaleRubberBandTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        RubberBandWorkerPool::createInstance();
+        m_pScheduler = std::make_unique<EngineWorkerScheduler>();
+        m_pScheduler->start(QThread::HighPriority);
+        m_pScaler = std::make_unique<EngineBufferScaleRubberBand>(&m_readAheadManager);
+        m_pScaler->setSignal(mixxx::audio::SampleRate(44100),
+                mixxx::audio::ChannelCount::stereo());
+        m_pScaler->enablePrerendering(m_pScheduler.get());
+    }
+
+    void TearDown() override {
+        m_pScaler.reset();
+        m_pScheduler.reset();
+        RubberBandWorkerPool::destroy();
+    }
+
+    void setRate(double rate) {
+        double tempoRatio = rate;
+        double pitchRatio = 1.0;
+        m_pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    }
+
+    // Processes a callback and wakes the workers like the engine
+    void process() {
+        m_pScaler->scaleBuffer(m_outputBuffer.data(), m_outputBuffer.size());
+        m_pScheduler->runWorkers();
+        QThread::msleep(1);
+    }
+
+    ReadAheadManagerFake m_readAheadManager;
+    std::unique_ptr<EngineWorkerScheduler> m_pScheduler;
+    std::unique_ptr<EngineBufferScaleRubberBand> m_pScaler;
+    mixxx::SampleBuffer m_outputBuffer{kOutputBufferSize};
+};
+
+TEST_F(EngineBufferScaleRubberBandTest, prerenderWithStableRate) {
+    setRate(1.1);
+    // The parameters are only set once like by EngineBuffer
+    for (int i = 0; i < kStableCallbacks; ++i) {
+        process();
+    }
+    EXPECT_TRUE(m_pScaler->isPrerendering());
+
+    // The worker runs asynchronously after the callbacks
+    for (int i = 0; i < 1000 && m_pScaler->m_pPrerenderWorker->processedBlocks() == 0; ++i) {
+        process();
+    }
+    EXPECT_LT(0, m_pScaler->m_pPrerenderWorker->processedBlocks());
+}
+
+TEST_F(EngineBufferScaleRubberBandTest, deferChangesWhilePrerendering) {
+    setRate(1.1);
+    for (int i = 0; i < kStableCallbacks; ++i) {
+        process();
+    }
+    ASSERT_TRUE(m_pScaler->isPrerendering());
+
+    // Changes neither wait for nor interfere with the worker
+    setRate(0.9);
+    EXPECT_FALSE(m_pScaler->isPrerendering());
+    m_pScaler->clear();
+    process();
+
+    // All changes are applied eventually
+    for (int i = 0; i < 1000 && m_pScaler->isWorkerBusy(); ++i) {
+        QThread::msleep(1);
+    }
+    process();
+    EXPECT_FALSE(m_pScaler->m_parametersPending);
+    EXPECT_FALSE(m_pScaler->m_resetPending);
+    EXPECT_DOUBLE_EQ(0.9, m_pScaler->m_appliedTempoRatio);
+}
+
+TEST_F(EngineBufferScaleRubberBandTest, stretchLiveWhileWorkerBusy) {
+    setRate(1.1);
+    for (int i = 0; i < kStableCallbacks; ++i) {
+        process();
+    }
+    for (int i = 0; i < 1000 && m_pScaler->m_pPrerenderWorker->isBusy(); ++i) {
+        QThread::msleep(1);
+    }
+    ASSERT_FALSE(m_pScaler->m_pPrerenderWorker->isBusy());
+
+    // The worker stays busy until the workers are run after the callback
+    RubberBandWrapper* pPrerenderedRubberBand = m_pScaler->m_pRubberBand;
+    m_pScaler->m_pPrerenderWorker->submit(pPrerenderedRubberBand, 64);
+    ASSERT_TRUE(m_pScaler->isWorkerBusy());
+
+    // A seek must not result in silence
+    m_pScaler->clear();
+    m_outputBuffer.clear();
+    m_pScaler->scaleBuffer(m_outputBuffer.data(), m_outputBuffer.size());
+    EXPECT_NE(pPrerenderedRubberBand, m_pScaler->m_pRubberBand);
+    EXPECT_FALSE(m_pScaler->m_resetPending);
+    EXPECT_LT(0.0f,
+            SampleUtil::maxAbsAmplitude(
+                    m_outputBuffer.data(), m_outputBuffer.size()));
+
+    m_pScheduler->runWorkers();
+    for (int i = 0; i < 1000 && m_pScaler->m_pPrerenderWorker->isBusy(); ++i) {
+        QThread::msleep(1);
+    }
+    process();
+}
+
+#endif // __RUBBERBAND__
@@ -0,0 +1,132 @@
+#include "engine/effects/engineeffectchain.h"
+
+#include <gtest/gtest.h>
+
+#include "engine/effects/groupfeaturestate.h"
+#include "engine/engine.h"
+#include "test/mixxxtest.h"
+#include "util/messagepipe.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kMessagePipeFifoSize = 16;
+constexpr std::size_t kNumSamples = 128;
+
+} // anonymous namespace
+
+class EngineEffectChainTest : public MixxxTest {
+  protected:
+    EngineEffectChainTest()
+            : m_inputChannel(m_factory.getOrCreateHandle(QStringLiteral("[Channel1]")),
+                      QStringLiteral("[Channel1]")),
+              m_outputChannel(m_factory.getOrCreateHandle(QStringLiteral("[Main]")),
+                      QStringLiteral("[Main]")),
+              m_pipes(makeTwoWayMessagePipe<EffectsRequest*, EffectsResponse>(
+                      kMessagePipeFifoSize, kMessagePipeFifoSize)),
+              m_chain(QStringLiteral("[EffectRack1_EffectUnit1]"),
+                      {m_inputChannel},
+                      {m_outputChannel}),
+              m_input(kNumSamples),
+              m_output(kNumSamples) {
+        m_input.clear();
+    }
+
+    void sendRequest(EffectsRequest& request) {
+        request.pTargetChain = &m_chain;
+        ASSERT_TRUE(m_chain.processEffectsRequest(request, &m_pipes.second));
+        // Keep the response pipe from filling up
+        EffectsResponse response;
+        EXPECT_TRUE(m_pipes.first.readMessage(&response));
+        EXPECT_TRUE(response.success);
+    }
+
+    void setChainEnabled(bool enabled) {
+        EffectsRequest request;
+        request.type = EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS;
+        request.SetEffectChainParameters.enabled = enabled;
+        request.SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+        request.SetEffectChainParameters.mix = 1.0;
+        sendRequest(request);
+    }
+
+    void enableForInputChannel() {
+        EffectsRequest request;
+        request.type = EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL;
+        request.EnableInputChannelForChain.channelHandle = m_inputChannel.handle();
+        sendRequest(request);
+    }
+
+    void process() {
+        ASSERT_TRUE(m_chain.isEnabledForChannel(
+                m_inputChannel.handle(), m_outputChannel.handle()));
+        m_chain.process(m_inputChannel.handle(),
+                m_outputChannel.handle(),
+                m_input.data(),
+                m_output.data(),
+                kNumSamples,
+                mixxx::audio::SampleRate(44100),
+                GroupFeatureState(),
+                false);
+    }
+
+    ChannelHandleFactory m_factory;
+    const ChannelHandleAndGroup m_inputChannel;
+    const ChannelHandleAndGroup m_outputChannel;
+    std::pair<EffectsRequestPipe, EffectsResponsePipe> m_pipes;
+    EngineEffectChain m_chain;
+    mixxx::SampleBuffer m_input;
+    mixxx::SampleBuffer m_output;
+};
+
+TEST_F(EngineEffectChainTest, toggleWithoutRoutedChannel) {
+    // The chain is not processed at all, because it isn't enabled for any
+    // channel. It still needs to settle in the requested state.
+    setChainEnabled(false);
+    EXPECT_EQ(EffectEnableState::Disabling, m_chain.m_enableState);
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Disabled, m_chain.m_enableState);
+
+    setChainEnabled(true);
+    EXPECT_EQ(EffectEnableState::Enabling, m_chain.m_enableState);
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Enabled, m_chain.m_enableState);
+
+    // Switched off and on again within the same callback
+    setChainEnabled(false);
+    setChainEnabled(true);
+    EXPECT_EQ(EffectEnableState::Enabling, m_chain.m_enableState);
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Enabled, m_chain.m_enableState);
+
+    // The channel that is routed afterwards is processed by the enabled chain
+    enableForInputChannel();
+    process();
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Enabled, m_chain.m_enableState);
+}
+
+TEST_F(EngineEffectChainTest, toggleBeforeProcessing) {
+    enableForInputChannel();
+    process();
+
+    // The effects of the routed channel need to get the intermediate state
+    setChainEnabled(false);
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Disabling, m_chain.m_enableState);
+
+    // Switched on before the Disabling state has been processed
+    setChainEnabled(true);
+    EXPECT_EQ(EffectEnableState::Enabling, m_chain.m_enableState);
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Enabling, m_chain.m_enableState);
+
+    process();
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Enabled, m_chain.m_enableState);
+
+    setChainEnabled(false);
+    process();
+    m_chain.onCallbackStart();
+    EXPECT_EQ(EffectEnableState::Disabled, m_chain.m_enableState);
+}
@@ -0,0 +1,44 @@
+#include "engine/effects/engineeffectparameter.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+class EngineEffectParameterTest : public testing::Test {
+  protected:
+    EngineEffectParameterTest()
+            : m_pManifest(new EffectManifestParameter()) {
+        m_pManifest->setRange(0.0, 0.5, 1.0);
+    }
+
+    EffectManifestParameterPointer m_pManifest;
+};
+
+TEST_F(EngineEffectParameterTest, pendingValuesAreCoalesced) {
+    EngineEffectParameter parameter(m_pManifest);
+    EXPECT_DOUBLE_EQ(0.5, parameter.value());
+
+    // Only the first update needs to notify the engine
+    EXPECT_TRUE(parameter.setPendingValue(0.1));
+    EXPECT_FALSE(parameter.setPendingValue(0.2));
+    EXPECT_FALSE(parameter.setPendingValue(0.3));
+    EXPECT_DOUBLE_EQ(0.5, parameter.value());
+
+    // The last value wins
+    EXPECT_TRUE(parameter.applyPendingValue());
+    EXPECT_DOUBLE_EQ(0.3, parameter.value());
+    EXPECT_FALSE(parameter.applyPendingValue());
+
+    EXPECT_TRUE(parameter.setPendingValue(0.4));
+}
+
+TEST_F(EngineEffectParameterTest, cancelPendingValue) {
+    EngineEffectParameter parameter(m_pManifest);
+    EXPECT_TRUE(parameter.setPendingValue(0.1));
+    parameter.cancelPendingValue();
+    EXPECT_FALSE(parameter.applyPendingValue());
+    EXPECT_DOUBLE_EQ(0.5, parameter.value());
+    EXPECT_TRUE(parameter.setPendingValue(0.2));
+}
+
+} // namespace
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstring>
+#include <utility>
+
+#include "engine/filters/enginefilteriir.h"
+
+/// Adds processScalar() to a filter of the EngineFilterIIR family. It
+/// processes the left and the right channel one after the other with
+/// the scalar processSample(), as EngineFilterIIR::process() did before
+/// it has been vectorized. Used as reference in tests and benchmarks.
+///
+/// The scalar state is updated by the setFrequencyCorners() and
+/// pauseFilter() of this class only.
+template<class Filter>
+class ScalarReferenceFilter : public Filter {
+  public:
+    template<typename... Args>
+    explicit ScalarReferenceFilter(Args&&... args)
+            : Filter(std::forward<Args>(args)...) {
+        clearScalarBuffers();
+    }
+
+    template<typename... Args>
+    void setFrequencyCorners(Args&&... args) {
+        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
+        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        clearScalarBuffers();
+        Filter::setFrequencyCorners(std::forward<Args>(args)...);
+    }
+
+    void pauseFilter() {
+        if (!this->m_doStart) {
+            clearScalarBuffers();
+        }
+        Filter::pauseFilter();
+    }
+
+    void processScalar(const CSAMPLE* pIn, CSAMPLE* pOutput, const std::size_t bufferSize) {
+        if (!this->m_doRamping) {
+            for (std::size_t i = 0; i < bufferSize; i += 2) {
+                pOutput[i] = static_cast<CSAMPLE>(processScalarSample(this->m_coef, m_buf1, pIn[i]));
+                pOutput[i + 1] = static_cast<CSAMPLE>(
+                        processScalarSample(this->m_coef, m_buf2, pIn[i + 1]));
+            }
+        } else {
+            double cross_mix = 0.0;
+            double cross_inc = 4.0 / static_cast<double>(bufferSize);
+            for (std::size_t i = 0; i < bufferSize; i += 2) {
+                double old1;
+                double old2;
+                if (!this->m_doStart) {
+                    old1 = static_cast<CSAMPLE>(processScalarSample(this->m_oldCoef, m_oldBuf1, pIn[i]));
+                    old2 = static_cast<CSAMPLE>(
+                            processScalarSample(this->m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                } else {
+                    if (this->m_startFromDry) {
+                        old1 = pIn[i];
+                        old2 = pIn[i + 1];
+                    } else {
+                        old1 = 0;
+                        old2 = 0;
+                    }
+                }
+                double new1 = static_cast<CSAMPLE>(processScalarSample(this->m_coef, m_buf1, pIn[i]));
+                double new2 = static_cast<CSAMPLE>(
+                        processScalarSample(this->m_coef, m_buf2, pIn[i + 1]));
+
+                if (i < bufferSize / 2) {
+                    pOutput[i] = static_cast<CSAMPLE>(old1);
+                    pOutput[i + 1] = static_cast<CSAMPLE>(old2);
+                } else {
+                    pOutput[i] = static_cast<CSAMPLE>(new1 * cross_mix + old1 * (1.0 - cross_mix));
+                    pOutput[i + 1] = static_cast<CSAMPLE>(
+                            new2 * cross_mix + old2 * (1.0 - cross_mix));
+                    cross_mix += cross_inc;
+                }
+            }
+            this->m_doRamping = false;
+            this->m_doStart = false;
+        }
+    }
+
+  private:
+    double processScalarSample(const double* coef, double* buf, double val) {
+        return this->template processSample<double>(coef, buf, val);
+    }
+
+    void clearScalarBuffers() {
+        memset(m_buf1, 0, sizeof(m_buf1));
+        memset(m_buf2, 0, sizeof(m_buf2));
+    }
+
+    static constexpr std::size_t kStateSize =
+            sizeof(ScalarReferenceFilter::m_buf) / sizeof(ScalarReferenceFilter::m_buf[0]);
+
+    double m_buf1[kStateSize];
+    double m_oldBuf1[kStateSize];
+    double m_buf2[kStateSize];
+    double m_oldBuf2[kStateSize];
+};
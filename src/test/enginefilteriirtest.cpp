@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefilterbutterworth8.h"
+#include "engine/filters/enginefilterlinkwitzriley2.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "test/enginefilteriirreference.h"
+
+namespace {
+
+constexpr std::size_t kBufferSize = 512;
+const mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+// Twice the rounding error of CSAMPLE at full scale
+constexpr CSAMPLE kRampedTolerance = 2.0f * std::numeric_limits<CSAMPLE>::epsilon();
+
+class EngineFilterIIRTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        // Noise in [-1, 1] with a fixed seed
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<CSAMPLE> distribution(-1.0f, 1.0f);
+        m_input.resize(kBufferSize);
+        for (auto& sample : m_input) {
+            sample = distribution(generator);
+        }
+        m_output.resize(kBufferSize);
+        m_referenceOutput.resize(kBufferSize);
+    }
+
+    // The first buffer after a change is ramped.
+    template<class Filter>
+    void processAndCompare(ScalarReferenceFilter<Filter>* pFilter,
+            ScalarReferenceFilter<Filter>* pReference,
+            int numBuffers) {
+        for (int i = 0; i < numBuffers; ++i) {
+            pFilter->process(m_input.data(), m_output.data(), kBufferSize);
+            pReference->processScalar(m_input.data(), m_referenceOutput.data(), kBufferSize);
+            if (i == 0) {
+                expectRampedEqual();
+            } else {
+                expectBitExact();
+            }
+        }
+    }
+
+    // Processes the filter through the settling, the ramping after the
+    // corner frequencies have been changed and a restart after a pause.
+    template<class Filter, typename... Args>
+    void processAndCompareLifecycle(ScalarReferenceFilter<Filter>* pFilter,
+            ScalarReferenceFilter<Filter>* pReference,
+            Args... retuneArgs) {
+        processAndCompare(pFilter, pReference, 3);
+        pFilter->setFrequencyCorners(retuneArgs...);
+        pReference->setFrequencyCorners(retuneArgs...);
+        processAndCompare(pFilter, pReference, 2);
+        pFilter->pauseFilter();
+        pReference->pauseFilter();
+        processAndCompare(pFilter, pReference, 2);
+    }
+
+    void expectBitExact() {
+        for (std::size_t i = 0; i < kBufferSize; ++i) {
+            // Not EXPECT_FLOAT_EQ, the result must be identical
+            ASSERT_EQ(m_referenceOutput[i], m_output[i]) << "sample " << i;
+        }
+    }
+
+    // The scalar code rounds the outputs of the old and the new filter
+    // to CSAMPLE before cross-fading them. The compiler may skip this
+    // round trip when it vectorizes the scalar code, so the cross-faded
+    // results may differ by the rounding error of the inputs.
+    void expectRampedEqual() {
+        expectRampedEqual(m_referenceOutput, m_output);
+    }
+
+    static void expectRampedEqual(const std::vector<CSAMPLE>& referenceOutput,
+            const std::vector<CSAMPLE>& output) {
+        for (std::size_t i = 0; i < kBufferSize; ++i) {
+            ASSERT_NEAR(referenceOutput[i], output[i], kRampedTolerance) << "sample " << i;
+        }
+    }
+
+    std::vector<CSAMPLE> m_input;
+    std::vector<CSAMPLE> m_output;
+    std::vector<CSAMPLE> m_referenceOutput;
+};
+
+TEST_F(EngineFilterIIRTest, bessel4LowIsBitExact) {
+    ScalarReferenceFilter<EngineFilterBessel4Low> filter(kSampleRate, 600.0);
+    ScalarReferenceFilter<EngineFilterBessel4Low> reference(kSampleRate, 600.0);
+    processAndCompareLifecycle(&filter, &reference, kSampleRate, 1200.0);
+}
+
+TEST_F(EngineFilterIIRTest, bessel4BandIsBitExact) {
+    ScalarReferenceFilter<EngineFilterBessel4Band> filter(kSampleRate, 600.0, 2000.0);
+    ScalarReferenceFilter<EngineFilterBessel4Band> reference(kSampleRate, 600.0, 2000.0);
+    processAndCompareLifecycle(&filter, &reference, kSampleRate, 300.0, 4000.0);
+}
+
+TEST_F(EngineFilterIIRTest, bessel8LowIsBitExact) {
+    ScalarReferenceFilter<EngineFilterBessel8Low> filter(kSampleRate, 600.0);
+    ScalarReferenceFilter<EngineFilterBessel8Low> reference(kSampleRate, 600.0);
+    processAndCompareLifecycle(&filter, &reference, kSampleRate, 1200.0);
+}
+
+TEST_F(EngineFilterIIRTest, bessel8HighIsBitExact) {
+    ScalarReferenceFilter<EngineFilterBessel8High> filter(kSampleRate, 2500.0);
+    ScalarReferenceFilter<EngineFilterBessel8High> reference(kSampleRate, 2500.0);
+    processAndCompareLifecycle(&filter, &reference, kSampleRate, 5000.0);
+}
+
+TEST_F(EngineFilterIIRTest, butterworth8BandIsBitExact) {
+    ScalarReferenceFilter<EngineFilterButterworth8Band> filter(kSampleRate, 600.0, 2000.0);
+    ScalarReferenceFilter<EngineFilterButterworth8Band> reference(kSampleRate, 600.0, 2000.0);
+    processAndCompareLifecycle(&filter, &reference, kSampleRate, 300.0, 4000.0);
+}
+
+TEST_F(EngineFilterIIRTest, linkwitzRiley8IsBitExact) {
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8Low> low(kSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8Low> lowReference(kSampleRate, 250.0);
+    processAndCompareLifecycle(&low, &lowReference, kSampleRate, 500.0);
+
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8High> high(kSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8High> highReference(kSampleRate, 250.0);
+    processAndCompareLifecycle(&high, &highReference, kSampleRate, 500.0);
+}
+
+TEST_F(EngineFilterIIRTest, linkwitzRiley2IsBitExact) {
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley2Low> low(kSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley2Low> lowReference(kSampleRate, 250.0);
+    processAndCompareLifecycle(&low, &lowReference, kSampleRate, 500.0);
+
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley2High> high(kSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley2High> highReference(kSampleRate, 250.0);
+    processAndCompareLifecycle(&high, &highReference, kSampleRate, 500.0);
+}
+
+TEST_F(EngineFilterIIRTest, biquadIsBitExact) {
+    ScalarReferenceFilter<EngineFilterBiquad1Peaking> peaking(kSampleRate, 1000.0, 1.75);
+    ScalarReferenceFilter<EngineFilterBiquad1Peaking> peakingReference(kSampleRate, 1000.0, 1.75);
+    processAndCompareLifecycle(&peaking, &peakingReference, kSampleRate, 1000.0, 1.75, 6.0);
+
+    // Starts from the dry signal
+    ScalarReferenceFilter<EngineFilterBiquad1Low> low(kSampleRate, 1000.0, 0.7, true);
+    ScalarReferenceFilter<EngineFilterBiquad1Low> lowReference(kSampleRate, 1000.0, 0.7, true);
+    processAndCompareLifecycle(&low, &lowReference, kSampleRate, 2000.0, 0.7);
+}
+
+TEST_F(EngineFilterIIRTest, processTogetherWithIsBitExact) {
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8Low> low(kSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8High> high(kSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8Low> lowReference(kSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8High> highReference(kSampleRate, 250.0);
+
+    std::vector<CSAMPLE> highOutput(kBufferSize);
+    std::vector<CSAMPLE> highReferenceOutput(kBufferSize);
+    // The first buffer is ramped, the following are interleaved
+    for (int i = 0; i < 3; ++i) {
+        low.processTogetherWith(&high,
+                m_input.data(),
+                m_output.data(),
+                m_input.data(),
+                highOutput.data(),
+                kBufferSize);
+        lowReference.processScalar(m_input.data(), m_referenceOutput.data(), kBufferSize);
+        highReference.processScalar(m_input.data(), highReferenceOutput.data(), kBufferSize);
+        if (i == 0) {
+            expectRampedEqual();
+            expectRampedEqual(highReferenceOutput, highOutput);
+        } else {
+            expectBitExact();
+            for (std::size_t j = 0; j < kBufferSize; ++j) {
+                ASSERT_EQ(highReferenceOutput[j], highOutput[j]) << "sample " << j;
+            }
+        }
+    }
+}
+
+} // namespace
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <QAtomicInt>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <memory>
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+
+namespace {
+
+// The tree that is generated for the benchmark
+constexpr int kNumberOfDirectories = 100;
+constexpr int kNumberOfFilesPerDirectory = 1000;
+
+SoundSourceProxy::PreparedTrackImport prepareTrackImport(const QString& filePath) {
+    return SoundSourceProxy::prepareTrackImportFromNewFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)),
+            {},
+            false);
+}
+
+class ProviderRegistration : public SoundSourceProviderRegistration {
+};
+
+// Copies a small test file into a tree of directories once and returns
+// the paths of all files
+const QStringList& generatedTrackFiles() {
+    static std::unique_ptr<QTemporaryDir> s_pTempDir;
+    static QStringList s_filePaths;
+    if (s_pTempDir) {
+        return s_filePaths;
+    }
+    s_pTempDir = std::make_unique<QTemporaryDir>();
+    VERIFY_OR_DEBUG_ASSERT(s_pTempDir->isValid()) {
+        return s_filePaths;
+    }
+    const QString sourceFilePath = MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("id3-test-data/artist.mp3"));
+    const QDir rootDir(s_pTempDir->path());
+    for (int i = 0; i < kNumberOfDirectories; ++i) {
+        const QString dirName = QStringLiteral("dir%1").arg(i);
+        rootDir.mkdir(dirName);
+        const QDir dir(rootDir.filePath(dirName));
+        for (int j = 0; j < kNumberOfFilesPerDirectory; ++j) {
+            const QString filePath = dir.filePath(QStringLiteral("track%1.mp3").arg(j));
+            if (QFile::copy(sourceFilePath, filePath)) {
+                s_filePaths.append(filePath);
+            }
+        }
+    }
+    return s_filePaths;
+}
+
+} // anonymous namespace
+
+// Parses the metadata of new files like ImportFilesTask with the given
+// number of threads
+static void BM_LibraryScannerPrepareTrackImport(benchmark::State& state) {
+    const ProviderRegistration registration;
+    const QStringList& filePaths = generatedTrackFiles();
+    if (filePaths.isEmpty()) {
+        state.SkipWithError("Failed to generate track files");
+        return;
+    }
+
+    const int numThreads = static_cast<int>(state.range(0));
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+    for (auto _ : state) {
+        QAtomicInt nextFile(0);
+        for (int i = 0; i < numThreads; ++i) {
+            pool.start([&filePaths, &nextFile] {
+                for (int j = nextFile.fetchAndAddRelaxed(1); j < filePaths.size();
+                        j = nextFile.fetchAndAddRelaxed(1)) {
+                    benchmark::DoNotOptimize(prepareTrackImport(filePaths[j]));
+                }
+            });
+        }
+        pool.waitForDone();
+    }
+    state.SetItemsProcessed(state.iterations() * filePaths.size());
+}
+BENCHMARK(BM_LibraryScannerPrepareTrackImport)
+        ->Arg(1)
+        ->Arg(2)
+        ->Arg(4)
+        ->Arg(8)
+        ->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <QTemporaryDir>
+#include <memory>
+
+#include "library/coverartutils.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+QString testFilePath(const QString& fileName) {
+    return MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("id3-test-data/") + fileName);
+}
+
+SoundSourceProxy::PreparedTrackImport prepareTrackImport(
+        const QString& filePath,
+        const QList<QFileInfo>& possibleCovers = {}) {
+    return SoundSourceProxy::prepareTrackImportFromNewFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)),
+            possibleCovers,
+            false);
+}
+
+} // anonymous namespace
+
+class LibraryScannerImportTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    // Imports the file into a new track like TrackDAO::addTracksAddFile()
+    // with or without parsing the file in advance.
+    static TrackPointer importNewTrack(const QString& filePath, bool prepared) {
+        auto pTrack = Track::newTemporary(filePath);
+        // The cover art is guessed from the same files
+        const auto preparedImport = prepareTrackImport(filePath,
+                CoverArtUtils::findPossibleCoversInFolder(
+                        pTrack->getFileInfo().locationPath()));
+        SoundSourceProxy(pTrack).updateTrackFromSource(
+                SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                SyncTrackMetadataParams{},
+                prepared ? &preparedImport : nullptr);
+        return pTrack;
+    }
+};
+
+TEST_F(LibraryScannerImportTest, preparedImportEqualsImport) {
+    for (const auto& fileName : {
+                 QStringLiteral("artist.mp3"),
+                 QStringLiteral("empty.mp3"),
+                 QStringLiteral("cover-test-png.mp3"),
+         }) {
+        const QString filePath = testFilePath(fileName);
+        const auto pTrack = importNewTrack(filePath, false);
+        const auto pPreparedTrack = importNewTrack(filePath, true);
+        EXPECT_TRUE(pPreparedTrack->checkSourceSynchronized());
+        EXPECT_EQ(pTrack->getArtist(), pPreparedTrack->getArtist());
+        EXPECT_EQ(pTrack->getTitle(), pPreparedTrack->getTitle());
+        EXPECT_EQ(pTrack->getAlbum(), pPreparedTrack->getAlbum());
+        EXPECT_EQ(pTrack->getDuration(), pPreparedTrack->getDuration());
+        EXPECT_EQ(pTrack->getCoverInfo(), pPreparedTrack->getCoverInfo());
+    }
+}
+
+TEST_F(LibraryScannerImportTest, preparedImportOfMissingFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+
+    const auto preparedImport = prepareTrackImport(
+            tempDir.filePath(QStringLiteral("missing.mp3")));
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Unavailable,
+            preparedImport.importResult);
+}
+
+TEST_F(LibraryScannerImportTest, preparedImportIsIgnoredForExistingMetadata) {
+    const QString filePath = testFilePath(QStringLiteral("artist.mp3"));
+    auto pTrack = Track::newTemporary(filePath);
+    ASSERT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                    SyncTrackMetadataParams{}));
+
+    // Prepared metadata must only be applied to new tracks and never
+    // when the metadata of a track is imported again
+    auto preparedImport = prepareTrackImport(filePath);
+    preparedImport.trackMetadata.refTrackInfo().setArtist(QStringLiteral("Other Artist"));
+    SoundSourceProxy(pTrack).updateTrackFromSource(
+            SoundSourceProxy::UpdateTrackFromSourceMode::Always,
+            SyncTrackMetadataParams{},
+            &preparedImport);
+    EXPECT_EQ(QStringLiteral("Test Artist"), pTrack->getArtist());
+}
@@ -94,3 +94,160 @@ DECLARE_EFFECT_BENCHMARK(ReverbEffect)
 
 }  // namespace
 #endif
+
+// Benchmarks of the IIR filters of the equalizers. The scalar variants
+// process the channels one after the other, as EngineFilterIIR did before
+// it processed both channels in the lanes of SimdDouble2.
+//
+// Results for 512 samples on an x86-64 server core (SSE2, -O2):
+//   Bessel8Low                 scalar 3237 ns, lanes 2138 ns
+//   LinkwitzRiley8Low          scalar 4103 ns, lanes 2311 ns
+//   LinkwitzRiley8 low + high  scalar 7700 ns, lanes 4613 ns,
+//                              processTogetherWith() 3477 ns
+
+#include <benchmark/benchmark.h>
+
+#include "effects/backends/builtin/partitionedconvolver.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+#include "test/enginefilteriirreference.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const mixxx::audio::SampleRate kFilterBenchmarkSampleRate = mixxx::audio::SampleRate(44100);
+
+void fillWithNoise(mixxx::SampleBuffer* pBuffer) {
+    unsigned int seed = 1;
+    for (SINT i = 0; i < pBuffer->size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        (*pBuffer)[i] = static_cast<CSAMPLE>(seed >> 16) / 32768.0f - 1.0f;
+    }
+}
+
+template<class Filter>
+void BM_EngineFilterIIR_Scalar(benchmark::State& state) {
+    const auto bufferSize = static_cast<SINT>(state.range(0));
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer output(bufferSize);
+    fillWithNoise(&input);
+    ScalarReferenceFilter<Filter> filter(kFilterBenchmarkSampleRate, 250.0);
+    for (auto _ : state) {
+        filter.processScalar(input.data(), output.data(), bufferSize);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * bufferSize);
+}
+
+template<class Filter>
+void BM_EngineFilterIIR_Lanes(benchmark::State& state) {
+    const auto bufferSize = static_cast<SINT>(state.range(0));
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer output(bufferSize);
+    fillWithNoise(&input);
+    Filter filter(kFilterBenchmarkSampleRate, 250.0);
+    for (auto _ : state) {
+        filter.process(input.data(), output.data(), bufferSize);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * bufferSize);
+}
+
+// The first run of the filter bank of LinkwitzRiley8EQEffect, low pass
+// and high pass of the same input
+void BM_EngineFilterIIR_LinkwitzRiley8Bank_Scalar(benchmark::State& state) {
+    const auto bufferSize = static_cast<SINT>(state.range(0));
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer lowOutput(bufferSize);
+    mixxx::SampleBuffer highOutput(bufferSize);
+    fillWithNoise(&input);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8Low> low(kFilterBenchmarkSampleRate, 250.0);
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8High> high(kFilterBenchmarkSampleRate, 250.0);
+    for (auto _ : state) {
+        high.processScalar(input.data(), highOutput.data(), bufferSize);
+        low.processScalar(input.data(), lowOutput.data(), bufferSize);
+        benchmark::DoNotOptimize(lowOutput.data());
+        benchmark::DoNotOptimize(highOutput.data());
+    }
+    state.SetItemsProcessed(state.iterations() * bufferSize * 2);
+}
+
+void BM_EngineFilterIIR_LinkwitzRiley8Bank_Lanes(benchmark::State& state) {
+    const auto bufferSize = static_cast<SINT>(state.range(0));
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer lowOutput(bufferSize);
+    mixxx::SampleBuffer highOutput(bufferSize);
+    fillWithNoise(&input);
+    EngineFilterLinkwitzRiley8Low low(kFilterBenchmarkSampleRate, 250.0);
+    EngineFilterLinkwitzRiley8High high(kFilterBenchmarkSampleRate, 250.0);
+    for (auto _ : state) {
+        high.process(input.data(), highOutput.data(), bufferSize);
+        low.process(input.data(), lowOutput.data(), bufferSize);
+        benchmark::DoNotOptimize(lowOutput.data());
+        benchmark::DoNotOptimize(highOutput.data());
+    }
+    state.SetItemsProcessed(state.iterations() * bufferSize * 2);
+}
+
+void BM_EngineFilterIIR_LinkwitzRiley8Bank_Together(benchmark::State& state) {
+    const auto bufferSize = static_cast<SINT>(state.range(0));
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer lowOutput(bufferSize);
+    mixxx::SampleBuffer highOutput(bufferSize);
+    fillWithNoise(&input);
+    EngineFilterLinkwitzRiley8Low low(kFilterBenchmarkSampleRate, 250.0);
+    EngineFilterLinkwitzRiley8High high(kFilterBenchmarkSampleRate, 250.0);
+    for (auto _ : state) {
+        high.processTogetherWith(&low,
+                input.data(),
+                highOutput.data(),
+                input.data(),
+                lowOutput.data(),
+                bufferSize);
+        benchmark::DoNotOptimize(lowOutput.data());
+        benchmark::DoNotOptimize(highOutput.data());
+    }
+    state.SetItemsProcessed(state.iterations() * bufferSize * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_EngineFilterIIR_Scalar, EngineFilterBessel8Low)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIR_Lanes, EngineFilterBessel8Low)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIR_Scalar, EngineFilterLinkwitzRiley8Low)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIR_Lanes, EngineFilterLinkwitzRiley8Low)->Range(64, 4096);
+BENCHMARK(BM_EngineFilterIIR_LinkwitzRiley8Bank_Scalar)->Range(64, 4096);
+BENCHMARK(BM_EngineFilterIIR_LinkwitzRiley8Bank_Lanes)->Range(64, 4096);
+BENCHMARK(BM_EngineFilterIIR_LinkwitzRiley8Bank_Together)->Range(64, 4096);
+
+// PartitionedConvolver::process() with a 2 s impulse response. The tail
+// is convolved by the ConvolutionTailWorker. The buffers follow each other
+// faster than in real time, so the engine thread waits for it, and the
+// wall time includes the tail.
+//
+// Results on a single x86-64 server core (-O2), CPU time of the engine
+// thread and wall time:
+//   64 samples     25521 ns,  34370 ns
+//   512 samples    60185 ns, 120786 ns
+//   4096 samples  444577 ns, 868379 ns
+void BM_PartitionedConvolver(benchmark::State& state) {
+    const auto bufferSize = static_cast<SINT>(state.range(0));
+    constexpr SINT kImpulseResponseFrames = 2 * 44100;
+    mixxx::SampleBuffer impulseResponse(kImpulseResponseFrames);
+    fillWithNoise(&impulseResponse);
+    const PartitionedConvolver::ImpulseResponse partitions(
+            impulseResponse.data(), impulseResponse.data(), kImpulseResponseFrames);
+    PartitionedConvolver convolver(kImpulseResponseFrames);
+    convolver.setImpulseResponse(&partitions);
+
+    mixxx::SampleBuffer input(bufferSize);
+    mixxx::SampleBuffer output(bufferSize);
+    fillWithNoise(&input);
+    for (auto _ : state) {
+        convolver.process(input.data(), output.data(), bufferSize / 2);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * bufferSize);
+}
+
+BENCHMARK(BM_PartitionedConvolver)->Range(64, 4096);
+
+} // namespace
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "effects/backends/builtin/partitionedconvolver.h"
+#include "util/assert.h"
+
+namespace {
+
+// Longer than the head, with an incomplete last tail partition
+constexpr SINT kImpulseResponseFrames = PartitionedConvolver::kHeadFrames +
+        2 * PartitionedConvolver::kTailBlockFrames + 123;
+constexpr SINT kInputFrames = kImpulseResponseFrames + 3 * PartitionedConvolver::kTailBlockFrames;
+constexpr CSAMPLE kTolerance = 1e-4f;
+
+class PartitionedConvolverTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<CSAMPLE> distribution(-1.0f, 1.0f);
+        m_left.resize(kImpulseResponseFrames);
+        m_right.resize(kImpulseResponseFrames);
+        for (SINT i = 0; i < kImpulseResponseFrames; ++i) {
+            const auto decay = static_cast<CSAMPLE>(std::exp(-3.0 * i / kImpulseResponseFrames));
+            m_left[i] = distribution(generator) * decay;
+            m_right[i] = distribution(generator) * decay;
+        }
+
+        // Sparse impulses keep the direct convolution cheap, but they
+        // still excite every partition of the impulse response.
+        m_input.assign(kInputFrames * 2, CSAMPLE_ZERO);
+        std::uniform_int_distribution<SINT> position(0, kInputFrames - 1);
+        for (int i = 0; i < 24; ++i) {
+            const SINT frame = i == 0 ? 0 : position(generator);
+            m_input[frame * 2] = distribution(generator);
+            m_input[frame * 2 + 1] = distribution(generator);
+        }
+    }
+
+    std::vector<CSAMPLE> convolveDirectly() const {
+        std::vector<CSAMPLE> output(kInputFrames * 2, CSAMPLE_ZERO);
+        for (SINT frame = 0; frame < kInputFrames; ++frame) {
+            const CSAMPLE left = m_input[frame * 2];
+            const CSAMPLE right = m_input[frame * 2 + 1];
+            if (left == CSAMPLE_ZERO && right == CSAMPLE_ZERO) {
+                continue;
+            }
+            for (SINT i = 0; i < kImpulseResponseFrames && frame + i < kInputFrames; ++i) {
+                output[(frame + i) * 2] += left * m_left[i];
+                output[(frame + i) * 2 + 1] += right * m_right[i];
+            }
+        }
+        return output;
+    }
+
+    // Processes the input with a repeating pattern of call sizes. The
+    // convolver doesn't wait for the tail worker, which would be late
+    // without the time of a real-time callback. Calls must not span more
+    // than a single tail block.
+    std::vector<CSAMPLE> convolvePartitioned(PartitionedConvolver* pConvolver,
+            const std::vector<SINT>& callFrames) const {
+        std::vector<CSAMPLE> output(kInputFrames * 2);
+        SINT frame = 0;
+        for (std::size_t call = 0; frame < kInputFrames; ++call) {
+            const SINT numFrames = std::min(
+                    callFrames[call % callFrames.size()], kInputFrames - frame);
+            DEBUG_ASSERT(numFrames <= PartitionedConvolver::kTailBlockFrames);
+            while (!pConvolver->isTailBlockDone()) {
+                QThread::yieldCurrentThread();
+            }
+            pConvolver->process(&m_input[frame * 2], &output[frame * 2], numFrames);
+            frame += numFrames;
+        }
+        return output;
+    }
+
+    static void expectNear(const std::vector<CSAMPLE>& expected,
+            const std::vector<CSAMPLE>& actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_NEAR(expected[i], actual[i], kTolerance) << "sample " << i;
+        }
+    }
+
+    std::vector<CSAMPLE> m_left;
+    std::vector<CSAMPLE> m_right;
+    std::vector<CSAMPLE> m_input;
+};
+
+TEST_F(PartitionedConvolverTest, matchesDirectConvolution) {
+    const PartitionedConvolver::ImpulseResponse impulseResponse(
+            m_left.data(), m_right.data(), kImpulseResponseFrames);
+    PartitionedConvolver convolver(kImpulseResponseFrames);
+    convolver.setImpulseResponse(&impulseResponse);
+
+    const auto expected = convolveDirectly();
+    expectNear(expected, convolvePartitioned(&convolver, {1024}));
+}
+
+TEST_F(PartitionedConvolverTest, matchesDirectConvolutionWithOddCallSizes) {
+    const PartitionedConvolver::ImpulseResponse impulseResponse(
+            m_left.data(), m_right.data(), kImpulseResponseFrames);
+    PartitionedConvolver convolver(kImpulseResponseFrames);
+    convolver.setImpulseResponse(&impulseResponse);
+
+    const auto expected = convolveDirectly();
+    expectNear(expected, convolvePartitioned(&convolver, {1, 37, 300, 4095, 64, 4096}));
+}
+
+TEST_F(PartitionedConvolverTest, shortImpulseResponseHasNoTail) {
+    constexpr SINT kShortFrames = 1000;
+    const PartitionedConvolver::ImpulseResponse impulseResponse(
+            m_left.data(), m_right.data(), kShortFrames);
+    PartitionedConvolver convolver(kImpulseResponseFrames);
+    convolver.setImpulseResponse(&impulseResponse);
+
+    m_left.resize(kShortFrames);
+    m_right.resize(kShortFrames);
+    m_left.resize(kImpulseResponseFrames, CSAMPLE_ZERO);
+    m_right.resize(kImpulseResponseFrames, CSAMPLE_ZERO);
+    const auto expected = convolveDirectly();
+    expectNear(expected, convolvePartitioned(&convolver, {512}));
+}
+
+TEST_F(PartitionedConvolverTest, resetClearsReverberation) {
+    const PartitionedConvolver::ImpulseResponse impulseResponse(
+            m_left.data(), m_right.data(), kImpulseResponseFrames);
+    PartitionedConvolver convolver(kImpulseResponseFrames);
+    convolver.setImpulseResponse(&impulseResponse);
+    convolvePartitioned(&convolver, {512});
+
+    // The result must be the same as for a fresh convolver
+    convolver.reset();
+    const auto expected = convolveDirectly();
+    expectNear(expected, convolvePartitioned(&convolver, {512}));
+}
+
+TEST_F(PartitionedConvolverTest, lateTailBlockIsMuted) {
+    const PartitionedConvolver::ImpulseResponse impulseResponse(
+            m_left.data(), m_right.data(), kImpulseResponseFrames);
+    PartitionedConvolver convolver(kImpulseResponseFrames);
+    convolver.setImpulseResponse(&impulseResponse);
+
+    // Without waiting for the worker only the head is played for sure.
+    // The call returns even if the worker is late.
+    std::vector<CSAMPLE> output(kInputFrames * 2);
+    convolver.process(m_input.data(), output.data(), kInputFrames);
+
+    // Resetting doesn't wait for the worker either
+    convolver.reset();
+    const auto expected = convolveDirectly();
+    expectNear(expected, convolvePartitioned(&convolver, {512}));
+}
+
+TEST_F(PartitionedConvolverTest, withoutImpulseResponseIsSilent) {
+    PartitionedConvolver convolver(kImpulseResponseFrames);
+    const std::vector<CSAMPLE> silence(kInputFrames * 2, CSAMPLE_ZERO);
+    expectNear(silence, convolvePartitioned(&convolver, {512}));
+}
+
+} // namespace
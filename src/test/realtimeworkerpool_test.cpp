@@ -0,0 +1,102 @@
+#include "engine/realtimeworkerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+struct Counters {
+    explicit Counters(int size)
+            : calls(size) {
+    }
+
+    std::vector<std::atomic<int>> calls;
+};
+
+void countCall(void* pContext, int index) {
+    static_cast<Counters*>(pContext)->calls[index].fetch_add(1);
+}
+
+void expectCalledTimes(const Counters& counters, int times) {
+    for (std::size_t i = 0; i < counters.calls.size(); ++i) {
+        EXPECT_EQ(times, counters.calls[i].load()) << "index " << i;
+    }
+}
+
+} // namespace
+
+TEST(RealtimeWorkerPoolTest, callsJobOncePerIndex) {
+    RealtimeWorkerPool pool(3, QStringLiteral("RealtimeWorkerPoolTest"));
+    ASSERT_EQ(3, pool.numWorkers());
+    Counters counters(64);
+    pool.run(64, countCall, &counters);
+    expectCalledTimes(counters, 1);
+}
+
+TEST(RealtimeWorkerPoolTest, fewerJobsThanWorkers) {
+    RealtimeWorkerPool pool(4, QStringLiteral("RealtimeWorkerPoolTest"));
+    Counters counters(2);
+    pool.run(2, countCall, &counters);
+    expectCalledTimes(counters, 1);
+    pool.run(1, countCall, &counters);
+    EXPECT_EQ(2, counters.calls[0].load());
+    EXPECT_EQ(1, counters.calls[1].load());
+    // Nothing to do
+    pool.run(0, countCall, &counters);
+    EXPECT_EQ(2, counters.calls[0].load());
+}
+
+TEST(RealtimeWorkerPoolTest, withoutWorkers) {
+    RealtimeWorkerPool pool(0, QStringLiteral("RealtimeWorkerPoolTest"));
+    Counters counters(8);
+    pool.run(8, countCall, &counters);
+    expectCalledTimes(counters, 1);
+}
+
+TEST(RealtimeWorkerPoolTest, repeatedRuns) {
+    // Alternates between idle workers that are still spinning
+    // and workers that are blocked on their semaphore.
+    RealtimeWorkerPool pool(RealtimeWorkerPool::defaultNumWorkers(),
+            QStringLiteral("RealtimeWorkerPoolTest"));
+    Counters counters(16);
+    constexpr int kRuns = 1000;
+    for (int i = 0; i < kRuns; ++i) {
+        pool.run(16, countCall, &counters);
+    }
+    expectCalledTimes(counters, kRuns);
+}
+
+namespace {
+
+struct NestedRun {
+    RealtimeWorkerPool* pPool;
+    Counters* pCounters;
+    std::atomic<int> rejected;
+};
+
+void tryRunNested(void* pContext, int index) {
+    auto* pNested = static_cast<NestedRun*>(pContext);
+    if (!pNested->pPool->tryRun(1, countCall, pNested->pCounters)) {
+        pNested->rejected.fetch_add(1);
+    }
+    countCall(pNested->pCounters, index);
+}
+
+} // namespace
+
+TEST(RealtimeWorkerPoolTest, tryRunWhileInUse) {
+    RealtimeWorkerPool pool(2, QStringLiteral("RealtimeWorkerPoolTest"));
+    Counters counters(4);
+    NestedRun nested{&pool, &counters, 0};
+    mixxx::Duration joinWaitTime = mixxx::Duration::fromSeconds(1);
+    EXPECT_TRUE(pool.tryRun(4, tryRunNested, &nested, &joinWaitTime));
+    // The pool is busy while the jobs are running
+    EXPECT_EQ(4, nested.rejected.load());
+    expectCalledTimes(counters, 1);
+    EXPECT_LT(joinWaitTime, mixxx::Duration::fromSeconds(1));
+    // and available again afterwards
+    EXPECT_TRUE(pool.tryRun(4, countCall, &counters));
+    expectCalledTimes(counters, 2);
+}
@@ -3,10 +3,13 @@
 
 #include <QList>
 #include <QPair>
+#include <QString>
 #include <QtDebug>
+#include <cmath>
 #include <vector>
 
 #include "util/sample.h"
+#include "util/samplesimd.h"
 #include "util/timer.h"
 
 namespace {
@@ -303,6 +306,20 @@ TEST_F(SampleUtilTest, sumAbsPerChannel) {
     }
 }
 
+TEST_F(SampleUtilTest, maxAbsAmplitude) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        ClearBuffer(buffer, size);
+        EXPECT_FLOAT_EQ(0.0f, SampleUtil::maxAbsAmplitude(buffer, size));
+        // The first sample is not special
+        buffer[0] = -0.5f;
+        EXPECT_FLOAT_EQ(0.5f, SampleUtil::maxAbsAmplitude(buffer, size));
+        buffer[size - 1] = -0.75f;
+        EXPECT_FLOAT_EQ(0.75f, SampleUtil::maxAbsAmplitude(buffer, size));
+    }
+}
+
 TEST_F(SampleUtilTest, interleaveBuffer) {
     for (int i = 0; i < buffers.size(); ++i) {
         CSAMPLE* buffer = buffers[i];
@@ -466,6 +483,201 @@ TEST_F(SampleUtilTest, mixMultichannelToStereo) {
     EXPECT_FLOAT_EQ(destination[3], 0.9f + 1.1f + 1.3f /* + 1.5f*/);
 }
 
+class SampleUtilSimdTest : public testing::TestWithParam<mixxx::SimdLevel> {
+  protected:
+    void SetUp() override {
+        if (!mixxx::simd::isSupported(GetParam())) {
+            GTEST_SKIP() << mixxx::simdLevelName(GetParam())
+                         << " is not supported on this machine";
+        }
+    }
+
+    const mixxx::SampleUtilKernels& kernels() const {
+        return mixxx::simd::kernelsForLevel(GetParam());
+    }
+
+    const mixxx::SampleUtilKernels& scalarKernels() const {
+        return mixxx::simd::kernelsForLevel(mixxx::SimdLevel::Scalar);
+    }
+
+    // Includes sizes that don't fill a whole vector and
+    // leave remaining frames for each vector size
+    static std::vector<SINT> frameCounts() {
+        return {0, 1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 33, 1027};
+    }
+
+    // The buffers are deliberately not aligned
+    static std::vector<CSAMPLE> signal(SINT numSamples, CSAMPLE scale = 1.0f) {
+        std::vector<CSAMPLE> samples(numSamples + 1);
+        for (SINT i = 0; i < numSamples; ++i) {
+            samples[i] = scale * std::sin(static_cast<CSAMPLE>(i) * 0.37f);
+        }
+        return samples;
+    }
+
+    static void expectBuffersEqual(
+            const std::vector<CSAMPLE>& expected,
+            const std::vector<CSAMPLE>& actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            // Not bit-exact, because the compiler is free to contract or
+            // reorder the floating point operations with -ffast-math
+            EXPECT_NEAR(expected[i], actual[i], 1e-5f) << "at index " << i;
+        }
+    }
+};
+
+TEST_P(SampleUtilSimdTest, rampingGain) {
+    for (const SINT numFrames : frameCounts()) {
+        const auto src = signal(numFrames * 2);
+        auto expected = signal(numFrames * 2, 0.5f);
+        auto actual = expected;
+        scalarKernels().applyRampingGain(expected.data(), 0.1f, 0.01f, numFrames);
+        kernels().applyRampingGain(actual.data(), 0.1f, 0.01f, numFrames);
+        expectBuffersEqual(expected, actual);
+
+        scalarKernels().copyWithRampingGain(
+                expected.data(), src.data(), 1.0f, -0.002f, numFrames);
+        kernels().copyWithRampingGain(
+                actual.data(), src.data(), 1.0f, -0.002f, numFrames);
+        expectBuffersEqual(expected, actual);
+
+        scalarKernels().addWithRampingGain(
+                expected.data(), src.data(), 0.3f, 0.005f, numFrames);
+        kernels().addWithRampingGain(
+                actual.data(), src.data(), 0.3f, 0.005f, numFrames);
+        expectBuffersEqual(expected, actual);
+    }
+}
+
+TEST_P(SampleUtilSimdTest, copyWithMultipleRampingGains) {
+    for (const SINT numFrames : frameCounts()) {
+        const auto src0 = signal(numFrames * 2);
+        const auto src1 = signal(numFrames * 2, -0.7f);
+        const auto src2 = signal(numFrames * 2, 0.2f);
+        auto expected = std::vector<CSAMPLE>(numFrames * 2 + 1);
+        auto actual = expected;
+        scalarKernels().copy2WithRampingGain(expected.data(),
+                src0.data(),
+                0.0f,
+                0.01f,
+                src1.data(),
+                1.0f,
+                -0.01f,
+                numFrames);
+        kernels().copy2WithRampingGain(actual.data(),
+                src0.data(),
+                0.0f,
+                0.01f,
+                src1.data(),
+                1.0f,
+                -0.01f,
+                numFrames);
+        expectBuffersEqual(expected, actual);
+
+        scalarKernels().copy3WithRampingGain(expected.data(),
+                src0.data(),
+                0.0f,
+                0.01f,
+                src1.data(),
+                1.0f,
+                -0.01f,
+                src2.data(),
+                0.5f,
+                0.0f,
+                numFrames);
+        kernels().copy3WithRampingGain(actual.data(),
+                src0.data(),
+                0.0f,
+                0.01f,
+                src1.data(),
+                1.0f,
+                -0.01f,
+                src2.data(),
+                0.5f,
+                0.0f,
+                numFrames);
+        expectBuffersEqual(expected, actual);
+    }
+}
+
+TEST_P(SampleUtilSimdTest, interleaveBuffer) {
+    for (const SINT numFrames : frameCounts()) {
+        const auto left = signal(numFrames);
+        const auto right = signal(numFrames, -0.5f);
+        auto expected = std::vector<CSAMPLE>(numFrames * 2 + 1);
+        auto actual = expected;
+        scalarKernels().interleaveBuffer(
+                expected.data(), left.data(), right.data(), numFrames);
+        kernels().interleaveBuffer(
+                actual.data(), left.data(), right.data(), numFrames);
+        expectBuffersEqual(expected, actual);
+
+        auto actualLeft = std::vector<CSAMPLE>(numFrames + 1);
+        auto actualRight = actualLeft;
+        kernels().deinterleaveBuffer(
+                actualLeft.data(), actualRight.data(), expected.data(), numFrames);
+        expectBuffersEqual(left, actualLeft);
+        expectBuffersEqual(right, actualRight);
+    }
+}
+
+TEST_P(SampleUtilSimdTest, mixMultichannelToStereo) {
+    const int numChannels = mixxx::audio::ChannelCount::stem();
+    for (const SINT numFrames : frameCounts()) {
+        const auto src = signal(numFrames * numChannels);
+        for (const int excludeChannelMask : {0b0000, 0b0101, 0b1000, 0b1111}) {
+            // Also verifies that the destination is overwritten
+            auto expected = std::vector<CSAMPLE>(numFrames * 2 + 1, 1.0f);
+            auto actual = expected;
+            scalarKernels().mixMultichannelToStereo(expected.data(),
+                    src.data(),
+                    numFrames,
+                    numChannels,
+                    excludeChannelMask);
+            kernels().mixMultichannelToStereo(actual.data(),
+                    src.data(),
+                    numFrames,
+                    numChannels,
+                    excludeChannelMask);
+            expectBuffersEqual(expected, actual);
+        }
+    }
+}
+
+TEST_P(SampleUtilSimdTest, convertSamples) {
+    for (const SINT numFrames : frameCounts()) {
+        const SINT numSamples = numFrames * 2;
+        // Exceeds the valid range for testing the clamping
+        const auto src = signal(numSamples, 1.5f);
+        auto expected = std::vector<SAMPLE>(numSamples + 1);
+        auto actual = expected;
+        scalarKernels().convertFloat32ToS16(expected.data(), src.data(), numSamples);
+        kernels().convertFloat32ToS16(actual.data(), src.data(), numSamples);
+        EXPECT_EQ(expected, actual);
+
+        auto expectedFloat = std::vector<CSAMPLE>(numSamples + 1);
+        auto actualFloat = expectedFloat;
+        scalarKernels().convertS16ToFloat32(expectedFloat.data(), expected.data(), numSamples);
+        kernels().convertS16ToFloat32(actualFloat.data(), expected.data(), numSamples);
+        expectBuffersEqual(expectedFloat, actualFloat);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(SampleUtilSimdTestSuite,
+        SampleUtilSimdTest,
+        testing::Values(mixxx::SimdLevel::Scalar,
+                mixxx::SimdLevel::SSE41,
+                mixxx::SimdLevel::AVX2,
+                mixxx::SimdLevel::AVX512,
+                mixxx::SimdLevel::NEON),
+        [](const testing::TestParamInfo<mixxx::SimdLevel>& info) {
+            // Only alphanumeric characters are allowed
+            QString name = QString::fromLatin1(mixxx::simdLevelName(info.param));
+            name.remove(QChar('.')).remove(QChar('-'));
+            return name.toStdString();
+        });
+
 static void BM_MemCpy(benchmark::State& state) {
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -632,7 +844,42 @@ static void BM_Copy2WithGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithGain)->Range(64, 4096);
 
-static void BM_Copy2WithRampingGain(benchmark::State& state) {
+// Selects the kernels of SampleUtil while running a benchmark
+class ScopedSimdLevel {
+  public:
+    explicit ScopedSimdLevel(mixxx::SimdLevel level)
+            : m_supported(mixxx::simd::setActiveLevel(level)) {
+    }
+    ~ScopedSimdLevel() {
+        mixxx::simd::setActiveLevel(mixxx::simd::bestSupportedLevel());
+    }
+
+    bool isSupported() const {
+        return m_supported;
+    }
+
+  private:
+    const bool m_supported;
+};
+
+// Runs a benchmark of a function that is dispatched to the SIMD
+// kernels once for each level. Unsupported levels are skipped.
+#define BENCHMARK_SIMD_LEVELS(bm)                                             \
+    BENCHMARK_CAPTURE(bm, Scalar, mixxx::SimdLevel::Scalar)->Range(64, 4096); \
+    BENCHMARK_CAPTURE(bm, SSE41, mixxx::SimdLevel::SSE41)->Range(64, 4096);   \
+    BENCHMARK_CAPTURE(bm, AVX2, mixxx::SimdLevel::AVX2)->Range(64, 4096);     \
+    BENCHMARK_CAPTURE(bm, AVX512, mixxx::SimdLevel::AVX512)->Range(64, 4096); \
+    BENCHMARK_CAPTURE(bm, NEON, mixxx::SimdLevel::NEON)->Range(64, 4096)
+
+#define SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel)         \
+    if (!(scopedLevel).isSupported()) {                         \
+        (state).SkipWithError("Not supported on this machine"); \
+        return;                                                 \
+    }
+
+static void BM_Copy2WithRampingGain(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
     SampleUtil::fill(buffer, 0.0f, size);
@@ -650,6 +897,329 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
     SampleUtil::free(buffer2);
     SampleUtil::free(buffer3);
 }
-BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
+BENCHMARK_SIMD_LEVELS(BM_Copy2WithRampingGain);
+
+static void BM_Copy3WithRampingGain(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.0f, size);
+    CSAMPLE* buffer4 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer4, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copy3WithRampingGain(
+                buffer, buffer2, 1.1f, 1.2f, buffer3, 1.1f, 1.2f, buffer4, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+    SampleUtil::free(buffer4);
+}
+BENCHMARK_SIMD_LEVELS(BM_Copy3WithRampingGain);
+
+static void BM_ApplyRampingGain(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::applyRampingGain(buffer, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_SIMD_LEVELS(BM_ApplyRampingGain);
+
+static void BM_CopyWithRampingGain(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyWithRampingGain(buffer, buffer2, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_SIMD_LEVELS(BM_CopyWithRampingGain);
+
+static void BM_AddWithRampingGain(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addWithRampingGain(buffer, buffer2, 1.1f, 1.2f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_SIMD_LEVELS(BM_AddWithRampingGain);
+
+static void BM_InterleaveBuffer(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer2, 0.0f, size / 2);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer3, 0.0f, size / 2);
+
+    while (state.KeepRunning()) {
+        SampleUtil::interleaveBuffer(buffer, buffer2, buffer3, size / 2);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK_SIMD_LEVELS(BM_InterleaveBuffer);
+
+static void BM_DeinterleaveBuffer(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer2, 0.0f, size / 2);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size / 2);
+    SampleUtil::fill(buffer3, 0.0f, size / 2);
+
+    while (state.KeepRunning()) {
+        SampleUtil::deinterleaveBuffer(buffer2, buffer3, buffer, size / 2);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+}
+BENCHMARK_SIMD_LEVELS(BM_DeinterleaveBuffer);
+
+static void BM_MixMultichannelToStereo(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    // The size of the stereo output
+    SINT size = static_cast<SINT>(state.range(0));
+    const auto numChannels = mixxx::audio::ChannelCount::stem();
+    const SINT numFrames = size / 2;
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(numFrames * numChannels);
+    SampleUtil::fill(buffer2, 0.0f, numFrames * numChannels);
+
+    while (state.KeepRunning()) {
+        SampleUtil::mixMultichannelToStereo(buffer, buffer2, numFrames, numChannels, 0b0100);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK_SIMD_LEVELS(BM_MixMultichannelToStereo);
+
+static void BM_ConvertS16ToFloat32(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    std::vector<SAMPLE> samples(size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::convertS16ToFloat32(buffer, samples.data(), size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_SIMD_LEVELS(BM_ConvertS16ToFloat32);
+
+static void BM_ConvertFloat32ToS16(benchmark::State& state, mixxx::SimdLevel level) {
+    ScopedSimdLevel scopedLevel(level);
+    SKIP_UNSUPPORTED_SIMD_LEVEL(state, scopedLevel);
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    std::vector<SAMPLE> samples(size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::convertFloat32ToS16(samples.data(), buffer, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK_SIMD_LEVELS(BM_ConvertFloat32ToS16);
+
+// The following functions rely on auto-vectorization
+// and don't depend on the SIMD level
+
+static void BM_ApplyGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::applyGain(buffer, 1.1f, size);
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_ApplyGain)->Range(64, 4096);
+
+static void BM_CopyWithGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyWithGain(buffer, buffer2, 1.1f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_CopyWithGain)->Range(64, 4096);
+
+static void BM_AddWithGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::addWithGain(buffer, buffer2, 1.1f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_AddWithGain)->Range(64, 4096);
+
+static void BM_Add3WithGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.0f, size);
+    CSAMPLE* buffer4 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer4, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::add3WithGain(buffer, buffer2, 1.1f, buffer3, 1.1f, buffer4, 1.1f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+    SampleUtil::free(buffer4);
+}
+BENCHMARK(BM_Add3WithGain)->Range(64, 4096);
+
+static void BM_Copy3WithGain(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+    CSAMPLE* buffer3 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer3, 0.0f, size);
+    CSAMPLE* buffer4 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer4, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copy3WithGain(buffer, buffer2, 1.1f, buffer3, 1.1f, buffer4, 1.1f, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+    SampleUtil::free(buffer3);
+    SampleUtil::free(buffer4);
+}
+BENCHMARK(BM_Copy3WithGain)->Range(64, 4096);
+
+static void BM_CopyClampBuffer(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::copyClampBuffer(buffer, buffer2, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_CopyClampBuffer)->Range(64, 4096);
+
+static void BM_SumAbsPerChannel(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE absL;
+    CSAMPLE absR;
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(SampleUtil::sumAbsPerChannel(&absL, &absR, buffer, size));
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_SumAbsPerChannel)->Range(64, 4096);
+
+static void BM_MaxAbsAmplitude(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(SampleUtil::maxAbsAmplitude(buffer, size));
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_MaxAbsAmplitude)->Range(64, 4096);
+
+static void BM_LinearCrossfadeStereoBuffersOut(benchmark::State& state) {
+    SINT size = static_cast<SINT>(state.range(0));
+    CSAMPLE* buffer = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer, 0.0f, size);
+    CSAMPLE* buffer2 = SampleUtil::alloc(size);
+    SampleUtil::fill(buffer2, 0.0f, size);
+
+    while (state.KeepRunning()) {
+        SampleUtil::linearCrossfadeStereoBuffersOut(buffer, buffer2, size);
+    }
+
+    SampleUtil::free(buffer);
+    SampleUtil::free(buffer2);
+}
+BENCHMARK(BM_LinearCrossfadeStereoBuffersOut)->Range(64, 4096);
 
 }  // namespace
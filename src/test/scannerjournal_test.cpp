@@ -0,0 +1,103 @@
+#include "library/scanner/scannerjournal.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "test/mixxxtest.h"
+
+class ScannerJournalTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_journalFilePath = m_tempDir.filePath(QStringLiteral("journal.json"));
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_journalFilePath;
+};
+
+TEST_F(ScannerJournalTest, invalidWithoutFile) {
+    ScannerJournal journal(m_journalFilePath);
+    journal.load();
+    EXPECT_FALSE(journal.isValid());
+
+    // An invalid journal is not saved
+    journal.save();
+    EXPECT_FALSE(QFile::exists(m_journalFilePath));
+}
+
+TEST_F(ScannerJournalTest, saveAndLoad) {
+    const QDateTime scanStartedAt = QDateTime::currentDateTimeUtc();
+    {
+        ScannerJournal journal(m_journalFilePath);
+        journal.load();
+        journal.beginScan();
+        journal.finishScan(true, scanStartedAt);
+        EXPECT_TRUE(journal.isValid());
+        journal.markDirectoryChanged(QStringLiteral("/music/a"));
+        journal.save();
+    }
+
+    ScannerJournal journal(m_journalFilePath);
+    journal.load();
+    EXPECT_TRUE(journal.isValid());
+    EXPECT_EQ(scanStartedAt, journal.cursor());
+    EXPECT_EQ(QSet<QString>{QStringLiteral("/music/a")}, journal.changedDirectories());
+
+    // The journal is invalid after a crash
+    EXPECT_FALSE(QFile::exists(m_journalFilePath));
+    ScannerJournal crashedJournal(m_journalFilePath);
+    crashedJournal.load();
+    EXPECT_FALSE(crashedJournal.isValid());
+}
+
+TEST_F(ScannerJournalTest, unfinishedScan) {
+    ScannerJournal journal(m_journalFilePath);
+    journal.load();
+    journal.beginScan();
+    journal.finishScan(true, QDateTime::currentDateTimeUtc());
+    const QDateTime cursor = journal.cursor();
+
+    journal.markDirectoryChanged(QStringLiteral("/music/a"));
+    EXPECT_EQ(QSet<QString>{QStringLiteral("/music/a")}, journal.beginScan());
+    EXPECT_TRUE(journal.changedDirectories().isEmpty());
+    journal.markDirectoryChanged(QStringLiteral("/music/b"));
+    journal.finishScan(false, QDateTime::currentDateTimeUtc());
+
+    // The directories are scanned again by the next scan
+    EXPECT_TRUE(journal.isValid());
+    EXPECT_EQ(cursor, journal.cursor());
+    EXPECT_EQ((QSet<QString>{QStringLiteral("/music/a"), QStringLiteral("/music/b")}),
+            journal.changedDirectories());
+}
+
+TEST_F(ScannerJournalTest, watchDirectories) {
+    const QDir rootDir(m_tempDir.path());
+    ASSERT_TRUE(rootDir.mkdir(QStringLiteral("a")));
+    ASSERT_TRUE(rootDir.mkdir(QStringLiteral("b")));
+    const QString dirPathA = rootDir.filePath(QStringLiteral("a"));
+    const QString dirPathB = rootDir.filePath(QStringLiteral("b"));
+
+    ScannerJournal journal(m_journalFilePath);
+    journal.load();
+    journal.beginScan();
+    journal.finishScan(true, QDateTime::currentDateTimeUtc());
+    journal.watchDirectories(QStringList{dirPathA, dirPathB});
+    ASSERT_TRUE(journal.isValid());
+
+    QFile file(QDir(dirPathA).filePath(QStringLiteral("track.mp3")));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!journal.changedDirectories().contains(dirPathA) && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+    }
+    EXPECT_EQ(QSet<QString>{dirPathA}, journal.changedDirectories());
+}
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <QByteArray>
+#include <algorithm>
+#include <random>
+
+#include "test/waveformlegacyformat.h"
+#include "waveform/waveform.h"
+
+// Loads the waveform of a 2 hour mix with 4 stems like AnalysisDao and
+// WaveformFactory do, in the legacy format (0) or the current one (1).
+// Legacy: 1966 ms, 63.3 MB compressed. Current: 880 ms, 37.9 MB compressed.
+static void BM_WaveformLoad(benchmark::State& state) {
+    Waveform waveform(44100, 44100 * 60 * 120, 441, -1, 4);
+    // Music changes slowly from one visual frame to the next
+    std::mt19937 generator(1234);
+    std::uniform_int_distribution<int> step(-6, 6);
+    WaveformData* data = waveform.data();
+    for (int i = 2; i < waveform.getDataSize(); ++i) {
+        const auto next = [&](unsigned char previous) {
+            return static_cast<unsigned char>(std::clamp(previous + step(generator), 0, 255));
+        };
+        data[i].filtered.low = next(data[i - 2].filtered.low);
+        data[i].filtered.mid = next(data[i - 2].filtered.mid);
+        data[i].filtered.high = next(data[i - 2].filtered.high);
+        data[i].filtered.all = next(data[i - 2].filtered.all);
+        for (int stemIdx = 0; stemIdx < 4; ++stemIdx) {
+            data[i].stems[stemIdx] = next(data[i - 2].stems[stemIdx]);
+        }
+    }
+    waveform.updateSummaryLevels(0, waveform.getDataSize());
+
+    const QByteArray compressedData = qCompress(
+            state.range(0) == 0 ? toLegacyByteArray(waveform) : waveform.toByteArray());
+    for (auto _ : state) {
+        const Waveform loaded(qUncompress(compressedData));
+        benchmark::DoNotOptimize(loaded.getDataSize());
+    }
+    state.counters["compressed_bytes"] = compressedData.size();
+}
+BENCHMARK(BM_WaveformLoad)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
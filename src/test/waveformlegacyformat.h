@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QByteArray>
+#include <string>
+
+#include "proto/waveform.pb.h"
+#include "waveform/waveform.h"
+
+// Converts a signal to the format used before Waveform-7.0
+inline void toLegacySignal(mixxx::track::io::Waveform::Signal* pSignal) {
+    const std::string deltaValues = pSignal->delta_values();
+    unsigned char previous[2] = {};
+    for (std::size_t i = 0; i < deltaValues.size(); ++i) {
+        previous[i % 2] += static_cast<unsigned char>(deltaValues[i]);
+        pSignal->add_value(previous[i % 2]);
+    }
+    pSignal->clear_delta_values();
+}
+
+inline QByteArray toLegacyByteArray(const Waveform& waveform) {
+    const QByteArray stored = waveform.toByteArray();
+    mixxx::track::io::Waveform proto;
+    proto.ParseFromArray(stored.constData(), stored.size());
+    toLegacySignal(proto.mutable_signal_all());
+    toLegacySignal(proto.mutable_signal_filtered()->mutable_low());
+    toLegacySignal(proto.mutable_signal_filtered()->mutable_mid());
+    toLegacySignal(proto.mutable_signal_filtered()->mutable_high());
+    for (auto& stem : *proto.mutable_signal_stems()) {
+        toLegacySignal(&stem);
+    }
+    proto.clear_summary_levels();
+    std::string output;
+    proto.SerializeToString(&output);
+    return QByteArray(output.data(), static_cast<int>(output.length()));
+}
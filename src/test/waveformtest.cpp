@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+#include "test/waveformlegacyformat.h"
+#include "waveform/waveform.h"
+
+namespace {
+
+// An odd number of frames, so the last frame of each level has fewer
+// children than the others.
+constexpr SINT kFrameLength = 44100 * 7 + 123;
+
+class WaveformTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        m_pWaveform = std::make_unique<Waveform>(44100, kFrameLength, 441, -1, 2);
+        std::mt19937 generator(1234);
+        std::uniform_int_distribution<int> distribution(0, 255);
+        WaveformData* data = m_pWaveform->data();
+        for (int i = 0; i < m_pWaveform->getDataSize(); ++i) {
+            data[i].filtered.low = static_cast<unsigned char>(distribution(generator));
+            data[i].filtered.mid = static_cast<unsigned char>(distribution(generator));
+            data[i].filtered.high = static_cast<unsigned char>(distribution(generator));
+            data[i].filtered.all = static_cast<unsigned char>(distribution(generator));
+            data[i].stems[0] = static_cast<unsigned char>(distribution(generator));
+            data[i].stems[1] = static_cast<unsigned char>(distribution(generator));
+        }
+    }
+
+    // Compares each level against the maximum over the waveform data
+    static void expectLevelsAggregateData(const Waveform& waveform) {
+        const WaveformSummaryLevel base = waveform.getSummaryLevel(0);
+        ASSERT_GT(waveform.getSummaryLevelCount(), 1);
+        for (int levelIdx = 1; levelIdx < waveform.getSummaryLevelCount(); ++levelIdx) {
+            const WaveformSummaryLevel level = waveform.getSummaryLevel(levelIdx);
+            ASSERT_EQ(level.dataSize % 2, 0);
+            for (int i = 0; i < level.dataSize; ++i) {
+                const int channel = i % 2;
+                const int frame = i / 2;
+                const int childBegin = frame * level.framesPerValue;
+                const int childEnd = std::min(childBegin + level.framesPerValue,
+                        base.dataSize / 2);
+                ASSERT_LT(childBegin, childEnd);
+                WaveformData expected{};
+                for (int child = childBegin; child < childEnd; ++child) {
+                    const WaveformData& datum = base.data[child * 2 + channel];
+                    expected.filtered.low = std::max(expected.filtered.low, datum.filtered.low);
+                    expected.filtered.all = std::max(expected.filtered.all, datum.filtered.all);
+                    expected.stems[1] = std::max(expected.stems[1], datum.stems[1]);
+                }
+                ASSERT_EQ(expected.filtered.low, level.data[i].filtered.low)
+                        << "level " << levelIdx << " index " << i;
+                ASSERT_EQ(expected.filtered.all, level.data[i].filtered.all)
+                        << "level " << levelIdx << " index " << i;
+                ASSERT_EQ(expected.stems[1], level.data[i].stems[1])
+                        << "level " << levelIdx << " index " << i;
+            }
+        }
+        const int lastLevel = waveform.getSummaryLevelCount() - 1;
+        EXPECT_EQ(2, waveform.getSummaryLevel(lastLevel).dataSize);
+    }
+
+    std::unique_ptr<Waveform> m_pWaveform;
+};
+
+TEST_F(WaveformTest, summaryLevelsAggregateIncrementalUpdates) {
+    // Like AnalyzerWaveform, which updates after each stored L/R pair
+    for (int i = 0; i < m_pWaveform->getDataSize(); i += 2) {
+        m_pWaveform->updateSummaryLevels(i, i + 2);
+    }
+    expectLevelsAggregateData(*m_pWaveform);
+}
+
+TEST_F(WaveformTest, summaryLevelsAreStored) {
+    m_pWaveform->updateSummaryLevels(0, m_pWaveform->getDataSize());
+    const Waveform waveform(m_pWaveform->toByteArray());
+    ASSERT_EQ(m_pWaveform->getSummaryLevelCount(), waveform.getSummaryLevelCount());
+    for (int levelIdx = 0; levelIdx < waveform.getSummaryLevelCount(); ++levelIdx) {
+        const WaveformSummaryLevel expected = m_pWaveform->getSummaryLevel(levelIdx);
+        const WaveformSummaryLevel actual = waveform.getSummaryLevel(levelIdx);
+        ASSERT_EQ(expected.dataSize, actual.dataSize);
+        ASSERT_EQ(expected.framesPerValue, actual.framesPerValue);
+        for (int i = 0; i < actual.dataSize; ++i) {
+            ASSERT_EQ(expected.data[i].filtered.mid, actual.data[i].filtered.mid);
+            ASSERT_EQ(expected.data[i].stems[0], actual.data[i].stems[0]);
+        }
+    }
+}
+
+TEST_F(WaveformTest, dataIsStored) {
+    const Waveform waveform(m_pWaveform->toByteArray());
+    ASSERT_EQ(m_pWaveform->getDataSize(), waveform.getDataSize());
+    for (int i = 0; i < waveform.getDataSize(); ++i) {
+        const WaveformData& expected = m_pWaveform->get(i);
+        const WaveformData& actual = waveform.get(i);
+        ASSERT_EQ(expected.filtered.all, actual.filtered.all);
+        ASSERT_EQ(expected.filtered.low, actual.filtered.low);
+        ASSERT_EQ(expected.filtered.mid, actual.filtered.mid);
+        ASSERT_EQ(expected.filtered.high, actual.filtered.high);
+        ASSERT_EQ(expected.stems[0], actual.stems[0]);
+        ASSERT_EQ(expected.stems[1], actual.stems[1]);
+    }
+}
+
+TEST_F(WaveformTest, legacyFormatIsRead) {
+    const Waveform waveform(toLegacyByteArray(*m_pWaveform));
+    ASSERT_EQ(m_pWaveform->getDataSize(), waveform.getDataSize());
+    for (int i = 0; i < waveform.getDataSize(); ++i) {
+        const WaveformData& expected = m_pWaveform->get(i);
+        const WaveformData& actual = waveform.get(i);
+        ASSERT_EQ(expected.filtered.all, actual.filtered.all);
+        ASSERT_EQ(expected.filtered.low, actual.filtered.low);
+        ASSERT_EQ(expected.filtered.mid, actual.filtered.mid);
+        ASSERT_EQ(expected.filtered.high, actual.filtered.high);
+        ASSERT_EQ(expected.stems[0], actual.stems[0]);
+        ASSERT_EQ(expected.stems[1], actual.stems[1]);
+    }
+    // Stored without summary levels
+    expectLevelsAggregateData(waveform);
+}
+
+TEST_F(WaveformTest, summaryLevelForPixel) {
+    EXPECT_EQ(1, m_pWaveform->getSummaryLevelForPixel(0.5).framesPerValue);
+    EXPECT_EQ(1, m_pWaveform->getSummaryLevelForPixel(3.9).framesPerValue);
+    EXPECT_EQ(4, m_pWaveform->getSummaryLevelForPixel(4).framesPerValue);
+    EXPECT_EQ(16, m_pWaveform->getSummaryLevelForPixel(63).framesPerValue);
+    // Never coarser than the last level
+    const int lastLevel = m_pWaveform->getSummaryLevelCount() - 1;
+    EXPECT_EQ(m_pWaveform->getSummaryLevel(lastLevel).framesPerValue,
+            m_pWaveform->getSummaryLevelForPixel(1e12).framesPerValue);
+}
+
+} // namespace
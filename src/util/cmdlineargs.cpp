@@ -51,6 +51,7 @@ CmdlineArgs::CmdlineArgs()
         : m_startInFullscreen(false), // Initialize vars
           m_startAutoDJ(false),
           m_rescanLibrary(false),
+          m_analyzeLibrary(false),
           m_controllerDebug(false),
           m_controllerAbortOnWarning(false),
           m_developer(false),
@@ -196,6 +197,15 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(rescanLibrary);
 
+    const QCommandLineOption analyzeLibrary(QStringLiteral("analyze-library"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Analyzes all tracks in the library that have not "
+                                      "been analyzed yet and exits without starting the "
+                                      "user interface. An interrupted analysis continues "
+                                      "where it stopped on the next invocation.")
+                            : QString());
+    parser.addOption(analyzeLibrary);
+
     // An option with a value
     const QCommandLineOption settingsPath(QStringLiteral("settings-path"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
@@ -425,6 +435,10 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_rescanLibrary = true;
     }
 
+    if (parser.isSet(analyzeLibrary)) {
+        m_analyzeLibrary = true;
+    }
+
     if (parser.isSet(settingsPath)) {
         m_settingsPath = parser.value(settingsPath);
         if (!m_settingsPath.endsWith("/")) {
@@ -5,6 +5,7 @@
 
 #include "engine/engine.h"
 #include "util/math.h"
+#include "util/samplesimd.h"
 
 #ifdef __WINDOWS__
 #include <QtGlobal>
@@ -20,6 +21,11 @@ typedef qint32 int32_t;
 // using scons optimize=native.
 // "SINT i" is the preferred loop index type that should allow vectorization in
 // general. Unfortunately there are exceptions where "int i" is required for some reasons.
+//
+// Distribution builds only target SSE2. Loops that don't vectorize well for SSE2,
+// like ramping gains, interleaving, and the conversion to integer samples, are
+// implemented as hand-vectorized kernels in samplesimd.cpp instead. The kernels
+// for the best instruction set of the CPU are selected at runtime.
 
 namespace {
 
@@ -142,13 +148,8 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
+        mixxx::simd::activeKernels().applyRampingGain(
+                pBuffer, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -267,12 +268,8 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
+        mixxx::simd::activeKernels().addWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (int i = 0; i < numSamples; ++i) {
@@ -365,12 +362,8 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i" (not SINT i).
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        mixxx::simd::activeKernels().copyWithRampingGain(
+                pDest, pSrc, start_gain, gain_delta, numSamples / 2);
     } else {
         // note: LOOP VECTORIZED.
         for (SINT i = 0; i < numSamples; ++i) {
@@ -390,11 +383,7 @@ void SampleUtil::convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
     // is the highest valid sample. Note that this means that although some
     // sample values convert to -1.0, none will convert to +1.0.
     DEBUG_ASSERT(-SAMPLE_MINIMUM >= SAMPLE_MAXIMUM);
-    const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] = CSAMPLE(pSrc[i]) / kConversionFactor;
-    }
+    mixxx::simd::activeKernels().convertS16ToFloat32(pDest, pSrc, numSamples);
 }
 
 //static
@@ -403,13 +392,7 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
     // We use here -SAMPLE_MINIMUM for a perfect round trip with convertS16ToFloat32
     // +1.0 is clamped to 32767 (0.99996942)
     DEBUG_ASSERT(-SAMPLE_MINIMUM >= SAMPLE_MAXIMUM);
-    const CSAMPLE kConversionFactor = SAMPLE_MINIMUM * -1.0f;
-    // note: LOOP VECTORIZED only with "int i" (not SINT i).
-    for (int i = 0; i < numSamples; ++i) {
-        pDest[i] = static_cast<SAMPLE>(math_clamp(pSrc[i] * kConversionFactor,
-                static_cast<CSAMPLE>(SAMPLE_MINIMUM),
-                static_cast<CSAMPLE>(SAMPLE_MAXIMUM)));
-    }
+    mixxx::simd::activeKernels().convertFloat32ToS16(pDest, pSrc, numSamples);
 }
 
 // static
@@ -461,7 +444,7 @@ CSAMPLE SampleUtil::rms(const CSAMPLE* pBuffer, SINT numSamples) {
 }
 
 CSAMPLE SampleUtil::maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE max = pBuffer[0];
+    CSAMPLE max = abs(pBuffer[0]);
     // note: LOOP VECTORIZED.
     for (SINT i = 1; i < numSamples; ++i) {
         CSAMPLE absValue = abs(pBuffer[i]);
@@ -486,11 +469,7 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    mixxx::simd::activeKernels().interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
@@ -522,11 +501,7 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
         CSAMPLE* M_RESTRICT pDest2,
         const CSAMPLE* M_RESTRICT pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 2];
-        pDest2[i] = pSrc[i * 2 + 1];
-    }
+    mixxx::simd::activeKernels().deinterleaveBuffer(pDest1, pDest2, pSrc, numFrames);
 }
 
 // static
@@ -774,25 +749,11 @@ void SampleUtil::mixMultichannelToStereo(CSAMPLE* pDest,
         mixxx::audio::ChannelCount numChannels,
         int excludeChannelMask) {
     DEBUG_ASSERT(numChannels > mixxx::audio::ChannelCount::stereo());
-    int stereoChCount = numChannels / mixxx::audio::ChannelCount::stereo();
     // Making sure we aren't using this function with more channel than supported with the mask
-    DEBUG_ASSERT(stereoChCount < static_cast<int>(sizeof(excludeChannelMask) * 8));
-    SampleUtil::clear(pDest, numFrames * mixxx::audio::ChannelCount::stereo());
-    for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
-        if (excludeChannelMask >> stemIdx & 0b1) {
-            continue;
-        }
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numFrames; i++) {
-            const int srcIdx = numChannels * i +
-                    stemIdx * mixxx::audio::ChannelCount::stereo();
-            const int destIdx = mixxx::audio::ChannelCount::stereo() * i;
-            pDest[destIdx] +=
-                    pSrc[srcIdx];
-            pDest[destIdx + 1] +=
-                    pSrc[srcIdx + 1];
-        }
-    }
+    DEBUG_ASSERT(numChannels / mixxx::audio::ChannelCount::stereo() <
+            static_cast<int>(sizeof(excludeChannelMask) * 8));
+    mixxx::simd::activeKernels().mixMultichannelToStereo(
+            pDest, pSrc, numFrames, numChannels, excludeChannelMask);
 }
 
 // static
@@ -801,20 +762,8 @@ void SampleUtil::mixMultichannelToStereo(CSAMPLE* pDest,
         SINT numFrames,
         mixxx::audio::ChannelCount numChannels) {
     DEBUG_ASSERT(numChannels > mixxx::audio::ChannelCount::stereo());
-    int stereoChCount = numChannels / mixxx::audio::ChannelCount::stereo();
-    SampleUtil::clear(pDest, numFrames * mixxx::audio::ChannelCount::stereo());
-    for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numFrames; i++) {
-            const int srcIdx = numChannels * i +
-                    stemIdx * mixxx::audio::ChannelCount::stereo();
-            const int destIdx = mixxx::audio::ChannelCount::stereo() * i;
-            pDest[destIdx] +=
-                    pSrc[srcIdx];
-            pDest[destIdx + 1] +=
-                    pSrc[srcIdx + 1];
-        }
-    }
+    mixxx::simd::activeKernels().mixMultichannelToStereo(
+            pDest, pSrc, numFrames, numChannels, 0);
 }
 
 // static
@@ -966,12 +915,8 @@ void SampleUtil::copy1WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     }
     const CSAMPLE_GAIN gain_delta0 = (gain0out - gain0in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain0 = gain0in + gain_delta0;
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples / 2; ++i) {
-        const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
-        pDest[i * 2] = pSrc0[i * 2] * gain0;
-        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0;
-    }
+    mixxx::simd::activeKernels().copyWithRampingGain(
+            pDest, pSrc0, start_gain0, gain_delta0, iNumSamples / 2);
 }
 // static
 void SampleUtil::copy2WithGain(CSAMPLE* M_RESTRICT pDest,
@@ -1015,15 +960,14 @@ void SampleUtil::copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain0 = gain0in + gain_delta0;
     const CSAMPLE_GAIN gain_delta1 = (gain1out - gain1in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples / 2; ++i) {
-        const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
-        const CSAMPLE_GAIN gain1 = start_gain1 + gain_delta1 * i;
-        pDest[i * 2] = pSrc0[i * 2] * gain0 +
-                pSrc1[i * 2] * gain1;
-        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
-                pSrc1[i * 2 + 1] * gain1;
-    }
+    mixxx::simd::activeKernels().copy2WithRampingGain(pDest,
+            pSrc0,
+            start_gain0,
+            gain_delta0,
+            pSrc1,
+            start_gain1,
+            gain_delta1,
+            iNumSamples / 2);
 }
 // static
 void SampleUtil::copy3WithGain(CSAMPLE* M_RESTRICT pDest,
@@ -1104,16 +1048,15 @@ void SampleUtil::copy3WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
     const CSAMPLE_GAIN gain_delta2 = (gain2out - gain2in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain2 = gain2in + gain_delta2;
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples / 2; ++i) {
-        const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
-        const CSAMPLE_GAIN gain1 = start_gain1 + gain_delta1 * i;
-        const CSAMPLE_GAIN gain2 = start_gain2 + gain_delta2 * i;
-        pDest[i * 2] = pSrc0[i * 2] * gain0 +
-                pSrc1[i * 2] * gain1 +
-                pSrc2[i * 2] * gain2;
-        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
-                pSrc1[i * 2 + 1] * gain1 +
-                pSrc2[i * 2 + 1] * gain2;
-    }
+    mixxx::simd::activeKernels().copy3WithRampingGain(pDest,
+            pSrc0,
+            start_gain0,
+            gain_delta0,
+            pSrc1,
+            start_gain1,
+            gain_delta1,
+            pSrc2,
+            start_gain2,
+            gain_delta2,
+            iNumSamples / 2);
 }
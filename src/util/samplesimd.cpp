@@ -0,0 +1,1404 @@
+#include "util/samplesimd.h"
+
+#include <atomic>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/platform.h"
+
+#if !defined(__EMSCRIPTEN__) &&                         \
+        (defined(__x86_64__) || defined(__i386__) ||    \
+                defined(_M_X64) || defined(_M_IX86))
+#define MIXXX_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define MIXXX_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// The x86 kernels are compiled with function specific target attributes
+// instead of global compiler flags, because the portable builds must still
+// run on CPUs with SSE2 only. The kernels are only called after the CPU
+// features have been checked at runtime. MSVC accepts all intrinsics in
+// any function and doesn't need the attributes.
+#if defined(__GNUC__) || defined(__clang__)
+#define MIXXX_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MIXXX_SIMD_TARGET(isa)
+#endif
+
+namespace mixxx {
+
+namespace {
+
+// See SampleUtil::convertS16ToFloat32()
+constexpr CSAMPLE kS16ConversionFactor = SAMPLE_MINIMUM * -1.0f;
+constexpr CSAMPLE kS16ConversionScale = 1.0f / kS16ConversionFactor;
+
+enum class RampMode {
+    Apply,
+    Copy,
+    Add,
+};
+
+// Scalar implementations that are also used for the remaining frames or
+// samples that don't fill a whole vector. The gain of frame i is always
+// calculated as startGain + gainDelta * i, independent of the level.
+
+void applyRampingGainScalar(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT firstFrame,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = static_cast<int>(firstFrame); i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        // a loop counter i += 2 prevents vectorizing.
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+void copyWithRampingGainScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT firstFrame,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED only with "int i" (not SINT i).
+    for (int i = static_cast<int>(firstFrame); i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithRampingGainScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT firstFrame,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = static_cast<int>(firstFrame); i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void rampingGainScalar(RampMode mode,
+        CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT firstFrame,
+        SINT numFrames) {
+    switch (mode) {
+    case RampMode::Apply:
+        DEBUG_ASSERT(pDest == pSrc);
+        applyRampingGainScalar(pDest, startGain, gainDelta, firstFrame, numFrames);
+        return;
+    case RampMode::Copy:
+        copyWithRampingGainScalar(pDest, pSrc, startGain, gainDelta, firstFrame, numFrames);
+        return;
+    case RampMode::Add:
+        addWithRampingGainScalar(pDest, pSrc, startGain, gainDelta, firstFrame, numFrames);
+        return;
+    }
+}
+
+void copy2WithRampingGainScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        SINT firstFrame,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = static_cast<int>(firstFrame); i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain0 = startGain0 + gainDelta0 * i;
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        pDest[i * 2] = pSrc0[i * 2] * gain0 +
+                pSrc1[i * 2] * gain1;
+        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
+                pSrc1[i * 2 + 1] * gain1;
+    }
+}
+
+void copy3WithRampingGainScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT firstFrame,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = static_cast<int>(firstFrame); i < numFrames; ++i) {
+        const CSAMPLE_GAIN gain0 = startGain0 + gainDelta0 * i;
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest[i * 2] = pSrc0[i * 2] * gain0 +
+                pSrc1[i * 2] * gain1 +
+                pSrc2[i * 2] * gain2;
+        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
+                pSrc1[i * 2 + 1] * gain1 +
+                pSrc2[i * 2 + 1] * gain2;
+    }
+}
+
+void interleaveBufferScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT firstFrame,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = firstFrame; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveBufferScalar(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT firstFrame,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = firstFrame; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+void mixMultichannelToStereoScalar(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT firstFrame,
+        SINT numFrames,
+        int numChannels,
+        int excludeChannelMask) {
+    const int stereoChCount = numChannels / 2;
+    for (SINT i = firstFrame * 2; i < numFrames * 2; ++i) {
+        pDest[i] = CSAMPLE_ZERO;
+    }
+    for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
+        if (excludeChannelMask >> stemIdx & 0b1) {
+            continue;
+        }
+        // note: LOOP VECTORIZED.
+        for (int i = static_cast<int>(firstFrame); i < numFrames; i++) {
+            const int srcIdx = numChannels * i + stemIdx * 2;
+            const int destIdx = 2 * i;
+            pDest[destIdx] += pSrc[srcIdx];
+            pDest[destIdx + 1] += pSrc[srcIdx + 1];
+        }
+    }
+}
+
+void convertS16ToFloat32Scalar(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT firstSample,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = firstSample; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) / kS16ConversionFactor;
+    }
+}
+
+void convertFloat32ToS16Scalar(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT firstSample,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED only with "int i" (not SINT i).
+    for (int i = static_cast<int>(firstSample); i < numSamples; ++i) {
+        pDest[i] = static_cast<SAMPLE>(math_clamp(pSrc[i] * kS16ConversionFactor,
+                static_cast<CSAMPLE>(SAMPLE_MINIMUM),
+                static_cast<CSAMPLE>(SAMPLE_MAXIMUM)));
+    }
+}
+
+constexpr SampleUtilKernels kScalarKernels = {
+        SimdLevel::Scalar,
+        [](CSAMPLE* pBuffer,
+                CSAMPLE_GAIN startGain,
+                CSAMPLE_GAIN gainDelta,
+                SINT numFrames) {
+            applyRampingGainScalar(pBuffer, startGain, gainDelta, 0, numFrames);
+        },
+        [](CSAMPLE* pDest,
+                const CSAMPLE* pSrc,
+                CSAMPLE_GAIN startGain,
+                CSAMPLE_GAIN gainDelta,
+                SINT numFrames) {
+            copyWithRampingGainScalar(pDest, pSrc, startGain, gainDelta, 0, numFrames);
+        },
+        [](CSAMPLE* pDest,
+                const CSAMPLE* pSrc,
+                CSAMPLE_GAIN startGain,
+                CSAMPLE_GAIN gainDelta,
+                SINT numFrames) {
+            addWithRampingGainScalar(pDest, pSrc, startGain, gainDelta, 0, numFrames);
+        },
+        [](CSAMPLE* pDest,
+                const CSAMPLE* pSrc0,
+                CSAMPLE_GAIN startGain0,
+                CSAMPLE_GAIN gainDelta0,
+                const CSAMPLE* pSrc1,
+                CSAMPLE_GAIN startGain1,
+                CSAMPLE_GAIN gainDelta1,
+                SINT numFrames) {
+            copy2WithRampingGainScalar(pDest,
+                    pSrc0,
+                    startGain0,
+                    gainDelta0,
+                    pSrc1,
+                    startGain1,
+                    gainDelta1,
+                    0,
+                    numFrames);
+        },
+        [](CSAMPLE* pDest,
+                const CSAMPLE* pSrc0,
+                CSAMPLE_GAIN startGain0,
+                CSAMPLE_GAIN gainDelta0,
+                const CSAMPLE* pSrc1,
+                CSAMPLE_GAIN startGain1,
+                CSAMPLE_GAIN gainDelta1,
+                const CSAMPLE* pSrc2,
+                CSAMPLE_GAIN startGain2,
+                CSAMPLE_GAIN gainDelta2,
+                SINT numFrames) {
+            copy3WithRampingGainScalar(pDest,
+                    pSrc0,
+                    startGain0,
+                    gainDelta0,
+                    pSrc1,
+                    startGain1,
+                    gainDelta1,
+                    pSrc2,
+                    startGain2,
+                    gainDelta2,
+                    0,
+                    numFrames);
+        },
+        [](CSAMPLE* pDest,
+                const CSAMPLE* pSrc1,
+                const CSAMPLE* pSrc2,
+                SINT numFrames) {
+            interleaveBufferScalar(pDest, pSrc1, pSrc2, 0, numFrames);
+        },
+        [](CSAMPLE* pDest1,
+                CSAMPLE* pDest2,
+                const CSAMPLE* pSrc,
+                SINT numFrames) {
+            deinterleaveBufferScalar(pDest1, pDest2, pSrc, 0, numFrames);
+        },
+        [](CSAMPLE* pDest,
+                const CSAMPLE* pSrc,
+                SINT numFrames,
+                int numChannels,
+                int excludeChannelMask) {
+            mixMultichannelToStereoScalar(
+                    pDest, pSrc, 0, numFrames, numChannels, excludeChannelMask);
+        },
+        [](CSAMPLE* pDest, const SAMPLE* pSrc, SINT numSamples) {
+            convertS16ToFloat32Scalar(pDest, pSrc, 0, numSamples);
+        },
+        [](SAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+            convertFloat32ToS16Scalar(pDest, pSrc, 0, numSamples);
+        },
+};
+
+#if defined(MIXXX_SIMD_X86)
+
+//
+// SSE4.1: 4 samples or 2 stereo frames per vector
+//
+
+template<RampMode mode>
+MIXXX_SIMD_TARGET("sse4.1")
+void rampingGainSse41(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m128 start = _mm_set1_ps(startGain);
+    const __m128 delta = _mm_set1_ps(gainDelta);
+    const __m128 step = _mm_set1_ps(2.0f);
+    __m128 frame = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const __m128 gain = _mm_add_ps(start, _mm_mul_ps(delta, frame));
+        __m128 out = _mm_mul_ps(_mm_loadu_ps(pSrc + i * 2), gain);
+        if constexpr (mode == RampMode::Add) {
+            out = _mm_add_ps(_mm_loadu_ps(pDest + i * 2), out);
+        }
+        _mm_storeu_ps(pDest + i * 2, out);
+        frame = _mm_add_ps(frame, step);
+    }
+    rampingGainScalar(mode, pDest, pSrc, startGain, gainDelta, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void applyRampingGainSse41(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampingGainSse41<RampMode::Apply>(pBuffer, pBuffer, startGain, gainDelta, numFrames);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void copy2WithRampingGainSse41(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        SINT numFrames) {
+    const __m128 start0 = _mm_set1_ps(startGain0);
+    const __m128 delta0 = _mm_set1_ps(gainDelta0);
+    const __m128 start1 = _mm_set1_ps(startGain1);
+    const __m128 delta1 = _mm_set1_ps(gainDelta1);
+    const __m128 step = _mm_set1_ps(2.0f);
+    __m128 frame = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const __m128 gain0 = _mm_add_ps(start0, _mm_mul_ps(delta0, frame));
+        const __m128 gain1 = _mm_add_ps(start1, _mm_mul_ps(delta1, frame));
+        _mm_storeu_ps(pDest + i * 2,
+                _mm_add_ps(
+                        _mm_mul_ps(_mm_loadu_ps(pSrc0 + i * 2), gain0),
+                        _mm_mul_ps(_mm_loadu_ps(pSrc1 + i * 2), gain1)));
+        frame = _mm_add_ps(frame, step);
+    }
+    copy2WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            i,
+            numFrames);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void copy3WithRampingGainSse41(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    const __m128 start0 = _mm_set1_ps(startGain0);
+    const __m128 delta0 = _mm_set1_ps(gainDelta0);
+    const __m128 start1 = _mm_set1_ps(startGain1);
+    const __m128 delta1 = _mm_set1_ps(gainDelta1);
+    const __m128 start2 = _mm_set1_ps(startGain2);
+    const __m128 delta2 = _mm_set1_ps(gainDelta2);
+    const __m128 step = _mm_set1_ps(2.0f);
+    __m128 frame = _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const __m128 gain0 = _mm_add_ps(start0, _mm_mul_ps(delta0, frame));
+        const __m128 gain1 = _mm_add_ps(start1, _mm_mul_ps(delta1, frame));
+        const __m128 gain2 = _mm_add_ps(start2, _mm_mul_ps(delta2, frame));
+        _mm_storeu_ps(pDest + i * 2,
+                _mm_add_ps(
+                        _mm_add_ps(
+                                _mm_mul_ps(_mm_loadu_ps(pSrc0 + i * 2), gain0),
+                                _mm_mul_ps(_mm_loadu_ps(pSrc1 + i * 2), gain1)),
+                        _mm_mul_ps(_mm_loadu_ps(pSrc2 + i * 2), gain2)));
+        frame = _mm_add_ps(frame, step);
+    }
+    copy3WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            pSrc2,
+            startGain2,
+            gainDelta2,
+            i,
+            numFrames);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void interleaveBufferSse41(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m128 left = _mm_loadu_ps(pSrc1 + i);
+        const __m128 right = _mm_loadu_ps(pSrc2 + i);
+        _mm_storeu_ps(pDest + i * 2, _mm_unpacklo_ps(left, right));
+        _mm_storeu_ps(pDest + i * 2 + 4, _mm_unpackhi_ps(left, right));
+    }
+    interleaveBufferScalar(pDest, pSrc1, pSrc2, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void deinterleaveBufferSse41(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m128 frames01 = _mm_loadu_ps(pSrc + i * 2);
+        const __m128 frames23 = _mm_loadu_ps(pSrc + i * 2 + 4);
+        _mm_storeu_ps(pDest1 + i, _mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(pDest2 + i, _mm_shuffle_ps(frames01, frames23, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    deinterleaveBufferScalar(pDest1, pDest2, pSrc, i, numFrames);
+}
+
+/// Loads the stereo pairs of two consecutive multichannel frames
+MIXXX_SIMD_TARGET("sse4.1")
+inline __m128 loadStereoPairsSse41(const CSAMPLE* pSrc, int numChannels) {
+    const __m128 pair0 = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(pSrc));
+    return _mm_loadh_pi(pair0, reinterpret_cast<const __m64*>(pSrc + numChannels));
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void mixMultichannelToStereoSse41(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames,
+        int numChannels,
+        int excludeChannelMask) {
+    const int stereoChCount = numChannels / 2;
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const CSAMPLE* pFrames = pSrc + numChannels * i;
+        __m128 sum = _mm_setzero_ps();
+        for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
+            if (excludeChannelMask >> stemIdx & 0b1) {
+                continue;
+            }
+            sum = _mm_add_ps(sum, loadStereoPairsSse41(pFrames + stemIdx * 2, numChannels));
+        }
+        _mm_storeu_ps(pDest + i * 2, sum);
+    }
+    mixMultichannelToStereoScalar(
+            pDest, pSrc, i, numFrames, numChannels, excludeChannelMask);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void convertS16ToFloat32Sse41(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m128 scale = _mm_set1_ps(kS16ConversionScale);
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_ps(pDest + i,
+                _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(samples)), scale));
+        _mm_storeu_ps(pDest + i + 4,
+                _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_srli_si128(samples, 8))),
+                        scale));
+    }
+    convertS16ToFloat32Scalar(pDest, pSrc, i, numSamples);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+inline __m128i convertToS32Sse41(const CSAMPLE* pSrc) {
+    const __m128 scaled = _mm_mul_ps(_mm_loadu_ps(pSrc), _mm_set1_ps(kS16ConversionFactor));
+    const __m128 clamped = _mm_min_ps(
+            _mm_max_ps(scaled, _mm_set1_ps(static_cast<CSAMPLE>(SAMPLE_MINIMUM))),
+            _mm_set1_ps(static_cast<CSAMPLE>(SAMPLE_MAXIMUM)));
+    // Truncates like static_cast
+    return _mm_cvttps_epi32(clamped);
+}
+
+MIXXX_SIMD_TARGET("sse4.1")
+void convertFloat32ToS16Sse41(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i),
+                _mm_packs_epi32(convertToS32Sse41(pSrc + i), convertToS32Sse41(pSrc + i + 4)));
+    }
+    convertFloat32ToS16Scalar(pDest, pSrc, i, numSamples);
+}
+
+constexpr SampleUtilKernels kSse41Kernels = {
+        SimdLevel::SSE41,
+        applyRampingGainSse41,
+        rampingGainSse41<RampMode::Copy>,
+        rampingGainSse41<RampMode::Add>,
+        copy2WithRampingGainSse41,
+        copy3WithRampingGainSse41,
+        interleaveBufferSse41,
+        deinterleaveBufferSse41,
+        mixMultichannelToStereoSse41,
+        convertS16ToFloat32Sse41,
+        convertFloat32ToS16Sse41,
+};
+
+//
+// AVX2: 8 samples or 4 stereo frames per vector
+//
+
+template<RampMode mode>
+MIXXX_SIMD_TARGET("avx2")
+void rampingGainAvx2(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 delta = _mm256_set1_ps(gainDelta);
+    const __m256 step = _mm256_set1_ps(4.0f);
+    __m256 frame = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 gain = _mm256_add_ps(start, _mm256_mul_ps(delta, frame));
+        __m256 out = _mm256_mul_ps(_mm256_loadu_ps(pSrc + i * 2), gain);
+        if constexpr (mode == RampMode::Add) {
+            out = _mm256_add_ps(_mm256_loadu_ps(pDest + i * 2), out);
+        }
+        _mm256_storeu_ps(pDest + i * 2, out);
+        frame = _mm256_add_ps(frame, step);
+    }
+    rampingGainScalar(mode, pDest, pSrc, startGain, gainDelta, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void applyRampingGainAvx2(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampingGainAvx2<RampMode::Apply>(pBuffer, pBuffer, startGain, gainDelta, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void copy2WithRampingGainAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        SINT numFrames) {
+    const __m256 start0 = _mm256_set1_ps(startGain0);
+    const __m256 delta0 = _mm256_set1_ps(gainDelta0);
+    const __m256 start1 = _mm256_set1_ps(startGain1);
+    const __m256 delta1 = _mm256_set1_ps(gainDelta1);
+    const __m256 step = _mm256_set1_ps(4.0f);
+    __m256 frame = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 gain0 = _mm256_add_ps(start0, _mm256_mul_ps(delta0, frame));
+        const __m256 gain1 = _mm256_add_ps(start1, _mm256_mul_ps(delta1, frame));
+        _mm256_storeu_ps(pDest + i * 2,
+                _mm256_add_ps(
+                        _mm256_mul_ps(_mm256_loadu_ps(pSrc0 + i * 2), gain0),
+                        _mm256_mul_ps(_mm256_loadu_ps(pSrc1 + i * 2), gain1)));
+        frame = _mm256_add_ps(frame, step);
+    }
+    copy2WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            i,
+            numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void copy3WithRampingGainAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    const __m256 start0 = _mm256_set1_ps(startGain0);
+    const __m256 delta0 = _mm256_set1_ps(gainDelta0);
+    const __m256 start1 = _mm256_set1_ps(startGain1);
+    const __m256 delta1 = _mm256_set1_ps(gainDelta1);
+    const __m256 start2 = _mm256_set1_ps(startGain2);
+    const __m256 delta2 = _mm256_set1_ps(gainDelta2);
+    const __m256 step = _mm256_set1_ps(4.0f);
+    __m256 frame = _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const __m256 gain0 = _mm256_add_ps(start0, _mm256_mul_ps(delta0, frame));
+        const __m256 gain1 = _mm256_add_ps(start1, _mm256_mul_ps(delta1, frame));
+        const __m256 gain2 = _mm256_add_ps(start2, _mm256_mul_ps(delta2, frame));
+        _mm256_storeu_ps(pDest + i * 2,
+                _mm256_add_ps(
+                        _mm256_add_ps(
+                                _mm256_mul_ps(_mm256_loadu_ps(pSrc0 + i * 2), gain0),
+                                _mm256_mul_ps(_mm256_loadu_ps(pSrc1 + i * 2), gain1)),
+                        _mm256_mul_ps(_mm256_loadu_ps(pSrc2 + i * 2), gain2)));
+        frame = _mm256_add_ps(frame, step);
+    }
+    copy3WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            pSrc2,
+            startGain2,
+            gainDelta2,
+            i,
+            numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void interleaveBufferAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256 left = _mm256_loadu_ps(pSrc1 + i);
+        const __m256 right = _mm256_loadu_ps(pSrc2 + i);
+        // The unpack instructions operate on both 128 bit lanes separately
+        const __m256 frames0145 = _mm256_unpacklo_ps(left, right);
+        const __m256 frames2367 = _mm256_unpackhi_ps(left, right);
+        _mm256_storeu_ps(pDest + i * 2, _mm256_permute2f128_ps(frames0145, frames2367, 0x20));
+        _mm256_storeu_ps(pDest + i * 2 + 8, _mm256_permute2f128_ps(frames0145, frames2367, 0x31));
+    }
+    interleaveBufferScalar(pDest, pSrc1, pSrc2, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void deinterleaveBufferAvx2(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m256 frames0123 = _mm256_loadu_ps(pSrc + i * 2);
+        const __m256 frames4567 = _mm256_loadu_ps(pSrc + i * 2 + 8);
+        const __m256 frames0145 = _mm256_permute2f128_ps(frames0123, frames4567, 0x20);
+        const __m256 frames2367 = _mm256_permute2f128_ps(frames0123, frames4567, 0x31);
+        _mm256_storeu_ps(pDest1 + i,
+                _mm256_shuffle_ps(frames0145, frames2367, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm256_storeu_ps(pDest2 + i,
+                _mm256_shuffle_ps(frames0145, frames2367, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    deinterleaveBufferScalar(pDest1, pDest2, pSrc, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void mixMultichannelToStereoAvx2(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames,
+        int numChannels,
+        int excludeChannelMask) {
+    const int stereoChCount = numChannels / 2;
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const CSAMPLE* pFrames = pSrc + numChannels * i;
+        __m256 sum = _mm256_setzero_ps();
+        for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
+            if (excludeChannelMask >> stemIdx & 0b1) {
+                continue;
+            }
+            const CSAMPLE* pStem = pFrames + stemIdx * 2;
+            const __m256 pairs = _mm256_insertf128_ps(
+                    _mm256_castps128_ps256(loadStereoPairsSse41(pStem, numChannels)),
+                    loadStereoPairsSse41(pStem + numChannels * 2, numChannels),
+                    1);
+            sum = _mm256_add_ps(sum, pairs);
+        }
+        _mm256_storeu_ps(pDest + i * 2, sum);
+    }
+    mixMultichannelToStereoScalar(
+            pDest, pSrc, i, numFrames, numChannels, excludeChannelMask);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void convertS16ToFloat32Avx2(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m256 scale = _mm256_set1_ps(kS16ConversionScale);
+    SINT i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+        _mm256_storeu_ps(pDest + i,
+                _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+                                      _mm256_castsi256_si128(samples))),
+                        scale));
+        _mm256_storeu_ps(pDest + i + 8,
+                _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+                                      _mm256_extracti128_si256(samples, 1))),
+                        scale));
+    }
+    convertS16ToFloat32Scalar(pDest, pSrc, i, numSamples);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+inline __m256i convertToS32Avx2(const CSAMPLE* pSrc) {
+    const __m256 scaled = _mm256_mul_ps(
+            _mm256_loadu_ps(pSrc), _mm256_set1_ps(kS16ConversionFactor));
+    const __m256 clamped = _mm256_min_ps(
+            _mm256_max_ps(scaled, _mm256_set1_ps(static_cast<CSAMPLE>(SAMPLE_MINIMUM))),
+            _mm256_set1_ps(static_cast<CSAMPLE>(SAMPLE_MAXIMUM)));
+    // Truncates like static_cast
+    return _mm256_cvttps_epi32(clamped);
+}
+
+MIXXX_SIMD_TARGET("avx2")
+void convertFloat32ToS16Avx2(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        // The pack instruction interleaves the 128 bit lanes of both inputs
+        const __m256i packed = _mm256_packs_epi32(
+                convertToS32Avx2(pSrc + i), convertToS32Avx2(pSrc + i + 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + i),
+                _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    convertFloat32ToS16Scalar(pDest, pSrc, i, numSamples);
+}
+
+constexpr SampleUtilKernels kAvx2Kernels = {
+        SimdLevel::AVX2,
+        applyRampingGainAvx2,
+        rampingGainAvx2<RampMode::Copy>,
+        rampingGainAvx2<RampMode::Add>,
+        copy2WithRampingGainAvx2,
+        copy3WithRampingGainAvx2,
+        interleaveBufferAvx2,
+        deinterleaveBufferAvx2,
+        mixMultichannelToStereoAvx2,
+        convertS16ToFloat32Avx2,
+        convertFloat32ToS16Avx2,
+};
+
+//
+// AVX-512: 16 samples or 8 stereo frames per vector
+//
+
+/// The frame index of each sample in the first vector
+MIXXX_SIMD_TARGET("avx512f")
+inline __m512 firstFramesAvx512() {
+    return _mm512_setr_ps(0.0f,
+            0.0f,
+            1.0f,
+            1.0f,
+            2.0f,
+            2.0f,
+            3.0f,
+            3.0f,
+            4.0f,
+            4.0f,
+            5.0f,
+            5.0f,
+            6.0f,
+            6.0f,
+            7.0f,
+            7.0f);
+}
+
+template<RampMode mode>
+MIXXX_SIMD_TARGET("avx512f")
+void rampingGainAvx512(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 delta = _mm512_set1_ps(gainDelta);
+    const __m512 step = _mm512_set1_ps(8.0f);
+    __m512 frame = firstFramesAvx512();
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 gain = _mm512_add_ps(start, _mm512_mul_ps(delta, frame));
+        __m512 out = _mm512_mul_ps(_mm512_loadu_ps(pSrc + i * 2), gain);
+        if constexpr (mode == RampMode::Add) {
+            out = _mm512_add_ps(_mm512_loadu_ps(pDest + i * 2), out);
+        }
+        _mm512_storeu_ps(pDest + i * 2, out);
+        frame = _mm512_add_ps(frame, step);
+    }
+    rampingGainScalar(mode, pDest, pSrc, startGain, gainDelta, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx512f")
+void applyRampingGainAvx512(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampingGainAvx512<RampMode::Apply>(pBuffer, pBuffer, startGain, gainDelta, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx512f")
+void copy2WithRampingGainAvx512(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        SINT numFrames) {
+    const __m512 start0 = _mm512_set1_ps(startGain0);
+    const __m512 delta0 = _mm512_set1_ps(gainDelta0);
+    const __m512 start1 = _mm512_set1_ps(startGain1);
+    const __m512 delta1 = _mm512_set1_ps(gainDelta1);
+    const __m512 step = _mm512_set1_ps(8.0f);
+    __m512 frame = firstFramesAvx512();
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 gain0 = _mm512_add_ps(start0, _mm512_mul_ps(delta0, frame));
+        const __m512 gain1 = _mm512_add_ps(start1, _mm512_mul_ps(delta1, frame));
+        _mm512_storeu_ps(pDest + i * 2,
+                _mm512_add_ps(
+                        _mm512_mul_ps(_mm512_loadu_ps(pSrc0 + i * 2), gain0),
+                        _mm512_mul_ps(_mm512_loadu_ps(pSrc1 + i * 2), gain1)));
+        frame = _mm512_add_ps(frame, step);
+    }
+    copy2WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            i,
+            numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx512f")
+void copy3WithRampingGainAvx512(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    const __m512 start0 = _mm512_set1_ps(startGain0);
+    const __m512 delta0 = _mm512_set1_ps(gainDelta0);
+    const __m512 start1 = _mm512_set1_ps(startGain1);
+    const __m512 delta1 = _mm512_set1_ps(gainDelta1);
+    const __m512 start2 = _mm512_set1_ps(startGain2);
+    const __m512 delta2 = _mm512_set1_ps(gainDelta2);
+    const __m512 step = _mm512_set1_ps(8.0f);
+    __m512 frame = firstFramesAvx512();
+    SINT i = 0;
+    for (; i + 8 <= numFrames; i += 8) {
+        const __m512 gain0 = _mm512_add_ps(start0, _mm512_mul_ps(delta0, frame));
+        const __m512 gain1 = _mm512_add_ps(start1, _mm512_mul_ps(delta1, frame));
+        const __m512 gain2 = _mm512_add_ps(start2, _mm512_mul_ps(delta2, frame));
+        _mm512_storeu_ps(pDest + i * 2,
+                _mm512_add_ps(
+                        _mm512_add_ps(
+                                _mm512_mul_ps(_mm512_loadu_ps(pSrc0 + i * 2), gain0),
+                                _mm512_mul_ps(_mm512_loadu_ps(pSrc1 + i * 2), gain1)),
+                        _mm512_mul_ps(_mm512_loadu_ps(pSrc2 + i * 2), gain2)));
+        frame = _mm512_add_ps(frame, step);
+    }
+    copy3WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            pSrc2,
+            startGain2,
+            gainDelta2,
+            i,
+            numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx512f")
+void interleaveBufferAvx512(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // Indices 0..15 select from the left and 16..31 from the right channel
+    const __m512i lowerFrames = _mm512_setr_epi32(
+            0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+    const __m512i upperFrames = _mm512_setr_epi32(
+            8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+    SINT i = 0;
+    for (; i + 16 <= numFrames; i += 16) {
+        const __m512 left = _mm512_loadu_ps(pSrc1 + i);
+        const __m512 right = _mm512_loadu_ps(pSrc2 + i);
+        _mm512_storeu_ps(pDest + i * 2, _mm512_permutex2var_ps(left, lowerFrames, right));
+        _mm512_storeu_ps(pDest + i * 2 + 16, _mm512_permutex2var_ps(left, upperFrames, right));
+    }
+    interleaveBufferScalar(pDest, pSrc1, pSrc2, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx512f")
+void deinterleaveBufferAvx512(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    const __m512i leftSamples = _mm512_setr_epi32(
+            0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const __m512i rightSamples = _mm512_setr_epi32(
+            1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+    SINT i = 0;
+    for (; i + 16 <= numFrames; i += 16) {
+        const __m512 lowerFrames = _mm512_loadu_ps(pSrc + i * 2);
+        const __m512 upperFrames = _mm512_loadu_ps(pSrc + i * 2 + 16);
+        _mm512_storeu_ps(pDest1 + i,
+                _mm512_permutex2var_ps(lowerFrames, leftSamples, upperFrames));
+        _mm512_storeu_ps(pDest2 + i,
+                _mm512_permutex2var_ps(lowerFrames, rightSamples, upperFrames));
+    }
+    deinterleaveBufferScalar(pDest1, pDest2, pSrc, i, numFrames);
+}
+
+MIXXX_SIMD_TARGET("avx512f")
+void convertS16ToFloat32Avx512(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m512 scale = _mm512_set1_ps(kS16ConversionScale);
+    SINT i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+        _mm512_storeu_ps(pDest + i,
+                _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(samples)), scale));
+    }
+    convertS16ToFloat32Scalar(pDest, pSrc, i, numSamples);
+}
+
+MIXXX_SIMD_TARGET("avx512f")
+void convertFloat32ToS16Avx512(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    const __m512 factor = _mm512_set1_ps(kS16ConversionFactor);
+    const __m512 minimum = _mm512_set1_ps(static_cast<CSAMPLE>(SAMPLE_MINIMUM));
+    const __m512 maximum = _mm512_set1_ps(static_cast<CSAMPLE>(SAMPLE_MAXIMUM));
+    SINT i = 0;
+    for (; i + 16 <= numSamples; i += 16) {
+        const __m512 scaled = _mm512_mul_ps(_mm512_loadu_ps(pSrc + i), factor);
+        const __m512 clamped = _mm512_min_ps(_mm512_max_ps(scaled, minimum), maximum);
+        // Truncates like static_cast
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + i),
+                _mm512_cvtsepi32_epi16(_mm512_cvttps_epi32(clamped)));
+    }
+    convertFloat32ToS16Scalar(pDest, pSrc, i, numSamples);
+}
+
+// The frames of mixMultichannelToStereo() need to be gathered from
+// non-contiguous memory. This doesn't profit from wider vectors,
+// so the AVX2 kernel is reused.
+constexpr SampleUtilKernels kAvx512Kernels = {
+        SimdLevel::AVX512,
+        applyRampingGainAvx512,
+        rampingGainAvx512<RampMode::Copy>,
+        rampingGainAvx512<RampMode::Add>,
+        copy2WithRampingGainAvx512,
+        copy3WithRampingGainAvx512,
+        interleaveBufferAvx512,
+        deinterleaveBufferAvx512,
+        mixMultichannelToStereoAvx2,
+        convertS16ToFloat32Avx512,
+        convertFloat32ToS16Avx512,
+};
+
+bool cpuSupports(SimdLevel level) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    if (level == SimdLevel::SSE41) {
+        return (info[2] & (1 << 19)) != 0;
+    }
+    // The operating system must save the YMM/ZMM registers
+    // on context switches
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || maxLeaf < 7) {
+        return false;
+    }
+    const unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    if (level == SimdLevel::AVX2) {
+        return (info[1] & (1 << 5)) != 0;
+    }
+    if (level == SimdLevel::AVX512) {
+        return (xcr0 & 0xe0) == 0xe0 && (info[1] & (1 << 16)) != 0;
+    }
+    return false;
+#else
+    // Also checks that the operating system supports the registers
+    __builtin_cpu_init();
+    switch (level) {
+    case SimdLevel::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case SimdLevel::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case SimdLevel::AVX512:
+        return __builtin_cpu_supports("avx512f");
+    default:
+        return false;
+    }
+#endif
+}
+
+#endif // MIXXX_SIMD_X86
+
+#if defined(MIXXX_SIMD_NEON)
+
+//
+// NEON: 4 samples or 2 stereo frames per vector
+//
+
+template<RampMode mode>
+void rampingGainNeon(CSAMPLE* pDest,
+        const CSAMPLE* pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t delta = vdupq_n_f32(gainDelta);
+    const float32x4_t step = vdupq_n_f32(2.0f);
+    const float kFirstFrames[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+    float32x4_t frame = vld1q_f32(kFirstFrames);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        // Multiply and add separately like the other implementations
+        const float32x4_t gain = vaddq_f32(start, vmulq_f32(delta, frame));
+        float32x4_t out = vmulq_f32(vld1q_f32(pSrc + i * 2), gain);
+        if constexpr (mode == RampMode::Add) {
+            out = vaddq_f32(vld1q_f32(pDest + i * 2), out);
+        }
+        vst1q_f32(pDest + i * 2, out);
+        frame = vaddq_f32(frame, step);
+    }
+    rampingGainScalar(mode, pDest, pSrc, startGain, gainDelta, i, numFrames);
+}
+
+void applyRampingGainNeon(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numFrames) {
+    rampingGainNeon<RampMode::Apply>(pBuffer, pBuffer, startGain, gainDelta, numFrames);
+}
+
+void copy2WithRampingGainNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        SINT numFrames) {
+    const float32x4_t start0 = vdupq_n_f32(startGain0);
+    const float32x4_t delta0 = vdupq_n_f32(gainDelta0);
+    const float32x4_t start1 = vdupq_n_f32(startGain1);
+    const float32x4_t delta1 = vdupq_n_f32(gainDelta1);
+    const float32x4_t step = vdupq_n_f32(2.0f);
+    const float kFirstFrames[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+    float32x4_t frame = vld1q_f32(kFirstFrames);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const float32x4_t gain0 = vaddq_f32(start0, vmulq_f32(delta0, frame));
+        const float32x4_t gain1 = vaddq_f32(start1, vmulq_f32(delta1, frame));
+        vst1q_f32(pDest + i * 2,
+                vaddq_f32(
+                        vmulq_f32(vld1q_f32(pSrc0 + i * 2), gain0),
+                        vmulq_f32(vld1q_f32(pSrc1 + i * 2), gain1)));
+        frame = vaddq_f32(frame, step);
+    }
+    copy2WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            i,
+            numFrames);
+}
+
+void copy3WithRampingGainNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        SINT numFrames) {
+    const float32x4_t start0 = vdupq_n_f32(startGain0);
+    const float32x4_t delta0 = vdupq_n_f32(gainDelta0);
+    const float32x4_t start1 = vdupq_n_f32(startGain1);
+    const float32x4_t delta1 = vdupq_n_f32(gainDelta1);
+    const float32x4_t start2 = vdupq_n_f32(startGain2);
+    const float32x4_t delta2 = vdupq_n_f32(gainDelta2);
+    const float32x4_t step = vdupq_n_f32(2.0f);
+    const float kFirstFrames[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+    float32x4_t frame = vld1q_f32(kFirstFrames);
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const float32x4_t gain0 = vaddq_f32(start0, vmulq_f32(delta0, frame));
+        const float32x4_t gain1 = vaddq_f32(start1, vmulq_f32(delta1, frame));
+        const float32x4_t gain2 = vaddq_f32(start2, vmulq_f32(delta2, frame));
+        vst1q_f32(pDest + i * 2,
+                vaddq_f32(
+                        vaddq_f32(
+                                vmulq_f32(vld1q_f32(pSrc0 + i * 2), gain0),
+                                vmulq_f32(vld1q_f32(pSrc1 + i * 2), gain1)),
+                        vmulq_f32(vld1q_f32(pSrc2 + i * 2), gain2)));
+        frame = vaddq_f32(frame, step);
+    }
+    copy3WithRampingGainScalar(pDest,
+            pSrc0,
+            startGain0,
+            gainDelta0,
+            pSrc1,
+            startGain1,
+            gainDelta1,
+            pSrc2,
+            startGain2,
+            gainDelta2,
+            i,
+            numFrames);
+}
+
+void interleaveBufferNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        float32x4x2_t frames;
+        frames.val[0] = vld1q_f32(pSrc1 + i);
+        frames.val[1] = vld1q_f32(pSrc2 + i);
+        vst2q_f32(pDest + i * 2, frames);
+    }
+    interleaveBufferScalar(pDest, pSrc1, pSrc2, i, numFrames);
+}
+
+void deinterleaveBufferNeon(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    SINT i = 0;
+    for (; i + 4 <= numFrames; i += 4) {
+        const float32x4x2_t frames = vld2q_f32(pSrc + i * 2);
+        vst1q_f32(pDest1 + i, frames.val[0]);
+        vst1q_f32(pDest2 + i, frames.val[1]);
+    }
+    deinterleaveBufferScalar(pDest1, pDest2, pSrc, i, numFrames);
+}
+
+void mixMultichannelToStereoNeon(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames,
+        int numChannels,
+        int excludeChannelMask) {
+    const int stereoChCount = numChannels / 2;
+    SINT i = 0;
+    for (; i + 2 <= numFrames; i += 2) {
+        const CSAMPLE* pFrames = pSrc + numChannels * i;
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
+            if (excludeChannelMask >> stemIdx & 0b1) {
+                continue;
+            }
+            const CSAMPLE* pStem = pFrames + stemIdx * 2;
+            sum = vaddq_f32(sum,
+                    vcombine_f32(vld1_f32(pStem), vld1_f32(pStem + numChannels)));
+        }
+        vst1q_f32(pDest + i * 2, sum);
+    }
+    mixMultichannelToStereoScalar(
+            pDest, pSrc, i, numFrames, numChannels, excludeChannelMask);
+}
+
+void convertS16ToFloat32Neon(CSAMPLE* M_RESTRICT pDest,
+        const SAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        const int16x8_t samples = vld1q_s16(pSrc + i);
+        vst1q_f32(pDest + i,
+                vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))),
+                        kS16ConversionScale));
+        vst1q_f32(pDest + i + 4,
+                vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))),
+                        kS16ConversionScale));
+    }
+    convertS16ToFloat32Scalar(pDest, pSrc, i, numSamples);
+}
+
+inline int32x4_t convertToS32Neon(const CSAMPLE* pSrc) {
+    const float32x4_t scaled = vmulq_n_f32(vld1q_f32(pSrc), kS16ConversionFactor);
+    const float32x4_t clamped = vminq_f32(
+            vmaxq_f32(scaled, vdupq_n_f32(static_cast<CSAMPLE>(SAMPLE_MINIMUM))),
+            vdupq_n_f32(static_cast<CSAMPLE>(SAMPLE_MAXIMUM)));
+    // Truncates like static_cast
+    return vcvtq_s32_f32(clamped);
+}
+
+void convertFloat32ToS16Neon(SAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numSamples) {
+    SINT i = 0;
+    for (; i + 8 <= numSamples; i += 8) {
+        vst1q_s16(pDest + i,
+                vcombine_s16(vqmovn_s32(convertToS32Neon(pSrc + i)),
+                        vqmovn_s32(convertToS32Neon(pSrc + i + 4))));
+    }
+    convertFloat32ToS16Scalar(pDest, pSrc, i, numSamples);
+}
+
+constexpr SampleUtilKernels kNeonKernels = {
+        SimdLevel::NEON,
+        applyRampingGainNeon,
+        rampingGainNeon<RampMode::Copy>,
+        rampingGainNeon<RampMode::Add>,
+        copy2WithRampingGainNeon,
+        copy3WithRampingGainNeon,
+        interleaveBufferNeon,
+        deinterleaveBufferNeon,
+        mixMultichannelToStereoNeon,
+        convertS16ToFloat32Neon,
+        convertFloat32ToS16Neon,
+};
+
+#endif // MIXXX_SIMD_NEON
+
+SimdLevel detectBestSupportedLevel() {
+    for (const auto level : {
+                 SimdLevel::AVX512,
+                 SimdLevel::AVX2,
+                 SimdLevel::SSE41,
+                 SimdLevel::NEON,
+         }) {
+        if (simd::isSupported(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::Scalar;
+}
+
+std::atomic<const SampleUtilKernels*>& activeKernelsPtr() {
+    static std::atomic<const SampleUtilKernels*> s_pActiveKernels(
+            &simd::kernelsForLevel(simd::bestSupportedLevel()));
+    return s_pActiveKernels;
+}
+
+} // anonymous namespace
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return "Scalar";
+    case SimdLevel::SSE41:
+        return "SSE4.1";
+    case SimdLevel::AVX2:
+        return "AVX2";
+    case SimdLevel::AVX512:
+        return "AVX-512";
+    case SimdLevel::NEON:
+        return "NEON";
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return "";
+}
+
+namespace simd {
+
+bool isSupported(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return true;
+#if defined(MIXXX_SIMD_X86)
+    case SimdLevel::SSE41:
+    case SimdLevel::AVX2:
+    case SimdLevel::AVX512:
+        return cpuSupports(level);
+#endif
+#if defined(MIXXX_SIMD_NEON)
+    case SimdLevel::NEON:
+        // Always available if enabled at compile time
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+SimdLevel bestSupportedLevel() {
+    static const SimdLevel s_level = detectBestSupportedLevel();
+    return s_level;
+}
+
+const SampleUtilKernels& kernelsForLevel(SimdLevel level) {
+    VERIFY_OR_DEBUG_ASSERT(isSupported(level)) {
+        return kScalarKernels;
+    }
+    switch (level) {
+#if defined(MIXXX_SIMD_X86)
+    case SimdLevel::SSE41:
+        return kSse41Kernels;
+    case SimdLevel::AVX2:
+        return kAvx2Kernels;
+    case SimdLevel::AVX512:
+        return kAvx512Kernels;
+#endif
+#if defined(MIXXX_SIMD_NEON)
+    case SimdLevel::NEON:
+        return kNeonKernels;
+#endif
+    default:
+        return kScalarKernels;
+    }
+}
+
+const SampleUtilKernels& activeKernels() {
+    // The kernel tables are constants, no synchronization is needed
+    return *activeKernelsPtr().load(std::memory_order_relaxed);
+}
+
+bool setActiveLevel(SimdLevel level) {
+    if (!isSupported(level)) {
+        return false;
+    }
+    activeKernelsPtr().store(&kernelsForLevel(level), std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace simd
+
+} // namespace mixxx
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "util/types.h"
+
+namespace mixxx {
+
+/// Instruction set extensions that are used by the hand-vectorized
+/// kernels of SampleUtil.
+enum class SimdLevel {
+    Scalar,
+    SSE41,
+    AVX2,
+    AVX512,
+    NEON,
+};
+
+const char* simdLevelName(SimdLevel level);
+
+/// The kernels of SampleUtil that are implemented for each SimdLevel.
+///
+/// Ramping gains are passed as the gain of the first frame and the
+/// delta between two frames. All functions operate on unaligned
+/// buffers, numFrames and numSamples don't need to be a multiple
+/// of the vector size.
+struct SampleUtilKernels {
+    SimdLevel level;
+
+    void (*applyRampingGain)(CSAMPLE* pBuffer,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*copyWithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*addWithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN startGain,
+            CSAMPLE_GAIN gainDelta,
+            SINT numFrames);
+    void (*copy2WithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc0,
+            CSAMPLE_GAIN startGain0,
+            CSAMPLE_GAIN gainDelta0,
+            const CSAMPLE* pSrc1,
+            CSAMPLE_GAIN startGain1,
+            CSAMPLE_GAIN gainDelta1,
+            SINT numFrames);
+    void (*copy3WithRampingGain)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc0,
+            CSAMPLE_GAIN startGain0,
+            CSAMPLE_GAIN gainDelta0,
+            const CSAMPLE* pSrc1,
+            CSAMPLE_GAIN startGain1,
+            CSAMPLE_GAIN gainDelta1,
+            const CSAMPLE* pSrc2,
+            CSAMPLE_GAIN startGain2,
+            CSAMPLE_GAIN gainDelta2,
+            SINT numFrames);
+    void (*interleaveBuffer)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc1,
+            const CSAMPLE* pSrc2,
+            SINT numFrames);
+    void (*deinterleaveBuffer)(CSAMPLE* pDest1,
+            CSAMPLE* pDest2,
+            const CSAMPLE* pSrc,
+            SINT numFrames);
+    /// Overwrites pDest with the sum of all stereo channel pairs
+    /// that are not excluded by the mask.
+    void (*mixMultichannelToStereo)(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            SINT numFrames,
+            int numChannels,
+            int excludeChannelMask);
+    void (*convertS16ToFloat32)(CSAMPLE* pDest,
+            const SAMPLE* pSrc,
+            SINT numSamples);
+    void (*convertFloat32ToS16)(SAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            SINT numSamples);
+};
+
+namespace simd {
+
+/// Checks if the kernels for the level have been compiled in and are
+/// supported by the CPU and the operating system.
+bool isSupported(SimdLevel level);
+
+/// The best level that is supported on this machine. Detected
+/// once by querying the CPU features.
+SimdLevel bestSupportedLevel();
+
+/// The kernels for an arbitrary supported level, used for
+/// comparing the implementations in tests and benchmarks.
+const SampleUtilKernels& kernelsForLevel(SimdLevel level);
+
+/// The kernels that are used by SampleUtil. Defaults to
+/// bestSupportedLevel().
+const SampleUtilKernels& activeKernels();
+
+/// Overrides the kernels that are used by SampleUtil. Returns false
+/// and leaves the active kernels unchanged if the level is not
+/// supported.
+bool setActiveLevel(SimdLevel level);
+
+} // namespace simd
+
+} // namespace mixxx
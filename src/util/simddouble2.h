@@ -0,0 +1,159 @@
+#pragma once
+
+#include "util/types.h"
+
+#if !defined(__EMSCRIPTEN__) &&                 \
+        (defined(__SSE2__) || defined(_M_X64) || \
+                (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MIXXX_SIMDDOUBLE2_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define MIXXX_SIMDDOUBLE2_NEON
+#include <arm_neon.h>
+#endif
+
+namespace mixxx {
+
+/// Two double lanes that are processed with a single instruction, used
+/// for running the same recursive filter over the left and the right
+/// channel at once.
+///
+/// SSE2 is part of the x86-64 baseline and NEON of AArch64, so unlike
+/// the kernels in util/samplesimd.h no runtime dispatch is required.
+/// Each lane is calculated with exactly the same IEEE operations as the
+/// equivalent scalar code, i.e. the results are identical.
+class SimdDouble2 {
+  public:
+    SimdDouble2() = default;
+
+    static SimdDouble2 broadcast(double value) {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        return SimdDouble2(_mm_set1_pd(value));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        return SimdDouble2(vdupq_n_f64(value));
+#else
+        return SimdDouble2(value, value);
+#endif
+    }
+
+    static SimdDouble2 zero() {
+        return broadcast(0.0);
+    }
+
+    /// Loads a stereo frame and converts it to double
+    static SimdDouble2 fromFrame(const CSAMPLE* pFrame) {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        return SimdDouble2(_mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)))));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        return SimdDouble2(vcvt_f64_f32(vld1_f32(pFrame)));
+#else
+        return SimdDouble2(pFrame[0], pFrame[1]);
+#endif
+    }
+
+    /// Converts both lanes to CSAMPLE and stores them as a stereo frame
+    void storeFrame(CSAMPLE* pFrame) const {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pFrame),
+                _mm_castps_si128(_mm_cvtpd_ps(m_value)));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        vst1_f32(pFrame, vcvt_f32_f64(m_value));
+#else
+        pFrame[0] = static_cast<CSAMPLE>(m_lane0);
+        pFrame[1] = static_cast<CSAMPLE>(m_lane1);
+#endif
+    }
+
+    /// Rounds both lanes to the precision of CSAMPLE, like
+    /// static_cast<double>(static_cast<CSAMPLE>(value)) does.
+    SimdDouble2 roundedToSample() const {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        return SimdDouble2(_mm_cvtps_pd(_mm_cvtpd_ps(m_value)));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        return SimdDouble2(vcvt_f64_f32(vcvt_f32_f64(m_value)));
+#else
+        return SimdDouble2(static_cast<CSAMPLE>(m_lane0),
+                static_cast<CSAMPLE>(m_lane1));
+#endif
+    }
+
+    friend SimdDouble2 operator+(SimdDouble2 a, SimdDouble2 b) {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        return SimdDouble2(_mm_add_pd(a.m_value, b.m_value));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        return SimdDouble2(vaddq_f64(a.m_value, b.m_value));
+#else
+        return SimdDouble2(a.m_lane0 + b.m_lane0, a.m_lane1 + b.m_lane1);
+#endif
+    }
+
+    friend SimdDouble2 operator-(SimdDouble2 a, SimdDouble2 b) {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        return SimdDouble2(_mm_sub_pd(a.m_value, b.m_value));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        return SimdDouble2(vsubq_f64(a.m_value, b.m_value));
+#else
+        return SimdDouble2(a.m_lane0 - b.m_lane0, a.m_lane1 - b.m_lane1);
+#endif
+    }
+
+    friend SimdDouble2 operator*(SimdDouble2 a, SimdDouble2 b) {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        return SimdDouble2(_mm_mul_pd(a.m_value, b.m_value));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        return SimdDouble2(vmulq_f64(a.m_value, b.m_value));
+#else
+        return SimdDouble2(a.m_lane0 * b.m_lane0, a.m_lane1 * b.m_lane1);
+#endif
+    }
+
+    friend SimdDouble2 operator-(SimdDouble2 a) {
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+        // Flip the sign bit like the scalar negation, 0.0 - a would
+        // turn -0.0 into 0.0.
+        return SimdDouble2(_mm_xor_pd(a.m_value, _mm_set1_pd(-0.0)));
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+        return SimdDouble2(vnegq_f64(a.m_value));
+#else
+        return SimdDouble2(-a.m_lane0, -a.m_lane1);
+#endif
+    }
+
+    SimdDouble2& operator+=(SimdDouble2 other) {
+        return *this = *this + other;
+    }
+
+    SimdDouble2& operator-=(SimdDouble2 other) {
+        return *this = *this - other;
+    }
+
+    SimdDouble2& operator*=(SimdDouble2 other) {
+        return *this = *this * other;
+    }
+
+  private:
+#if defined(MIXXX_SIMDDOUBLE2_SSE2)
+    explicit SimdDouble2(__m128d value)
+            : m_value(value) {
+    }
+
+    __m128d m_value;
+#elif defined(MIXXX_SIMDDOUBLE2_NEON)
+    explicit SimdDouble2(float64x2_t value)
+            : m_value(value) {
+    }
+
+    float64x2_t m_value;
+#else
+    SimdDouble2(double lane0, double lane1)
+            : m_lane0(lane0),
+              m_lane1(lane1) {
+    }
+
+    double m_lane0;
+    double m_lane1;
+#endif
+};
+
+} // namespace mixxx
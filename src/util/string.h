@@ -29,6 +29,12 @@ class StringCollator {
         return m_collator.compare(s1, s2);
     }
 
+    /// Comparing sort keys is faster when the same strings are compared
+    /// many times, e.g. for sorting.
+    QCollatorSortKey sortKey(const QString& string) const {
+        return m_collator.sortKey(string);
+    }
+
   private:
     QCollator m_collator;
 };
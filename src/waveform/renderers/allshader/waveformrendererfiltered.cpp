@@ -70,12 +70,17 @@ bool WaveformRendererFiltered::preprocessInner() {
 
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
     const int visualFramesSize = dataSize / 2;
-    const double firstVisualFrame =
-            m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
-    const double lastVisualFrame =
-            m_waveformRenderer->getLastDisplayedPosition() * visualFramesSize;
-
-    // Represents the # of visual frames per horizontal pixel.
+    const double firstDisplayedPosition = m_waveformRenderer->getFirstDisplayedPosition();
+    const double lastDisplayedPosition = m_waveformRenderer->getLastDisplayedPosition();
+    const WaveformSummaryLevel summaryLevel = waveform->getSummaryLevelForPixel(
+            (lastDisplayedPosition - firstDisplayedPosition) * visualFramesSize /
+            static_cast<double>(pixelLength));
+    const double levelFramesSize =
+            static_cast<double>(visualFramesSize) / summaryLevel.framesPerValue;
+    const double firstVisualFrame = firstDisplayedPosition * levelFramesSize;
+    const double lastVisualFrame = lastDisplayedPosition * levelFramesSize;
+
+    // Represents the # of frames of the summary level per horizontal pixel.
     const double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(pixelLength);
 
@@ -149,7 +154,8 @@ bool WaveformRendererFiltered::preprocessInner() {
 
         const int visualIndexStart = std::max(visualFrameStart * 2, 0);
         const int visualIndexStop =
-                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2,
+                        summaryLevel.dataSize - 1);
 
         const float fpos = static_cast<float>(pos) * invDevicePixelRatio;
 
@@ -158,7 +164,7 @@ bool WaveformRendererFiltered::preprocessInner() {
         uchar u8max[3][2]{};
         for (int chn = 0; chn < 2; chn++) {
             for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
+                const WaveformData& waveformData = summaryLevel.data[i];
 
                 u8max[0][chn] = math_max(u8max[0][chn], waveformData.filtered.low);
                 u8max[1][chn] = math_max(u8max[1][chn], waveformData.filtered.mid);
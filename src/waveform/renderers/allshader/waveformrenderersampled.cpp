@@ -0,0 +1,177 @@
+#include "waveform/renderers/allshader/waveformrenderersampled.h"
+
+#include <array>
+
+#include "track/track.h"
+#include "waveform/renderers/allshader/matrixforwidgetgeometry.h"
+#include "waveform/renderers/allshader/waveformtexture.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+#include "waveform/waveform.h"
+
+namespace allshader {
+
+WaveformRendererSampled::WaveformRendererSampled(
+        WaveformWidgetRenderer* waveformWidget,
+        ::WaveformWidgetType::Type type,
+        ::WaveformRendererAbstract::PositionSource positionSource,
+        ::WaveformRendererSignalBase::Options options)
+        : WaveformRendererSignalBase(waveformWidget, options),
+          m_type(type),
+          m_isSlipRenderer(positionSource == ::WaveformRendererAbstract::Slip),
+          m_options(options) {
+    DEBUG_ASSERT(m_type == ::WaveformWidgetType::RGB ||
+            m_type == ::WaveformWidgetType::Filtered ||
+            m_type == ::WaveformWidgetType::Stacked);
+}
+
+void WaveformRendererSampled::onSetup(const QDomNode&) {
+}
+
+void WaveformRendererSampled::initializeGL() {
+    m_shader.init(m_type == ::WaveformWidgetType::RGB
+                    ? mixxx::WaveformSignalShader::Type::RGB
+                    : mixxx::WaveformSignalShader::Type::Filtered);
+}
+
+void WaveformRendererSampled::paintGL() {
+    TrackPointer pTrack = m_waveformRenderer->getTrackInfo();
+    if (!pTrack || (m_isSlipRenderer && !m_waveformRenderer->isSlipActive())) {
+        return;
+    }
+
+    auto positionType = m_isSlipRenderer ? ::WaveformRendererAbstract::Slip
+                                         : ::WaveformRendererAbstract::Play;
+
+    ConstWaveformPointer pWaveform = pTrack->getWaveform();
+    if (pWaveform.isNull()) {
+        return;
+    }
+
+    const int dataSize = pWaveform->getDataSize();
+    if (dataSize <= 1) {
+        return;
+    }
+#ifdef __STEM__
+    auto stemInfo = pTrack->getStemInfo();
+    // If this track is a stem track, skip the rendering
+    if (!stemInfo.isEmpty() && pWaveform->hasStem() && !m_ignoreStem) {
+        return;
+    }
+#endif
+
+    const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
+    const auto length = static_cast<float>(m_waveformRenderer->getLength());
+    const int pixelLength = static_cast<int>(length * devicePixelRatio);
+    if (pixelLength <= 0) {
+        return;
+    }
+
+    // The track's waveform is replaced when it is analyzed again or loaded
+    // from the library, so this also picks up the new one. Only uploads
+    // what was analyzed since the last frame, if this wasn't already done
+    // by another renderer of the same waveform.
+    if (!m_pTexture || m_pTexture->waveform() != pWaveform) {
+        m_pTexture = WaveformTexture::forWaveform(pWaveform);
+    }
+    m_pTexture->update();
+
+    // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
+    const int visualFramesSize = dataSize / 2;
+    const double firstDisplayedPosition =
+            m_waveformRenderer->getFirstDisplayedPosition(positionType);
+    const double lastDisplayedPosition =
+            m_waveformRenderer->getLastDisplayedPosition(positionType);
+    const WaveformTexture::Level level = m_pTexture->levelForPixel(
+            (lastDisplayedPosition - firstDisplayedPosition) * visualFramesSize /
+            static_cast<double>(pixelLength));
+    const double levelFramesSize =
+            static_cast<double>(visualFramesSize) / level.framesPerValue;
+    const double firstVisualFrame = firstDisplayedPosition * levelFramesSize;
+    const double lastVisualFrame = lastDisplayedPosition * levelFramesSize;
+
+    // Represents the # of frames of the summary level per horizontal pixel.
+    const double visualIncrementPerPixel =
+            (lastVisualFrame - firstVisualFrame) / static_cast<double>(pixelLength);
+
+    // Per-band gain from the EQ knobs.
+    float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
+    // The RGB waveform is not compensated, as it is scaled to match filtered.all
+    getGains(&allGain, m_type != ::WaveformWidgetType::RGB, &lowGain, &midGain, &highGain);
+
+    const auto breadth = static_cast<float>(m_waveformRenderer->getBreadth());
+
+    QVector3D lowColor;
+    QVector3D midColor;
+    QVector3D highColor;
+    if (m_type == ::WaveformWidgetType::Filtered) {
+        lowColor = QVector3D(m_lowColor_r, m_lowColor_g, m_lowColor_b);
+        midColor = QVector3D(m_midColor_r, m_midColor_g, m_midColor_b);
+        highColor = QVector3D(m_highColor_r, m_highColor_g, m_highColor_b);
+    } else {
+        lowColor = QVector3D(m_rgbLowColor_r, m_rgbLowColor_g, m_rgbLowColor_b);
+        midColor = QVector3D(m_rgbMidColor_r, m_rgbMidColor_g, m_rgbMidColor_b);
+        highColor = QVector3D(m_rgbHighColor_r, m_rgbHighColor_g, m_rgbHighColor_b);
+    }
+
+    // A single quad, the texture coordinates are the frames of the summary
+    // level and the signed distance from the axis.
+    const auto firstFrame = static_cast<float>(firstVisualFrame);
+    const auto lastFrame = static_cast<float>(lastVisualFrame);
+    const std::array<float, 8> positionArray = {
+            0.f, 0.f, length, 0.f, 0.f, breadth, length, breadth};
+    const std::array<float, 8> texcoordArray = {
+            firstFrame, -1.f, lastFrame, -1.f, firstFrame, 1.f, lastFrame, 1.f};
+
+    const QMatrix4x4 matrix = matrixForWidgetGeometry(m_waveformRenderer, false);
+
+    m_shader.bind();
+
+    const int positionLocation = m_shader.positionLocation();
+    const int texcoordLocation = m_shader.texcoordLocation();
+
+    m_shader.setUniformValue(m_shader.matrixLocation(), matrix);
+    m_shader.setUniformValue(m_shader.textureLocation(), 0);
+    m_shader.setUniformValue(m_shader.textureSizeLocation(),
+            QVector2D(static_cast<float>(level.textureWidth),
+                    static_cast<float>(level.textureHeight)));
+    m_shader.setUniformValue(m_shader.levelOffsetLocation(),
+            static_cast<float>(level.offset));
+    m_shader.setUniformValue(m_shader.levelDataSizeLocation(),
+            static_cast<float>(level.dataSize));
+    m_shader.setUniformValue(m_shader.framesPerPixelLocation(),
+            static_cast<float>(visualIncrementPerPixel));
+    m_shader.setUniformValue(m_shader.halfBreadthLocation(), breadth / 2.f);
+    m_shader.setUniformValue(m_shader.splitStereoSignalLocation(),
+            static_cast<GLint>(m_options.testFlag(
+                    ::WaveformRendererSignalBase::Option::SplitStereoSignal)));
+    m_shader.setUniformValue(m_shader.upperHalfOnlyLocation(),
+            static_cast<GLint>(m_isSlipRenderer));
+    m_shader.setUniformValue(m_shader.allGainLocation(), allGain);
+    m_shader.setUniformValue(m_shader.bandGainsLocation(),
+            QVector3D(lowGain, midGain, highGain));
+    m_shader.setUniformValue(m_shader.axesColorLocation(),
+            QVector3D(m_axesColor_r, m_axesColor_g, m_axesColor_b));
+    m_shader.setUniformValue(m_shader.lowColorLocation(), lowColor);
+    m_shader.setUniformValue(m_shader.midColorLocation(), midColor);
+    m_shader.setUniformValue(m_shader.highColorLocation(), highColor);
+
+    m_shader.enableAttributeArray(positionLocation);
+    m_shader.enableAttributeArray(texcoordLocation);
+    m_shader.setAttributeArray(
+            positionLocation, GL_FLOAT, positionArray.data(), 2);
+    m_shader.setAttributeArray(
+            texcoordLocation, GL_FLOAT, texcoordArray.data(), 2);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, level.textureId);
+
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_shader.disableAttributeArray(positionLocation);
+    m_shader.disableAttributeArray(texcoordLocation);
+    m_shader.release();
+}
+
+} // namespace allshader
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+
+#include "rendergraph/openglnode.h"
+#include "shaders/waveformsignalshader.h"
+#include "util/class.h"
+#include "waveform/renderers/allshader/waveformrenderersignalbase.h"
+#include "waveform/widgets/waveformwidgettype.h"
+
+namespace allshader {
+class WaveformRendererSampled;
+class WaveformTexture;
+} // namespace allshader
+
+/// Renders the RGB, Filtered and Stacked waveforms by sampling the
+/// WaveformTexture that is shared by all renderers of the same waveform.
+/// Unlike WaveformRendererRGB and WaveformRendererFiltered, which build
+/// the vertices of every pixel column on the CPU, only a single quad and
+/// a few uniforms are passed to the shader per frame.
+///
+/// WaveformRendererRGB and WaveformRendererFiltered are still used for QML,
+/// which doesn't render through raw OpenGL nodes.
+class allshader::WaveformRendererSampled final
+        : public allshader::WaveformRendererSignalBase,
+          public rendergraph::OpenGLNode {
+  public:
+    explicit WaveformRendererSampled(WaveformWidgetRenderer* waveformWidget,
+            ::WaveformWidgetType::Type type,
+            ::WaveformRendererAbstract::PositionSource positionSource =
+                    ::WaveformRendererAbstract::Play,
+            ::WaveformRendererSignalBase::Options options =
+                    ::WaveformRendererSignalBase::Option::None);
+
+    // Pure virtual from WaveformRendererSignalBase, not used
+    void onSetup(const QDomNode& node) override;
+
+    void initializeGL() override;
+    void paintGL() override;
+
+    // Like the vertex based renderers, the filtered waveforms don't
+    // support slip
+    bool supportsSlip() const override {
+        return m_type == ::WaveformWidgetType::RGB;
+    }
+
+  private:
+    const ::WaveformWidgetType::Type m_type;
+    const bool m_isSlipRenderer;
+    const ::WaveformRendererSignalBase::Options m_options;
+
+    // Shared with the other renderers of the same waveform
+    std::shared_ptr<WaveformTexture> m_pTexture;
+    mixxx::WaveformSignalShader m_shader;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformRendererSampled);
+};
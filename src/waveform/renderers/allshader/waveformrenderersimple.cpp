@@ -70,13 +70,24 @@ bool WaveformRendererSimple::preprocessInner() {
     // WaveformData* data contains the L and R waveform values interleaved. In the calculations
     // below, 'frame' refers to the index of such an L-R pair.
     const int visualFramesSize = dataSize / 2;
+    const double firstDisplayedPosition = m_waveformRenderer->getFirstDisplayedPosition();
+    const double lastDisplayedPosition = m_waveformRenderer->getLastDisplayedPosition();
+
+    // When zoomed out, thousands of visual frames end up in a single pixel.
+    // They are not aggregated here, but read from the summary level of the
+    // waveform that has at least one frame per pixel, see
+    // Waveform::getSummaryLevelForPixel(). Below, 'frame' refers to a frame
+    // of that level, which is a visual frame when zoomed in.
+    const WaveformSummaryLevel summaryLevel = waveform->getSummaryLevelForPixel(
+            (lastDisplayedPosition - firstDisplayedPosition) * visualFramesSize /
+            static_cast<double>(pixelLength));
+    const double levelFramesSize =
+            static_cast<double>(visualFramesSize) / summaryLevel.framesPerValue;
     // Calculate the first and last frame to draw, from the normalized display position
-    const double firstVisualFrame =
-            m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
-    const double lastVisualFrame =
-            m_waveformRenderer->getLastDisplayedPosition() * visualFramesSize;
+    const double firstVisualFrame = firstDisplayedPosition * levelFramesSize;
+    const double lastVisualFrame = lastDisplayedPosition * levelFramesSize;
 
-    // Represents the # of visual frames per horizontal pixel.
+    // Represents the # of frames of the summary level per horizontal pixel.
     const double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(pixelLength);
 
@@ -122,7 +133,8 @@ bool WaveformRendererSimple::preprocessInner() {
 
         const int visualIndexStart = std::max(visualFrameStart * 2, 0);
         const int visualIndexStop =
-                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+                std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2,
+                        summaryLevel.dataSize - 1);
 
         const float fpos = static_cast<float>(pos) * invDevicePixelRatio;
 
@@ -131,7 +143,7 @@ bool WaveformRendererSimple::preprocessInner() {
         for (int chn = 0; chn < 2; chn++) {
             // data is interleaved left / right
             for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
+                const WaveformData& waveformData = summaryLevel.data[i];
 
                 u8maxAllChn[chn] = math_max(u8maxAllChn[chn], waveformData.filtered.all);
             }
@@ -150,12 +150,19 @@ bool WaveformRendererStem::preprocessInner() {
 
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
     const int visualFramesSize = dataSize / 2;
-    const double firstVisualFrame =
-            m_waveformRenderer->getFirstDisplayedPosition(positionType) * visualFramesSize;
-    const double lastVisualFrame =
-            m_waveformRenderer->getLastDisplayedPosition(positionType) * visualFramesSize;
-
-    // Represents the # of visual frames per horizontal pixel.
+    const double firstDisplayedPosition =
+            m_waveformRenderer->getFirstDisplayedPosition(positionType);
+    const double lastDisplayedPosition =
+            m_waveformRenderer->getLastDisplayedPosition(positionType);
+    const WaveformSummaryLevel summaryLevel = waveform->getSummaryLevelForPixel(
+            (lastDisplayedPosition - firstDisplayedPosition) * visualFramesSize /
+            static_cast<double>(stripLength));
+    const double levelFramesSize =
+            static_cast<double>(visualFramesSize) / summaryLevel.framesPerValue;
+    const double firstVisualFrame = firstDisplayedPosition * levelFramesSize;
+    const double lastVisualFrame = lastDisplayedPosition * levelFramesSize;
+
+    // Represents the # of frames of the summary level per horizontal pixel.
     const double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(stripLength);
 
@@ -208,7 +215,8 @@ bool WaveformRendererStem::preprocessInner() {
 
                 const int visualIndexStart = std::max(visualFrameStart * 2, 0);
                 const int visualIndexStop =
-                        std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2, dataSize - 1);
+                        std::min(std::max(visualFrameStop, visualFrameStart + 1) * 2,
+                                summaryLevel.dataSize - 1);
 
                 const float fVisualIdx = static_cast<float>(visualIdx) * invDevicePixelRatio;
 
@@ -218,7 +226,7 @@ bool WaveformRendererStem::preprocessInner() {
                 for (int chn = 0; chn < 2; chn++) {
                     // data is interleaved left / right
                     for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                        const WaveformData& waveformData = data[i];
+                        const WaveformData& waveformData = summaryLevel.data[i];
 
                         u8max = math_max(u8max, waveformData.stems[stemIdx]);
                     }
@@ -7,6 +7,7 @@
 
 #include "moc_waveformrenderertextured.cpp"
 #include "track/track.h"
+#include "waveform/renderers/allshader/waveformtexture.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
 
 namespace allshader {
@@ -34,8 +35,6 @@ WaveformRendererTextured::WaveformRendererTextured(
         ::WaveformRendererSignalBase::Options options)
         : WaveformRendererSignalBase(waveformWidget, options),
           m_unitQuadListId(-1),
-          m_textureId(0),
-          m_textureRenderedWaveformCompletion(0),
           m_isSlipRenderer(type == ::WaveformRendererAbstract::Slip),
           m_options(options),
           m_shadersValid(false),
@@ -44,10 +43,6 @@ WaveformRendererTextured::WaveformRendererTextured(
 }
 
 WaveformRendererTextured::~WaveformRendererTextured() {
-    if (m_textureId) {
-        glDeleteTextures(1, &m_textureId);
-    }
-
     if (m_frameShaderProgram) {
         m_frameShaderProgram->removeAllShaders();
     }
@@ -94,76 +89,19 @@ bool WaveformRendererTextured::loadShaders() {
     return true;
 }
 
-bool WaveformRendererTextured::loadTexture() {
-    int dataSize = 0;
-    const WaveformData* data = nullptr;
-
+void WaveformRendererTextured::loadTexture() {
     ConstWaveformPointer pWaveform = m_waveformRenderer->getWaveform();
-    if (pWaveform) {
-        dataSize = pWaveform->getDataSize();
-        if (dataSize > 1) {
-            data = pWaveform->data();
-        }
-    }
-
-    glEnable(GL_TEXTURE_2D);
-
-    if (m_textureId == 0) {
-        glGenTextures(1, &m_textureId);
-
-        int error = glGetError();
-        if (error) {
-            qDebug() << "WaveformRendererTextured::loadTexture - m_textureId"
-                     << m_textureId << "error" << error;
-        }
-    }
-
-    glBindTexture(GL_TEXTURE_2D, m_textureId);
-
-    int error = glGetError();
-    if (error) {
-        qDebug() << "WaveformRendererTextured::loadTexture - bind error" << error;
+    if (pWaveform.isNull() || pWaveform->getDataSize() <= 1) {
+        m_pTexture.reset();
+        return;
     }
 
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-
-    if (pWaveform != nullptr && data != nullptr) {
-        // Make a copy of the waveform data, stripping the stems portion. Note that the datasize is
-        // different from the texture size -- we want the full texture size so the upload works. See
-        // m_data in waveform/waveform.h.
-        if (m_data.size() == 0 || static_cast<int>(m_data.size()) != pWaveform->getTextureSize()) {
-            m_data.resize(pWaveform->getTextureSize());
-        }
-        for (int i = 0; i < pWaveform->getDataSize(); i++) {
-            m_data[i] = data[i].filtered;
-        }
-        // Waveform ensures that getTextureSize is a multiple of
-        // getTextureStride so there is no rounding here.
-        int textureWidth = pWaveform->getTextureStride();
-        int textureHeight = pWaveform->getTextureSize() / pWaveform->getTextureStride();
-
-        glTexImage2D(GL_TEXTURE_2D,
-                0,
-                GL_RGBA,
-                textureWidth,
-                textureHeight,
-                0,
-                GL_RGBA,
-                GL_UNSIGNED_BYTE,
-                m_data.data());
-        int error = glGetError();
-        VERIFY_OR_DEBUG_ASSERT(!error) {
-            qWarning() << "WaveformRendererTextured::loadTexture - glTexImage2D error" << error;
-        }
-    } else {
-        glDeleteTextures(1, &m_textureId);
-        m_textureId = 0;
+    // The track's waveform is replaced when it is analyzed again or loaded
+    // from the library, so this also picks up the new one.
+    if (!m_pTexture || m_pTexture->waveform() != pWaveform) {
+        m_pTexture = WaveformTexture::forWaveform(pWaveform);
     }
-
-    glDisable(GL_TEXTURE_2D);
-
-    return true;
+    m_pTexture->update();
 }
 
 void WaveformRendererTextured::createGeometry() {
@@ -219,8 +157,6 @@ void WaveformRendererTextured::createFrameBuffers() {
 }
 
 void WaveformRendererTextured::initializeGL() {
-    m_textureRenderedWaveformCompletion = 0;
-
     if (!m_frameShaderProgram) {
         m_frameShaderProgram = std::make_unique<QOpenGLShaderProgram>();
     }
@@ -230,53 +166,16 @@ void WaveformRendererTextured::initializeGL() {
     }
     createFrameBuffers();
     createGeometry();
-    if (!loadTexture()) {
-        return;
-    }
+    loadTexture();
 }
 
 void WaveformRendererTextured::onSetup(const QDomNode&) {
 }
 
-void WaveformRendererTextured::onSetTrack() {
-    if (m_loadedTrack) {
-        disconnect(m_loadedTrack.get(),
-                &Track::waveformUpdated,
-                this,
-                &WaveformRendererTextured::slotWaveformUpdated);
-    }
-
-    slotWaveformUpdated();
-
-    const TrackPointer pTrack = m_waveformRenderer->getTrackInfo();
-    if (!pTrack) {
-        return;
-    }
-
-    // When the track's waveform has been changed (or cleared), it is necessary
-    // to update (or delete) the texture containing the waveform which was
-    // uploaded to GPU. Otherwise, previous waveform will be shown.
-    connect(pTrack.get(),
-            &Track::waveformUpdated,
-            this,
-            &WaveformRendererTextured::slotWaveformUpdated);
-
-    m_loadedTrack = pTrack;
-}
-
 void WaveformRendererTextured::resizeGL(int, int) {
     createFrameBuffers();
 }
 
-void WaveformRendererTextured::slotWaveformUpdated() {
-    m_textureRenderedWaveformCompletion = 0;
-    // initializeGL not called yet
-    if (!m_frameShaderProgram) {
-        return;
-    }
-    loadTexture();
-}
-
 void WaveformRendererTextured::paintGL() {
     TrackPointer pTrack = m_waveformRenderer->getTrackInfo();
     if (!pTrack || (m_isSlipRenderer && !m_waveformRenderer->isSlipActive())) {
@@ -317,13 +216,9 @@ void WaveformRendererTextured::paintGL() {
         return;
     }
 
-    // NOTE(vRince): completion can change during loadTexture
-    // do not remove currentCompletion temp variable !
-    const int currentCompletion = pWaveform->getCompletion();
-    if (m_textureRenderedWaveformCompletion < currentCompletion) {
-        loadTexture();
-        m_textureRenderedWaveformCompletion = currentCompletion;
-    }
+    // Uploads only what was analyzed since the last frame, if this wasn't
+    // already done by another renderer of the same waveform.
+    loadTexture();
 
     // Per-band gain from the EQ knobs.
     float lowGain(1.0), midGain(1.0), highGain(1.0), allGain(1.0);
@@ -441,9 +336,7 @@ void WaveformRendererTextured::paintGL() {
         }
 
         glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, m_textureId);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, m_pTexture->textureId());
 
         m_framebuffer->bind();
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
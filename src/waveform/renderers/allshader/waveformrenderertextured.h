@@ -2,10 +2,10 @@
 
 #ifndef QT_OPENGL_ES_2
 
+#include <memory>
+
 #include "rendergraph/openglnode.h"
-#include "track/track_decl.h"
 #include "waveform/renderers/allshader/waveformrenderersignalbase.h"
-#include "waveform/waveform.h"
 #include "waveform/widgets/waveformwidgettype.h"
 
 class QOpenGLFramebufferObject;
@@ -13,6 +13,7 @@ class QOpenGLShaderProgram;
 
 namespace allshader {
 class WaveformRendererTextured;
+class WaveformTexture;
 } // namespace allshader
 
 // Based on GLSLWaveformRendererSignal (waveform/renderers/glslwaveformrenderersignal.h)
@@ -39,33 +40,18 @@ class allshader::WaveformRendererTextured final : public allshader::WaveformRend
         return true;
     }
 
-    void onSetTrack() override;
-
-  public slots:
-    void slotWaveformUpdated();
-
   private:
-    struct WaveformTexture {
-        unsigned char low;
-        unsigned char mid;
-        unsigned char high;
-        unsigned char all;
-    };
-
     static QString fragShaderForType(WaveformWidgetType::Type t);
     bool loadShaders();
-    bool loadTexture();
+    void loadTexture();
 
     void createGeometry();
     void createFrameBuffers();
 
     GLint m_unitQuadListId;
-    GLuint m_textureId;
-
-    TrackPointer m_loadedTrack;
-    int m_textureRenderedWaveformCompletion;
 
-    std::vector<WaveformFilteredData> m_data;
+    // Shared with the other renderers of the same waveform
+    std::shared_ptr<WaveformTexture> m_pTexture;
 
     // Frame buffer for two pass rendering.
     std::unique_ptr<QOpenGLFramebufferObject> m_framebuffer;
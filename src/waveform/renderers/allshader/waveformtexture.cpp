@@ -0,0 +1,184 @@
+#include "waveform/renderers/allshader/waveformtexture.h"
+
+#include <algorithm>
+#include <map>
+
+namespace allshader {
+
+// static
+std::shared_ptr<WaveformTexture> WaveformTexture::forWaveform(
+        const ConstWaveformPointer& pWaveform) {
+    // Each texture keeps its waveform alive, so the address of a waveform
+    // is not reused as long as its entry isn't expired.
+    static std::map<const Waveform*, std::weak_ptr<WaveformTexture>> s_textures;
+    for (auto it = s_textures.begin(); it != s_textures.end();) {
+        if (it->second.expired()) {
+            it = s_textures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    std::weak_ptr<WaveformTexture>& pCached = s_textures[pWaveform.data()];
+    std::shared_ptr<WaveformTexture> pTexture = pCached.lock();
+    if (!pTexture) {
+        pTexture = std::shared_ptr<WaveformTexture>(new WaveformTexture(pWaveform));
+        pCached = pTexture;
+    }
+    return pTexture;
+}
+
+WaveformTexture::WaveformTexture(ConstWaveformPointer pWaveform)
+        : m_pWaveform(std::move(pWaveform)),
+          m_textureId(0),
+          m_summaryTextureId(0),
+          m_uploadedCompletion(0) {
+    initializeOpenGLFunctions();
+
+    // The completion can change during the upload, so everything after the
+    // completion at this point is uploaded again by the next update.
+    const int completion = m_pWaveform->getCompletion();
+
+    // Waveform ensures that getTextureSize is a multiple of
+    // getTextureStride so there is no rounding here.
+    const int textureWidth = m_pWaveform->getTextureStride();
+    const int textureHeight = m_pWaveform->getTextureSize() / textureWidth;
+    m_textureId = createTexture(textureWidth, textureHeight);
+    m_levels.push_back(Level{m_textureId,
+            textureWidth,
+            textureHeight,
+            0,
+            m_pWaveform->getDataSize(),
+            1});
+
+    // Each level starts at a new row, so the completed rows of one level
+    // can be uploaded without touching the neighboring levels.
+    int summaryTextureHeight = 0;
+    for (int levelIndex = 1; levelIndex < m_pWaveform->getSummaryLevelCount(); ++levelIndex) {
+        const WaveformSummaryLevel summaryLevel = m_pWaveform->getSummaryLevel(levelIndex);
+        m_levels.push_back(Level{0,
+                textureWidth,
+                0,
+                summaryTextureHeight * textureWidth,
+                summaryLevel.dataSize,
+                summaryLevel.framesPerValue});
+        summaryTextureHeight += (summaryLevel.dataSize + textureWidth - 1) / textureWidth;
+    }
+    if (summaryTextureHeight > 0) {
+        m_summaryTextureId = createTexture(textureWidth, summaryTextureHeight);
+        for (auto it = m_levels.begin() + 1; it != m_levels.end(); ++it) {
+            it->textureId = m_summaryTextureId;
+            it->textureHeight = summaryTextureHeight;
+        }
+    }
+
+    // Also fills the padding after the data of each level
+    uploadLevel(0, 0, m_pWaveform->getTextureSize());
+    for (int levelIndex = 1; levelIndex < static_cast<int>(m_levels.size()); ++levelIndex) {
+        uploadLevel(levelIndex, 0, m_levels[levelIndex].dataSize);
+    }
+    m_uploadedCompletion = completion;
+}
+
+WaveformTexture::~WaveformTexture() {
+    glDeleteTextures(1, &m_textureId);
+    if (m_summaryTextureId) {
+        glDeleteTextures(1, &m_summaryTextureId);
+    }
+}
+
+GLuint WaveformTexture::createTexture(int width, int height) {
+    GLuint textureId = 0;
+    glGenTextures(1, &textureId);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    // Required for textures that aren't a power of two in size on OpenGL ES
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D,
+            0,
+            GL_RGBA,
+            width,
+            height,
+            0,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            nullptr);
+    return textureId;
+}
+
+WaveformTexture::Level WaveformTexture::levelForPixel(double visualFramesPerPixel) const {
+    const int framesPerValue =
+            m_pWaveform->getSummaryLevelForPixel(visualFramesPerPixel).framesPerValue;
+    for (const auto& level : m_levels) {
+        if (level.framesPerValue == framesPerValue) {
+            return level;
+        }
+    }
+    DEBUG_ASSERT(!"summary level without texture");
+    return m_levels.front();
+}
+
+void WaveformTexture::update() {
+    const int completion = m_pWaveform->getCompletion();
+    if (completion <= m_uploadedCompletion) {
+        return;
+    }
+    // Starts with the row that was only partially completed the last time
+    uploadLevel(0, m_uploadedCompletion, completion);
+
+    // The analyzer has also updated the summary frames that
+    // aggregate the new frames, see Waveform::updateSummaryLevels().
+    int firstFrame = m_uploadedCompletion / ChannelCount;
+    int endFrame = (completion + ChannelCount - 1) / ChannelCount;
+    for (int levelIndex = 1; levelIndex < static_cast<int>(m_levels.size()); ++levelIndex) {
+        firstFrame /= Waveform::kSummaryLevelFactor;
+        endFrame = (endFrame + Waveform::kSummaryLevelFactor - 1) /
+                Waveform::kSummaryLevelFactor;
+        uploadLevel(levelIndex,
+                firstFrame * ChannelCount,
+                std::min(endFrame * ChannelCount, m_levels[levelIndex].dataSize));
+    }
+    m_uploadedCompletion = completion;
+}
+
+void WaveformTexture::uploadLevel(int levelIndex, int begin, int end) {
+    const Level& level = m_levels[levelIndex];
+    const int firstRow = (level.offset + begin) / level.textureWidth;
+    const int endRow = std::min(
+            (level.offset + end + level.textureWidth - 1) / level.textureWidth,
+            level.textureHeight);
+    if (firstRow >= endRow) {
+        return;
+    }
+
+    // Strip the stems, which are not rendered from the texture. The
+    // padding after the data of the level is uploaded as zeros.
+    const WaveformSummaryLevel summaryLevel = m_pWaveform->getSummaryLevel(levelIndex);
+    const int firstIndex = firstRow * level.textureWidth - level.offset;
+    std::vector<WaveformFilteredData> rows(
+            static_cast<std::size_t>(endRow - firstRow) * level.textureWidth);
+    const int size = std::min(static_cast<int>(rows.size()),
+            summaryLevel.dataSize - firstIndex);
+    for (int i = 0; i < size; ++i) {
+        rows[i] = summaryLevel.data[firstIndex + i].filtered;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, level.textureId);
+    glTexSubImage2D(GL_TEXTURE_2D,
+            0,
+            0,
+            firstRow,
+            level.textureWidth,
+            endRow - firstRow,
+            GL_RGBA,
+            GL_UNSIGNED_BYTE,
+            rows.data());
+    const GLenum error = glGetError();
+    VERIFY_OR_DEBUG_ASSERT(error == GL_NO_ERROR) {
+        qWarning() << "WaveformTexture::uploadLevel - glTexSubImage2D error" << error;
+    }
+}
+
+} // namespace allshader
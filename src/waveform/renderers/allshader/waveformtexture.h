@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QOpenGLFunctions>
+#include <memory>
+#include <vector>
+
+#include "util/class.h"
+#include "waveform/waveform.h"
+
+namespace allshader {
+class WaveformTexture;
+} // namespace allshader
+
+/// The filtered data of a Waveform in a GPU texture, shared by all renderers
+/// that show the same waveform. While the waveform is being analyzed, only
+/// the rows that were completed since the last update are uploaded.
+///
+/// The summary levels of the waveform are stored one after another in a
+/// second texture, each starting at a new row. Renderers that aggregate the
+/// data per pixel sample the level returned by levelForPixel(), so a shader
+/// never needs to read more than a few values per pixel.
+///
+/// This relies on the OpenGL contexts of all widgets sharing their objects,
+/// see Qt::AA_ShareOpenGLContexts in main.cpp. It must only be used from the
+/// thread that renders the waveforms, with an OpenGL context made current.
+class allshader::WaveformTexture : protected QOpenGLFunctions {
+  public:
+    /// The location of a level of the summary pyramid in the textures
+    struct Level {
+        GLuint textureId;
+        int textureWidth;
+        int textureHeight;
+        // The index of the first data element in the texture
+        int offset;
+        // The L and R values interleaved, like WaveformSummaryLevel
+        int dataSize;
+        int framesPerValue;
+    };
+
+    /// Returns the texture that is shared by all renderers of the waveform,
+    /// or creates it when the waveform isn't rendered yet.
+    static std::shared_ptr<WaveformTexture> forWaveform(
+            const ConstWaveformPointer& pWaveform);
+
+    ~WaveformTexture();
+
+    const ConstWaveformPointer& waveform() const {
+        return m_pWaveform;
+    }
+
+    /// The texture of the waveform data, i.e. level 0, with the
+    /// layout expected by the shaders in res/shaders
+    GLuint textureId() const {
+        return m_textureId;
+    }
+
+    /// See Waveform::getSummaryLevelForPixel()
+    Level levelForPixel(double visualFramesPerPixel) const;
+
+    /// Uploads the data that was completed since the last update
+    void update();
+
+  private:
+    explicit WaveformTexture(ConstWaveformPointer pWaveform);
+
+    GLuint createTexture(int width, int height);
+    // Uploads the rows that contain the data elements [begin, end)
+    // of the given level
+    void uploadLevel(int levelIndex, int begin, int end);
+
+    const ConstWaveformPointer m_pWaveform;
+    GLuint m_textureId;
+    // Levels 1 and above, 0 if the waveform has no summary levels
+    GLuint m_summaryTextureId;
+    std::vector<Level> m_levels;
+    // The number of data elements that were completed when uploaded
+    int m_uploadedCompletion;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformTexture);
+};
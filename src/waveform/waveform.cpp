@@ -1,10 +1,12 @@
 #include "waveform/waveform.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "analyzer/constants.h"
 #include "engine/engine.h"
 #include "proto/waveform.pb.h"
+#include "util/assert.h"
 
 using namespace mixxx::track;
 
@@ -18,6 +20,140 @@ int computeTextureStride(int size) {
     return stride;
 }
 
+namespace {
+
+void storeMax(WaveformData* pDest, const WaveformData& source) {
+    pDest->filtered.low = std::max(pDest->filtered.low, source.filtered.low);
+    pDest->filtered.mid = std::max(pDest->filtered.mid, source.filtered.mid);
+    pDest->filtered.high = std::max(pDest->filtered.high, source.filtered.high);
+    pDest->filtered.all = std::max(pDest->filtered.all, source.filtered.all);
+    for (int stemIdx = 0; stemIdx < mixxx::kMaxSupportedStems; ++stemIdx) {
+        pDest->stems[stemIdx] = std::max(pDest->stems[stemIdx], source.stems[stemIdx]);
+    }
+}
+
+// The values are stored as the difference to the previous value of the
+// same channel, in a byte each. Most differences are small, so they
+// compress much better than the values themselves.
+template<typename Getter>
+void writeSignal(io::Waveform::Signal* pSignal,
+        const WaveformData* data,
+        int size,
+        Getter value) {
+    pSignal->set_units(io::Waveform::RMS);
+    pSignal->set_channels(mixxx::kEngineChannelOutputCount);
+    std::string* pDeltaValues = pSignal->mutable_delta_values();
+    pDeltaValues->resize(size);
+    unsigned char previous[ChannelCount] = {};
+    for (int i = 0; i < size; ++i) {
+        const unsigned char current = value(data[i]);
+        (*pDeltaValues)[i] = static_cast<char>(
+                static_cast<unsigned char>(current - previous[i % ChannelCount]));
+        previous[i % ChannelCount] = current;
+    }
+}
+
+int signalSize(const io::Waveform::Signal& signal) {
+    if (signal.has_delta_values()) {
+        return static_cast<int>(signal.delta_values().size());
+    }
+    // Stored before Waveform-7.0
+    return signal.value_size();
+}
+
+// Values that are missing or not RMS are read as 0.
+template<typename Getter>
+void readSignal(const io::Waveform::Signal& signal,
+        WaveformData* data,
+        int size,
+        Getter value) {
+    // TODO(XXX) If non-RMS, convert but since we only save RMS today we can add
+    // this later.
+    const bool valid = signal.units() == io::Waveform::RMS;
+    const int validSize = valid ? std::min(size, signalSize(signal)) : 0;
+    if (signal.has_delta_values()) {
+        const std::string& deltaValues = signal.delta_values();
+        unsigned char previous[ChannelCount] = {};
+        for (int i = 0; i < validSize; ++i) {
+            previous[i % ChannelCount] += static_cast<unsigned char>(deltaValues[i]);
+            value(data[i]) = previous[i % ChannelCount];
+        }
+    } else {
+        for (int i = 0; i < validSize; ++i) {
+            value(data[i]) = static_cast<unsigned char>(signal.value(i));
+        }
+    }
+    for (int i = validSize; i < size; ++i) {
+        value(data[i]) = 0;
+    }
+}
+
+bool readSummaryLevels(const io::Waveform& waveform,
+        std::vector<std::vector<WaveformData>>* pLevels,
+        int stemCount) {
+    if (waveform.summary_levels_size() != static_cast<int>(pLevels->size())) {
+        return false;
+    }
+    int framesPerValue = 1;
+    for (int levelIdx = 0; levelIdx < waveform.summary_levels_size(); ++levelIdx) {
+        const io::Waveform::SummaryLevel& summaryLevel = waveform.summary_levels(levelIdx);
+        std::vector<WaveformData>* pLevel = &(*pLevels)[levelIdx];
+        const int size = static_cast<int>(pLevel->size());
+        const auto isComplete = [size](const io::Waveform::Signal& signal) {
+            return signal.units() == io::Waveform::RMS && signalSize(signal) == size;
+        };
+        framesPerValue *= Waveform::kSummaryLevelFactor;
+        const io::Waveform::FilteredSignal& levelFiltered = summaryLevel.signal_filtered();
+        if (summaryLevel.frames_per_value() != framesPerValue ||
+                !isComplete(summaryLevel.signal_all()) ||
+                !isComplete(levelFiltered.low()) ||
+                !isComplete(levelFiltered.mid()) ||
+                !isComplete(levelFiltered.high()) ||
+                summaryLevel.signal_stems_size() != stemCount ||
+                !std::all_of(summaryLevel.signal_stems().begin(),
+                        summaryLevel.signal_stems().end(),
+                        isComplete)) {
+            return false;
+        }
+        WaveformData* data = pLevel->data();
+        readSignal(summaryLevel.signal_all(),
+                data,
+                size,
+                [](WaveformData& datum) -> unsigned char& {
+                    return datum.filtered.all;
+                });
+        readSignal(levelFiltered.low(),
+                data,
+                size,
+                [](WaveformData& datum) -> unsigned char& {
+                    return datum.filtered.low;
+                });
+        readSignal(levelFiltered.mid(),
+                data,
+                size,
+                [](WaveformData& datum) -> unsigned char& {
+                    return datum.filtered.mid;
+                });
+        readSignal(levelFiltered.high(),
+                data,
+                size,
+                [](WaveformData& datum) -> unsigned char& {
+                    return datum.filtered.high;
+                });
+        for (int i = 0; i < stemCount; ++i) {
+            readSignal(summaryLevel.signal_stems(i),
+                    data,
+                    size,
+                    [i](WaveformData& datum) -> unsigned char& {
+                        return datum.stems[i];
+                    });
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 Waveform::Waveform(const QByteArray& data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
@@ -84,10 +220,6 @@ QByteArray Waveform::toByteArray() const {
     io::Waveform::Signal* all = waveform.mutable_signal_all();
     io::Waveform::FilteredSignal* filtered = waveform.mutable_signal_filtered();
 
-    QList<io::Waveform::Signal*> stems;
-    for (int i = 0; i < m_stemCount; i++) {
-        stems.append(waveform.add_signal_stems());
-    }
     // TODO(rryan) get the actual cutoff values from analyzerwaveform.cpp so
     // that if they change we don't have to remember to update these.
 
@@ -105,44 +237,64 @@ QByteArray Waveform::toByteArray() const {
     // Frequency cutoff for bessel_highpass4
     filtered->set_high_cutoff_frequency(4000);
 
-    io::Waveform::Signal* low = filtered->mutable_low();
-    io::Waveform::Signal* mid = filtered->mutable_mid();
-    io::Waveform::Signal* high = filtered->mutable_high();
-
     // TODO(vrince) set max/min for each signal
-    all->set_units(io::Waveform::RMS);
-    all->set_channels(mixxx::kEngineChannelOutputCount);
-    low->set_units(io::Waveform::RMS);
-    low->set_channels(mixxx::kEngineChannelOutputCount);
-    mid->set_units(io::Waveform::RMS);
-    mid->set_channels(mixxx::kEngineChannelOutputCount);
-    high->set_units(io::Waveform::RMS);
-    high->set_channels(mixxx::kEngineChannelOutputCount);
-
-    int dataSize = getDataSize();
-    for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
-        all->add_value(datum.filtered.all);
-        low->add_value(datum.filtered.low);
-        mid->add_value(datum.filtered.mid);
-        high->add_value(datum.filtered.high);
+    const int dataSize = getDataSize();
+    writeSignal(all, data(), dataSize, [](const WaveformData& datum) {
+        return datum.filtered.all;
+    });
+    writeSignal(filtered->mutable_low(), data(), dataSize, [](const WaveformData& datum) {
+        return datum.filtered.low;
+    });
+    writeSignal(filtered->mutable_mid(), data(), dataSize, [](const WaveformData& datum) {
+        return datum.filtered.mid;
+    });
+    writeSignal(filtered->mutable_high(), data(), dataSize, [](const WaveformData& datum) {
+        return datum.filtered.high;
+    });
+    for (int stemIdx = 0; stemIdx < m_stemCount; ++stemIdx) {
+        writeSignal(waveform.add_signal_stems(),
+                data(),
+                dataSize,
+                [stemIdx](const WaveformData& datum) {
+                    return datum.stems[stemIdx];
+                });
     }
 
-    int stemIdx = 0;
-    for (auto& stem : stems) {
-        stem->set_units(io::Waveform::RMS);
-        stem->set_channels(mixxx::kEngineChannelOutputCount);
-        for (int i = 0; i < dataSize; ++i) {
-            const WaveformData& datum = m_data.at(i);
-            stem->add_value(datum.stems[stemIdx]);
+    for (int levelIdx = 1; levelIdx < getSummaryLevelCount(); ++levelIdx) {
+        const WaveformSummaryLevel level = getSummaryLevel(levelIdx);
+        io::Waveform::SummaryLevel* summaryLevel = waveform.add_summary_levels();
+        summaryLevel->set_frames_per_value(level.framesPerValue);
+        writeSignal(summaryLevel->mutable_signal_all(),
+                level.data,
+                level.dataSize,
+                [](const WaveformData& datum) { return datum.filtered.all; });
+        io::Waveform::FilteredSignal* levelFiltered = summaryLevel->mutable_signal_filtered();
+        writeSignal(levelFiltered->mutable_low(),
+                level.data,
+                level.dataSize,
+                [](const WaveformData& datum) { return datum.filtered.low; });
+        writeSignal(levelFiltered->mutable_mid(),
+                level.data,
+                level.dataSize,
+                [](const WaveformData& datum) { return datum.filtered.mid; });
+        writeSignal(levelFiltered->mutable_high(),
+                level.data,
+                level.dataSize,
+                [](const WaveformData& datum) { return datum.filtered.high; });
+        for (int stemIdx = 0; stemIdx < m_stemCount; ++stemIdx) {
+            writeSignal(summaryLevel->add_signal_stems(),
+                    level.data,
+                    level.dataSize,
+                    [stemIdx](const WaveformData& datum) {
+                        return datum.stems[stemIdx];
+                    });
         }
-        stemIdx++;
     }
 
     qDebug() << "Writing waveform from byte array:"
              << "dataSize" << dataSize
              << "stemCount" << m_stemCount
-             << "allSignalSize" << all->value_size()
+             << "allSignalSize" << signalSize(*all)
              << "visualSampleRate" << waveform.visual_sample_rate()
              << "audioVisualRatio" << waveform.audio_visual_ratio();
 
@@ -181,16 +333,16 @@ void Waveform::readByteArray(const QByteArray& data) {
     const io::Waveform::Signal& high = waveform.signal_filtered().high();
 
     qDebug() << "Reading waveform from byte array:"
-             << "allSignalSize" << all.value_size()
+             << "allSignalSize" << signalSize(all)
              << "visualSampleRate" << waveform.visual_sample_rate()
              << "audioVisualRatio" << waveform.audio_visual_ratio()
              << "stemSignalSize" << waveform.signal_stems_size();
 
-    resize(all.value_size());
+    resize(signalSize(all));
 
     int dataSize = getDataSize();
-    if (all.value_size() != dataSize) {
-        qDebug() << "ERROR: Couldn't resize Waveform to" << all.value_size()
+    if (signalSize(all) != dataSize) {
+        qDebug() << "ERROR: Couldn't resize Waveform to" << signalSize(all)
                  << "while reading.";
         resize(0);
         m_saveState = SaveState::NotSaved;
@@ -199,39 +351,39 @@ void Waveform::readByteArray(const QByteArray& data) {
 
     m_visualSampleRate = waveform.visual_sample_rate();
     m_audioVisualRatio = waveform.audio_visual_ratio();
-    if (low.value_size() != dataSize ||
-        mid.value_size() != dataSize ||
-        high.value_size() != dataSize) {
+    if (signalSize(low) != dataSize ||
+            signalSize(mid) != dataSize ||
+            signalSize(high) != dataSize) {
         qDebug() << "WARNING: Filtered data size does not match all-signal size.";
     }
 
-    // TODO(XXX) If non-RMS, convert but since we only save RMS today we can add
-    // this later.
-    bool low_valid = low.units() == io::Waveform::RMS;
-    bool mid_valid = mid.units() == io::Waveform::RMS;
-    bool high_valid = high.units() == io::Waveform::RMS;
-    for (int i = 0; i < dataSize; ++i) {
-        m_data[i].filtered.all = static_cast<unsigned char>(all.value(i));
-        bool use_low = low_valid && i < low.value_size();
-        bool use_mid = mid_valid && i < mid.value_size();
-        bool use_high = high_valid && i < high.value_size();
-        m_data[i].filtered.low = use_low ? static_cast<unsigned char>(low.value(i)) : 0;
-        m_data[i].filtered.mid = use_mid ? static_cast<unsigned char>(mid.value(i)) : 0;
-        m_data[i].filtered.high = use_high ? static_cast<unsigned char>(high.value(i)) : 0;
-    }
+    WaveformData* pData = m_data.data();
+    readSignal(all, pData, dataSize, [](WaveformData& datum) -> unsigned char& {
+        return datum.filtered.all;
+    });
+    readSignal(low, pData, dataSize, [](WaveformData& datum) -> unsigned char& {
+        return datum.filtered.low;
+    });
+    readSignal(mid, pData, dataSize, [](WaveformData& datum) -> unsigned char& {
+        return datum.filtered.mid;
+    });
+    readSignal(high, pData, dataSize, [](WaveformData& datum) -> unsigned char& {
+        return datum.filtered.high;
+    });
     m_stemCount = waveform.signal_stems_size();
     for (int stemIdx = 0; stemIdx < m_stemCount; ++stemIdx) {
-        const io::Waveform::Signal& stem = waveform.signal_stems(stemIdx);
-        if (stem.units() == io::Waveform::RMS && stem.value_size() > 0) {
-            for (int i = 0; i < std::min(dataSize, stem.value_size()); ++i) {
-                m_data[i].stems[stemIdx] = static_cast<unsigned char>(stem.value(i));
-            }
-        }
-        if (stem.units() != io::Waveform::RMS || dataSize > stem.value_size()) {
-            for (int i = stem.value_size(); i < dataSize; ++i) {
-                m_data[i].stems[stemIdx] = 0;
-            }
-        }
+        readSignal(waveform.signal_stems(stemIdx),
+                pData,
+                dataSize,
+                [stemIdx](WaveformData& datum) -> unsigned char& {
+                    return datum.stems[stemIdx];
+                });
+    }
+
+    if (!readSummaryLevels(waveform, &m_summaryLevels, m_stemCount)) {
+        // Stored by an older version or inconsistent, so we rebuild them
+        // from the waveform data.
+        updateSummaryLevels(0, dataSize);
     }
 
     m_completion = dataSize;
@@ -242,15 +394,77 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    allocateSummaryLevels();
 }
 
 void Waveform::assign(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, {});
+    allocateSummaryLevels();
     m_saveState = SaveState::SavePending;
 }
 
+void Waveform::allocateSummaryLevels() {
+    m_summaryLevels.clear();
+    int frames = m_dataSize / ChannelCount;
+    while (frames > 1) {
+        frames = (frames + kSummaryLevelFactor - 1) / kSummaryLevelFactor;
+        m_summaryLevels.emplace_back(frames * ChannelCount, WaveformData{});
+    }
+}
+
+WaveformSummaryLevel Waveform::getSummaryLevel(int level) const {
+    VERIFY_OR_DEBUG_ASSERT(level >= 0 && level < getSummaryLevelCount()) {
+        level = 0;
+    }
+    if (level == 0) {
+        return {data(), m_dataSize, 1};
+    }
+    int framesPerValue = 1;
+    for (int i = 0; i < level; ++i) {
+        framesPerValue *= kSummaryLevelFactor;
+    }
+    const std::vector<WaveformData>& summaryLevel = m_summaryLevels[level - 1];
+    return {summaryLevel.data(), static_cast<int>(summaryLevel.size()), framesPerValue};
+}
+
+WaveformSummaryLevel Waveform::getSummaryLevelForPixel(double visualFramesPerPixel) const {
+    int level = 0;
+    double framesPerValue = kSummaryLevelFactor;
+    while (level + 1 < getSummaryLevelCount() && framesPerValue <= visualFramesPerPixel) {
+        ++level;
+        framesPerValue *= kSummaryLevelFactor;
+    }
+    return getSummaryLevel(level);
+}
+
+void Waveform::updateSummaryLevels(int begin, int end) {
+    DEBUG_ASSERT(begin >= 0 && begin <= end && end <= m_dataSize);
+    // The frames of the level below, starting with the waveform data
+    const WaveformData* pChildren = data();
+    int childFrames = m_dataSize / ChannelCount;
+    int firstFrame = begin / ChannelCount;
+    int endFrame = (end + ChannelCount - 1) / ChannelCount;
+    for (std::vector<WaveformData>& level : m_summaryLevels) {
+        firstFrame /= kSummaryLevelFactor;
+        endFrame = (endFrame + kSummaryLevelFactor - 1) / kSummaryLevelFactor;
+        for (int frame = firstFrame; frame < endFrame; ++frame) {
+            const int childBegin = frame * kSummaryLevelFactor;
+            const int childEnd = std::min(childBegin + kSummaryLevelFactor, childFrames);
+            for (int channel = 0; channel < ChannelCount; ++channel) {
+                WaveformData maximum{};
+                for (int child = childBegin; child < childEnd; ++child) {
+                    storeMax(&maximum, pChildren[child * ChannelCount + channel]);
+                }
+                level[frame * ChannelCount + channel] = maximum;
+            }
+        }
+        pChildren = level.data();
+        childFrames = static_cast<int>(level.size()) / ChannelCount;
+    }
+}
+
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size(" + QString::number(getDataSize()) + ")"
@@ -31,6 +31,15 @@ struct WaveformData {
     unsigned char stems[mixxx::kMaxSupportedStems];
 };
 
+/// A level of the summary pyramid of a Waveform. Each frame of a level
+/// holds the maximum of framesPerValue visual frames of the waveform.
+struct WaveformSummaryLevel {
+    // The L and R values interleaved, like Waveform::data()
+    const WaveformData* data;
+    int dataSize;
+    int framesPerValue;
+};
+
 class Waveform {
   public:
     enum class SaveState {
@@ -137,12 +146,34 @@ class Waveform {
         return m_stemCount > 0;
     }
 
+    // Each summary level aggregates this many frames of the level below.
+    static constexpr int kSummaryLevelFactor = 4;
+
+    // The number of summary levels, including level 0 which is the
+    // waveform data itself. We do not lock the mutex since the levels are
+    // not resized after the constructor runs.
+    int getSummaryLevelCount() const {
+        return static_cast<int>(m_summaryLevels.size()) + 1;
+    }
+
+    WaveformSummaryLevel getSummaryLevel(int level) const;
+
+    // Returns the level with the fewest frames that still has at least one
+    // frame per pixel, so renderers don't need to aggregate thousands of
+    // visual frames per pixel when zoomed out.
+    WaveformSummaryLevel getSummaryLevelForPixel(double visualFramesPerPixel) const;
+
+    // Aggregates the data elements in [begin, end) into the summary levels.
+    // Called by the analyzer after storing new data elements.
+    void updateSummaryLevels(int begin, int end);
+
     void dump() const;
 
   private:
     void readByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size);
+    void allocateSummaryLevels();
 
     inline WaveformData& at(int i) { return m_data[i];}
     inline unsigned char& low(int i) { return m_data[i].filtered.low;}
@@ -169,6 +200,10 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // Levels 1 and above of the summary pyramid, see getSummaryLevel().
+    // Unlike m_data they are not padded. Not allowed to be resized after
+    // the constructor runs.
+    std::vector<std::vector<WaveformData>> m_summaryLevels;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
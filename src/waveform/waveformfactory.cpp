@@ -18,6 +18,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(con
         return VC_USE;
     }
 
+    if (version == WAVEFORM_5_VERSION) {
+        // Used up to Mixxx 2.5, stored without the byte deltas
+        return VC_CONVERT;
+    }
+
     if (version == WAVEFORM_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug #7776
         return VC_REMOVE;
@@ -39,6 +44,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformVersionToVersionClass(con
         // the signal scale removal
         return VC_REMOVE;
     }
+
+    if (version == WAVEFORM_6_VERSION) {
+        // Used in Mixxx 2.6 beta, stored without the byte deltas
+        return VC_CONVERT;
+    }
 #endif
 
     // possible a future version
@@ -52,6 +62,11 @@ WaveformFactory::VersionClass WaveformFactory::waveformSummaryVersionToVersionCl
         return VC_USE;
     }
 
+    if (version == WAVEFORMSUMMARY_5_VERSION) {
+        // Used up to Mixxx 2.6 beta, stored without the byte deltas
+        return VC_CONVERT;
+    }
+
     if (version == WAVEFORMSUMMARY_4_VERSION) {
         // Used in Mixxx 1.12 beta, suffers Bug #7776
         return VC_REMOVE;
@@ -36,19 +36,26 @@ class Waveform;
 #define WAVEFORM_6_DESCRIPTION "Waveform 6.1"
 #define WAVEFORMSUMMARY_6_DESCRIPTION "WaveformSummary 6.1"
 
-#define WAVEFORM_CURRENT_VERSION WAVEFORM_6_VERSION
-#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_6_DESCRIPTION
-#else
-#define WAVEFORM_CURRENT_VERSION WAVEFORM_5_VERSION
-#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_5_DESCRIPTION
 #endif
-#define WAVEFORMSUMMARY_CURRENT_VERSION WAVEFORMSUMMARY_5_VERSION
-#define WAVEFORMSUMMARY_CURRENT_DESCRIPTION WAVEFORMSUMMARY_5_DESCRIPTION
+
+// Used from Mixxx 2.6 with the signals stored as byte deltas, see
+// proto/waveform.proto
+#define WAVEFORM_7_VERSION "Waveform-7.0"
+#define WAVEFORMSUMMARY_7_VERSION "WaveformSummary-7.0"
+#define WAVEFORM_7_DESCRIPTION "Waveform 7.0"
+#define WAVEFORMSUMMARY_7_DESCRIPTION "WaveformSummary 7.0"
+
+#define WAVEFORM_CURRENT_VERSION WAVEFORM_7_VERSION
+#define WAVEFORM_CURRENT_DESCRIPTION WAVEFORM_7_DESCRIPTION
+#define WAVEFORMSUMMARY_CURRENT_VERSION WAVEFORMSUMMARY_7_VERSION
+#define WAVEFORMSUMMARY_CURRENT_DESCRIPTION WAVEFORMSUMMARY_7_DESCRIPTION
 
 class WaveformFactory {
   public:
     enum VersionClass {
         VC_USE,
+        // Use, but store again in the current version
+        VC_CONVERT,
         VC_KEEP,
         VC_REMOVE
     };
@@ -7,10 +7,9 @@
 #include "waveform/renderers/allshader/waveformrenderbackground.h"
 #include "waveform/renderers/allshader/waveformrenderbeat.h"
 #include "waveform/renderers/allshader/waveformrendererendoftrack.h"
-#include "waveform/renderers/allshader/waveformrendererfiltered.h"
 #include "waveform/renderers/allshader/waveformrendererhsv.h"
 #include "waveform/renderers/allshader/waveformrendererpreroll.h"
-#include "waveform/renderers/allshader/waveformrendererrgb.h"
+#include "waveform/renderers/allshader/waveformrenderersampled.h"
 #include "waveform/renderers/allshader/waveformrenderersimple.h"
 #include "waveform/renderers/allshader/waveformrendererslipmode.h"
 #include "waveform/renderers/allshader/waveformrendererstem.h"
@@ -121,14 +120,14 @@ WaveformWidget::addWaveformSignalRenderer(WaveformWidgetType::Type type,
     case ::WaveformWidgetType::Simple:
         return addWaveformSignalRenderer<WaveformRendererSimple>(options);
     case ::WaveformWidgetType::RGB:
-        return addWaveformSignalRenderer<WaveformRendererRGB>(positionSource, options);
-    case ::WaveformWidgetType::HSV:
-        return addWaveformSignalRenderer<WaveformRendererHSV>(options);
     case ::WaveformWidgetType::Filtered:
-        return addWaveformSignalRenderer<WaveformRendererFiltered>(false, options);
     case ::WaveformWidgetType::Stacked:
-        return addWaveformSignalRenderer<WaveformRendererFiltered>(
-                true, options); // true for RGB Stacked
+        // Sampled from the waveform texture that is shared by all widgets,
+        // see WaveformRendererRGB and WaveformRendererFiltered for QML
+        return addWaveformSignalRenderer<WaveformRendererSampled>(
+                type, positionSource, options);
+    case ::WaveformWidgetType::HSV:
+        return addWaveformSignalRenderer<WaveformRendererHSV>(options);
     default:
         break;
     }